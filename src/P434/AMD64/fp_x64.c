@@ -6,6 +6,9 @@
 
 #include "../P434_internal.h"
 #include "../../internal.h"
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+    #include "../../cpu_features.h"
+#endif
 
 
 // Global constants
@@ -15,6 +18,52 @@ extern const uint64_t p434x2[NWORDS_FIELD];
 extern const uint64_t p434x4[NWORDS_FIELD];
 
 
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+// Variants of the multiplication, squaring and Montgomery reduction, the fastest one supported by the host is bound at load time
+void mul434_asm_adx(const digit_t* a, const digit_t* b, digit_t* c);
+void mul434_asm_mulx(const digit_t* a, const digit_t* b, digit_t* c);
+void rdc434_asm_adx(digit_t* ma, digit_t* mc);
+void rdc434_asm_mulx(digit_t* ma, digit_t* mc);
+void sqr434_asm_adx(const digit_t* a, digit_t* c);
+void sqr434_asm_mulx(const digit_t* a, digit_t* c);
+static void mul434_comba(const digit_t* a, const digit_t* b, digit_t* c);
+static void rdc434_comba(digit_t* ma, digit_t* mc);
+static void sqr434_comba(const digit_t* a, digit_t* c);
+
+static void (*mul434_kernel)(const digit_t* a, const digit_t* b, digit_t* c) = mul434_comba;
+static void (*rdc434_kernel)(digit_t* ma, digit_t* mc) = rdc434_comba;
+static void (*sqr434_kernel)(const digit_t* a, digit_t* c) = sqr434_comba;
+
+// Variants of the fused GF(p434^2) squaring, processors without MULX compose it from the kernels above
+void fp2sqr434_asm_adx(const f2elm_t a, f2elm_t c);
+void fp2sqr434_asm_mulx(const f2elm_t a, f2elm_t c);
+static void fp2sqr434_karatsuba(const f2elm_t a, f2elm_t c);
+
+static void (*fp2sqr434_kernel)(const f2elm_t a, f2elm_t c) = fp2sqr434_karatsuba;
+
+
+__attribute__((constructor)) static void fp434_dispatch_init(void)
+{ // Selection of the multiplication, squaring, reduction and fused GF(p^2) squaring kernels according to the host's support for MULX and ADX.
+  // Processors without MULX keep the baseline x64 implementation in C.
+    unsigned int features = cpu_features();
+
+    if ((features & CPU_FEATURE_MULX) && (features & CPU_FEATURE_ADX)) {
+        mul434_kernel = mul434_asm_adx;
+        rdc434_kernel = rdc434_asm_adx;
+        sqr434_kernel = sqr434_asm_adx;
+        fp2sqr434_kernel = fp2sqr434_asm_adx;
+    } else if (features & CPU_FEATURE_MULX) {
+        mul434_kernel = mul434_asm_mulx;
+        rdc434_kernel = rdc434_asm_mulx;
+        sqr434_kernel = sqr434_asm_mulx;
+        fp2sqr434_kernel = fp2sqr434_asm_mulx;
+    }
+}
+
+#endif
+
+
 __inline void mp_sub434_p2(const digit_t* a, const digit_t* b, digit_t* c)
 { // Multiprecision subtraction with correction with 2*p, c = a-b+2p.    
 #if (OS_TARGET == OS_WIN) || defined(GENERIC_IMPLEMENTATION) || (TARGET == TARGET_ARM) || (TARGET == TARGET_ARM64 && NBITS_FIELD == 610)
@@ -331,6 +380,10 @@ void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int n
     c[12] = uv[0];
     c[13] = uv[1];
 
+#elif (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+    mul434_kernel(a, b, c);
+
 #elif (OS_TARGET == OS_NIX)
     
     mul434_asm(a, b, c);
@@ -339,6 +392,27 @@ void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int n
 }
 
 
+void mp_sqr(const digit_t* a, digit_t* c, const unsigned int nwords)
+{ // Multiprecision squaring, c = a^2, where lng(a) = nwords.
+        
+    UNREFERENCED_PARAMETER(nwords);
+
+#if (OS_TARGET == OS_WIN)
+
+    mp_mul(a, a, c, NWORDS_FIELD);
+
+#elif (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+    sqr434_kernel(a, c);
+
+#elif (OS_TARGET == OS_NIX)
+    
+    sqr434_asm(a, c);
+
+#endif
+}
+
+
 void rdc_mont(digit_t* ma, digit_t* mc)
 { // Montgomery reduction exploiting special form of the prime.
   // mc = ma*R^-1 mod p434x2, where R = 2^448.
@@ -480,9 +554,160 @@ void rdc_mont(digit_t* ma, digit_t* mc)
     ADDC(0, uv[0], ma[12], carry, mc[5]); 
     ADDC(carry, uv[1], ma[13], carry, mc[6]); 
     
+#elif (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+    rdc434_kernel(ma, mc);
+
 #elif (OS_TARGET == OS_NIX)                 
     
     rdc434_asm(ma, mc);    
 
 #endif
-}
\ No newline at end of file
+}
+
+
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+static void mul434_comba(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Multiprecision comba multiply, c = a*b, for processors without MULX.
+    unsigned int i, j, carry = 0;
+    digit_t t = 0, u = 0, v = 0, UV[2];
+    
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        for (j = 0; j <= i; j++) {
+            MUL(a[j], b[i-j], UV+1, UV[0]); 
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+        }
+        c[i] = v;
+        v = u; 
+        u = t;
+        t = 0;
+    }
+
+    for (i = NWORDS_FIELD; i < 2*NWORDS_FIELD-1; i++) {
+        for (j = i-NWORDS_FIELD+1; j < NWORDS_FIELD; j++) {
+            MUL(a[j], b[i-j], UV+1, UV[0]); 
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+        }
+        c[i] = v;
+        v = u; 
+        u = t;
+        t = 0;
+    }
+    c[2*NWORDS_FIELD-1] = v; 
+}
+
+
+static void sqr434_comba(const digit_t* a, digit_t* c)
+{ // Multiprecision comba squaring, c = a^2, for processors without MULX.
+    unsigned int i, j, carry = 0;
+    digit_t t = 0, u = 0, v = 0, UV[2];
+    
+    for (i = 0; i < 2*NWORDS_FIELD-1; i++) {
+        for (j = (i < NWORDS_FIELD) ? 0 : i-NWORDS_FIELD+1; j < i-j; j++) {
+            MUL(a[j], a[i-j], UV+1, UV[0]);          // Cross products are computed once and added twice
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+        }
+        if ((i & 1) == 0) {
+            MUL(a[i/2], a[i/2], UV+1, UV[0]); 
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+        }
+        c[i] = v;
+        v = u; 
+        u = t;
+        t = 0;
+    }
+    c[2*NWORDS_FIELD-1] = v; 
+}
+
+
+static void rdc434_comba(digit_t* ma, digit_t* mc)
+{ // Montgomery reduction using comba and exploiting the special form of the prime, for processors without MULX.
+  // mc = ma*R^-1 mod p434x2. If ma < 2^MAXBITS_FIELD*p434, the output mc is in the range [0, 2*p434-1].
+    unsigned int i, j, carry, count = p434_ZERO_WORDS;
+    digit_t UV[2], t = 0, u = 0, v = 0;
+
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        mc[i] = 0;
+    }
+
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        for (j = 0; j < i; j++) {
+            if (j < (i-p434_ZERO_WORDS+1)) { 
+                MUL(mc[j], ((digit_t*)p434p1)[i-j], UV+1, UV[0]);
+                ADDC(0, UV[0], v, carry, v); 
+                ADDC(carry, UV[1], u, carry, u); 
+                t += carry; 
+            }
+        }
+        ADDC(0, v, ma[i], carry, v); 
+        ADDC(carry, u, 0, carry, u); 
+        t += carry; 
+        mc[i] = v;
+        v = u;
+        u = t;
+        t = 0;
+    }    
+
+    for (i = NWORDS_FIELD; i < 2*NWORDS_FIELD-1; i++) {
+        if (count > 0) {
+            count -= 1;
+        }
+        for (j = i-NWORDS_FIELD+1; j < NWORDS_FIELD; j++) {
+            if (j < (NWORDS_FIELD-count)) { 
+                MUL(mc[j], ((digit_t*)p434p1)[i-j], UV+1, UV[0]);
+                ADDC(0, UV[0], v, carry, v); 
+                ADDC(carry, UV[1], u, carry, u); 
+                t += carry;
+            }
+        }
+        ADDC(0, v, ma[i], carry, v); 
+        ADDC(carry, u, 0, carry, u); 
+        t += carry; 
+        mc[i-NWORDS_FIELD] = v;
+        v = u;
+        u = t;
+        t = 0;
+    }
+    ADDC(0, v, ma[2*NWORDS_FIELD-1], carry, v); 
+    mc[NWORDS_FIELD-1] = v;
+}
+
+#endif
+
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+void fp2sqr434_asm(const f2elm_t a, f2elm_t c)
+{ // GF(p434^2) squaring using Montgomery arithmetic, c = a^2 in GF(p434^2), through the kernel bound at load time.
+    fp2sqr434_kernel(a, c);
+}
+
+
+static void fp2sqr434_karatsuba(const f2elm_t a, f2elm_t c)
+{ // GF(p434^2) squaring for processors without MULX, c = a^2 in GF(p434^2).
+  // Inputs: a = a0+a1*i, where a0, a1 are in [0, 2*p434-1] 
+  // Output: c = c0+c1*i, where c0, c1 are in [0, 2*p434-1] 
+    felm_t t1, t2, t3;
+    dfelm_t tt;
+    
+    mp_add434_asm(a[0], a[1], t1);                   // t1 = a0+a1 
+    mp_sub434_p4_asm(a[0], a[1], t2);                // t2 = a0-a1
+    mp_add434_asm(a[0], a[0], t3);                   // t3 = 2a0
+    mul434_kernel(t1, t2, tt);
+    rdc434_kernel(tt, c[0]);                         // c0 = (a0+a1)(a0-a1)
+    mul434_kernel(t3, a[1], tt);
+    rdc434_kernel(tt, c[1]);                         // c1 = 2a0*a1
+}
+
+#endif
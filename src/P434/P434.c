@@ -70,8 +70,32 @@ const uint64_t Montgomery_R2[NWORDS64_FIELD]     = { 0x28E55B65DCD69B30, 0xACEC7
 const uint64_t Montgomery_one[NWORDS64_FIELD]    = { 0x000000000000742C, 0x0000000000000000, 0x0000000000000000, 0xB90FF404FC000000, 
                                                      0xD801A4FB559FACD4, 0xE93254545F77410C, 0x0000ECEEA7BD2EDA };
 
+#ifdef AVX2_X4_IMPLEMENTATION
+// Constants for the 4-way AVX2 representation in radix 2^29, with Montgomery constant R' = 2^(29*NLIMBS_X4)
+// p434 + 1 in radix 2^29
+const uint64_t p434p1_x4[NLIMBS_X4]             = { 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0F5C6000,
+                                                    0x03FDC176, 0x018AC575, 0x1EF1971E, 0x038A40AC, 0x0FC5FD68, 0x0BB9A236, 0x08D07C9C, 0x00000000 };
+// p434 x 2 in radix 2^29
+const uint64_t p434x2_x4[NLIMBS_X4]             = { 0x1FFFFFFE, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1EB8BFFF,
+                                                    0x07FB82EC, 0x03158AEA, 0x1DE32E3C, 0x07148159, 0x1F8BFAD0, 0x1773446C, 0x11A0F938, 0x00000000 };
+// p434 x 4 in radix 2^29
+const uint64_t p434x4_x4[NLIMBS_X4]             = { 0x1FFFFFFC, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1D717FFF,
+                                                    0x0FF705D9, 0x062B15D4, 0x1BC65C78, 0x0E2902B3, 0x1F17F5A0, 0x0EE688D9, 0x0341F271, 0x00000001 };
+// Conversion constant Montgomery_R2_x4 = (2^464)^2/2^448 mod p434, in radix 2^29
+const uint64_t Montgomery_R2_x4[NLIMBS_X4]      = { 0x0B854089, 0x0003A163, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0F90A000,
+                                                    0x09E71FF0, 0x16F57666, 0x0E921C06, 0x1587021A, 0x1C386E22, 0x1D372540, 0x05903292, 0x00000000 };
+// Conversion constant Montgomery_R_x4 = 2^448 mod p434, in radix 2^29
+const uint64_t Montgomery_R_x4[NLIMBS_X4]       = { 0x0000742C, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x009F8000,
+                                                    0x14B90FF4, 0x1AACFD66, 0x1600693E, 0x1EEE8219, 0x13254545, 0x1E976D74, 0x03B3BA9E, 0x00000000 };
+#endif
+
 
 // Fixed parameters for isogeny tree computation
+#if defined(TUNED_STRATEGIES)
+const unsigned int strat_Alice[MAX_Alice-1] = STRAT_ALICE_TUNED;
+
+const unsigned int strat_Bob[MAX_Bob-1] = STRAT_BOB_TUNED;
+#else
 const unsigned int strat_Alice[MAX_Alice-1] = { 
 48, 28, 16, 8, 4, 2, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 8, 4, 2, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 13, 7, 4, 2, 1, 1, 2, 1, 1, 3, 2, 1, 1, 
 1, 1, 5, 4, 2, 1, 1, 2, 1, 1, 2, 1, 1, 1, 21, 12, 7, 4, 2, 1, 1, 2, 1, 1, 3, 2, 1, 1, 1, 1, 5, 3, 2, 1, 1, 1, 1, 2, 1, 1, 1, 9, 5, 3, 2, 1, 1, 
@@ -81,6 +105,7 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 66, 33, 17, 9, 5, 3, 2, 1, 1, 1, 1, 2, 1, 1, 1, 4, 2, 1, 1, 1, 2, 1, 1, 8, 4, 2, 1, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 16, 8, 4, 2, 1, 1, 1, 
 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 8, 4, 2, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 32, 16, 8, 4, 3, 1, 1, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 8, 4, 2, 
 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 16, 8, 4, 2, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 8, 4, 2, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1 };
+#endif
            
 // Setting up macro defines and including GF(p), GF(p^2), curve, isogeny and kex functions
 #define fpcopy                        fpcopy434
@@ -95,6 +120,7 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 #define fpinv_mont                    fpinv434_mont
 #define fpinv_chain_mont              fpinv434_chain_mont
 #define fpinv_mont_bingcd             fpinv434_mont_bingcd
+#define fpinv_mont_safegcd            fpinv434_mont_safegcd
 #define fp2copy                       fp2copy434
 #define fp2zero                       fp2zero434
 #define fp2add                        fp2add434
@@ -113,17 +139,39 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 #define mp_add_asm                    mp_add434_asm
 #define mp_subaddx2_asm               mp_subadd434x2_asm
 #define mp_dblsubx2_asm               mp_dblsub434x2_asm
+#define fp2sqr_asm                    fp2sqr434_asm
+#define fp2mul_cxx                    fp2mul434_cxx
+#define fp2sqr_cxx                    fp2sqr434_cxx
 #define crypto_kem_keypair            crypto_kem_keypair_SIKEp434
 #define crypto_kem_enc                crypto_kem_enc_SIKEp434
 #define crypto_kem_dec                crypto_kem_dec_SIKEp434
+#define crypto_kem_dec_x4             crypto_kem_dec_x4_SIKEp434
+#define crypto_kem_pk_expand          crypto_kem_pk_expand_SIKEp434
+#define crypto_kem_enc_ctx            crypto_kem_enc_ctx_SIKEp434
+#define sike_pk_ctx                   sike_pk_ctx_SIKEp434
+#define crypto_kem_enc_batch          crypto_kem_enc_batch_SIKEp434
+#define crypto_kem_dec_batch          crypto_kem_dec_batch_SIKEp434
 #define random_mod_order_A            random_mod_order_A_SIDHp434
 #define random_mod_order_B            random_mod_order_B_SIDHp434
 #define EphemeralKeyGeneration_A      EphemeralKeyGeneration_A_SIDHp434
 #define EphemeralKeyGeneration_B      EphemeralKeyGeneration_B_SIDHp434
 #define EphemeralSecretAgreement_A    EphemeralSecretAgreement_A_SIDHp434
 #define EphemeralSecretAgreement_B    EphemeralSecretAgreement_B_SIDHp434
+#define EphemeralKeyGeneration_A_x4   EphemeralKeyGeneration_A_x4_SIDHp434
+#define EphemeralSecretAgreement_B_x4 EphemeralSecretAgreement_B_x4_SIDHp434
+#define EphemeralKeyPoolStart_A       EphemeralKeyPoolStart_A_SIDHp434
+#define EphemeralKeyPoolStart_B       EphemeralKeyPoolStart_B_SIDHp434
+#define EphemeralKeyPoolStop          EphemeralKeyPoolStop_SIDHp434
+#define EphemeralKeyPair_A            EphemeralKeyPair_A_SIDHp434
+#define EphemeralKeyPair_B            EphemeralKeyPair_B_SIDHp434
 
 #include "../fpx.c"
+#include "P434_fixed_base_tables.c"
 #include "../ec_isogeny.c"
-#include "../sidh.c"    
+#include "../sidh.c"
+#ifdef AVX2_X4_IMPLEMENTATION
+    #include "../fpx_x4.c"
+    #include "../ec_isogeny_x4.c"
+    #include "../sidh_x4.c"
+#endif
 #include "../sike.c"
\ No newline at end of file
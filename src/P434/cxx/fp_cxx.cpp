@@ -0,0 +1,124 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: modular arithmetic for P434 instantiated from the header-only C++ field backend
+*********************************************************************************************/
+
+extern "C" {
+#include "../P434_internal.h"
+#include "../../internal.h"
+}
+#include "../../cxx/fp.hpp"
+
+
+struct P434_params {
+    static constexpr unsigned nwords = NWORDS64_FIELD;
+    static constexpr sidh::limb_t p[NWORDS64_FIELD] = { 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFDC1767AE2FFFFFF, 0x7BC65C783158AEA3, 0x6CFC5FD681C52056, 0x0002341F27177344 };
+};
+
+typedef sidh::Fp<P434_params> fp434;
+typedef sidh::Fp2<P434_params> fp2_434;
+
+static_assert(fp434::zero_words == p434_ZERO_WORDS, "p434_ZERO_WORDS does not match p434+1");
+static_assert(sizeof(digit_t) == sizeof(sidh::limb_t), "the C++ field backend requires 64-bit digits");
+
+
+extern "C" {
+
+void mp_sub434_p2(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Multiprecision subtraction with correction with 2*p, c = a-b+2p.
+    fp434::sub_p2(a, b, c);
+}
+
+
+void mp_sub434_p4(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Multiprecision subtraction with correction with 4*p, c = a-b+4p.
+    fp434::sub_p4(a, b, c);
+}
+
+
+void fpadd434(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Modular addition, c = a+b mod p434.
+  // Inputs: a, b in [0, 2*p434-1]
+  // Output: c in [0, 2*p434-1]
+    fp434::add(a, b, c);
+}
+
+
+void fpsub434(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Modular subtraction, c = a-b mod p434.
+  // Inputs: a, b in [0, 2*p434-1]
+  // Output: c in [0, 2*p434-1]
+    fp434::sub(a, b, c);
+}
+
+
+void fpneg434(digit_t* a)
+{ // Modular negation, a = -a mod p434.
+  // Input/output: a in [0, 2*p434-1]
+    fp434::neg(a);
+}
+
+
+void fpdiv2_434(const digit_t* a, digit_t* c)
+{ // Modular division by two, c = a/2 mod p434.
+  // Input : a in [0, 2*p434-1]
+  // Output: c in [0, 2*p434-1]
+    fp434::div2(a, c);
+}
+
+
+void fpcorrection434(digit_t* a)
+{ // Modular correction to reduce field element a in [0, 2*p434-1] to [0, p434-1].
+    fp434::correction(a);
+}
+
+
+void digit_x_digit(const digit_t a, const digit_t b, digit_t* c)
+{ // Digit multiplication, digit * digit -> 2-digit result
+    sidh::dlimb_t t = (sidh::dlimb_t)a*b;
+
+    c[0] = (digit_t)t;
+    c[1] = (digit_t)(t >> 64);
+}
+
+
+void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords)
+{ // Multiprecision multiply, c = a*b, where lng(a) = lng(b) = nwords.
+
+    UNREFERENCED_PARAMETER(nwords);
+
+    fp434::mul(a, b, c);
+}
+
+
+void mp_sqr(const digit_t* a, digit_t* c, const unsigned int nwords)
+{ // Multiprecision squaring, c = a^2, where lng(a) = nwords.
+
+    UNREFERENCED_PARAMETER(nwords);
+
+    fp434::sqr(a, c);
+}
+
+
+void rdc_mont(digit_t* ma, digit_t* mc)
+{ // Efficient Montgomery reduction using comba and exploiting the special form of the prime p434.
+  // mc = ma*R^-1 mod p434x2, where R = 2^448.
+  // If ma < 2^448*p434, the output mc is in the range [0, 2*p434-1].
+  // ma is assumed to be in Montgomery representation.
+    fp434::rdc(ma, mc);
+}
+
+
+void fp2mul434_cxx(const f2elm_t a, const f2elm_t b, f2elm_t c)
+{ // GF(p434^2) multiplication using Montgomery arithmetic, c = a*b in GF(p434^2).
+    fp2_434::mul(a, b, c);
+}
+
+
+void fp2sqr434_cxx(const f2elm_t a, f2elm_t c)
+{ // GF(p434^2) squaring using Montgomery arithmetic, c = a^2 in GF(p434^2).
+    fp2_434::sqr(a, c);
+}
+
+}
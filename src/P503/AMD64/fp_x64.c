@@ -6,6 +6,9 @@
 
 #include "../P503_internal.h"
 #include "../../internal.h"
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+    #include "../../cpu_features.h"
+#endif
 
 
 // Global constants
@@ -15,6 +18,52 @@ extern const uint64_t p503x2[NWORDS_FIELD];
 extern const uint64_t p503x4[NWORDS_FIELD];
 
 
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+// Variants of the multiplication, squaring and Montgomery reduction, the fastest one supported by the host is bound at load time
+void mul503_asm_adx(const digit_t* a, const digit_t* b, digit_t* c);
+void mul503_asm_mulx(const digit_t* a, const digit_t* b, digit_t* c);
+void rdc503_asm_adx(digit_t* ma, digit_t* mc);
+void rdc503_asm_mulx(digit_t* ma, digit_t* mc);
+void mul503_asm_nomulx(const digit_t* a, const digit_t* b, digit_t* c);
+void rdc503_asm_nomulx(digit_t* ma, digit_t* mc);
+void sqr503_asm_adx(const digit_t* a, digit_t* c);
+void sqr503_asm_mulx(const digit_t* a, digit_t* c);
+void sqr503_asm_nomulx(const digit_t* a, digit_t* c);
+
+static void (*mul503_kernel)(const digit_t* a, const digit_t* b, digit_t* c) = mul503_asm_nomulx;
+static void (*rdc503_kernel)(digit_t* ma, digit_t* mc) = rdc503_asm_nomulx;
+static void (*sqr503_kernel)(const digit_t* a, digit_t* c) = sqr503_asm_nomulx;
+
+// Variants of the fused GF(p503^2) squaring, processors without MULX compose it from the kernels above
+void fp2sqr503_asm_adx(const f2elm_t a, f2elm_t c);
+void fp2sqr503_asm_mulx(const f2elm_t a, f2elm_t c);
+static void fp2sqr503_karatsuba(const f2elm_t a, f2elm_t c);
+
+static void (*fp2sqr503_kernel)(const f2elm_t a, f2elm_t c) = fp2sqr503_karatsuba;
+
+
+__attribute__((constructor)) static void fp503_dispatch_init(void)
+{ // Selection of the multiplication, squaring, reduction and fused GF(p^2) squaring kernels according to the host's support for MULX and ADX.
+  // Processors without MULX keep the baseline x64 assembly.
+    unsigned int features = cpu_features();
+
+    if ((features & CPU_FEATURE_MULX) && (features & CPU_FEATURE_ADX)) {
+        mul503_kernel = mul503_asm_adx;
+        rdc503_kernel = rdc503_asm_adx;
+        sqr503_kernel = sqr503_asm_adx;
+        fp2sqr503_kernel = fp2sqr503_asm_adx;
+    } else if (features & CPU_FEATURE_MULX) {
+        mul503_kernel = mul503_asm_mulx;
+        rdc503_kernel = rdc503_asm_mulx;
+        sqr503_kernel = sqr503_asm_mulx;
+        fp2sqr503_kernel = fp2sqr503_asm_mulx;
+    }
+}
+
+#endif
+
+
 __inline void mp_sub503_p2(const digit_t* a, const digit_t* b, digit_t* c)
 { // Multiprecision subtraction with correction with 2*p, c = a-b+2p.    
 #if (OS_TARGET == OS_WIN) || defined(GENERIC_IMPLEMENTATION) || (TARGET == TARGET_ARM) || (TARGET == TARGET_ARM64 && NBITS_FIELD == 610)
@@ -371,6 +420,10 @@ void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int n
     c[14] = uv[0];
     c[15] = uv[1];
 
+#elif (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+    mul503_kernel(a, b, c);
+
 #elif (OS_TARGET == OS_NIX)
     
     mul503_asm(a, b, c);
@@ -379,6 +432,27 @@ void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int n
 }
 
 
+void mp_sqr(const digit_t* a, digit_t* c, const unsigned int nwords)
+{ // Multiprecision squaring, c = a^2, where lng(a) = nwords.
+        
+    UNREFERENCED_PARAMETER(nwords);
+
+#if (OS_TARGET == OS_WIN)
+
+    mp_mul(a, a, c, NWORDS_FIELD);
+
+#elif (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+    sqr503_kernel(a, c);
+
+#elif (OS_TARGET == OS_NIX)
+    
+    sqr503_asm(a, c);
+
+#endif
+}
+
+
 void rdc_mont(digit_t* ma, digit_t* mc)
 { // Montgomery reduction exploiting special form of the prime.
   // mc = ma*R^-1 mod p503x2, where R = 2^512.
@@ -561,9 +635,39 @@ void rdc_mont(digit_t* ma, digit_t* mc)
     ADDC(carry, uv[1], 0, carry, uv[1]); 
     ADDC(0, uv[1], ma[15], carry, mc[7]); 
     
+#elif (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+    rdc503_kernel(ma, mc);
+
 #elif (OS_TARGET == OS_NIX)                 
     
     rdc503_asm(ma, mc);    
 
 #endif
-}
\ No newline at end of file
+}
+
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+void fp2sqr503_asm(const f2elm_t a, f2elm_t c)
+{ // GF(p503^2) squaring using Montgomery arithmetic, c = a^2 in GF(p503^2), through the kernel bound at load time.
+    fp2sqr503_kernel(a, c);
+}
+
+
+static void fp2sqr503_karatsuba(const f2elm_t a, f2elm_t c)
+{ // GF(p503^2) squaring for processors without MULX, c = a^2 in GF(p503^2).
+  // Inputs: a = a0+a1*i, where a0, a1 are in [0, 2*p503-1] 
+  // Output: c = c0+c1*i, where c0, c1 are in [0, 2*p503-1] 
+    felm_t t1, t2, t3;
+    dfelm_t tt;
+    
+    mp_add503_asm(a[0], a[1], t1);                   // t1 = a0+a1 
+    mp_sub503_p4_asm(a[0], a[1], t2);                // t2 = a0-a1
+    mp_add503_asm(a[0], a[0], t3);                   // t3 = 2a0
+    mul503_kernel(t1, t2, tt);
+    rdc503_kernel(tt, c[0]);                         // c0 = (a0+a1)(a0-a1)
+    mul503_kernel(t3, a[1], tt);
+    rdc503_kernel(tt, c[1]);                         // c1 = 2a0*a1
+}
+
+#endif
@@ -71,8 +71,37 @@ const uint64_t Montgomery_R2[NWORDS64_FIELD]     = { 0x5289A0CF641D011F, 0x9B882
 const uint64_t Montgomery_one[NWORDS64_FIELD]    = { 0x00000000000003F9, 0x0000000000000000, 0x0000000000000000, 0xB400000000000000, 
                                                      0x63CB1A6EA6DED2B4, 0x51689D8D667EB37D, 0x8ACD77C71AB24142, 0x0026FBAEC60F5953 };
 
+#ifdef AVX2_X4_IMPLEMENTATION
+// Constants for the 4-way AVX2 representation in radix 2^29, with Montgomery constant R' = 2^(29*NLIMBS_X4)
+// p503 + 1 in radix 2^29
+const uint64_t p503p1_x4[NLIMBS_X4]             = { 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                                                    0x00AC0000, 0x11108F3D, 0x04C216F6, 0x16FCFB5E, 0x19BF6C87, 0x1BD2680D, 0x171AF769, 0x03C3CC08,
+                                                    0x06F54181, 0x00000203, 0x00000000 };
+// p503 x 2 in radix 2^29
+const uint64_t p503x2_x4[NLIMBS_X4]             = { 0x1FFFFFFE, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF,
+                                                    0x0157FFFF, 0x02211E7A, 0x09842DED, 0x0DF9F6BC, 0x137ED90F, 0x17A4D01B, 0x0E35EED3, 0x07879811,
+                                                    0x0DEA8302, 0x00000406, 0x00000000 };
+// p503 x 4 in radix 2^29
+const uint64_t p503x4_x4[NLIMBS_X4]             = { 0x1FFFFFFC, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF,
+                                                    0x02AFFFFF, 0x04423CF4, 0x13085BDA, 0x1BF3ED78, 0x06FDB21E, 0x0F49A037, 0x1C6BDDA7, 0x0F0F3022,
+                                                    0x1BD50604, 0x0000080C, 0x00000000 };
+// Conversion constant Montgomery_R2_x4 = (2^551)^2/2^512 mod p503, in radix 2^29
+const uint64_t Montgomery_R2_x4[NLIMBS_X4]      = { 0x00B3765A, 0x0430684C, 0x1F99AF57, 0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                                                    0x1B880000, 0x036CC1F1, 0x05B70379, 0x02B8BF7C, 0x0FB6E6B3, 0x12BAEB4F, 0x1E4AE974, 0x0798BD01,
+                                                    0x116B896F, 0x00000031, 0x00000000 };
+// Conversion constant Montgomery_R_x4 = 2^512 mod p503, in radix 2^29
+const uint64_t Montgomery_R_x4[NLIMBS_X4]       = { 0x000003F9, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                                                    0x14B40000, 0x1536F695, 0x18F2C69B, 0x0CFD66FA, 0x1689D8D6, 0x1920A128, 0x15DF1C6A, 0x0B2A7159,
+                                                    0x1BAEC60F, 0x00000137, 0x00000000 };
+#endif
+
 
 // Fixed parameters for isogeny tree computation
+#if defined(TUNED_STRATEGIES)
+const unsigned int strat_Alice[MAX_Alice-1] = STRAT_ALICE_TUNED;
+
+const unsigned int strat_Bob[MAX_Bob-1] = STRAT_BOB_TUNED;
+#else
 const unsigned int strat_Alice[MAX_Alice-1] = { 
 61, 32, 16, 8, 4, 2, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 8, 4, 2, 1, 1, 2, 1, 1, 
 4, 2, 1, 1, 2, 1, 1, 16, 8, 4, 2, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 8, 4, 2, 1, 
@@ -87,6 +116,7 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 1, 4, 2, 1, 1, 2, 1, 1, 33, 17, 9, 5, 3, 2, 1, 1, 1, 1, 2, 1, 1, 1, 4, 2, 1, 1, 1, 
 2, 1, 1, 8, 4, 2, 1, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 16, 8, 4, 2, 1, 1, 1, 2, 
 1, 1, 4, 2, 1, 1, 2, 1, 1, 8, 4, 2, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1 };
+#endif
            
 // Setting up macro defines and including GF(p), GF(p^2), curve, isogeny and kex functions
 #define fpcopy                        fpcopy503
@@ -101,6 +131,7 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 #define fpinv_mont                    fpinv503_mont
 #define fpinv_chain_mont              fpinv503_chain_mont
 #define fpinv_mont_bingcd             fpinv503_mont_bingcd
+#define fpinv_mont_safegcd            fpinv503_mont_safegcd
 #define fp2copy                       fp2copy503
 #define fp2zero                       fp2zero503
 #define fp2add                        fp2add503
@@ -119,17 +150,39 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 #define mp_add_asm                    mp_add503_asm
 #define mp_subaddx2_asm               mp_subadd503x2_asm
 #define mp_dblsubx2_asm               mp_dblsub503x2_asm
+#define fp2sqr_asm                    fp2sqr503_asm
+#define fp2mul_cxx                    fp2mul503_cxx
+#define fp2sqr_cxx                    fp2sqr503_cxx
 #define crypto_kem_keypair            crypto_kem_keypair_SIKEp503
 #define crypto_kem_enc                crypto_kem_enc_SIKEp503
 #define crypto_kem_dec                crypto_kem_dec_SIKEp503
+#define crypto_kem_dec_x4             crypto_kem_dec_x4_SIKEp503
+#define crypto_kem_pk_expand          crypto_kem_pk_expand_SIKEp503
+#define crypto_kem_enc_ctx            crypto_kem_enc_ctx_SIKEp503
+#define sike_pk_ctx                   sike_pk_ctx_SIKEp503
+#define crypto_kem_enc_batch          crypto_kem_enc_batch_SIKEp503
+#define crypto_kem_dec_batch          crypto_kem_dec_batch_SIKEp503
 #define random_mod_order_A            random_mod_order_A_SIDHp503
 #define random_mod_order_B            random_mod_order_B_SIDHp503
 #define EphemeralKeyGeneration_A      EphemeralKeyGeneration_A_SIDHp503
 #define EphemeralKeyGeneration_B      EphemeralKeyGeneration_B_SIDHp503
 #define EphemeralSecretAgreement_A    EphemeralSecretAgreement_A_SIDHp503
 #define EphemeralSecretAgreement_B    EphemeralSecretAgreement_B_SIDHp503
+#define EphemeralKeyGeneration_A_x4   EphemeralKeyGeneration_A_x4_SIDHp503
+#define EphemeralSecretAgreement_B_x4 EphemeralSecretAgreement_B_x4_SIDHp503
+#define EphemeralKeyPoolStart_A       EphemeralKeyPoolStart_A_SIDHp503
+#define EphemeralKeyPoolStart_B       EphemeralKeyPoolStart_B_SIDHp503
+#define EphemeralKeyPoolStop          EphemeralKeyPoolStop_SIDHp503
+#define EphemeralKeyPair_A            EphemeralKeyPair_A_SIDHp503
+#define EphemeralKeyPair_B            EphemeralKeyPair_B_SIDHp503
 
 #include "../fpx.c"
+#include "P503_fixed_base_tables.c"
 #include "../ec_isogeny.c"
-#include "../sidh.c"    
+#include "../sidh.c"
+#ifdef AVX2_X4_IMPLEMENTATION
+    #include "../fpx_x4.c"
+    #include "../ec_isogeny_x4.c"
+    #include "../sidh_x4.c"
+#endif
 #include "../sike.c"
\ No newline at end of file
@@ -0,0 +1,1521 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: precomputed tables for the fixed-base ephemeral key generation on the starting curve E0: y^2 = x^3 + 6x^2 + x
+*********************************************************************************************/ 
+
+
+// The tables contain the affine x-coordinates of the multiples [2^i]Q of Alice's and Bob's public generators Q, i.e., the points
+// that LADDER3PT computes by repeated doubling. They are used by LADDER3PT_fixed_base() in place of the doublings.
+
+// x-coordinates {x([2^i]QA), i = 0,...,eA-1} in GF(p^2), in affine Montgomery representation
+const uint64_t A_fixed_base[OALICE_BITS*2*NWORDS64_FIELD] = { 
+0x4D83695107D03BAD, 0x221F3299005E2FCF, 0x78E6AE22F30DECF2, 0x6D982DB5111253E4, 
+0x504C80A8AB4526A8, 0xEFD0C3AA210BB024, 0xCB77483501DC6FCF, 0x001052544A96BDF3, 
+0x0D74FE3402BCAE47, 0xDF5B8CDA832D8AED, 0xB86BCF06E4BD837E, 0x892A2933A0FA1F63, 
+0x9F88FC67B6CCB461, 0x822926EA9DDA3AC8, 0xEAC8DDE5855425ED, 0x000618FE6DA37A80, 
+0x9B8595DD36BDF477, 0xEFEB09BDFF2FDE16, 0xCB4AA2C634807B32, 0xE43853FD5C6A1C81, 
+0x5958CE32DB46F8B0, 0xC54B204D06BC2F29, 0x5F498285FFB3AA56, 0x000A06363548AFF5, 
+0xE2A1EFE8B232470C, 0x0AAE5C20BDA69468, 0xCAB8229A6CF8D8C0, 0x21A663E0CF76AE8E, 
+0xB9D46AFE77161628, 0xCD29977684DE5913, 0x4B49C469A2EC846D, 0x00192218D62E8423, 
+0x55D443522C3B7346, 0xCF4C7717D12D5C63, 0x0C6725EBD76BC280, 0x760CA6DE46E95B0B, 
+0x0C025032C9EF8E39, 0x2CBE4F831BFF2591, 0xC3A28A23B5AA845A, 0x003B0DE1D644800D, 
+0x2151BF8B714EFFD8, 0x7C8FFCC9865FC797, 0x8F6C4A12B5BF2ED2, 0x40FE78E1C3ED635B, 
+0x98D8D7CEBC414C3A, 0x10376C89D46BF93F, 0x4A16986236C1B227, 0x0010EE263BAEE5F8, 
+0x4EEB96C66CD61FC2, 0x0E350CF84AEE102E, 0xD99FEDA2FFF9F49F, 0x76FB7A1D01F87DED, 
+0xA13657FB417FF0C1, 0x4D31DA6315AE4558, 0x1195033A178EF134, 0x001ADE4C9693CADB, 
+0x9DD808917FF03A87, 0x27651D4A44A2D832, 0x96033FDE3A1CE811, 0xA2261431D39FC430, 
+0x728E825EFEBC7951, 0xD87CBE361BDA48E6, 0x706D17940CC00F67, 0x002F9173E732AA40, 
+0x0170738CE22075B2, 0xAD82EFBB53E228D7, 0x47874B883C8DEE21, 0x4CA208DFB551DA18, 
+0x2663A208D0B92DEE, 0x6A40394B967245A6, 0xCEA8FBBCF288C7E5, 0x0033D37578F0AF3A, 
+0x1CA02917078A170B, 0xB7481A0945820586, 0xCDBFD21F42DC166C, 0xA412446FD1B386AC, 
+0x9488E59812B9AC6B, 0x976D084FAF1ED3F2, 0x7E021E59C39AE768, 0x000DD62A81B9962D, 
+0x2C92D0C38EAC60AA, 0xF52D831D5FDB8478, 0x0929C6BF54FCCA08, 0x9459A34598A208EB, 
+0x38BF3594B2EE0749, 0x859B7AAEB68BA567, 0x9FA685B286F2F3BA, 0x0003A890ACA5BB85, 
+0xF9D7F4501ED00E9D, 0xC563ABE2FD19A592, 0xE3046C0F0AA86FD3, 0xA04DB872C38C5B4A, 
+0xCB894DF135D27B36, 0x4063AF1C9619B51F, 0xB6546EDE65B3C7AE, 0x0039734C5ABB74D6, 
+0x547998B2CD3A7F1C, 0x02C1BC626D738EA7, 0x9CCC8391B71ED4EC, 0x553D67E7955CC5A1, 
+0xAA678D84566FC2D5, 0x093032687BAEB599, 0x64FF143C97D62DB9, 0x002FC4E087C075C6, 
+0x0E0071435E9D4E64, 0xBEE7CE460A8D1472, 0x00F98589FCF3326B, 0x45125890BC851A43, 
+0x413513D42F2EA9B1, 0x81637E1AC40BE413, 0xA369C4AB14D6E508, 0x001EF9D84B1FA21F, 
+0x82DD5D1501A4F7B2, 0x71C577F81B56A1FE, 0x98A1C70C1A536033, 0xC9A14CA98A9E563F, 
+0x06F385BB018C5C87, 0x405A2188CE52BF1D, 0x37939AA5F66771A7, 0x0017B40B080FB4FC, 
+0xA59069E095F6F9AB, 0xD2CE017BDECDCA4F, 0x8B0C1626CEEDA53D, 0xCFF10ED887CB0CB3, 
+0xA79A271C87B6F032, 0x103D0B08412CC861, 0x92F301B5ED75B9C5, 0x00238FFEAC4632D2, 
+0x7EDB1F75A44B3372, 0xFCB19C4FF91C54B7, 0x775540AB8223DE94, 0x23F5B80F52CDCF34, 
+0xA79ECEA8121BD965, 0xEE82F07F8246B266, 0x395BBC743DCADBED, 0x0027ED78493D439E, 
+0xE5F20FD1A183B922, 0x0AA0050F1B0B5E3F, 0xAD8BA886F0CE7781, 0x9120B946FCC7E2FD, 
+0xC393B22BF3153756, 0xF773A3E9CED23E94, 0xB8F5004FEE8D9AB9, 0x0023124287C91B50, 
+0x9806EFB9EA2EC314, 0xDCB60B2A7079D153, 0xB03D27398C870212, 0x212DF22220ED82A9, 
+0x90CB0B41EFE0862B, 0xA1EC48790A907C56, 0x795DFA37AED45B2F, 0x0002EC617FA49FB8, 
+0xD9BFCC548435EF0B, 0x613747ADD02D5FF9, 0x9745AC14A7CB2FA8, 0x7CAC7AD2431803ED, 
+0xBCADB16359000A5B, 0x4491981FAFD31C39, 0xF0F632E9748CDECF, 0x000D88E068E5AC18, 
+0x565D947EFE39D59F, 0x513E6F98493424C8, 0x32193A657A95BBCA, 0x30F031FB3D9A5DE0, 
+0x3F6BFC04D4D9D7F0, 0xA020E4FCBD9847A7, 0x10EAF69B593EF015, 0x002AD9F132BD4E31, 
+0x7E21E50B7E9A8205, 0x1B624E3568A33D5C, 0x5280E10F83394916, 0xA8525EF34E84F280, 
+0x18EC2C3A4CC1B6E0, 0xCDD6D9C009502D49, 0xD8D6D83E5B11A2CD, 0x00015F5FA730E150, 
+0xC67BE40AFDCBD322, 0x0D4B544C862E456B, 0xDC19A571DE41B364, 0x49D2282A6AF7BE9C, 
+0x0CC72C7B9F722D9B, 0x835C5D18250F110B, 0xC36A69FFDA19A567, 0x000055DAA8CBF414, 
+0x61E9C99BA358BF7E, 0x638FB18220E83FEF, 0x88D932F81A01DD64, 0x00FF6823D709C4F3, 
+0xDCBDAB22D363C704, 0x7DA63433880D205E, 0xE9131836637E3139, 0x000E29B47A6CEA77, 
+0x760A050582939F14, 0x49464EF0B1455382, 0x04592E37C55A676B, 0x9996390666EB7B7F, 
+0x5BBE1D39F1AAE8D9, 0x99AE0652779EFEC4, 0x0CD736B7F45641A3, 0x0015DC285C0B3ECA, 
+0xB26F5114E40172A7, 0xA26D29C64D38BB14, 0x075B4150B65054CA, 0xAE5E896C4ADD2EE4, 
+0x030B45DFD6C7EF2A, 0xAE60DC1F0153CE6A, 0x862A5F9A9E70EF99, 0x003E3173807768F2, 
+0x4A1E517A069D3AB5, 0x8EC2B933B60C5D23, 0x5467DB7197C4828E, 0x317B5B94A2C6A2EE, 
+0xD1E56841948DD9EA, 0x93B6B8FAFEBF3929, 0xD49CBB3173EE898D, 0x003B94ABF5BB6DD1, 
+0xC3F7B6758B961D2E, 0x96FB915A438FF2C2, 0x469131356AECE8B4, 0x49E205B9A59F7822, 
+0x981DFBC386AB6479, 0x87E44FE2D479580F, 0x00B73C2746226D77, 0x000DB6914EA69918, 
+0x113AC6D407A7C595, 0x1716B38EBA2562F7, 0x8DF1525F656FCDB1, 0xB5F11EFF1735C82D, 
+0xA3EFC8220F122914, 0xE1B728471C05A686, 0x99647E4F62E302C0, 0x0011FCFA736B500F, 
+0x23F372BCB4BCC144, 0xC0CEAC7EF00F79C9, 0x387B2DC1258242F7, 0x6004003D90C788FB, 
+0x006C3E5EB043052E, 0x1AF932303442AF8A, 0xECA2E05752DEDAAB, 0x002BC5FD2364E9CB, 
+0xBEAD4DF90288A1A6, 0xC6B988BA4DECA578, 0xCBD1CE86ED15CEF7, 0xFAA0C1E90BF2FDF0, 
+0x97815F279AD2EB16, 0x5F8352F8C1A6AE2D, 0xD14FA187FA7B6736, 0x002BE9FC67FAA694, 
+0xC42E143D975553A1, 0x23AA6E717CB2CFFD, 0x9AC21B2D9E0C3835, 0xD2753F4D4DD01188, 
+0xF271D243CD2B3FDB, 0x895AC5C154344713, 0x1F9E116693C11C30, 0x001AB8EF9288197C, 
+0x56B65D18EB16235E, 0x6F756E679B4BB23E, 0x93EDDE9FBCC18C54, 0xDC1CC1B082D215AE, 
+0x1D98573DCF8AF51D, 0x280158A192B3F677, 0x3C8C99120F7F0699, 0x00372997B90A0B0B, 
+0xA0A3FEFA58D699A9, 0xB139BC8A62DE3811, 0xF03027C97FCFCD69, 0x3CF0A3ED37394BC1, 
+0x52D742740D4180EB, 0x23FFF117B8EB9BA4, 0x83A73F7EFB46827C, 0x00232914EB465014, 
+0xBEFFB4816C9D942E, 0x658F25D4AF44DE86, 0x3F352D794BB678B5, 0xF403B35BD3E9DDBA, 
+0x8DB11A80166A8C56, 0x96016246DB879D8E, 0xCB41B5EE25B15EA6, 0x00156C09E3862628, 
+0xFE47D36DC17D9692, 0x0E0DC9E86B9A7843, 0x0DD17C607EFC32EC, 0x6385E5418A1DAFAB, 
+0x86CF65991BB663A6, 0x60BCC711DF03F832, 0x16673B7898C20A28, 0x003C04DADF6F47BB, 
+0xF764F0C756C6A992, 0x7F582E6FB4C846CF, 0x33236B45560B615B, 0x7EDF7DE9E966884D, 
+0x4A23182184A47363, 0x02A2468DAF4A6EE5, 0xC6A25ACFFFCE600F, 0x0034A5EC747D2B36, 
+0xB299F2FFA59790AB, 0xF273669A11B54699, 0x324786A449117535, 0x10F59DB07B5B9B17, 
+0xDC261AF1110BF697, 0x8C648240A617B6D8, 0x38309B68A11133FF, 0x0027C34DC7BD9245, 
+0x4455FAB9584222E9, 0xC522ABB508CFCF9B, 0x9D89DEBB24B3CE73, 0x98FF4F4CA1DC6BD8, 
+0xC20E91DDD00EA2C8, 0x50CAF803B5257EB1, 0x50770CD71B3AC9CB, 0x0029D7E158E60078, 
+0x957EFF6F41EA732A, 0x85C09955E831D142, 0x2954FC22EEF35DAE, 0xC7F8715D6CB2AC0A, 
+0x4790DA620DC6439A, 0xB80053FC6EBB57B2, 0x4D55A210C0BEC40E, 0x002E5B7321D8265D, 
+0x68CC262F14093121, 0xD171C07CA942FC4C, 0x3C5CA7F44C1CF954, 0x850A58A671573100, 
+0xE69CDC31C7C23F64, 0xD9F38B890EC2EC48, 0xAC24A54AF809EB39, 0x003B19AE49CF2D5F, 
+0xA53E145B8BC893E0, 0x7D376736DE00E6BD, 0xCE75B254E4800E51, 0x6F6B33F1334B9B00, 
+0x7A146F2203600CF8, 0x0B8DCC2C52688B8D, 0x0095D3D10A3142A6, 0x00371122C3F1322F, 
+0x1B3CCBDC9C9F0CA1, 0x305C4742ACEDC96A, 0x92499875E5FFEF2A, 0xC0D575237BA9324F, 
+0x57A888BE03BC14A4, 0x092C4FE61338F0FD, 0x8D13DFAAE139FE5A, 0x000766413105D164, 
+0xB4A697C96E09CED0, 0x2AF2942AD73A5153, 0x85A914F3F1E328C5, 0xAC91A99AED658505, 
+0x666FDAAE8B725F5E, 0x47BEA74302D10669, 0x9856BAC9DD196461, 0x0020E8C6B9BCB2F9, 
+0x273C1D59C9965D95, 0x3B3715B0FD8D554F, 0x3360470950EF4D63, 0x4B0508C8EE934A9A, 
+0xD0C1F29ACE162241, 0x79F50A57073E269E, 0xB75C53F84BC5484F, 0x001C491B7C647E62, 
+0xB94BF6C5FBD68D30, 0xE64AC65360A4299F, 0x968E9DA3ABDD12A0, 0xA330BA46199DF13A, 
+0xD9CC8D4888BECA38, 0x9CDD0E19098AC577, 0xAC02EEB10725F7B9, 0x001320F3EC6B2F52, 
+0x12BEB89E1D9B7864, 0x6245B0288CB89B0B, 0xE4DAAF3AE3A90FE6, 0xEED8FCA8E2A35684, 
+0x395DF97499A9E6E9, 0xE2B1815BA5BA8BBF, 0x302F5AB74C1E53A1, 0x0017B5A7C0B09C3D, 
+0x3F1679AD0EA8D141, 0xA89AC4B33D99707B, 0xDAE4C819CCBD99EE, 0x096BAF7F3207CB0F, 
+0x024254C3B6D89C91, 0x50D72AE41FA50796, 0x6B403C20C4661678, 0x00303DA08559A563, 
+0x97FB03983B38F9BE, 0xD2CF1E12053F937F, 0xCA8DC2021FC21751, 0x7BCAB9C3F05C8793, 
+0xB4EF3CB892F29F8F, 0x34B8D0058FBEA0B1, 0xAB327AAF12D73F53, 0x002E03C316C21B42, 
+0x5A5A691D1A160D52, 0x48464E0D21315326, 0xDA8E133629133A1A, 0x533E592841188AD9, 
+0xE63A94748AF8736F, 0x8C88A2F2322A6FB3, 0x5609A6BC0C0B459A, 0x00249E85D8F51DAC, 
+0xE3DF99B33321C4BE, 0x550662ED07C3C5FB, 0xA2C46B57F378AD9A, 0xA78624D24239A827, 
+0x6FCAB01F32F2B4EC, 0x2472D71BF925947D, 0x81C4EC56E80A37AF, 0x000444E8FA5C88B6, 
+0x979F1193C7755E49, 0x36758D59665EFDE6, 0xDF5409AAAFEF2CF8, 0xF302DF3CC9CA5570, 
+0xC09C3DCB8B7C653A, 0xE7754D604035CDB9, 0x2EC90B1AE00D1907, 0x000548D0187880B4, 
+0xB90BC97D812FAB52, 0x640A023507925FDE, 0xB9B547C9D92EB444, 0x598EDDC03245006E, 
+0xD64EBB73B208D0B4, 0x254FE0A5E52FA22A, 0x12CA39B43A01A91C, 0x0031588316B04EB6, 
+0x42A012E6E6499288, 0xDFA20A612C46E3DD, 0xB73210B37DD7B56D, 0x498B85FEF0B95814, 
+0x47D486DE11069C34, 0x9D7C600B75AA7769, 0xF357AD6AA22F1073, 0x002E9114496BC38B, 
+0x9C6AF124A99EE043, 0x8BAEC66EBD934355, 0x7E0664DD788C7ABA, 0xE098D088E12D79B0, 
+0xA5AB153FC2DD6AD4, 0x7D34EDE705B21BAE, 0x4CB5DE8029E185C3, 0x001425A415960E1D, 
+0x3141100D1779E10E, 0x1A67CE4E4F3E9406, 0x4CA84C70657AE599, 0x528BBD9D63E9568D, 
+0x780FB1F4D0081570, 0xBB6AB606BEEB6412, 0xEAFE6BDA85081F49, 0x0013161BC801F391, 
+0x1DDC960A2D50C51B, 0x5864DE056752FE7D, 0x37040E2EB7973892, 0x1EE41F78374469F6, 
+0x52621BDE895287D7, 0x8EF52973B3AC4C75, 0x54FEED8DC5971018, 0x003E5F9B977099C0, 
+0x6A679AA7AB1436AC, 0x16C950E834068949, 0x892D860C894AAF4D, 0x06D37B7EC8BC165F, 
+0x722056734F89606F, 0x716592BC669FC2F9, 0xFB844B8A4F582729, 0x003504D2D21061A1, 
+0xA36C4460AB8D1D95, 0x1A480B59C97FE74D, 0xEFCF706715896D87, 0xEA0A0A4B965441C3, 
+0x52CA2C12BF4FC138, 0x6020CDB07221E280, 0x0E60917E43C72C97, 0x00319B991AD97B1F, 
+0xDDA435B26A2D6DE3, 0xFA7F2AE6E337BDDC, 0x57D892DDDD498BC1, 0x15390E3D69F53FF9, 
+0x023DB2627C3F617C, 0x3AF6EAFDC5118FF2, 0x45B07DFD23420B7E, 0x002E539E6F8199DC, 
+0x2DE618925A84604A, 0x2BB31A3051DA70B3, 0xF64B4E08D9703573, 0x74742DF0646971A1, 
+0x38C762739985FE69, 0xB1372C27A98AE0B7, 0x0C5BD4D67D5AF20C, 0x001F3F70C57725D7, 
+0xD6FD42C300C5FF23, 0x723FCFD5EC6FDC40, 0x917AF3401845B71D, 0xB039F8F3200300E4, 
+0xB2F80847BD63CCFB, 0xC735272683937100, 0xE776EF4F0C917B0A, 0x002DD31F25087994, 
+0x0C26B49CE1372282, 0x9CCB8D1D5D4D5D10, 0xD0EB8590E71E5EDA, 0x99A42305777003E7, 
+0xA140E54CCB2E1ED5, 0xD0D424E5E05212B6, 0x467F27E36103FEA4, 0x003FDFCD489F19DF, 
+0x3689856E1D13AF94, 0x25548CE065FE13F5, 0xA7497A2E75BA6ADB, 0xDFA5965B140A5409, 
+0xE4376AFE6960C541, 0xDA09B7227CFA1880, 0x9C3758B6D9225762, 0x001693A0CD9528EA, 
+0xDD8EEDFDF37888D7, 0x82D54D3CC93B5B94, 0xEA5685D53DD0C011, 0x8F3A0685620BA0F9, 
+0x6D937BA3D0786D65, 0xD4774E4FAE61FD94, 0xB13A2996676BECE2, 0x002CE657873A0A37, 
+0x6FF37FC921BB7476, 0xA60483F4CB6DB7C4, 0xDADADA708CD9F2EC, 0xF2B172310CECF47B, 
+0xA12E0AABFD399F98, 0x081429F30FF6A454, 0x0A14BA78022DAA31, 0x002175E0783A2E8F, 
+0x87512E82230C5060, 0x48262551EA5ECB34, 0x9DC0EA2EE92519BD, 0xE22F1A7237746DDD, 
+0x49FB4003C5FD8453, 0x646E8A01C9456493, 0x96380FFE49AC7C44, 0x002363F0C5B93A71, 
+0x0456D8F43AFE42FD, 0x49BEE1343D9278BD, 0x6A86F6D90D7B1178, 0x7799260D8CB368E6, 
+0x545AE9E8F3A19B25, 0x0FB956983C1CF909, 0x4CA4D73D05FF0C34, 0x00197977C138623B, 
+0x1C4AFEECC4AE14EC, 0xA9CF8E32B0762670, 0x91C5897DA90E9947, 0x34A5F1AF0AB228C6, 
+0x8CE0E95A5A129E9A, 0x9F5E57606536CD4E, 0xA2447C3D343F3C28, 0x0004798AB3A484E8, 
+0xF2E2F16D67A50816, 0xB7CC67F84FE3B476, 0x4A890662391C346D, 0x4C8F5FD6373C4DB8, 
+0x7EC9A9007E9B2DC9, 0xF7F9AC6D630DCC88, 0x15D9BD88210E5F3E, 0x0009115059FBF3F2, 
+0x60E6204147A2C381, 0xD1C98FFEC40CCEB7, 0x4D9FC03CA6068E26, 0x82040FF076F414BC, 
+0xAC7788D9223B6AEF, 0x62A2D85135A11B81, 0x5DF94C9A1ADE014F, 0x000C0E2A912DCC70, 
+0xF2F3A63CB81AD43C, 0xED8C92C2CF229C6E, 0xC34476C0277BA48C, 0x8FFD0A2061ED7F95, 
+0x7C8103C11820CFBC, 0x07586D6F6E11DB73, 0x7D6937163F2FA7AA, 0x002D8E587AD21256, 
+0x08EFE1E0C9D4FC35, 0x68F74C9C71FB8A65, 0xB24F7A6969BDAE56, 0x1939E3198ADD1A94, 
+0xD62B110B9B33606A, 0x671C6F0B07CC1257, 0x024CB38298167962, 0x00315BD45B96E640, 
+0xFEC9446BECBBBCEA, 0x7D9DC77E16826EFB, 0x93F80CE5E1D369CD, 0xCD95217372CC51E5, 
+0x815088530788860A, 0xF1DAF6A4225F7783, 0x435A81E512D6F6B0, 0x0022860C84E056C8, 
+0x5977AD69ABD7A146, 0x266027DA9EDE8E37, 0x6C5E2559B8A15B58, 0x8BB8056082C20B70, 
+0x249885004FEE9FCA, 0x28A4697CACFEFC85, 0xF8642486068C1E95, 0x00187B1F231F1BA5, 
+0x579BCF07CE44D64B, 0x0809CFE7AFB749DE, 0xF4E6316F416CCD5E, 0x0A9BE7B026FFC85A, 
+0xB84A139BFF077274, 0x69623EA1137437DC, 0xB25134B152D0DB2E, 0x000D144E169D1436, 
+0x9B5EA07AC0C62B5E, 0xB914313CA87861F9, 0xE1345D9D0DF82A5C, 0x109BA1FC1118750A, 
+0x6CAF41E8AAE30AA1, 0x727AD9BB13D8EF4C, 0x89DBA207B5959D81, 0x003C400470850CC8, 
+0x59D07B62CBD525AA, 0x1A805B65E5F48136, 0xFA5D3EA5EA5E715F, 0x7B9F64F0A48447B2, 
+0x9CDF720BDF860314, 0x63DB98DF6F5EA225, 0xD7467EBE81505AB6, 0x00143145648FCEB1, 
+0xC3CB5854933B42E9, 0x6B9D443D61CFDDBA, 0xD19EAADAEB9EDCBC, 0x6EDA28E835AB36D0, 
+0x2D6EBC952F11E812, 0x7D9C3EA0021C1F71, 0xC339827410E5FEF2, 0x0002179FBDE0C7E8, 
+0x52E2D63D85EF2F26, 0x0997426A2194027B, 0xF9682E89B5D6F6AF, 0xE909AB53830AEE2C, 
+0x199A210D76E070A8, 0x554BD617E2283A94, 0x99AC599C6C93E190, 0x0030193372FF757F, 
+0xC70A09E95BC7E6BC, 0xDDE7855A32A759D3, 0x69FE283540BBB358, 0x65F0FF52ACFF38EE, 
+0x2789B2904B768DB6, 0x5D0D0EE31FDF2C23, 0x22E70D7D852B9F67, 0x000374C9C65D6874, 
+0x5A7602B74AEE3851, 0xB53295510C8B4118, 0x813C68B000690E89, 0xC9EE4987D615CBCF, 
+0xECBC2C4C6DB026C9, 0xDA98930180585F5E, 0xCF886C8D4F583D07, 0x00238DFAFCFE8DB6, 
+0xE320D9BB727B953F, 0xE42FE7D5CE81099D, 0xBB5EFFC9D2BB9DCD, 0x86843D7D1AAF1A13, 
+0xCB4F937237B1092D, 0x34A2AC00FAF8EDAB, 0xF00C0AE04BFAB04D, 0x003742AD49532491, 
+0x1CB92AD7F1D99027, 0x5589168152A790A0, 0xDA5096C3234C8C65, 0xF2AB346F099EA112, 
+0xF078648CB70C53BA, 0x715D73B1D2383EFA, 0x6B63FCEB75D91794, 0x002DEB7DB366F62E, 
+0x17F70EE0CE4B45D1, 0x3F01DBB4D6C23120, 0x5F3E625AA49A5FE2, 0x6702C833B37FF68E, 
+0xBACC382059323CB4, 0xB1E7425CA8B55A1A, 0x27CE77786A199C33, 0x001DF8EAAF326BB6, 
+0x3140DD3C1897665D, 0x0A072559C142D44E, 0xB1B5B12E63920945, 0x11ECE1C4DEDF1DB2, 
+0x220F6887CFB831DB, 0x8543C76AAB4BE331, 0x8DB39BD41F7D4BA4, 0x003677FC204492EC, 
+0xF587AF44B510556B, 0x6F961B6DFB323866, 0x0356030BB0C114DD, 0x22CE218A393790E3, 
+0x3B0C0DC72FCC880F, 0x8E8F4041F73F6654, 0xD0916E805BF453BD, 0x001C1FFC5BD3D0C6, 
+0xCE9CE5A04EA6B033, 0x6133C3BE2DF36A0F, 0x8C38E31EAF132E23, 0x9F7C80EFC863B1CC, 
+0x83763D2D3EFEA8E7, 0x2E3C980028403948, 0x020C5D30C9ABA3F1, 0x0018636015336EB7, 
+0x6D314AF1844C9C94, 0xE94B3A14A3397490, 0xF0EC8355698A9727, 0x31F1B8F2E5AD06B1, 
+0x1823A4730AA6B73A, 0x4194838233CD8A52, 0x33232D3C3E5A719A, 0x000C6AAB18362A3A, 
+0xB76C21030E998153, 0x1EABA1592D47EDB6, 0xF07FDDFAACC27EBE, 0x8BC3057522A868E8, 
+0xAB784C9C01374E00, 0x3368030AE1E4E5C8, 0xF2D97D37F6BD2D85, 0x0039FBFD00C2CCEA, 
+0xF55794C6C083B72D, 0x82DAE8A1914E99F7, 0x63492227A34EA85E, 0x84505C86876F6BB6, 
+0x9B8FC91EDD01F505, 0x3EEDBAE6104DD4F7, 0x299B44B922B6B9B3, 0x002E10129DB1090E, 
+0x3472250683BFF3C3, 0xC2E8991E43B78B39, 0x368325EC47A38D2A, 0x4B784FABF05C5E3F, 
+0xF08C57E250F638FF, 0x607E04F2FC0714D5, 0xB5E61C9CC99B1F29, 0x00152EFF0E5E5A54, 
+0x4F803D3E79196808, 0x38AF2B4175F91A3D, 0x3B67CB7571D82C38, 0x2783A7437E9BEC8F, 
+0xFC6F03F0132E885E, 0xC40C6F795F12E5D1, 0x3013DA70B5B25BD8, 0x0011B728127A22AC, 
+0x76B2712438B01310, 0xBFB91D72A99FA85B, 0x33B37D88F27C3977, 0x48D169C69C55DD7C, 
+0x230AC081D84726E7, 0x00AAB0DD784FF212, 0xEDEC3FD4CA84EA22, 0x001C9F6589D9FF71, 
+0x8A9E7810469FA716, 0x2168302DE5BC85BF, 0x03652956405DE4C5, 0xB72C0A048C8C212A, 
+0x07C705F4E9A30FEA, 0xA9FBC6B81BCB31F5, 0x628B0770E3AA95A3, 0x001A8C58C4220A30, 
+0x11A8C9BBC6E32A00, 0xECE407E560E3AC97, 0xBFA535509217BF1D, 0x03019BC46F7AE491, 
+0x5AEE4C7F5F62218C, 0x2900B2721EDA4272, 0x707B955BB323E44E, 0x001665DC3B47BFCD, 
+0x5FB66AC191A188FE, 0x7CC22E3E95C2CBDB, 0x408EBE123B404607, 0x55BB42AA75D0C0F8, 
+0xF1F0788ACE4618BC, 0x9C4EEEF8CCC755E7, 0xA448BC6042DAC967, 0x00010E03FE5EF9C5, 
+0x851E3C9BC07D47C2, 0x6C967F5BDB1ADD42, 0xE7AA8777E25032A0, 0xD9E900745C96068B, 
+0xF2855048E36315DD, 0xDAAD1526C035E1D8, 0x2CDAE88739563C0E, 0x00371861DD060068, 
+0x2E49157759713773, 0x03F51398947FDFED, 0x1654210C9C07D3CA, 0xA4CB47055AF3580C, 
+0xAF0331F2C23FF7A4, 0x7434308E3126C6A7, 0x2C243450C20CC4F8, 0x0013962B78F4399F, 
+0xBF50801DFE2483A2, 0xA3CE8986BB59FBB0, 0x212DCC8D53C40A18, 0xD06AF71718C36A50, 
+0x4A93915EB866A8AE, 0xCF92C844D0673BE1, 0x0F49A2B3D19389CF, 0x00321A16957C0460, 
+0x44FF2594931CFD91, 0xB0FD72C1693F2DA7, 0xFD529264FD01E641, 0x4F477601F6F47F45, 
+0x094F76DA308E6F36, 0x13B8C035AE0595FE, 0x7610C8E6C3CE8436, 0x003A09DC1AD597D3, 
+0x15756B29510CC032, 0x608B854523179240, 0xF804BFE3FA945043, 0xED1BE2DC1049553D, 
+0x3E22A265E8C7B0AE, 0x974F49FE099ED687, 0x4B61073AB290F328, 0x001D603F85EF498F, 
+0x4E6B4E049632AF55, 0x458A6A5830A640A8, 0x43A40E06D4A0218C, 0x94441A89123B23DE, 
+0x8E257517D0D1CB7C, 0x4BD97820439BCD78, 0x34EF845BC23E007E, 0x002D3F4FF3106F5F, 
+0x58A72C4C52DAE439, 0xDAD87A3AB541B3AF, 0x277591AE9073E14C, 0xA36796615DB527DF, 
+0x3A74939C6F587BF1, 0xC5B17E15D17B37AB, 0xCB4E205A4F815828, 0x0019B66167C4C8D6, 
+0xDA957D0619DF97F8, 0x7BFC21F21C96D1F7, 0x9BE0B7A1DB8DFFE0, 0x337D108AE61FBEB7, 
+0x0A50F8ABD9B803DD, 0x24C9D6A97A2F1FF2, 0x1683550545E8A389, 0x000384EDE11E880E, 
+0x78C79B8EA724529D, 0x801BB98765A7B816, 0x83140D10EACF0768, 0x5AA08A5A078D3974, 
+0x295E4C3E7040E68E, 0xE5FCFA948E899006, 0x097406455C64B9C4, 0x003371569981388C, 
+0x79E278C3691E0CCB, 0x74F8A5293EE400F8, 0x4552566DD8BDB06E, 0xD99D6FB7B748C8D4, 
+0xDF3C7DDDF43BB025, 0x307E552B697763B3, 0x1617BE10AA3F3D23, 0x00348CB2073C1021, 
+0xCEDA7A2C54998D8F, 0xC85C864C87FCE105, 0x84194C7D8AA65298, 0x648B3E8A0246AED9, 
+0x940962A5A2E2452A, 0x7AD4CCE678121512, 0x2DC19E6654744873, 0x00242133B97C0994, 
+0x3FDC93CE1387A608, 0x437E9C996364A1B4, 0x9E054D35928D79F1, 0x48927E233A76FA0F, 
+0x41E75B677C8A4132, 0x15F4536BD86BB440, 0x2C4ECA3AFCFF37DF, 0x003E4500EC32977C, 
+0xBE778FFE2B05893B, 0xABD2052FB26843F1, 0x50E5E1A014E2824D, 0x30DDCDC2D7C627C1, 
+0xEBAAF390270C86F6, 0xB96F44C4F492EE7B, 0xBA38DFC0844DA2A7, 0x00199F8AC5F93B1F, 
+0x4BC7D59473F303CC, 0xEF061A572EFC5072, 0x0B49F6C12CBA2B01, 0x223EEB384F999C94, 
+0xE8F49428541D9BB7, 0x7115A52790639F10, 0x625162EDEB296E4D, 0x001845C4258BFBD0, 
+0xD25A3826D43A1C24, 0xCF8DCEDDEF5CEEBC, 0xA768B1BDE037EA4E, 0x3114F0521512BE41, 
+0x2BD084187760525D, 0x0C08F39D0EE001DB, 0x736CF9474ADFF4C1, 0x00196F93CA9DEC0B, 
+0x317746F4C4D73D64, 0x6E63AEBA32118692, 0xCD6753EC437F8CB2, 0x83BD370A38A6C9F7, 
+0x57C3F3ADC5E94F76, 0xBC080C5CE39E6BFD, 0x2544EAB0D2D44BEC, 0x00184234160752C3, 
+0xE3ED3B2EEB0D1130, 0x8C792BB9DAC878F6, 0xB65BDACB3429FE51, 0xCDC07979FF007658, 
+0x6A36A575BEA96E37, 0xE46AE0777648296D, 0xD7172F6A92048BDF, 0x000B9ECF266F32F2, 
+0xA7E7380DDA5BBE3A, 0x237AAC3FE9B192BD, 0xEE5546B762282D29, 0xF5A81D7B3D2CB253, 
+0x90CA3211C1258C1F, 0x00DF6CDDD8CDDBC2, 0x1CF85D56D0F41E61, 0x003659EED7FDE482, 
+0x54837058BF378FDB, 0x98616B1D533648FF, 0x7C89F817860B90AB, 0xB01E75353BFDA42A, 
+0x59468FFE42ACDA2A, 0x0BDFD7DB049E7947, 0x9EAF5AEBBBDA5C1F, 0x0018C4968F673211, 
+0xD2CE1D4DE2D1BC5D, 0xC7F66993A8E39E02, 0xF4E5540E9224649F, 0xD232D27E963F1269, 
+0x5A5054953D6F7D28, 0x01E18C78C8298467, 0xB0F79B15D81BF98A, 0x000EE663D23BB373, 
+0x49F8EF507B131375, 0x731ECA27FFCC1D98, 0xA14EBD5F2C43D386, 0x484DE8D52EF951B5, 
+0x1DDC7198C4B3DBFF, 0xA6BD7AB641637599, 0xCE26EC814D148004, 0x0007357C76958BEF, 
+0x9D84DAA311DD0A7A, 0x968E5263BC783FC3, 0xF28E0C84C32A7210, 0x2070E4B7D006E3BA, 
+0xF6CD49B8D046B2C5, 0x058E6EA8D65C3772, 0xACE470A89E6F0949, 0x0002AD17F9D68421, 
+0xB4A5C1BDCBFE7264, 0x43463551A17E04AA, 0x8913FA14BCA9B6E7, 0x4860D6A7B6C420B6, 
+0x0971764E442B19EB, 0x2EF29437CCA07C73, 0x05E4CFD40BCB537D, 0x00033D8323285397, 
+0x47504A7A5F44293D, 0x3C02A80BE136F858, 0x185E1DF731FCFB93, 0x2142C0C1B8A63B1E, 
+0x7ACF5CB09AC09853, 0x7B4C645608031CD7, 0x1CC2E1C0A5D47CE7, 0x002E3EDED7A60DC8, 
+0xDCF639CF8D581676, 0x23BE0E5F2D768AA9, 0xD0B40FF3D216C55D, 0x4F300EBA259D88A6, 
+0x68FD6CB8B1868049, 0x9C613DDD18D46340, 0x6BDD04D7818CC77A, 0x002537E244419B0C, 
+0x7DC35E805C906147, 0x3E24A0BE47919BCF, 0x16952DA524977A47, 0xC5742B8B8F1A5B5C, 
+0x9FAAB1614476CDE1, 0x7609711ACB04CD40, 0x858C2E7FD37F29B4, 0x0017171BC02EF843, 
+0x9876C987999BEB9A, 0xF910478D39CB1F2B, 0xAEADC3067EC90B4E, 0xEB4A9DC3491AB5DE, 
+0x04562A965FB43C4B, 0x8407096E73ABF58D, 0xD01C23C6D56ED06F, 0x0001119B2BB63353, 
+0xF1EF3592403F0492, 0x901D1C33280038C9, 0xA2CF8DB6C86E3832, 0xDD749905336DC406, 
+0x38C9B9B8617A9FA7, 0xF3913DA7DDA05293, 0x68D6A63B4DE58845, 0x000E644E96E267E0, 
+0xC0E75733BC2F6688, 0x71BF46E027B5BAD8, 0xEC3CDE218449ACB6, 0x592D5E853DB09935, 
+0xD145A21CA7BA7FE6, 0x250297E722BF4922, 0xA6B1F97A4B1FD2EA, 0x003183C50AF04DD3, 
+0xBE41DA8C5122E3C8, 0x6FA01C8B9EFE0347, 0x31CF58DE3E36CF58, 0x19BDCF4879B6F20F, 
+0x7C7FD36C551419E4, 0x1A1C3D61185F4A87, 0x489838B0B036D24E, 0x0037D5ABC9BC47CC, 
+0xE0A3E97C16CBF915, 0x48CB6090CC62CB70, 0x5631B02EB3786A0A, 0xC82FAD89FD578F40, 
+0xF6F8734D77EE8E4A, 0x7D001E9D26F36686, 0x60DDC37C96FF0BBA, 0x00318D681667D83A, 
+0x7F5BB2CE00C88CFF, 0xC7CE5D066DE0AB33, 0x7115484400044516, 0x1B2B2A96912B3908, 
+0x2400F0687FC9FE88, 0xA956FA846B837733, 0x644ADCC74EFAEA7F, 0x0021F04ACB69435B, 
+0x2F91CC84176C6D34, 0x98E478F13E9BE31B, 0x118A2F286DF6ADEC, 0x572C2ED37173AB52, 
+0x001F876796CDA376, 0x1361A391CB16DC7C, 0xB3ADB3735315E26E, 0x001F83428A02B27E, 
+0x33F3549D94EBDD4A, 0x3E6FB95C1797E35E, 0x90175F799DBE804E, 0x1322DE7392C53D41, 
+0x79A794CD70BB9464, 0xDE7CAA90D874A614, 0xCF1BE06E3D5817C8, 0x001C0A665DF22654, 
+0xACBA394B858963E3, 0x340123D71A083CB6, 0x6740B21FF1152F36, 0x680FB7BCA63C48C8, 
+0xA04C7EECC7D57E97, 0x55CC6F556BDC9136, 0xAEA5666524A5CDCC, 0x00111FD515514531, 
+0x310B5BD79741FB31, 0xDFC5A0C612B52C45, 0x321A2571D27F9D24, 0x4F961340726F517E, 
+0x3299593C1D4065AB, 0x4800A2F2C27285ED, 0x27885BFFD96FB60A, 0x00239CE1F181FA6A, 
+0x22EC39C5D01A5CBB, 0xB17C0B0746BCCE53, 0x6C4DACCB34160116, 0x8E829D115BAB70F7, 
+0x6D39E0BD7C807BBF, 0x8D49F6928427F5A0, 0xCF42FACEC0735B65, 0x0039674EA6FB3610, 
+0x87444A48E020E029, 0x3A5A28F6F8B69ABB, 0x30BFFB51AFFA5F6C, 0x14C6126FF626869C, 
+0xD864C8BBE5584611, 0x659C9934561D20B0, 0x595012A78A5E9FAA, 0x00070DC587D56BDF, 
+0xA29957DF48E64CFD, 0x1659A4DC6250CD94, 0x943FB08CDABCF571, 0x63F594259B391AFC, 
+0xC54783C990993A1A, 0x029238EEA8CE3D92, 0xC0DE87B2D0106677, 0x00045A9DC28D44BA, 
+0x29F7F177C6EC99A3, 0xA178C39525B8F121, 0x7FFB6B9659A05772, 0x544D51E41246C479, 
+0x88AD1E7AB3C13D07, 0xBF6D94D0537C8ABA, 0xA538044ACD22B35E, 0x00065DA295D43019, 
+0x0C96560A405DD4CD, 0x4118E73CF91E879B, 0xFD77382DE51C710E, 0xDDA1E47C262313EB, 
+0x82285D6198918136, 0x9DFBA0301638E359, 0x24E6D032003E1D8D, 0x002A9A8865CDE3E1, 
+0xE058EEB97562C21A, 0x2C6BAA0DAB008F88, 0xF71AED547E16FC68, 0xFC4B9F4FFBD90351, 
+0xA959EBF68E038E5E, 0xE56EB2B0FB5E2DC3, 0xC4D2C5FEE6136251, 0x0023434ABD425DD0, 
+0x1AE2AD817FA54299, 0x32D27ACF9D4498D8, 0x8089D16C8DD62DC7, 0x5B3619CDA8FA60DE, 
+0xD523322ACC1A2A71, 0x665767F0307D937B, 0xE48B4F5137078DAC, 0x000B39A5BCF98F40, 
+0x8583B0D1F17BAFE5, 0x117D309BEBDB3E31, 0x7E1BA944576FF41A, 0x5E4CF489232038C4, 
+0x41F4118010CC2F92, 0x3EF8B69981B009A4, 0xC3C323714AA5A7C9, 0x003936C0FFF13034, 
+0x77AC98C57C3C87B7, 0xB1C661AD0072EE03, 0xA1D7798AB4A8B59F, 0xC813480A682271EE, 
+0xF27F3D33645F3210, 0x8856C4E1535657B1, 0x00EBA0280A496AC3, 0x002776A4861470CD, 
+0xD620C1DF0E7E546A, 0xF8EAB853114F66F8, 0x705CD38CFAD2D6E4, 0xEFB460554B78342D, 
+0x07577679D9BF04D8, 0x99D7F8D6AF2A42EF, 0xCC9A550C1FB81D97, 0x0028BBB886A306CC, 
+0x6E9E4D41095707E4, 0xC0409E311F5EF3E1, 0xD29BAFB7468CEA92, 0x1451E088E0ECC439, 
+0xF30B4C8C248A93D6, 0xD0B096F838C777A9, 0x291A4FD38629DAEC, 0x00362B43934F76BC, 
+0x9D9292CDB73EEDF6, 0x7263A93C3A2CA7C6, 0x003EC10B09C85896, 0x4EFA32AE41FF5CAD, 
+0x20CF9F04A4D1790D, 0x37DAFF4B31A27560, 0xCB013224D9827D6B, 0x00016512D0E7AEC9, 
+0x0DE231AA1B3990E4, 0xF25E78DE3DE9F092, 0x03ABB23327AA955A, 0xC139F532F7968FFC, 
+0x6958C54D3F756BDB, 0x4C7147593E9AF57B, 0xB499FFAC6809351D, 0x0005C79FC299CB2B, 
+0x29EC20CD48117F69, 0xC467837012DC3C92, 0x9588457BFBA4A058, 0x5717CA9E18ABEED6, 
+0x8F81F062F4FF2758, 0xF71320778D825B92, 0xA3B2D0ED07D35B95, 0x002E57162975FB84, 
+0x7C9BB02FDBA2ECA8, 0x1E287ECADCA42ADA, 0x7ECA9311FE78053B, 0x865376B41637AFD9, 
+0x6A8BB2B951DE692B, 0xFD899B635EC37B74, 0x13FEDF407D188A4F, 0x0012607B24832F71, 
+0x509A3B46615075C6, 0xD0DDE861ACDC12FF, 0x8971800CB58A2CCE, 0x0D9820F1EB67BD11, 
+0x2BB99CF531378477, 0xB4464356033AED0F, 0xCE51BD0BDF365C9A, 0x002DF407E1F295CF, 
+0xCC277DF933FA6557, 0xBAE972C23B4CD7A4, 0xC08ACB9D5AA0B228, 0x7DD144F2162C6B34, 
+0x0E82E4EF6BAE2276, 0x715640FC4510D21D, 0x92DB0EE2A99BE8A8, 0x00077BDEC301DED7, 
+0xC47A3164600248E4, 0x64876C9E6D0BF0EE, 0xEF11928621180B99, 0x52D957CD49CCCA53, 
+0x49885C6A15DD5940, 0xB7EE455FA81D2825, 0x8E8BD535E1DC3AD3, 0x00186E65410817D4, 
+0xC36055DBD6F4EC3D, 0xDB10C4A87694DFFF, 0xC3526945C36D30F8, 0x4A2C73F134E58B72, 
+0x4864D6E0C10FE322, 0x4E58A08319CF5584, 0x507A50CEF2159C87, 0x0000E45ECC87F34E, 
+0x21D0BD24AF7CC36D, 0xD45A14F003E99E02, 0x3E99414C2E735307, 0xAD29FC50BA05428D, 
+0x715C7EAC6CBEF0CB, 0x1D3D343AE04C74B2, 0x8E0F0E102A463D55, 0x0023706213443B00, 
+0xE5C9F6EE09C4089A, 0xD0ADA6164976C074, 0x0A060AE86C04BE53, 0x95A8672B5D358F8F, 
+0x96090081EDE2FE12, 0x1C45CE50B4B58691, 0x16C2C488455BEE21, 0x000ED3F64C26AA46, 
+0xDC6FB21145CBB562, 0x30E2C6BD7654F28E, 0x66B513A43F39EE8C, 0x2D0E33DFF29E7E38, 
+0x8392485A5090748A, 0xD0EC5D6DCDCB8EAF, 0x091453EE6C49E018, 0x003CEA07ED86C9AB, 
+0xB4D1969AF2AE3718, 0x095AC3F88458C472, 0x9A08A59825C2F316, 0x25DD2C9D1DD73344, 
+0x573BAC6DF600CF28, 0x859CE7A3407314AD, 0x5225AAB517B81B0A, 0x00168BE295D14634, 
+0x1D7B3168AF8D174F, 0xBB96E732C9DF2ECD, 0x8F8C7AA2AD7D7ADD, 0x149A57581935573F, 
+0x3B3470A23B92A186, 0x4C09C8BE02A54456, 0x8619921009AA4DB2, 0x0010BE03FE502BE0, 
+0x8176AD2F43B267DA, 0xDF9CE94025EA8F92, 0x0BECCB473756791A, 0x906668E957665330, 
+0x76AED2D876BA05A5, 0x90A1A971FB6CB0E9, 0x2AD2D27F8860FEA8, 0x002D28D7BC5A53C2, 
+0x2490C89FD883AB85, 0x3D0F2429338379A0, 0xFA26F46D4DDCEBAE, 0xCC680A6E06CDCC16, 
+0x44A3244AC8A6A10C, 0x5E02AF8B81B9CC06, 0x5EDB836294563DD7, 0x00363B4789FED102, 
+0x48F7BE42CCC4474B, 0x4D741838609E2AA1, 0x399757E9012B21C8, 0x4EB8A4563EF4740B, 
+0xC0867D368C959E39, 0xC4654EB601041F47, 0x6D15A09204193CFA, 0x000B3D3802D0C456, 
+0xD10AD70427A14B09, 0x95E0804F434EABBB, 0x443AC3ACC57D9ED0, 0x54B23D540AB8E360, 
+0xB91DEE11303B7384, 0x3501D7CFAFD7147B, 0x4F304D84559CE220, 0x001821025F219096, 
+0x4C7A18BFD83C2FB5, 0xE957A72BBAA58D78, 0xD51BE010F85A85C1, 0xB8892ADC1E539AE9, 
+0xA6CA607B402F9C40, 0xCA267D46D5B8B1F4, 0x9693DEE25325CA62, 0x0012260961BEDFCA, 
+0x873287D6F51E1934, 0x76CCEFE4EF4CCD18, 0x338CD38DAA129C84, 0xBCDA1E948989BC20, 
+0x747463FE90591A1C, 0x959648E8417E6F0A, 0x04EEC5FF2A916A2E, 0x0039E62C098A65F6, 
+0x77D81F490ADCC487, 0x2A07AA2DDDFCAE12, 0x9C9C523CF1BB9719, 0x3F4FC96CACC579AA, 
+0x05EF67C59D669873, 0x4ED5CC24C32D5A34, 0x4D7149B1A7D95205, 0x002198A88362AA06, 
+0x718D51CEB81C2974, 0x592097E0CA321857, 0x5884B331034C3B2C, 0xA66689BA66ED5B52, 
+0xBBB91F01B29213C9, 0xC522521A6CA17F8D, 0xB0938110BF13A2BD, 0x002C9B7649F37760, 
+0xC75BB8046CBB878A, 0x49F4B015F01B1A1F, 0x07FFEEFCFD140408, 0xDD3CEA576CCF3390, 
+0xC4C04776DBDC279E, 0x11EE35CE3888B096, 0x8F7DF8B43F10269B, 0x0031D5253FCCEE73, 
+0x003160298A335862, 0x06E4850DDCE4EC55, 0x8AAEFE7FC8A90E65, 0xB63629C9BD1423D0, 
+0x183291A39A0DB4A7, 0x01F9D0B8EA9A705B, 0xC2E1AB3F00D20D94, 0x0005B91B9CB31C51, 
+0x41A5F72324BD418F, 0x1892F8D28B2FB92A, 0x69F250B24BFCC70E, 0x3C4E0102E0E01D66, 
+0x263D70CB668E62DF, 0x0EDA9A9C60B9157B, 0x5A8F86CCA09E395F, 0x0034A9C3E23B5DAE, 
+0x6A6889C0B0C2C0DC, 0x01AC8CA5B7C62204, 0x1E749A4A0C9D50CC, 0x4F53E29967E2641D, 
+0xDB283D53FEBDDE0A, 0xB8F06F37AD87D6DB, 0xFF992A734B6C629D, 0x003FE0677FA8BDD3, 
+0x65E490098E7ECB8E, 0x7D396F6E072EC864, 0x7F01D09715E279F1, 0xD0699A463C75D8D9, 
+0x7481658CAF2ADA1C, 0xD9B28060A8FDCFE7, 0xDE9A444F5DA00EF2, 0x000E949C227BA5C1, 
+0x0D43D2F0F1AAA71C, 0xD4B28D0C221FACAD, 0x485B3DF15FE51710, 0xDBF86CB7D7EE3CC8, 
+0x0C19F0B266AD5461, 0x1ACF7DBFA1B3E148, 0x812A9CA9B9294EC7, 0x0028A5A33E6AADA1, 
+0xDE479FE45448FD9B, 0xC9AACB95CA16A180, 0x349D39F606DB1F71, 0x18D40CE18EA6F3D7, 
+0x3303C465DC738BBB, 0x752E409C9B9230E7, 0x23BCF4A3AB315054, 0x001FD6201FF524DF, 
+0xFBC8B887C809CA0E, 0xCB12294AEB8B8D57, 0x493055CDCD1956D8, 0xFDC67ACDF2E6A984, 
+0x388BC64A71AA8085, 0x1ADF650DE4243C54, 0x7230311B82E16C05, 0x002779E057BD0665, 
+0xFE630153DBC35DAD, 0xF26D82D7A1C1DDF0, 0x45917DDA04A58F54, 0x16EF1911AC491D96, 
+0x5FDED66B9320F00D, 0xC76F7C9FEC034275, 0xAB3FC847165B5373, 0x00081DF730EFB514, 
+0x2B67913D47E93D74, 0xC8DDF8FE9A3E0E9E, 0x63F9AC915359F048, 0x1548DBDA6FF6AF7C, 
+0x5F9EC2E7AEF8327E, 0x8A1C188C2B7B3B89, 0xA23C60D52AD9A39C, 0x000BAFA7EB92E2EA, 
+0x631A6187C01F7EED, 0xA09A014392303CA8, 0x3E79FD8E08372146, 0x9CA561E83CB9ECD0, 
+0xAC9924436668B41B, 0x1FA649D1B25084A2, 0x4AFC320F5154A944, 0x003F3FAF44D826AB, 
+0x29B5F0C4EC11905B, 0x9BBFB3144EEB7ED2, 0x1A9511DB0E22E73C, 0x63A964E019486B6B, 
+0x0DEBA694A1749760, 0x610B34396890E25E, 0xB3E9DFA3710374AC, 0x0019C4168D667CBF, 
+0x80C263D8DD5EAEF4, 0x569249E6D2C75E84, 0x95E40412B9ACCCE4, 0xADA9ADA199AB5D23, 
+0xB935B6F169FA7BB8, 0xE3BC49C237F35B96, 0xD5ECF1C9916D232F, 0x003C9AE82DAF6982, 
+0x7162A30749CAC3D2, 0x37265AA87E590A3A, 0xE61FCEAD8323C42B, 0x50553AAD62C93A77, 
+0x9B399D5E59DBAB9B, 0x693ACCCF8E1CC5C6, 0x09D00B1D060250F7, 0x0017BEA6C6E4C5A2, 
+0x4088EADB6929CBCD, 0xB82458A4408F14DC, 0xE5CB4AE28E271A1F, 0x87FB062CB65985AB, 
+0x945F8C11DE7762C2, 0x40DF5C2378442111, 0x22BEFE14F9BC3343, 0x0010A55F7BDF3BD7, 
+0x93DFFCEFD03371AD, 0xB837AE2ABCC1D5F6, 0x13922467C8F64106, 0x11F8B72AF99ED945, 
+0xCE20E11E974DF934, 0x6E90125BBD73AE2E, 0xF8BBEF65AC09F27E, 0x00088E19179D35BB, 
+0xFE064CE574B91E7C, 0x7BBB901ED18A1995, 0xEEABCE4D114D3226, 0xC2BB676B273FCED8, 
+0xC228A14D361BD391, 0x836A4A9A9C9FBA80, 0xB64E2E8F8E740EC1, 0x000F0E2DAD01D596, 
+0x5EA3908AF057904C, 0x32036F50F9B071EA, 0x8764F830EB94E2CD, 0xB4D8ECEEBC6799CF, 
+0xF3D05E9CAE5DD533, 0x0CB77E755359D2B9, 0xC5A7EC7C01C50FD9, 0x000C611C5B300A68, 
+0xF983B1D3A32FC47A, 0x55E1A7939C5C9EAA, 0x0C08BA9D279A3748, 0x2DCA75480EB0269B, 
+0x289D720D2DDD384D, 0xAF2B19B0E6C81306, 0x592E967383B0826B, 0x0028E0B64B542A1E, 
+0xF80DD98BE9EEC373, 0x59C260C9D97DD7F1, 0x479731772B4292F1, 0x693402DCD570060A, 
+0x9C48E36B72ADF4FA, 0x53CAA3CD0C0B2FB4, 0x74A05125CA285B54, 0x0019987699E91A09, 
+0xFFCE8EB147B9AF92, 0x3183F8FDE904C1C2, 0x655A579CF3A338B1, 0xEC5FA9EB6B2840E2, 
+0x80FA44DCB18105D7, 0x413B6FADBB5C570F, 0x24529C26C610AFDD, 0x0009BE9EDB88FB01, 
+0xB59C2A5809520B04, 0x786F5C13A394B1E3, 0x2A6858D4CDB89632, 0x1E91B415FFC3C1FD, 
+0x156CF0119FA1E1FD, 0x339D701C9D64763F, 0x14E3AD1CDC5ED0C3, 0x0003CBD467CCD1EA, 
+0xD8DF4806D91C7B63, 0xC73A97340A6302C5, 0x03AF2628438CC134, 0xE85E1BE0C0A012A1, 
+0x68E8A5F8A4EE102D, 0x48FB75A0D3FA5A4D, 0x4BBC165E1C4BB03E, 0x001CD6C6BDDF8424, 
+0x08AEC09287CF85AD, 0x911D6BF864226BA3, 0xCCA38082B1075D9D, 0x977F7467A44750FF, 
+0x9DB449804C8E331F, 0x7C656D4AFD155860, 0xF4BD0EEBF852EE15, 0x001C639E00D7DC23, 
+0x82466DB2DE8274F5, 0xB64E935068F4B390, 0x931F490161047600, 0xD81710CDA681721F, 
+0xDE95A67A643CBA3D, 0xC89BAE22079E0ACB, 0xA995A1A9C9B67E9D, 0x002D8AC63268A907, 
+0xA07AD5C8B9B04A41, 0x3371CA58785112D1, 0xD3078D9129CDA0CC, 0x5484DE4E3DCA6938, 
+0x66DD0CBFF6A0794C, 0xAAFA317F55399CFE, 0xEEED30A489DA6EF4, 0x0031EEC652DB193B, 
+0x5E494D83B299A713, 0x48E72C6A4ADF7C80, 0x6690956808A9D117, 0xA1E5669DBE2CC9CA, 
+0x80E68876499D1F0D, 0xC20A9C420A5C31FE, 0xDC42C87D26EE14BD, 0x001E00185D7439B4, 
+0x15CDFAA0D81D545A, 0xB37C3A34E78272CF, 0xEC1770F4C570D4CC, 0x8A366819A2E08F49, 
+0xDBA31D94E4AF068C, 0xA7064A7AC70A1247, 0x5A1BF30F718FDC2E, 0x002A5F9C0074D80D, 
+0x9F2D1AB366AB1956, 0x82866AD77D57CA23, 0x44639A2A0F1594A5, 0x7759C5F1B03CA39A, 
+0x520A5FD6A3E195C7, 0x5484D3203D25A675, 0x8A773A4038515046, 0x00198A0F11B6559B, 
+0x0EEA11D7F1520D1F, 0x0C1EF7B5AC3C916B, 0x169C1523466BD981, 0xA14E947447D3DD98, 
+0x66246CD3B5960B63, 0x837D041392CAD124, 0x87761A7AB98A5E96, 0x0026B362FDDCB598, 
+0xE1F4C5C09CE10448, 0x2CE6B9FA9587BD9A, 0x352051497A5645BA, 0x7649B97265A29559, 
+0xACA5568D587196FF, 0x9F9EEF5D4A214286, 0x4D31938D4D8B46F5, 0x000395F444B10A43, 
+0x821A453C1B288DDE, 0x7526E5D5EAC0B791, 0xD8EFFC4E8395BAAE, 0x019CFC6D7195C417, 
+0x8B1D4915B0DE5450, 0xDDF5ECBCD7EEC647, 0xA25F62B461CC4439, 0x00091ECF32881A1C, 
+0x712FBC3A411DD779, 0x6D170A7746EC9FBB, 0xD20BCC5D709944B3, 0x076F63E3306B6507, 
+0x4885CD0D3DC1413A, 0xA70E1C72A3CE82FC, 0xBBCBE16E0562AD83, 0x0023BB1A7DC3CA36, 
+0x1946EF7592BBBDCE, 0x2A7B6E58D19BAA7F, 0xC122008BA8BAD242, 0xE7F979C1F505A7E1, 
+0x46036445E26BBCA3, 0xE7D032050ABD40F3, 0xFFD1765A02F0A0DB, 0x002898A56CCDD306, 
+0x5F20A8C740009F99, 0xCFD48EA90CBCDC23, 0xCC0B1EA27A187332, 0x5B5E4798503AAA67, 
+0x69C5A56549FF7C9C, 0x3488445060A0F830, 0xCC77D24B25D8AA5B, 0x001D0A772F014C00, 
+0xD0034A7042E42924, 0x4B3F63B8CBE0F2F1, 0xBD9F878F2AE3E59B, 0xB9D0788348E4F556, 
+0x6F4A2628C4B0BB2E, 0x81D13B9E89DCBD3C, 0xBA2AF77CDDDE8D26, 0x0007AE3043A46B4F, 
+0x529C5DDA075F7A35, 0x8F172122E98479E4, 0x6DBCC907C71BB11E, 0xAF8C1E9C0B9BA565, 
+0x4BE666AE97B6911C, 0x26F9E9536ED79F0B, 0xC4F263CEE79A464A, 0x002322E8B05960B8, 
+0x3FB530AAF60B7873, 0x6A0313BC13E551F6, 0xC1ED5CDD554078DD, 0xE00158E3615A6B6F, 
+0x1C8AFA930EB1698E, 0x0FA4D9991B30E576, 0x0351D26C72838BCC, 0x0003595847B66CA8, 
+0x828DD245A0B289E5, 0x4ABF410C8242DC70, 0x8D076BBD1D5D12BB, 0x772B5D31E1EC3901, 
+0x3849EFD258318472, 0xCB8A84A89B3C294A, 0x730A7AC67DE723B8, 0x003AC9E13B8AAB02, 
+0x7B0D8E92880B6F15, 0x3B076A8942AA7EAB, 0x695750074D9258C5, 0xB8EF72CE08DC0F98, 
+0x81AA591A1AC93AE3, 0x6A2BF3FC1EE61AC3, 0xD45D9587A53CE46E, 0x00348FB78D3091DF, 
+0x84316679EC290605, 0x4E4048CB8BC75C58, 0x7E14EB2C7F4F6B2D, 0xE13ADE70796E7577, 
+0x5283A9BFD31013E9, 0xFC480D3BA2E6A889, 0x4163D88943DA4EAA, 0x002054B42AF99C47, 
+0x714AEF7E9977E33D, 0x89B019F4DCD783E2, 0xFD7E08E21B4B800F, 0x2CFFC42906E1220A, 
+0xA08954EBDAB8D290, 0xD7AB9CE4D0685BCC, 0x620D8ABA8F51C300, 0x001CBE5591220A18, 
+0x5A15DBDA5FEF4823, 0xB0A8D7C93C50800D, 0x8F7E829022564DA5, 0x618A797126841287, 
+0x3F41FF3BE3DC21FE, 0x8F23AE9E02D90738, 0x4EEC7D2F2FDD747F, 0x003632D8628AE75C, 
+0xB4FDAAC9B8AD9E03, 0xE725DDBCCFF5DB3E, 0xE2768949222C7D96, 0x939AC3F50C2274B4, 
+0x2C728FE050154D66, 0x38257D16D76F72B5, 0xCCA0FA00A8F94C0B, 0x0018B9DD1EEF663B, 
+0x20279DB00B0275AC, 0x2A2C774F1AE6FA76, 0xAB17A03E11A7BA65, 0x34A7D133A7D450AD, 
+0x066B5B43B4EE189A, 0x500BDFA943B24570, 0x763E9B6794DEC304, 0x0002840587CBB3A1, 
+0x22F13F5D20B42E44, 0x1BC148DA4327F0CE, 0x1503C3B5C39D400E, 0x5C57FADEDB2F32A0, 
+0x1A49476D0BBD8D38, 0x8AFB2F190CA395AE, 0x515DA59C5A7EE208, 0x000EB4EEE8D24F4A, 
+0x169FF7818D008259, 0xC18E1A0B5491762A, 0x272BCC7BEB72437E, 0x9986FFB3D5B0B65E, 
+0xBA4A54DFD79CCD77, 0xD7D15B6B7DDBDCCF, 0xBE363FEBBD64BC7C, 0x0024D60F9EDBD904, 
+0xF8A7247E488ADAA2, 0xD58BE56C27986C61, 0xBB9B701CD35B1169, 0xB2A55115CCCAD057, 
+0xE536B7B518E1B4A0, 0x98E1AD74F2BD7B57, 0x7507F7DB5E34A30E, 0x00017E29F3863E22, 
+0x049708E3F10BECA6, 0xF84FAAA524E57B1E, 0x81A7686896FFF304, 0xCA98179E0CF24236, 
+0xEDD47AAE5C1D146C, 0x4290679C38252956, 0xD8D69BFA472FF83B, 0x0019647AFA681E82, 
+0x6831CAEF6105EB24, 0x4482B3CEB5B846BE, 0xA627ED9BDC921C9E, 0xD06E5F38CC24D3ED, 
+0x6C5FA5174BD0C5DD, 0x8C7BE8380EA94AD2, 0x85D458D8EEA5C3D7, 0x00077CFC5DA3F8B5, 
+0x98167A11AACACC95, 0x93D7400E1410DDBC, 0x42625D251161D84F, 0xEA8729718C16E9E2, 
+0x0EDD51B9BDF5389B, 0xB6FC6537E4CAEE30, 0x9CE7156C8AC0C59A, 0x000E526889BBF9C4, 
+0xDCDFC333205575B1, 0x77EB81B63DAD90FD, 0x93981E71EB2C50D8, 0xEDF70A2F9FD2F19A, 
+0xF1D09C4181FDC32C, 0x5D1F763C9BE48D4A, 0x069B492E69D2A28E, 0x00263A4AB336C30E, 
+0x4035FFC08B38977A, 0x6B3F555C00091BC5, 0x9AA96F18F657D4F3, 0x1957D648D6BAE042, 
+0x305C596B6EF9B713, 0x4190C6087453BD35, 0x598755BA86ACAED8, 0x00024F59695618A7, 
+0x73B2BA906DAB32CE, 0xC63ACD71B7C4E090, 0xE69323DA9EB576E3, 0x88C948BC798E903F, 
+0x0301118D97F0C45E, 0xDD993C335FFA26CA, 0xA7138944FC488833, 0x00189AF6BC9CBE65, 
+0xC369D47D90F1AFE6, 0x13540BFB5A835673, 0xE1D85E752B3AC31A, 0xE739B43E0C3E986C, 
+0xB742DB23E5665F19, 0x2BC8D2DF75957CD2, 0xD3CFBDDCDB0E33D7, 0x0014341CB97BEFC8, 
+0x2C46EE0543DFB4BA, 0x852FCD98EE97C29B, 0xE22D8C34068DA3F0, 0xA024DB6ED5D5F66D, 
+0xEE99D66EF339B5D4, 0x27C71800525ADEB7, 0xA59FDD71D9BBBE6B, 0x00329C0B06378AC4, 
+0x98DDA196113A1441, 0x34C9A4EC720A5A3F, 0x0073785091EE7BD7, 0xA1EB3E7122A6EB0D, 
+0x61F2C6B839227307, 0xB38FBB5E950A2DE0, 0x79B06315A776C682, 0x002C47D4CDA440DE, 
+0x0819E62F9F508EB0, 0xB0FA5F16CCE48C35, 0xB56FA61E0F92C0C8, 0xBB18225A166353E8, 
+0x23229726FA7F9847, 0x80C9DC8FE5546D71, 0x4FF0D5CBB02B2D54, 0x002605B4067BF7F5, 
+0x2C27C18E7C6D305E, 0xE859973EE6EA9EFA, 0x986E19C903407EC5, 0xD8C5C57E96C2FA20, 
+0x8D4C2D4A37E8B7F0, 0x95E85A44E635F66E, 0x02F8AD123AD1EED6, 0x000878F076A1E3D9, 
+0x8FFE92A98E664D60, 0xB118138D20BB4BBC, 0x129E52F1A616990E, 0x16C59C68800F5202, 
+0x2975EE3D1C734D5F, 0x1149C60B50F13CCB, 0xB03C9FA6DB18818C, 0x00305E94C617768E, 
+0x0830A3CEA9AF813C, 0x93F7EABA8CB5DE5E, 0xC543B01606E86313, 0xEC358A58DB414083, 
+0x7AD5FFBA1EA8C7A3, 0x746A92F777DCD2F8, 0xF427A2CBB1690151, 0x00067C34371FCF82, 
+0x6B0113905D042F8D, 0xED9C9B3C6BBF903B, 0xB3DF960267465C34, 0xD543DEA231D4C1FE, 
+0x561125321C70D0AF, 0x83AB17C8C0664B3A, 0x94AE58F334D29252, 0x001DEC45A74E61B2, 
+0x6F84706C8049719A, 0xA8C41F73F44177FB, 0xE929CA7EB2F140F1, 0x748912346D4F6A81, 
+0x72A6C247DD4D0CC8, 0xA2A0DFB08FDADD72, 0x53EE63CB8E89B260, 0x0019318C37D18EEC, 
+0x3CFE5E44B20E192A, 0xD5014DA9D5AD0EA7, 0x3E5911470CB4045E, 0x323B1B638C663613, 
+0xEE14C3FB711FCA22, 0x38C1E4417BE2CCD4, 0xB1E20853DBE43299, 0x00085D36F0B84D9E, 
+0x6BE3D6A1D0F6F569, 0xE1D8C9FCCA4EC813, 0xB8D86C0BD189C9E9, 0xCCBAF1F159F4FFC8, 
+0x926C267880CA0BDA, 0x7788624B5FB1E420, 0xF950E03125E3B126, 0x001DFDE17E7960F2, 
+0x1D258AAA4A148446, 0x3133E73EFA902D52, 0x756DF05546E10833, 0x38708DD0A12BA38B, 
+0x50149A9CDDD406C6, 0x554979C45A399CDA, 0x8F2E28C409F657EE, 0x0011B65608D9100B, 
+0x53E5A635E85B7ED1, 0x64F96EC5ED464413, 0x9328EFFF07E9729D, 0x465D5436447146B1, 
+0xF8DFD9AA5C1782F2, 0x7C299F8CC8744DEB, 0x98B09A67104177E4, 0x00300565B6727E07, 
+0x7A18A1DBA91880CE, 0xC5CD6B9075FD2350, 0x411AD7B716C208EF, 0xDBFCD84A6099B71E, 
+0x6E7CBA479F226B9B, 0xD632443CA116ED95, 0x086CD54E77DCD633, 0x0005CA741D818CDF, 
+0xA2409C104B94867F, 0xA474794371239379, 0x3E403C64533FE2AE, 0xD2DA74DDAA5F1E53, 
+0xFBFBEECB945C6B0B, 0x38DCA25D99F80181, 0xCF665F84A89B548E, 0x000D33BADC379510, 
+0xEF222C4D544F23B6, 0x33CD076DAD9F459C, 0x751DDE6006984404, 0x9D01747A2C4AA96B, 
+0x08E485496640A7A4, 0x1B86C910937B1620, 0x60A2FBBFDACD4B5A, 0x0009B7C1CE81DEF6, 
+0x703B4E6BD7534639, 0x93B0244A04B17C13, 0x3B76FB72226894BC, 0xE7C3A2A512D3837C, 
+0xEE88181AF47C008D, 0x7E0D55CF44796F85, 0x1934A5EB21C0544F, 0x003A4711B731518F, 
+0xDDA0336CCC7261FC, 0x85A5DC5BDF27E7F9, 0x7EB2D3B460AC3F54, 0xA7844B279930530E, 
+0xA46432ABA686A07D, 0xCB3A95DCDAF2070D, 0x94863387B78351E8, 0x0012218AE7681AD7, 
+0x759809C1246F1C1D, 0x7EA0D860DEE01B89, 0xF6EE3498B32DA391, 0x658AAD1A25931277, 
+0x2CD06AA93A4DC0F9, 0x4A35D01E4DD0B074, 0x9B61DE8F53BDD67E, 0x00393692D671F28C, 
+0xCD5197F6A6F5714B, 0xC89FD23794C4B8E3, 0x79C7677E3714A073, 0xA006A9B03E4B0E61, 
+0x642070E1E4CEC314, 0x246B4CCAAAA96D6D, 0x2EC98DE5C0F08DCD, 0x003EC797E1A1259D, 
+0x2B423A543B3D188C, 0x9D570EECB4BA4EB8, 0x3B73D513FF880F44, 0xDD0EFA01F3A7D697, 
+0x807C7673B12762B1, 0xC9E002FCD9A647F9, 0x2044B689E086A89E, 0x00117A69122C0527, 
+0x16D05E342C8523E0, 0xD20A34C6C4120111, 0x30342125D39FD381, 0x38FECC70A173543B, 
+0xDBC53093028F3A5D, 0x1B5E2889724678FD, 0x6CC8E14E95F383AD, 0x0012A0E5D7F1AD6F, 
+0x9911D9BE26B77B7F, 0x6E0510A8E8E3626E, 0xCA75510EFD5D7C1B, 0x1474B9052D675525, 
+0x609A69D0771FA17A, 0xEA1F0B19A0B31058, 0x1BD7D4B6B40A2F9D, 0x000B9C095CFDE022, 
+0xEC0EB7CADE3B264F, 0x68EC5051FDD55AA9, 0xAB86999B72078FBA, 0x83A09EE47003424D, 
+0xC68E381C5C5E5154, 0x9CB03B595B6102B5, 0xF551DBA15C096A49, 0x002F01A7CE8C1B49, 
+0xEBBCD7EBAC055AA8, 0x7AB14AD0215A47D2, 0x316714E72069A424, 0xD141FA41B1A585C2, 
+0x8634B2E470BC519B, 0x1737238F3AC343A5, 0x984FDE658E54B4E4, 0x002F18B655A63103, 
+0xC6FCA9464B6DA2F9, 0xACD2E35357E467D8, 0x9DA39B42D2F0D305, 0x609053B58DA25FFD, 
+0x3F833E188BABE043, 0x74C6F5426EDDB7B3, 0xB46B5B6886FA6D08, 0x0016B6B8EF808103, 
+0x426963B27CC21694, 0x31D30BFD2EA37E3C, 0x4A566446451C88CB, 0xBAF7BC3961A5AB92, 
+0x5E0675B74833D8D7, 0x0849B964D59DC491, 0x07352CA0168854AD, 0x00107A0540585785, 
+0x60499B2FCA213D80, 0x8F339D1A72BD2966, 0x68AE3B3ADA23AD29, 0xA2850B1EDADE02A2, 
+0x0D3DCD1B6D4C8727, 0xD5BF5DD1DEF0F88F, 0xC372720F76556FF4, 0x0020FAC86F040D54, 
+0x6E218BEBF3C4F7F7, 0xC3FBC7B17B59CD7D, 0xFAD1BD6B5CA92863, 0x32314E6EA85DBB4B, 
+0x800AA3C838BF885D, 0x0F941E5B0DC66E78, 0x5FE8CE91EB4C4D0A, 0x001BB695AFDF5720, 
+0xCB206132493DD759, 0xC0250A0130EC77FB, 0xB600442E11B6ABC0, 0xB469FF067607D74A, 
+0x80307605CF56D2A5, 0x87487F0427303D5C, 0x23F1908993753477, 0x00324453A01DFB5F, 
+0x91D7DB9CC6554A6A, 0xB6FDC0E4812E4CFA, 0x41441A536BDA6505, 0xBFD04F56C5AF6D3D, 
+0x56136948B1B8A333, 0xAEFA7FA56559DC7B, 0xB6D17EAB1D905016, 0x000B08D46486923E, 
+0xD429E33752015924, 0x43579A0EB12548ED, 0x8FA1AD7CCDA46CCD, 0x27DE82F1EC894A9D, 
+0x283EA29BCD97AD85, 0x9EEB2D426B722F7A, 0xAC17BC76CE544416, 0x0039F57092AE2ACF, 
+0x0FA9BCF9F7D91DF7, 0x02BBE54CBA45172F, 0xCD64C7345858BB42, 0x4F5ECB59B233FC85, 
+0x9603C85717FB472D, 0x4B7132E185E9D5A0, 0xACA653D0EF62A4F7, 0x002E38B6CF1E4049, 
+0x88E80B0780AEC5AD, 0xACE0DDD9E2D378CD, 0x45AF8EA179D0733F, 0xD3C478E6026B5040, 
+0x0D58733F52421D52, 0xB00CBD25F823DB5B, 0x20C0FD1C1AF0271D, 0x0027CA60B6B8CF35, 
+0xA18414B3AB51DAE0, 0x4395F7EFB4178C55, 0xB99FEEF37DE72346, 0xA687119561122EBD, 
+0x3C8E19C0122F0DB4, 0x407EB050F0E1104D, 0xD680E9AE150F9CC1, 0x0018FD739C5F89FA, 
+0x85CC692A3BA25C4E, 0x4E9AE2A248A32BD1, 0x2D37D081F55390F2, 0xB6EC095EF6EEB4AC, 
+0x5DC738345EB61B68, 0x3BAF1E1297923DCD, 0xC927E7CDCACB38DA, 0x0013341CF919EFE6, 
+0x9361CD8111DF4350, 0xCE9FAA014D116642, 0x8AF6AE16908D572B, 0xFE6097D13DC07150, 
+0xA30230F6A9C7F3A3, 0xE366C1A5E2354A3F, 0x76AF1C99842BE2F1, 0x0007C65349B67337, 
+0xCEB8F451FB036BA2, 0xAD3B215322E73C22, 0x19C669BD0BD76D28, 0x2AA8B609D1715EA3, 
+0x96AACC71EADC18E7, 0x8B03377DEB9EBF11, 0xA70E9A723055BED5, 0x003A9272870989AA, 
+0x93EC46E655581B5B, 0x1D96DD5ACBD19913, 0x8825F507563F6390, 0x84EC2C2C46FCB7AC, 
+0xEB96580114A9C2CF, 0x73039DA59B359F1E, 0x6FCB38F913C9675D, 0x003D1E4C52DE35F9, 
+0xFF4CB6368CB3F9F3, 0xE56AC7778BD55810, 0x3323A3DAC761FFC6, 0x1F81BA04212157EC, 
+0x24C4612BACE551FA, 0xBDF417395FECA220, 0xFFBCC90347F0F7EC, 0x0011EA448F50C381, 
+0xA4B80DEFB982FFA9, 0x010E968EB1404048, 0x474A34F7E7EB8674, 0x576D339C68FE636A, 
+0x9E62BCDE7D10542A, 0xA7A875B8BA31C1DB, 0x194D124C02BEBA2F, 0x002910984A3776F9, 
+0x992C0D957BF26C63, 0xF8B6EE4DCCBEDF40, 0x77302F6D5EB67CF1, 0x81F2BDCF862F4FBE, 
+0x18B35E51C1D2FD90, 0x9299F17F457ABC30, 0x82C04A28C5257620, 0x002F1FBE41A31A6E, 
+0x2C17484EE59388BB, 0x60C63C2AB1CCD673, 0xDDA8B15611FEC489, 0x72A710DB90371F7A, 
+0x20960D4C9F792DCD, 0x43FA73369FD634D5, 0x3BC0C0625275C333, 0x0022265A35B9F6DB, 
+0x4BF43878ECF2A442, 0xA53AA3365DDDD1EB, 0xB5CE557035B3C995, 0xEAF78FE4CD916636, 
+0x66184355DA24F258, 0x670578DA584AEAF6, 0xF2E75D051CCF5474, 0x0010984D051CA18A, 
+0x035B9028DE4CEEB3, 0x587D909091CE97F0, 0xAE56F7B84B8B20E4, 0xD94F4A697EC94E86, 
+0x3184A47D25755DDF, 0x2D462908496AF870, 0xA0BF08C388CB832F, 0x003862DF444FFA04, 
+0xE050644CB2FFED48, 0x27E43B4C6AE877C4, 0x01B3D41B134BB981, 0x65EF1755F39360F4, 
+0xF38DF75FE2E1113D, 0x9CEEDAD5EF6DA185, 0x8A40B9383CFDADF4, 0x0011C591FB42B82C, 
+0xEB9D16652B2AC6A1, 0x4E78654697F9D20F, 0x84DC9E83D7F9EFB0, 0x1EC04C1604514BDD, 
+0x0F4E4F473D5756F1, 0xBC65FF1AC2BB6B28, 0xFE3FCEC8113937D2, 0x000BA20FC32F7AC3, 
+0x431F3FB51D0D91FA, 0x2BCCD74D2EFE3ADA, 0xA21D849A2C5CAD05, 0xA930D898A4786559, 
+0x7E98B53299171D95, 0xB1790AEE025167D5, 0x3C73729E55DF60B0, 0x000A05C114DA19B4, 
+0x23A2CA45FCF27325, 0xE4B51CD235FEB42C, 0x1ACC1EE9D5ABD22E, 0x95F56ABE164BDE00, 
+0xA96A405AF469C059, 0x2B981A123DFA56F7, 0x70E71C6C45F272B0, 0x0037780DB4DC4F99, 
+0x0C7F59EA7AEC1456, 0x93F55938F1D72F8A, 0xFBAC21EECD77EF53, 0x7ACC1CCA4C14DB07, 
+0xD19A8092457463C9, 0x3DF7A8DC73FED113, 0x400D73ED73A79905, 0x0033DC99EF76F45D, 
+0x61C82F235BB230B8, 0x3C18D1EBFB49CE00, 0x7CE5A2ECF4E409AA, 0x3DB8D87F1189FDD5, 
+0x241EEFCE2CC470FE, 0xD55D235ED21F5EA0, 0x11A62D4A4B2DE3DF, 0x0005D09879B938E0, 
+0xBE5F4FA4A5EC133E, 0x4CE5A083DCB3BE1F, 0x9E9FD5A983E374A5, 0x1812860882D1277D, 
+0x73F26320DBDEC74B, 0x987262C4DD988673, 0xEFA4E27677BD0F5C, 0x002838EC1DDE40C3, 
+0xD91350E9AC6E7B4C, 0x3AF901651C16BB66, 0x04CA106FC6416C66, 0xF3E9B343418C37B1, 
+0x8A2EAFB94FAABA65, 0xAF131A58DD0CD5DB, 0x165A66713496B774, 0x0027A5C0194E38EC, 
+0xD89CDD67108F6591, 0x539B05C7732A6ECE, 0x26EAA40FCB18AF90, 0x76FD54214F36EB3B, 
+0x71F01A7CEC143165, 0x44A720EA0F84D599, 0xE7CB664A0C7BAE0C, 0x000868906D45A632, 
+0x1BA6049281C216BD, 0x8672043629802BC7, 0x52E1266F7171D857, 0xCFAD63B6F32E8F79, 
+0x55CCBB77CF28C9B3, 0x16B42C0511D3A115, 0xF4238479DB6A23B2, 0x0007712E2DB4A146, 
+0x94A9439C231D0EC0, 0x41F8FA0BE66B8F96, 0xAF1F2BA2070B8734, 0xD875594B0CB4F422, 
+0x4367A3D5C5483AB5, 0x75F51A7DACD1E98A, 0x0305B3D89A81DA8C, 0x000D3412A7E1C3FD, 
+0xC8E21163C17B87E3, 0x9458659879B864F5, 0x6D314A047EC4A73C, 0x16BFBB2D6B111A43, 
+0xA78A9718B498A87D, 0x8EEB6D7CCAA7D43A, 0xB1235D8BAAE28A27, 0x001DB2FE371B1F04, 
+0x9DBD42F3613688E0, 0x92D2D66F6ECA0AD6, 0x3E6E7A1D476F04B3, 0x310AAE36E5FC456C, 
+0xE3019D70F06C5BFD, 0xCAB7D92C66A7875C, 0xE17A3D80AA5F4104, 0x0001CBE8E74F3CDC, 
+0x94AE27DF631964D3, 0xBEEB4F85FA7C946B, 0x1D00465B4817B003, 0xB7002FE3E00957B0, 
+0x1B7187154B2A4621, 0xF514361F99D933E0, 0x595D4D2C7F881ED7, 0x003241904243AECB, 
+0xDB2E0151B2F75E14, 0x8B43AFDA9D1F8004, 0x12C551CF027284BF, 0xA66272DC6C3506F7, 
+0x828E73B2D34A4BB2, 0x104B39BF6CE561D7, 0xF80FFDE154AB3534, 0x0035D09D779F6673, 
+0x7B8F9B3B89693545, 0xFE0F9BA181A3E093, 0x8E48C5CA06FB5423, 0x0C437FE35357705A, 
+0x760C2901D855BB12, 0xE0332AAD34C3BA0C, 0x61F08DABC06EE0BC, 0x001BD0A0A412A162, 
+0x02E161B2137D43BA, 0x7ED8BD4A1B57A627, 0x5B81BA3F31356FA8, 0xCAFD8C6A496F5A92, 
+0xAB9B71569CF10EA4, 0x03EB6B39C8EF5F27, 0x07CD664E1647E9DB, 0x0013961AAF0DD523, 
+0xBA150AA0D99923AB, 0x51CF024826291E86, 0xEFD783FD494245C9, 0x84ABB5C2692D2A98, 
+0x441E5BD4FD7E0FC2, 0xA2A818121FC58860, 0xA22B4894DCC318D2, 0x000D17DFDDC0AB91, 
+0x06BD132535F4EC58, 0xC61640C02BE15A6C, 0x2141E97050FFDCEC, 0xC8992962D355012E, 
+0x9CA445933D02E3DA, 0x38674AC51635D485, 0x086C107DD97236E1, 0x001A77DF408E8A5B, 
+0x326B5AE30412ABE2, 0x9EA93783E2E15F20, 0xB19B426BC6628B0A, 0xDA9CD52374E8D2DE, 
+0xDBB1F23BF47133D3, 0x25A3442B552A6056, 0x4214AEBE4F5603DA, 0x00104BA2392E1713, 
+0x15F26558F281780F, 0xF7A9A68B8570B7B8, 0xBF7538CACDF109F8, 0x9BF3B7FF40853B41, 
+0xF8765BDE33E00685, 0xCCDFD4F8FC837E42, 0x2F8439FF78B00DEF, 0x002C49C1A44B35E4, 
+0x4D099E37A44A65CE, 0x108FBF1312DAD5A6, 0x34AF2201652CDA6C, 0x41599F40697564A0, 
+0x954C8144A5D828A6, 0xCD6BD3BF137A3C44, 0x9F5793E0BA5F3F6D, 0x0011D5DC22219569, 
+0x476F9FA7743E9292, 0x74A32A0E70AA13CA, 0x788D08DDE000E792, 0xC844A8C60B80E15C, 
+0xF08EE6CDBBCB5DC2, 0x46EF8C8B69368585, 0x51771D1F51E48CEF, 0x0014C5896CA2EADC, 
+0xBA3ED5C8A20F3AE7, 0xD0BBDE951A63F361, 0xE375DEDBECB38D86, 0xD20ACDA42F4FDCB2, 
+0x0099D42D1D32202D, 0x9A53654CB093A330, 0xA0919BBF1DB17E77, 0x00173036C603BC91, 
+0x05D21C43445F7ED0, 0x7DD5941D96B7E4C5, 0x87ECB1400EF8326C, 0x95262CA98228F21F, 
+0x4F96A113FF321640, 0xFCD85CBF356644AD, 0xBEC3C486997C21E1, 0x0028EC4E69580AAA, 
+0x6115B840E8E35B56, 0xCA8C99102CDE8970, 0x763F5D8E144E7A26, 0x86F60C54E6A44EB2, 
+0x444A24231F711285, 0x1A560FF4B14975A1, 0x74E40DEF03F66124, 0x000185E0F5165D5F, 
+0x08AEC06E152C40C0, 0x76137EB405E7C8D3, 0x4807DF24C4951932, 0x320C2BD05C76B3BE, 
+0x4026A83471B9E399, 0x2ED4961AC5BA23E4, 0xD9BB9372398B2E7E, 0x001FB09AE534FAEE, 
+0x34B0F88EA7E081C3, 0x1AD988FD7D8EB280, 0xD849E9F900F75679, 0x2BC6F29EBC8913DF, 
+0x1AF17213B5E47DF5, 0xF21906AAD04C21B0, 0xBE3D6DBDB4A03305, 0x0014A341CE9F4E98, 
+0x17BFE12E98115D01, 0x180B98CBB51B7CA3, 0x4EC69A193DB512B3, 0x3AAD33C13D6F6230, 
+0x0F31BD5B4BBAB646, 0xB4B4CC8EF94BA66D, 0x0E52D7D880AB6F51, 0x0031F48C8460D33C, 
+0x5363A50816B88859, 0x0767BB16DA7742F9, 0x181C676AB0BA26C0, 0x209907753E911D87, 
+0xED1942D4B74EA2E6, 0x0521D2139A516E6D, 0x5A481C647EBA1018, 0x002D4BDD9BB771D8, 
+0x506B27D7A717D7B6, 0x99B3412ADF2937A4, 0x69B4F3799E892AC8, 0x692B6E99FE0E005C, 
+0x4832E01796AB739A, 0x417F00C13BA2C7DB, 0xAD1575DD34DD3EA2, 0x003BB7E3C7371CC0, 
+0xF71649554F76F42E, 0xB252A5FE646B0FB0, 0x995AA7FF41E4B149, 0x9B9BD614D2174FEB, 
+0x9DFF4CD42688A6FB, 0x2DB3753B19120DC5, 0xCC752EC1F517ED5F, 0x002E3FBA5DB0210B, 
+0x9EEF7B117C6513DF, 0xF5223D920C8118DD, 0xC26DE3BB5B3AECB5, 0x5E91C6B19D71D765, 
+0x58F205C8A019B75C, 0xA421A11BB11AC4F6, 0xCB32325C70E5394B, 0x002633D46A42E64B, 
+0xDAA6EBC61A6E6379, 0xB4034E23BBF50483, 0x05776F07FCC4C584, 0x1C8B74A2AC059D23, 
+0x58DF542D550D104B, 0xD30A1E323BE64ABA, 0x8245AA62698E2BD8, 0x00076ED28E1AFEF9, 
+0x0E00E7D7FD24D324, 0x910AA3A9F881BCCC, 0x399A5F5B12536C52, 0x3318C54571215EDE, 
+0xC4E76B618AF1DDE1, 0x9C12BB7C78AC613A, 0x03B81FB89A1D0782, 0x0026F264BABBE5D3, 
+0xFA87E575FD715E92, 0x44390994BFA469C0, 0x8D93D8EFB11A9812, 0xD4DDD4302963A663, 
+0x84E35C72408FDDA4, 0x9F3758AA87168607, 0xA707E0332BE2E75C, 0x002904774C478FF4, 
+0x11712E552A172347, 0xF68DE24B66A244CD, 0xACC509FAEB1DE9E5, 0x2020E49E0BA04DBA, 
+0x0F1F08307B542237, 0xF07E10B0383BC927, 0x1C04A125548248C6, 0x0039B537DD6D96F7, 
+0x84D3533703CFD5C7, 0x7C8F0B7E19A218C3, 0xC25A409EA4C50947, 0x6FE69EA6B1F1DE8D, 
+0xC5B24FB779B55B5F, 0x6C405CC39DA12E3F, 0xCA0FA9D72E26735A, 0x0010D0E5B7759D52, 
+0xB30046A3C1D5317C, 0x0348474FF244703A, 0xF666A91DD4052F56, 0x88EB0E588E6F2502, 
+0x28943660E3E8D40D, 0x3C454490D5688DD9, 0x58BCDFCFD3D81E2A, 0x0017D80944744946, 
+0xF3655A681B745F87, 0xD29C747B046CF5EF, 0xD1747B1E74B65965, 0xD264DBE7230D87C6, 
+0x12C4B67149590475, 0x04684657E93320E0, 0x4A2F1A48C6CE5931, 0x001BB5C20F55596D, 
+0xB7047D91000AB1F6, 0x05CC55693D5F30D6, 0xE983FFE9170D4D80, 0x63DA59DB25D8399E, 
+0x0F27E04C3975C58E, 0xF6C817C5519CCC45, 0xE599EAEEA50AC515, 0x000DEFBAF7E85D20, 
+0xF1AF5308F0501450, 0xEFB8BA0DB3BC8A8E, 0xFEEEDF05CD67F55C, 0x413E79204DC9D648, 
+0xC92E0450C98B14F4, 0x44253DD886B5CA36, 0x516CCB4EAB2D19C4, 0x0029EBECA1A0EB2C, 
+0x7C42EC4320A26F04, 0xEE5DF25345B53731, 0xFA316D4C2B753478, 0x0D85CCE33C10F9AD, 
+0x468F0B01784C394F, 0xC145E10312A8E593, 0x228BC38A8C8B90D9, 0x001C429FB825FACD, 
+0xD7B746851809BEC7, 0x8043AAA0C330DB95, 0x0FBB4712C753B84A, 0x86E76B0A5F291CC9, 
+0x4F834F677AFFD10C, 0xF44F2DA70D9E0BF2, 0x7D0C16D7EDC63633, 0x00150647E8CCDF7C, 
+0xE040397B93F03DD9, 0x71FA7831C5BE8ADA, 0x3B68C72FA9EFB238, 0x8408A67F2501BCF0, 
+0x42AF1EF63A4C1A7D, 0x52F37A3C96E77EA5, 0x5CBF4364430FC551, 0x0032A004AE037070, 
+0x268D0E9F0673C31C, 0x75145C38A9C4DD18, 0xD91C8F0611C4999D, 0x8673F9C692BB45CD, 
+0xC2CF4940A59C606D, 0x8CCCCD05D6E70EB7, 0x447148642FF4151F, 0x003B9EFBFB1F1A48, 
+0x02A87FA4B076C5A9, 0x42B3D4F03D25F4A3, 0x7ACEF835CD5D90A7, 0x42543306D9D80A45, 
+0xFC5B681F6884857B, 0xD3788B8CD383B3DB, 0x31EEEECDD73412E3, 0x000C777A5D7E092C, 
+0x0FA7A24013E60BF7, 0xDA83ED0CB3831D98, 0xAE3576D60D4D5E21, 0x5C6E50C7286B0A83, 
+0xDEE81B4CB9B7ADD3, 0xD3C07480317D6CEA, 0xA44037184E30CA02, 0x00143A511145A22C, 
+0xD39D67876FD26EA3, 0xE788FE01BF7468EE, 0xCBAAF228961106C7, 0x89A9F4A6BE69168F, 
+0x29554D9F316ED011, 0xAEB3563DFC5F6A79, 0x4DE0FC06CFB4343A, 0x00378495D3F7316A, 
+0x624346F657AD57C1, 0x61F111E1227AC06A, 0x5962CCB2B1A12636, 0x7A4F4D662BA4FAD7, 
+0xBE85868938E7E077, 0xFBA976D524599E98, 0xD37E924BC22C20B7, 0x000919DB2F7AA871, 
+0xAC3C1E0257CB9B36, 0x41B181CF1199ECC8, 0xE6D13B172AB01CE0, 0x6EBDA0BC70D1106E, 
+0x3C43550CBD3A6759, 0xC678A6B95FEF444A, 0x41FF5C2E0ED6B7F4, 0x001BA18667CC2E9A, 
+0xB683FCFF5795F792, 0x0D5597C791AD34FA, 0x8AFF5C0CC58E978D, 0xE9B1339E9493C4E5, 
+0x6F9DE28C9F8B612C, 0xF7E7B894B92FFE88, 0xDFC623729CD588A5, 0x001CA1A144DCE60E, 
+0xE1717C7CD2CF5D48, 0xF53C46E4063C5629, 0xAEDAD0D6C0BC5CE4, 0xC67423EB78235343, 
+0x2E7F64E4B6BEA6A6, 0x96BBA130DD05FBEA, 0xBC0B51B860744910, 0x0034418091E50FA2, 
+0x8DCE6679752F621E, 0xDF3F9D8F065C04F0, 0xEE5F213F97510672, 0x65D737671D015940, 
+0x86D0EB7FD197ECB5, 0x28602CCBC4C81231, 0xA6F01D4A4467128E, 0x0007A638AF31BAB0, 
+0x8D7C0EC763FC313D, 0x7C99819CC28D9E0F, 0xF06CCB54E86297AB, 0xAB2A0DC612462DC4, 
+0xB668D92318634131, 0x3B7DF5CAC08AEF75, 0x403AE3456FA1CD6A, 0x0008DCA1E5D53094, 
+0x6A71C1FB4DFFE10B, 0xB13F433C07D90C95, 0xB984054A95E8BE03, 0x9F849265ADBDC095, 
+0x3718EE9B90A058CB, 0x16CE453DF303B8D2, 0x5942E46B6D22040C, 0x003B4F1B241C43D0, 
+0xEDD0610D2A1D7A42, 0x547FF25B8E74333E, 0x922503CF7381EC1C, 0x4B29C50BB3086829, 
+0x55465B9046D0BC50, 0x8D20D023BDF2EBC1, 0x35565D79CA6237AD, 0x0029F738BB3C8F4A, 
+0xEDDF10CCCD95AE6D, 0xE61DAC77481D795D, 0x9A326D5579D0B289, 0x5608F88CC628F52E, 
+0xCAED2CF90A9F5D67, 0x2BA9895D699F7D13, 0xC52D99ED279D30AD, 0x002E11FFD2B8969C, 
+0xB4D0347AA96E896E, 0xA8D76813208DD889, 0x6F84866D1BFD0C87, 0xDFC5DFF6C4BE54AE, 
+0xC18D5AA77324884E, 0xF128182A221C89BF, 0x8C70425F8EAB9456, 0x00189974152A6D44, 
+0x3798D1A71D9D2FEA, 0x3AE4D72439E9E4EC, 0x4010550445F1D2FA, 0x223AAF54C991F698, 
+0xDBA122C1E0136428, 0x614DB96DA52F60C5, 0x0F92A40810D8BC1C, 0x001B76BC69CD3699, 
+0x084D150BB3EA36E1, 0xA671A5357971E622, 0x7CB2B84D899A70DC, 0xDA98120D0B39258F, 
+0x15C91ECFB37BACE2, 0xCD2FC18A525283D2, 0xCA9794D59B0CC96C, 0x0014C440877D4388, 
+0xF83F63DC1BC3D1AB, 0x2A2D21C0C8FC4B97, 0xF746AC31DBAD1F89, 0x6C5BBB78D6F67EBB, 
+0x41F645E97443D0FA, 0xAAD5E2BF9D132EED, 0xF26A77E4868C2CB1, 0x001CA0B4DE3C5B39, 
+0x6391750FA1B95DAF, 0x90BE240DB3462FAA, 0xA91B9AE28DCB0B8B, 0x463C8D2548377A9A, 
+0xE5953E7073AFF9EA, 0xEBAD9805CC79F26E, 0xC2F418BD8BF392D1, 0x001E7D273B3B26B4, 
+0x7800C2D08B629667, 0xE9FF65CD54F9B89A, 0xC52F41C213AC832D, 0x3A148338761027E2, 
+0x3FCC42B4F99FBABD, 0x5FEBC7B2A2187664, 0xEC220C0CFD27A460, 0x001C8BFA995D8F8D, 
+0x674D3F132BABECA2, 0x0B218B6D8987FA6F, 0x4F5C7176D081AA66, 0x28CCC84A966E06CC, 
+0xDBBE0EBA2344731A, 0x31BFB6CD2ACDFC4F, 0xCC85714B21A39B8B, 0x003F8AE188B53714, 
+0x45897421A4604CC9, 0x48CBE9E758FEF18C, 0x2B96A39E24D73034, 0x506676133A36B886, 
+0x460841C26F1725F8, 0xCDC32D00ED49F67B, 0x69A3DB92921D8E2E, 0x001B0E00B9C596DB, 
+0x6C1204995414E769, 0xF1073B861106BF3A, 0x2B754164DF0ECEFD, 0x71FB2B09BF9E3B85, 
+0xD1E7FA1FBE59E4A2, 0xD0C4A883E70EA1BB, 0x6550001E1A96FCF8, 0x003DB0B4A21AE75F, 
+0x07B2DB0CDC17ED74, 0xE311C0F1690308BF, 0x7D67E29529214D64, 0x503F4CDAF84275F3, 
+0xB837ECB0B0D61013, 0xC186967CEB35F585, 0x9AED28103B995D8E, 0x0024A41A730BCB03, 
+0x05B0014B60043FB2, 0xDA7D1D01F5D4ED45, 0x14B5FC4DFF425766, 0x402E27ACDBDE6517, 
+0x2325AD29DC498C53, 0x3B99CC0E061B4C09, 0x6555EDCD7D742041, 0x000D6A32B47516B7, 
+0x252727DFC111F3D6, 0xA99CBE7AFB649078, 0xFAC86AB8568F52D6, 0xE84A0ED8D2C3E349, 
+0xE891E9FB318AC13D, 0xDAED4D13A62A2F96, 0x02A6AE361204D069, 0x0006C08516E496EC, 
+0x7058ADB6FA10A12A, 0x8FB05E4ED875E6F2, 0x3F675B2427825A42, 0x7C4587216EC4630B, 
+0xAB36C334D7D06D80, 0x0C85763BBF00134F, 0x6884642224A8F8A4, 0x003284007ED8142F, 
+0xA449EB849E16F3D0, 0x75D8AF6C6AEF4671, 0x8CE853036AA6DC09, 0x677419D38D80B367, 
+0x62C37FE0B1FEE574, 0xAF0933A2E9F3D75F, 0xBF44A796C33D6856, 0x002B9423F2048AC4, 
+0xAFE85DCC9B4D0B1C, 0x7E67AFB299EE7F75, 0xD6EF15A58D9CFE6D, 0x20ED6D1F61762788, 
+0x16E273B276A47E8D, 0x5FBC7FB6DCCA1FB4, 0xB366DBCCA5FF26DE, 0x000FB996990A28EE, 
+0xA473DFAB137D48FC, 0x87D7628EFBB5B8AA, 0x7D5CCECD8416BBB6, 0xFEC163529A60684D, 
+0x2F0307714F03530C, 0xB191502315759D1E, 0xE4667E8258C908B5, 0x002B01FBC70F19B0, 
+0x9D4162064E9BD244, 0xEA1CD094A9864868, 0xD012819E841429D7, 0x9E07EF720BBCA22E, 
+0xABA8781DC259D678, 0x8013E0C71203498A, 0xED1A00F65D4A475F, 0x000BA74FEAC418A9, 
+0x01644A7674FCC376, 0x9FCE466AB498FF4D, 0xACBD90C8C55DBA57, 0x772BB990C8BBB800, 
+0xEB6B3CC09C4A383C, 0x744BDF0CA6B02202, 0x943C3D41608C1DF7, 0x000B48EDA71A9634, 
+0x98135252FEF2BBA7, 0x457F28401D7D108B, 0x43947DADBD79369D, 0x6FF4BF2F54D6FC13, 
+0x01FEC8F0B7E87CF2, 0x5030E6FA05DBD0EF, 0x406C1870DF85426A, 0x000ADDCC8D7D7CAA, 
+0x9286493D6ABCD011, 0x0560A61F579E34BC, 0xC34703C046903105, 0xBFC0F937E9ACE230, 
+0x726BC181C1A11F87, 0xBBA82BAD206ECA4F, 0x672A412B551477D5, 0x00220E588B2CC2B0, 
+0x0FAB0EAA18DDA9AF, 0xDAAE093CB19654B7, 0x81AC1DCFBD968049, 0xF789449D488620A5, 
+0xE9FBCAC3B19AB49E, 0x920B6D51115043E1, 0x16AE1E7E10E3E39A, 0x003B6280617C6188, 
+0xF1E214679EB2F4A8, 0x7288F9E1CE8BB560, 0x2BD914E131646C39, 0xE627B05400A0E51D, 
+0xF92D8A67EAC6C1C5, 0x68BBC9F3275A7B36, 0x231B80AD426C6181, 0x00197220555AC9CB, 
+0x7531B97A7EC2FCE8, 0xF0A365918C468C94, 0x6C15F54942A6392E, 0xE72656CEF035D2DE, 
+0x09FBE60A6C3F0BCA, 0xEF1E743D81E189F1, 0x5C7260554B4B90A0, 0x0007AB34B1BB367C, 
+0xAE6A1C2633A3BF63, 0x144B80F2C54D956F, 0xB0CB12AE22B5673C, 0x070F73BFBF513890, 
+0xB47B186FCCFE9E36, 0x73F9F7F2F308BFB2, 0x58E148E897EA5030, 0x000EDED9CF9F04BB, 
+0xE827C2FBC152EAAD, 0x3F6F0E6A9F31436D, 0xCA4EC61FF202F52E, 0xBB41CB6E336F487B, 
+0x192B0B178A59A0AA, 0xC966B6DBF0A0E915, 0x0E8618956B50694F, 0x002BC089277E0D7B, 
+0x10FAA638C8479493, 0xBC70DE03164A7B77, 0xBF400A2BF0091FF6, 0x22A2507C7506AFA8, 
+0x7EB7709CB6E39327, 0x623F84223BDABE3F, 0x446C5CC07295C6AA, 0x000EC2C56985C4B6, 
+0xAEB1A1C12184BF62, 0x48FC5349131C7EA4, 0x07DE0F0891B38ABA, 0x6BDC5FED6A850368, 
+0x458C544A020E197D, 0x5243655F110393AC, 0x6562984E54D2D367, 0x00259BF17BFEE52B, 
+0x2AED381247F3EB14, 0xF8855EBB223BF802, 0x471BC52F88E70ECF, 0x30F3C6A7F1A7508E, 
+0x4FD68146D4AE9493, 0x8664D362E5FD7E9D, 0xE80A84DB7F5E6DDB, 0x002240633D3D9F89, 
+0x58CD96F650D58A90, 0x4F49B4B5F28A9CFB, 0x3FD389E9F7426B70, 0xE8B6AD0F1F322020, 
+0xAAB372E1B961407A, 0x2C88135F0F3933C8, 0x469ADE05AA588F09, 0x002C3BDED1C5C9C5, 
+0x083369BA96DEC950, 0x5F05AA07D0FB3B5C, 0xF3C6924D6195A964, 0x4BE04DD286400AA7, 
+0xF4B7CE10ACD510F3, 0xC60AC7D509318156, 0xEAC5F503D4B3ABF4, 0x0017917D69B00D73, 
+0x1B036FA9321934C8, 0x73EFAC849BABC547, 0x90096EE7821D5DE3, 0x2AB2B67C54001CC8, 
+0x6F77BE25082ACA56, 0xB387BCF4FEF854CE, 0x35942B3E391053AE, 0x0022709636CE61CC, 
+0xD818336F4BDAADD4, 0x67FC9784756B6207, 0x3F54FCEB4F76582D, 0xE1F81E4CE0657987, 
+0xB1ABCCB27A16A2AF, 0x7739363B38F55709, 0x7CF3907A44986699, 0x0022701BE529882D, 
+0x58EF9957D4C92F40, 0xB99327E415A51EAF, 0xB0A834E2ED4F4E2B, 0x75493F77577B1460, 
+0x5A0E36CDAB671ECD, 0x6DB0036F244C502B, 0xEF1796EA14EF0F3F, 0x003F1C7DEB5DB4A3, 
+0x0E395CC201E54D0E, 0xC6669413D1A2B3AD, 0xD3176966850F60D7, 0xEDBB9C99DB4DE8B2, 
+0x8695D9B6EC88CD30, 0x2C803F27466DB324, 0x212D8FCB7CABD5C3, 0x002331C225075A06, 
+0xA808905879DA38D0, 0x6E11BB9AD30AB182, 0x915BFF7600308637, 0xF801E2644E00239D, 
+0xDE6851EDAEDDA673, 0x92A2FFE6DCB55C82, 0x5296664EC7BDB9BA, 0x0032C2EA1C9D60F6, 
+0xD7C1943FACE3EBEF, 0x836896D6FCB38057, 0xB1E28DE9B63F01B8, 0x9FB16CDFF1A5C829, 
+0x072838161BFE9C64, 0x1AC218BB39301100, 0xA187D800753E8C6C, 0x0015E13A4B709DEF, 
+0xC77E02C1F3EF65D2, 0x06909F15FDE5EB73, 0xA403862B490C4F7A, 0xF750012372B9BC52, 
+0x829315F46EF50EF4, 0x0FED279D1E48897B, 0x5BA42A7DFD982062, 0x0004EF26A482504A, 
+0xFB4BF4D2D8140634, 0xE3A70F57CFCFBC23, 0xC05CCA0F54A2A12F, 0x90614CEDC88E08D4, 
+0x5763CC8BC278DF3C, 0xABFC6D034A499A94, 0xE0F2644BD95F1B88, 0x002214127A0DB5DB, 
+0x49DC60F3375BF89A, 0x6E1A3722F8459FD4, 0x92B8C46D491FF7CB, 0x3AF3B4F33C32E91C, 
+0xA3B999F85A34C061, 0x771A97A0E5060517, 0x567156CF2A396415, 0x001F140AB5B4C39D, 
+0xB0B8F964CAD0B653, 0x1A8B6A78A51BF96F, 0x189FB7817108CAE1, 0xFB91990909143A15, 
+0xACF1968392E95394, 0xA0581F3CCF228D45, 0x77A0C77BC6F12704, 0x0023E82CA953F647, 
+0xEBF4FAE784D54043, 0xF1E7789555B5FEAA, 0x83817B9AAAEA399F, 0xF321200EB5CB2B72, 
+0xB74CEC72B9EB1908, 0x6F2696692DE9418D, 0x9F4F5190A3F5B941, 0x0001310EBBCB2878, 
+0x75D6B1B7CB9DFCFE, 0x6317A2424348280C, 0x9A58C05BFD451990, 0x8BE09CB4F9F23D74, 
+0x108962F9749E81E0, 0xA69328A9422A185B, 0x4BA1C6C46DD45C5D, 0x002064B35FD42A8D, 
+0xBCBBBA04C0B84528, 0x32F32CB4C5AE7883, 0xF308B511EDF56EC4, 0x8113551000AD4676, 
+0xCA45C4ABE462051E, 0xAE42726BAC5156CC, 0x1DFBFE1320FF7719, 0x002747A29A5735CF, 
+0xF03BF4930B03C146, 0x5C32C30890FB5E2B, 0x28A0FEDC04E38E28, 0x70CCEF057624587E, 
+0xFDB6B605B558B705, 0xBDE2B233DE900598, 0x1B767AB5EEFB6347, 0x00014B5597FC51F3, 
+0x306A1BCC19071794, 0xCDCC8BB82AB7C6B4, 0x481EB5CA4CC2D722, 0x60AB4F660CEE975A, 
+0xDCA46F088E38D218, 0xAEBA642AB89EAC5B, 0xE0A6C849B8D1FE3E, 0x000DB1F8E3736B55, 
+0x8FDB609F03198D13, 0xB56D894D9E3604C2, 0x049951C8A85E0989, 0x947A08510564557C, 
+0x62D61112D4E9CB2D, 0x7A895F4C977A1E9A, 0x96B4B96EF247FDC0, 0x0008D98AA85414FD, 
+0x30C3A771BFECC859, 0x8FE26AA073F5CA09, 0xAE97AEDE8023D0AC, 0x0E546858E89B2EF6, 
+0x0CEA2E051D3E2564, 0x22700A3219FFC186, 0x2A8DE611345E804B, 0x001A53C8328D41DD, 
+0x5C8038AD3DBDF739, 0x6F9E077DE6820A3F, 0x02BBC0DAF2F697C2, 0x6CFCC7E5215A0AF5, 
+0x767413345BD0F29C, 0x91F7B4E616006BB4, 0x269C8831DFDB71CB, 0x0006B41855CF993B, 
+0x1A6C6D800A8CBBDE, 0x8EDEFA703C245B23, 0x2BDFC0B98F26A015, 0xB43B160E8E38175F, 
+0x1A983A447E76CD10, 0x964C4B595C6DD1C1, 0x87E908F6DC2DD651, 0x002337C284F7B27D, 
+0x2CA4290840E3FDB3, 0x90ABEE8827DBEE94, 0x693698651FBE878F, 0xCFC0E17AD430E874, 
+0x1EE3544D2C853C56, 0xB539FFC9C19A530B, 0xBEF0E5AE272E8C60, 0x001A047A044F83C1, 
+0xABF5838DBD16A10E, 0xB266965BE41E4A76, 0xA7965ED5D75DF02C, 0xF0D5A42AC147585C, 
+0x02C3F053BB3A4BBD, 0xCDE0B482C6A21994, 0x45A48B28EE680700, 0x00149A971F05C7D3, 
+0x172A345662F6C380, 0xCEF3D0C101295F41, 0xC33942ECC81BC140, 0x2FA5F06A6632E91E, 
+0xE4B4435773D05611, 0x38A464A4985C16DA, 0xD299EBDE7FF4164A, 0x00247B3CF00FC5B4, 
+0xE7A46D53757280F6, 0xC042B87855977F0E, 0x6C99724F35657FF3, 0xBF0E038D031E5684, 
+0xAD3B9CD42399ACA7, 0xC57B65821E2D25D5, 0x111C032B64BE3D5C, 0x000D30301D6D6CE3, 
+0xAAFEF436B789F0BC, 0x93C7B2CE5CCDF9E8, 0xE06136F54344DFC0, 0x5003F2618D8F67B5, 
+0xD583BCB8E3F0AA1A, 0xB129326A8360EE5F, 0xD5D508D047752122, 0x0017E00E2FB9EED7, 
+0x98BDDD739FA5FE63, 0xD3211ACD182DFE41, 0x7EADD32790A35476, 0x173961C0AC3E0BFE, 
+0x781B54EDA7082947, 0x5F3855DEE86AF629, 0xE5560963D635EC9C, 0x0040653ED4727D35, 
+0x4C4B89AC5834C89E, 0xB9C9B43CDDDECF63, 0x28A5F9D1616A9583, 0x670A3A2D835D3FAC, 
+0x0360E845F740392A, 0x69AD828FACAB28FE, 0xDC8821E8E39D7F19, 0x0007EE4F31A6192E, 
+0x24B606702E37C3D9, 0x37C235EC19DAD71A, 0xFBE33BC2C3312232, 0x9632A462F2D52A96, 
+0xD927159323741D31, 0x79DC166DC158FC6D, 0xF6390DD3C1DFA50B, 0x0021CD05184B8BA7, 
+0xB576402250B4B329, 0x5CB2C0C5C6D4BDA9, 0xBE875ED8F792F11C, 0xE700F1B166659A0D, 
+0x83230F1781FB0B2B, 0xE04F809702EBF805, 0xA339D211918CAEA2, 0x000A73CFFE36F891, 
+0x8B29E7EB7513BDE3, 0xD1C1F371D018B399, 0x2D72EAA9D204F6BA, 0x6A4E7871C09C611E, 
+0x1AFBB966A8A85A46, 0x8FF8B3E2D737B368, 0x56BB1699ACE41CF3, 0x0026A7728F99480D, 
+0x20AD6059D8DF3E70, 0x9DA5D7739EFC1AD8, 0xC1B2D161EB99E5AA, 0x90455C19D6B936CF, 
+0xA9BB4CD679A0C4EA, 0x1BE945B2A05591BD, 0x98C1DF798D912CF9, 0x0038A1291E696DF9, 
+0x70759EC803884E53, 0x30ED400DFB9EE383, 0x6286E55A9528BC2C, 0xC7239C7BE7B10B58, 
+0x1FCF0544B33B5252, 0x31B27AC75C074DCC, 0x355D3F16586B0A57, 0x00023F90B5980197, 
+0x245833CC02C0D038, 0x0E468ED9248BD87D, 0xD9E5F1F4FB7FE77D, 0xBC5F398D49EA5A5E, 
+0x645CFCBFECE5573F, 0x1D919E9ABA1893AE, 0xFE404E7C2EAA4A7D, 0x00053C81502A77C3, 
+0x016FFCB282FC0108, 0x3AE709902E6DE423, 0x0688B38E8622B2AF, 0x30195C8A9DB14EE1, 
+0x9543B5A424581BED, 0x23CF324C0874E537, 0xD54E7FE75BEAA9B9, 0x00248CFFCD3ADD66, 
+0x3EE48813D85D0352, 0xFFC50504C9ADE42E, 0x6C814F232BD2E462, 0xE8C5C721BD6040F9, 
+0x42939BB71EAEEEAB, 0x270AE73CEF53A8E4, 0x62910FDFE1824CC3, 0x003A37F34B9DFE47, 
+0xF029E9B2FE111795, 0xD29762AC21016D17, 0x391623D3AECCCF34, 0xD63DC32DB1A93471, 
+0x332D5427ECB6B4A2, 0xD85552E4FE47CFA7, 0x199D1583097DB65B, 0x002DE6147FBA7189, 
+0x4680AD0EAA4E1672, 0x311C9D7CB74349F5, 0x66E378BDE129B661, 0x41E9381475284240, 
+0xEBC0345F36E7C902, 0x9DDC2B5FD2A7A42F, 0x96FC892FADC6FEB4, 0x000CEA5BDBBA371D, 
+0x250D07E0E436C2E7, 0x14DEB62EDAE816D1, 0x3CD8A0EDAFF70E92, 0x4755BD062E5397E4, 
+0x28A467020D558126, 0xE1A29A0E4C3DD865, 0xE56EE6A7160FDF28, 0x00105280EC8A1D6E, 
+0x0EC75A064A4D5AB5, 0xCAD2D677276EAF47, 0x39C550F00C561BD5, 0x71A0E8EB3EBA05C5, 
+0xEA42A031C7EFF86E, 0xCD8831347B780CE9, 0xA1EF8C55D625C357, 0x002562A2E0644BDC, 
+0x901F4508490F331E, 0x1922A5F6ABD26609, 0x6C679F9CDCE1E804, 0xE9B89C56B58398B8, 
+0x8EBA5315208778F8, 0x9BB50C2A042B1D66, 0xFCE1CEBF696B6E9D, 0x00380BB1934958B9, 
+0xC643E81C1B6ECE04, 0xDC2F174A11BD7FE9, 0xD2217C375E29E2B7, 0xC786CB92341A74DB, 
+0x3CB51574F60F9BFC, 0x049BE77CB7A50E48, 0xB71BF9B7906A50C0, 0x001B4F3AB58F73F0, 
+0x8A96741795115D3C, 0xF3A06726BC176918, 0xE1548894B4197AF4, 0x6D0CEE700C50C929, 
+0xDE84F9F7489538E9, 0x93BE24E218EE0A55, 0xE2BCB84A7F5452B6, 0x003073E7A302866D, 
+0xE921E9084732EB59, 0x8F020AEF3B3A0903, 0x63D76DEFD43EC980, 0x90E2FA90F93B050E, 
+0x14F40B46FEB4434F, 0xC96A093575372474, 0xA0521D86FE8B1511, 0x0003A57268F97302, 
+0x1AF55C6507CD0814, 0x959D3E3FB30E8EE9, 0x7B262E5C7263A1D7, 0x8937EBE2E37E548B, 
+0x827443D86CF4B513, 0xED144DAE0C00B91F, 0xB5C4FC355652E120, 0x0031ED4609DC3370, 
+0x10685D5050F063A0, 0x3A4B461F17EABAA0, 0x641D1957F45512D7, 0x1DA3EAF92D01B0AD, 
+0xAFDF8FF94E79FDCC, 0x471E96F7CA5E5E6D, 0x29144C9FF4551C46, 0x00398DD10109624E, 
+0xEC376BF3C0D73BA0, 0xBEAC223D164FB550, 0x71B968B7CF0FD372, 0x016AD7D1741B082B, 
+0xCB76C9843A2B917E, 0x344DC202E43F08EB, 0x0FD3D51E8FD74010, 0x0036D6E8C96A44FF, 
+0x52B1A9FD4FD67EB9, 0x038C6498B730EAA4, 0x8AEACF3FCCA6D38A, 0x376818A4DCD03B24, 
+0x456429C66C888AAB, 0xBF989B2B2BED4EC1, 0xA79E2DEABF01493A, 0x002D10CA72D805E6, 
+0xCD7FA14A74D540DD, 0x386BC52F1169D884, 0x47EB178935A614E0, 0xA086510493342530, 
+0x8DB232BD28461C94, 0xD449417A73645D3D, 0xFFD26D54AAD1A050, 0x002E1364E52A1217, 
+0x93CC981E603668E6, 0x6F33DEF72A479D96, 0x040DCC63B89A9F16, 0xD4E662A3016D9AB9, 
+0x198851FCF2E632A2, 0xE11401058F57CC2D, 0xF47AFCB6D7A61EFB, 0x00139AF35487F890, 
+0x58B154A5F7B720BE, 0x54E4A6A6048B2BFA, 0xC156324412187C3F, 0xC5F484A9D0C62F7E, 
+0x6BE3948F26BBC348, 0x6CEF5456111577DE, 0xE077AFA7B037C18A, 0x000769137120DCD5, 
+0xAAEFDCB844E5584B, 0x9385E2CE350A19B2, 0x4C5022AB667D3A11, 0xCE51D02B4A5F8D52, 
+0x9E2FF01FDE2A6915, 0x8F9F15B7D1D82166, 0xCFD64175216D660E, 0x000765D51455A35C, 
+0xE2E3EF1437A4BF1D, 0x2F509EE0171534AC, 0xED15DFDAD117237B, 0x0056E9A35C22C723, 
+0x29EF37C492044575, 0x428CBB67F8C17FEE, 0x9899ED53E93BF369, 0x0023900D3BD63FAD, 
+0x346A7C5A718C0F20, 0xC7DB9CE2C3571918, 0xF50A7129F3B23CB3, 0x3E86BA99E4D8B4C2, 
+0x5B3D3EFCED9DCFC0, 0xA16B6645787540A4, 0x4D3E53EFDF68FCB0, 0x0020736597B11DD3, 
+0xFC24FED1B8292513, 0x8664B390E7B7DD51, 0x18B2FA7847B01F7E, 0xF59513CD768F2D86, 
+0xC12FA1968D4F678D, 0xB3C168AA885E4BAB, 0xCE800818551B673C, 0x002386FF0A026C8E, 
+0x342FDB7140990E60, 0xD271D8979755A80A, 0x930E4941AD474202, 0x8298264A57862A18, 
+0xDBA4F43CB40DD54D, 0xDC9EBF52210E962D, 0x1CDCF56860663872, 0x00002F8375F36B9F, 
+0xBEAE31A50AA047D6, 0x789F678F04EC4304, 0xB9680FD5EF1BBED5, 0x2F7A10FB68A4DFD4, 
+0x764EFE26E9039DDD, 0x45674E577B7E3E10, 0x9F8A7A3309309863, 0x003D73A80ACA5308, 
+0xE80ACDDB0BD21BBB, 0x257D474F0E2EDDC2, 0x3C713D5E310DFD3A, 0x68E0191736E3276B, 
+0xFCB45B1F6B65217A, 0xF1B7312264811392, 0x27861BE9DD9B656F, 0x000BD1FB4D4183B9, 
+0x3E29C89E4AF43B15, 0x7E7225296C217ED7, 0xC77367682337854E, 0x5AB8D28E7E618D13, 
+0x95FF5EAF491B2135, 0x5A7BDE4044F9537B, 0xF249107195450FAF, 0x00378BF6C7E55FFE, 
+0xEE92406AC7E339C4, 0xDEDE4E4276C8E95A, 0x3878A42D02682A2A, 0x9E353C2D6F345DB0, 
+0x39948EE29CD34E40, 0x469473E5108F2A1C, 0x857481A7A34B97E0, 0x002F2A10F8121739, 
+0xA59D573EBF0FF9FB, 0xC22A5DE80BDF453D, 0xEE912AB1FFFBE129, 0x774D62598BC72861, 
+0x04D8374A971E17A5, 0x3F5647B364DB6F87, 0xAEBAEDE1D3903DD4, 0x00163BF63FCD16EF, 
+0x2BC61DE16E24AE59, 0xFAEE74CA77145BA2, 0x9F73D9A6DFA8CFE1, 0xF6AFFFE30C904A59, 
+0xA65C27CFAB5AD3B9, 0x75BFA899CB9EA9E0, 0xF58037862FD8DA20, 0x0026B7C9E432EEC2, 
+0xD5B0CD8C38046F6A, 0xDE6C89F8EACA247E, 0x664BAA366863DD67, 0x176BF36F590E53F2, 
+0x4D832E030AA2C4F2, 0x77584E164CBF659D, 0x59DE85231FE9BBFD, 0x000171D24EBB853F, 
+0xBD3327CC846E3BD6, 0xC7667D0668A835CD, 0x3F35FC2A2C2863F3, 0x881A662DB8D8D21C, 
+0x46300CF04334C470, 0x74CB679DD9E564E2, 0xDF1EEC7C075C9CFF, 0x0031E690E2EECBE6, 
+0x3A9A9CD3049F24FF, 0xA7C2E1559532DA90, 0x2DF86A42CD93C17D, 0x55DAC2DE5729AC2A, 
+0xA5B5ECC63D0B0AAD, 0xADFDA239DD0F4E20, 0x0A2F770F3140F987, 0x0012CA26DDE30FB4, 
+0x3F031C13055B8822, 0x0058D46FB5364249, 0xC3CE8663A2F12B52, 0xB15DADDCAEB065B0, 
+0x954093F12C41AB74, 0x1E40BD5AB36930D1, 0xC42AABB4783D542F, 0x0027F3C615CD4736, 
+0x9D202DED8A5FEA0F, 0x29A5799403B5EA57, 0x718648FDB659202C, 0xA52CF124393765C1, 
+0x1F700BD8E2D955E9, 0xCC5632107BC8A4C9, 0x66AC1EDE2E47817F, 0x002384D2F0E3EFC0, 
+0x18EB70F1F2156D98, 0xCCADAE533534CA7F, 0xAB9BC3E02EE45711, 0x185AE50FB8C42FCF, 
+0xDF59C1C7B1A5275C, 0x120C5195E8D6F3DB, 0xBBB3A011B902D2D6, 0x003F0C18704EBB0C, 
+0xDD349C83C2F30B00, 0x15FC6C3ADD624B51, 0xD4A635458294CDB6, 0xA1F9836B455E31EA, 
+0x01B42298DAB46A56, 0x41281013997B460B, 0x2B4B44E0B61B6956, 0x00373B384CD57698, 
+0x82A2219018C20C6E, 0x67CFE3AC73D89F70, 0xC4B6099F0A651111, 0xD1D357BF9BA73CFA, 
+0x3A9DE4F60C691040, 0x8917C2F3E745270F, 0x9479C7325B4DD5F4, 0x003CD4C17D9A3A3E, 
+0x5811F8A52CCDBCF0, 0x50CCCF6912BC04A0, 0x27D729AE935286C4, 0x93C40F3BE1E2F4C7, 
+0x4D9E1CACA93D286F, 0xB455902E959D265A, 0xA2F7FC254434EF88, 0x00395E6547E58381, 
+0xFB487F4D088D8FEA, 0x3585613F65D636C9, 0x0EF1D7D7D3034AEE, 0xFBCC9A454585F172, 
+0xD0002932F091A847, 0xCDE00A5B6453CF4F, 0xF3C2717E0AC30122, 0x003E0A30606C1DEE, 
+0xFB733EDF7C5E767C, 0xE1BC4533913A4E6B, 0x9522FB5B4158D8C1, 0x5601CDA2D64054FD, 
+0x2260401FFE02EE8E, 0x58FFEDF8BF5503BE, 0x8C5A659506EB4605, 0x000839AE3152D34D, 
+0x5E1AD0EA66AD042D, 0x938B1E24ECC40FE4, 0x8FABBEFA0D364177, 0x080B06722B0724E0, 
+0x6987C48D7F2A6537, 0xF39685C540ADAC54, 0x2CE6B9ADD0EE5473, 0x0026E7B0D61E3E19, 
+0xD822CD95E8AF95C4, 0xABEADAA5598CC3F3, 0x508F2EF1A26EFA7B, 0x6B57A5672EEA2C87, 
+0x93356852CE664D5D, 0x184847D1EA69B51B, 0x2D069074EF8CB416, 0x0003288BFC491943, 
+0x5A4D3D2E322B262A, 0x236686D6C469BBDB, 0x9C0B746AE1DC294E, 0x255D323B5FC60CAD, 
+0x6371D121B87EBA68, 0xD98DD00B4BED051D, 0x5B26697BF184E9BC, 0x0013FE06A85708B3, 
+0x7E71FC2C00A7F07D, 0x3509F585291A1DAA, 0x1DC0EB4E82D09B57, 0x13458F8393026D95, 
+0xBDE6683711227952, 0x633E8876C4D57EA2, 0xA3EAE31C4B12ED36, 0x001FF100809000BC, 
+0xBBDFEAF2982152C7, 0xB7392331108C00CB, 0xC9D9338E85EECAE6, 0xD7AD33EE5FA6CFCE, 
+0x527257BB0C8F7F5E, 0x8E1DC0F1B62909EC, 0x1BD0344AE3DB1FF6, 0x002A25A132683139, 
+0xFF3A4BC895978AD0, 0x85919EA0F7D6279C, 0xE1C876317D325EDB, 0xCC1238D4BA21E99C, 
+0xA05CB85663E47AC9, 0x061DF06452EFF4BB, 0xDF9D515237F41EA4, 0x0007AA67F1F6F6A7, 
+0x951A0BC67E7D871F, 0xD67458DCE7B2627B, 0x548D242A98E287BC, 0x4F4C9D5B87AF47BB, 
+0xEDBA9174354967F0, 0xB974CFCC2CE29F25, 0xE0B6706492A01073, 0x001AAF60DA67992F, 
+0x076A200FEA1C9704, 0xF62E92795BFF7957, 0x8CA34B824E523EA6, 0x64D7A04EC568B2FA, 
+0xCE9978D5713A7EB0, 0x7E92375885BEA6B5, 0x4EF26EAFFB3917A0, 0x003AA256A3CB81B9, 
+0x5BFE1089767577A0, 0x5D4E493C9772E217, 0x1CB5B80C88FFF2A4, 0x6FAF8F3C99754579, 
+0x9B86A61CA2112628, 0x65212B615D8B544E, 0x052ACAB94939F6AF, 0x003A42B79C7427B5, 
+0x0349FBE8C7C3DB0F, 0x2227B53B30B11662, 0x1E207AAF2AFDB94E, 0x7FF8DD4A8C614175, 
+0xF4C67ECB1A84088A, 0x7FEA72A8D089DB08, 0x70A4B3E6FB5EFE87, 0x000C3817AC48FF87, 
+0x765A1607D4B6F746, 0x1B3EF6F2CFB5445A, 0xC1EEDB9B16C2E30D, 0xF483C3FAD17B7465, 
+0x8B4AEEFCEAE921B3, 0x228DAF8598382DA3, 0xF915A8A9A310F24F, 0x0024832203509704, 
+0x19EF26A73693E8E2, 0xB3F5E9CF3A4E8364, 0x98AD1F615763A9A5, 0x94D8141221C11D30, 
+0xB54C22A5E9AFC0D2, 0x24CA85DDAD3EE85D, 0x923F592589B94BB9, 0x001130D0EDBB1151, 
+0xED42A942B22C65F8, 0x7607600653EC6582, 0xC3B00CD4A0640464, 0xC2BF15FD041698DE, 
+0x5BD60D30DF25694E, 0x96C13EC2211E1C8C, 0xB1FA52257C18CA43, 0x0033FEC8FF835648, 
+0x3CB13A4C79A46328, 0x2C370200E2F450F5, 0x0BE23E2520342BDD, 0xAEAB4D23C99E582B, 
+0x4DCFD5F6DCEABE3A, 0xCD1A082067FA8D55, 0xDD75A655009B718A, 0x0012C4D7A6003FAB, 
+0x16FDEFF7E94807D3, 0xE4827BAB77708D93, 0xF0ECDAF125E75E29, 0x88E772967D0528BE, 
+0xF102D5D828762A20, 0xA2975A2355B9BA07, 0xA1BE2C2CEA6B2DA8, 0x003070BE67FC4D13, 
+0x575B6BFC3FBB5374, 0x66C97F6D758898B1, 0x6019BC5F788DCA36, 0x942039B766ECDA9F, 
+0xA86B2B1E8D310008, 0xA4BFAF9AB5038CBD, 0x02DBD25A241194A8, 0x002E524AE64D8119, 
+0x17872068B82093D8, 0xC25DAD23ABD79DB2, 0xB9FFE12CD998CDC8, 0xB2838CBF19F522CD, 
+0xAECDF63975FF49A7, 0x7AA421CA6288B176, 0x99928359158865D7, 0x003D566901E9DAE7, 
+0x68943092F4C28343, 0xDCB44124CCA967AD, 0x03224DCE0887D63F, 0x1708059843A7241F, 
+0x769CFB85F6749C72, 0x3A2D87766E51732E, 0x8E71BC5C3C16483C, 0x001D4D7C33F92E33, 
+0x601D4E7EC0ED2915, 0x6C32C4E6306C69C2, 0x0D3336C175E96155, 0x47BCBA37B780E315, 
+0xC54DF58B58257A77, 0x03A6346C958F9987, 0x9EBBB9069012DFDE, 0x00209CE5462FD8BA, 
+0x0C4CA3B49830933F, 0x98E73751D6347B42, 0x15E0F81E427FFA80, 0x3CF0A44B0BF59701, 
+0x5C14E7E75CFC749F, 0xC74AD0C2BAD84710, 0xF85A6AB9F7D19097, 0x000B7B8A1B02353C, 
+0x889322F542462C28, 0xA513D44FD9E44F85, 0x802CA6419F4AA650, 0x34D0E0C9E3D59A1E, 
+0x423675B5396927CD, 0x4F04697E61BF9B9A, 0xB996C7FAE240083E, 0x001B0C5A0B93D22B, 
+0xD5E58BEC55CC79A9, 0x1CC6F666C82C88E1, 0x21DB41185146A6B5, 0x55669AA817DB8686, 
+0x342DB0CCA47CE7F5, 0xD870C12C901C31A0, 0xD24EB3E4FBCD6100, 0x00009444CD0B6343, 
+0xA29546409BF5051B, 0xF8D79CC96DF33021, 0xE17F8945614CC26E, 0xAAC5D542DC5A79E1, 
+0x3E33ECC0F69C009F, 0x8FB091C855FA7A98, 0xAA41B3794AC0C3BE, 0x00076F5960B9FA0E, 
+0x2BA5B83EF5897A61, 0xCA2E48D768E37933, 0x256D43591A5CEAB2, 0x1ECB78B1C88FB06B, 
+0xFBF1A86765E8D0C6, 0xFED889F7F6D04E83, 0xD97EDA45698265A9, 0x00087AB735DE9254, 
+0x2031D3EEE7EC6066, 0xE94559F1019B37A8, 0x89BF2D01D80C9918, 0x76C144074D86E273, 
+0x9C2E8960585FA090, 0x9E607B9204D7EC9E, 0xBEA76BF0EB455E36, 0x00191B22AC0AF6E1, 
+0xA782434CCAC2E286, 0x63351BBEFC607295, 0xDBFB4EDAB69706E0, 0x9E83E239D6A0F1E0, 
+0x7B3FACE2980651FC, 0xC89794EF2EEBE552, 0x9DC22203EBD60784, 0x000D4519334D7C90, 
+0xECC598C8213DF422, 0x5B730E7B8F0DCA41, 0x38CA1CAA49E4AA2A, 0x225437CB327FA6A7, 
+0x9E6CDC5B0A216126, 0xDD5839028D1C2396, 0x24DE2305B59A977F, 0x0039101C72F23BE5, 
+0x5E0D6E9A1329C085, 0xCE8657C048EB5FAB, 0xE150BAE4BF451D4D, 0xCB3E6D9BB96BB9E4, 
+0x0812AFA34D4F7E69, 0x51C99A3312E534AC, 0x0B9AA9CB733DEB4A, 0x003610C29F276C10, 
+0xD86BB7E6EAB2200B, 0x4566FBD617964E74, 0xFBFADC3602103232, 0xB0DE128A98D0C105, 
+0x171B1A05C4F4AB63, 0xF0B9012E40C95357, 0xDCBFEC8EF59DF076, 0x0027FAB387A5FBAF, 
+0x7A3C41BBF700E00F, 0x4EDF2080D86CFFA7, 0x9803D371A491FF80, 0x63BF95BB52EBE088, 
+0x43D9564C8BD5E337, 0x6BBBA09C7FBD6B54, 0x7D18C00567031D22, 0x003A7DF16E309A80, 
+0x8C7F13438FC65EAB, 0x8C7E4B61A5ABA61E, 0xFB398341780DF7EC, 0xD34E843FD719EE3B, 
+0xD798826E0136A27C, 0x347A84528E03D6D6, 0x5C57F45C4011ED65, 0x001AC8379086A13F, 
+0x0F1914797C20EBCB, 0xB9DF12F7AE8AB7A9, 0xD28FDB81D7F821FE, 0x2D724173DED5E196, 
+0x5BFC9F572E7CFB43, 0x8EF05AA617A4962F, 0xEC27139695C62D1E, 0x00239F12D89B6CEB, 
+0x7E92466D40EC189D, 0x2DF013FC53A71CCE, 0x3503201CD8E7F828, 0x8B59B8EA24394829, 
+0x3263C3FBB8122937, 0x5AEB73E63590CA31, 0xDEBAA1E6E2A708B2, 0x000E6451C9A81710, 
+0x2173B13B5F2FD4DB, 0xBAA15B7C03C36CBC, 0x8A561B4FE8E28D39, 0x6BBDCA27D989B351, 
+0x58B768E414608674, 0x64BA27C4F74CD078, 0x7FE3FA43C9FD70C8, 0x002C4F7B96F9D489, 
+0x7E37EF418366222E, 0x3B0D299BE375FC37, 0xFA4A727F2E3CC56C, 0x1D9D260980C861D0, 
+0x23DB1F04EDF41F7F, 0x2748A2679DB589E3, 0x106951A0BAD2EE5B, 0x002557C6FA11D93D, 
+0x53608FFFE9D8F8DB, 0x545B0D5B95A4CFD8, 0x42458196400A6DAB, 0x6123664C66589D29, 
+0x886AF4369A1054D2, 0x4AE7F7D059E19BF5, 0xEEA5D70B70F40688, 0x001092A6D8BAC17F, 
+0xF1BA834FB62E3408, 0x88D3C6326DBFD782, 0x7D405F3E8F61B380, 0x7F329CFF923FA32C, 
+0x3845F8DF98C44C41, 0xBE85811A254EBC3E, 0x6577BE58CFD4961A, 0x0028B6ABFC1EF30C, 
+0xE3959CE19A2434F1, 0x1D80F66E7D25DB15, 0x61603F72715611FA, 0x2ACD47F2013F2966, 
+0x5C110BCF2CF2B2F2, 0xC5CF0F955647255A, 0x3460E3EE6ED6B592, 0x003775CF48B5BF45, 
+0x49BCF3FBE41278EE, 0x9EEEDD25E297E98B, 0x0A009827EFF7ADE1, 0x80415C8DA0C2D7E9, 
+0x9F5F20DC472ED4E3, 0x922C62FC70B4E0B6, 0x6C697A6FC716C841, 0x00312EF7CF98504B, 
+0x86700E85969C02F7, 0x2FF103937588EB5A, 0x2B69C2EC4A034EC8, 0x939A0DAF472B56C5, 
+0x55ED251637B6C9D3, 0xF7E70EE426D53E1D, 0x83CA0EEA6DFEF9CB, 0x001008F596198D38, 
+0xFC2FDCCDD347E2F9, 0x90445221B42AEA9D, 0xC0D7E2070CCE2E36, 0xDAF7D1F42F9668D9, 
+0x694FC45BC199F7D2, 0xFC0803ABBE5C5ADB, 0xB6EFC574CB66A045, 0x001C4BA24A7FEC8A, 
+0x97688A9BB9A890D2, 0xB4A1C52131EA4380, 0xCE7110D442C1F1B2, 0xF4A6417CBAA89B15, 
+0xC2E64B8B8554FD63, 0xD2BB6F0D27A51279, 0x90F5A39BF7252AFB, 0x0023912D87D2060D, 
+0x4192CB5805485346, 0xF0435B1BCC93D024, 0xBF30DE0FC3CC3CED, 0x6A5DB6B24BFF11EB, 
+0x8795120D3569DEFC, 0xBF3785758E5D71DE, 0x5AE0196DCE90E9C9, 0x002D8F3115637A1C, 
+0x943A8816FA823C2D, 0x0EA7287250335513, 0x6BE93822B3C7155E, 0x4EE630786FABE51A, 
+0x13CF20F747413E55, 0x9CEDA9DC1099298E, 0x045C99AE7D06FFD8, 0x00106F1AFA070925, 
+0xF09CA994F6E76D0B, 0x6226AA32ECF86562, 0x0FE4F9BFEBFD1640, 0x78C0FC55981F60E2, 
+0x1BDD51BF7B672A0D, 0x059185442A8CE735, 0xA2F2C17A78D9007F, 0x001DB11428FA7A7C, 
+0xF82F50C8F7AFE827, 0xFBFCD8F3F8BCEB37, 0x2D71908B45472E18, 0x875BD87FFC8A57D6, 
+0xD37EF71C7DEDFC3D, 0xF4F72872D66429E0, 0x6C3F3A5140E8FC68, 0x002D2CD44064D88F, 
+0x6BF94804AE8270CC, 0x20094F59A60D279F, 0xEC035DE2200E2C7F, 0x4FBA245263560556, 
+0xEDB19FC1E42B3221, 0xE54EA7EF31764777, 0xB0F33BCCA7238F5A, 0x0003E976170ED317, 
+0x7C4A0A07A155FD1F, 0x306E1538C0242585, 0x7A420A47BD8ED607, 0x97750EDE7873A8E1, 
+0x87A45A15EC58B080, 0xC954B8493A8C9250, 0x838CAF829E6489D6, 0x0013E207C01A3A7D, 
+0xCA307A5BF46DFADD, 0x307EF03CFF714268, 0x691DED32C3C2F32D, 0xC84631B37A97AB4A, 
+0xA067D6E95EABE437, 0x154F821B9ADA19C2, 0x97EEBD17C511C6B5, 0x000EF06FED4ED8E7, 
+0xC19CDB24D313941B, 0x02D3AE2A201218F4, 0x1610BA1829B7B373, 0x72AE2F5C46522393, 
+0x1196C7CE8F65D2A6, 0xAEE85B782F2817F4, 0x3AAA2539918F3560, 0x000659CAB26D38E0, 
+0x8EEE2AE5A8394758, 0x70A3BCB5D4E5259B, 0x9B65DB3494958EFE, 0xA506A6DD65B6418D, 
+0xCDBA56004DF0584A, 0xF2E1D3B9E7386780, 0x21AEA51F38F9F431, 0x00276DC2725C85F4, 
+0xA1AF0B54E0EAD102, 0x2E4D5796CCC3E71B, 0x77F0A897200E69E2, 0xCFA62278C93EC064, 
+0x2295805817B0EDBE, 0xC7EFE14A90C2212E, 0x01D42DE6B902CB8B, 0x001ACB7DFD2928D2, 
+0x4FADE0163194F267, 0x8ED7AFF0B060FBC6, 0xB6081B8097FB9279, 0x39AF6F1A1D0AB651, 
+0x504EBB3E3FADE606, 0x1A2891430E9514C1, 0x06290E1A71D17A22, 0x0033A400DEAF20F5, 
+0x97FA9C8AB61FC7F0, 0xB4DC8C93DA9989D1, 0x1C6B25116346B5CD, 0xE16767B60E121C9A, 
+0xB27233BAA2BE3BDF, 0x8B4BE27BA432EE95, 0x79826056BDEFF95A, 0x0029A1F632906F8F, 
+0x15F4C9452E757C87, 0xCD4981A99BDA2718, 0xE22FF89D97FA1BBA, 0x86F2F5AEB99388D5, 
+0xC96A62C339F58E72, 0x13D6FC99375E12D1, 0x2C4272B016CB6364, 0x00245C78BDE10912, 
+0x24D9523B3E5FE99A, 0xDA527210502E0C8F, 0x211E89D394068455, 0xAE905108FEA1A1EA, 
+0x71DB42854445D45C, 0x7F413C71DA2A6A66, 0x35A7E8991A99D6CE, 0x0035D6C549429AE8, 
+0x77E167BB80288E68, 0x47B99C1AE625A8DA, 0x4B51274BF122092D, 0x330C9E29BCF8B010, 
+0x7613D923B9A304BB, 0x82D856F5FA08385B, 0x06BBC27925C758B7, 0x001D583B70259D9D, 
+0xE891FD69AB1BF9F7, 0x7718F78EC1BECB94, 0xE6D88FEED3D1D496, 0x20DDBC4BFA415D4D, 
+0x9BC251937141F681, 0x2F32C93CDA38F97D, 0xDDF3FBA16505A2E0, 0x000218AB2DF290ED, 
+0xC503080A1856C97F, 0x27308963689FF35D, 0x2012868D9DCC791A, 0x3F32E744235756A8, 
+0x163D6205D4EA3ECF, 0xF3A5FC8E295BA456, 0x61031040A937E4FB, 0x00250619F455A9C0, 
+0x4B5842CD6E462B56, 0xB781BDF6281BEB8B, 0x6B385AA2E9431B1C, 0x3ED66FE6D40048EB, 
+0x30553658A2385F2F, 0xEAAFFA9CE635CD36, 0xC2DB3E9E9A4858EE, 0x003F2D6024DA8616, 
+0xB27C8CCCC3E4938E, 0xED820FB5C74332D9, 0x9C358F8DB57BB403, 0x592377D463C8855E, 
+0x68C64728245C78BA, 0xDC1862A6821F0044, 0x3D38BFAB02F3DE7C, 0x003BDDE4FA623D29, 
+0x233DC9E597985FEA, 0xB46A8C38F2D4FCB7, 0xDA0E8A3FF2B31A89, 0x9A9E6933EB67E517, 
+0x18E71B93C1D58777, 0x80FF35FC9ED8819A, 0x9D0B29E210F073BB, 0x000A3B2FB896DD77, 
+0xD216CC0EE2311CBE, 0x8538B7717692F51D, 0x8724A6C4714AF815, 0x6151E3104DE56684, 
+0x299427C5513F1941, 0xA26AE3298B85EE33, 0x15B9743CD6048443, 0x001EDF974C4B63F9, 
+0x1134B2970CD984EF, 0x1425A189CC691BAD, 0x7BF0E495C1C0EBD7, 0xA8B679A51A49E602, 
+0xA24967BE7F92A649, 0xA774A30D677A18BF, 0x58491693E0E58485, 0x0017604044365880, 
+0x64E88044EBB88B23, 0x10C87FFAD67176DB, 0x53F3BA6F78B7CA84, 0xA99565848F7124A1, 
+0x5585A10D0BAB48F4, 0x736713AD80B00EB0, 0x94911809B0080872, 0x000ECB47B66DFFC5, 
+0xDD378ECC65745E8E, 0x6BCF4B51925A771D, 0x37B19F974503B2CF, 0x73F8CA99C2D9801C, 
+0x644055C3339676DD, 0xBB0A289407C1B901, 0x44BF5BBF24A45854, 0x0037AC56D322CC8D, 
+0xD47F657415154D7C, 0x56B063CDA1A1CAE6, 0x2558DA276AB3A406, 0x4D07ED29205BE4DB, 
+0x58EFF18B97FA439F, 0x89719371A89283F2, 0x32858D167F9CFD92, 0x002E7AB267E0CEFD, 
+0xBD8DFA8181027AE9, 0x32F528F4114FD870, 0x87094881635424F6, 0xE7026A948FFCC93B, 
+0xF8C0E84DE468EEB3, 0xB1AD5EE51B49AF37, 0xEE604C703D32BBFA, 0x003B516AAB0DDB1D, 
+0x0A25A346A3301797, 0xE1B77B25EA20DFB9, 0x0A04202860E38165, 0x434AE3121E44DD7F, 
+0x35F398239EA9118A, 0x2711FA4F21BF83A6, 0x4D2595E4720C6D61, 0x000C7236B2948A8D, 
+0x4C310A0C3FDD84A3, 0x98ED8E800FF0B149, 0x35CFA60368753916, 0x0E04C1609E449FAD, 
+0x81FC8A73B5307B6F, 0xA4E371DBD2C4F991, 0xDA94D0FCC8E95A7D, 0x0021F1A04A7440A8, 
+0x9119605730123BA4, 0x7B43E70592106723, 0x443C6BECD926BE05, 0x770117A29D59E6B9, 
+0x2E00DDB29F1E15CE, 0xE86034488A97B1CB, 0xE62017231D32928F, 0x000E5A47626550DD, 
+0x9E772544018C050B, 0x70A2B6F36C8651B3, 0xED775FF9D8F8EB51, 0x3F7ECFE3FE2AAC55, 
+0x007FB18C39488E2A, 0x00EECAC070757CCE, 0x2A9D077C6D56BCED, 0x0013EB2AF50E5DD5, 
+0x9B1767B1DDE61356, 0xA1BD181E829B3AEB, 0x5D710B8125731012, 0xFC10274A7CC298E1, 
+0xA820B64B7B13E6DC, 0xB666B02F39DFC37A, 0xE6E89315C6056F5E, 0x0018C828F09BD12C, 
+0xFFFFFFFFFFFFFC06, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xF7FFFFFFFFFFFFFF, 
+0xAF3D416B7B3314EB, 0xCA33593B14FFCA31, 0xD5784EF6BFC5638D, 0x00196B467B71C4CA, 
+0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 
+0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 
+0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 
+0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 
+0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 
+0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000
+};
+
+// x-coordinates {x([2^i]QB), i = 0,...,OBOB_BITS-2}, which lie in GF(p), in affine Montgomery representation
+const uint64_t B_fixed_base[(OBOB_BITS-1)*NWORDS64_FIELD] = { 
+0x2E3457A12B429261, 0x311F94E89627DCF8, 0x5B71C98FD1DB73F6, 0x3671DB7DCFC21541, 
+0xB6D1484C9FE0CF4F, 0x19CD110717356E35, 0xF4F9FB00AC9919DF, 0x0035BC124D38A70B, 
+0x5FF732DC5C9F8074, 0x8341E438ED48C045, 0xF7C17E9C88904EAD, 0xEC2FAFDF8851A017, 
+0x808ABDBCA11A418F, 0x1CC9777C0D5547B0, 0xEDD6AC1656F7C759, 0x002DBB048DB65C02, 
+0x7D0B45EFF5A5F98F, 0x67C4CADB9384F887, 0xC4DF5DC70E406523, 0x9B6A30E80570CFCB, 
+0x422D0DFE05F5894F, 0x82E90B7D522321FE, 0xACB26C9E3D10ADD6, 0x004057D6AF77C41B, 
+0x961644611F783B8F, 0xFBE0A74E36D98624, 0x4AC0FD66154DCABB, 0x775C80D5BA1355A9, 
+0x08653570DC381C6F, 0x5551D1C6B3D36D9D, 0x77AC8BDC50742498, 0x002A06B843120296, 
+0x2E094D539227824D, 0xC0E5744453A7C122, 0xD2479ADC240A6D5B, 0x47AD855E8AE4D1AF, 
+0xDCDC5FC21F8280F4, 0x1A876B06EFD16401, 0x29B68EC0EAA2C25A, 0x001433324AD30CFF, 
+0x7B123F50E45A8CDF, 0x27850F4A82F17D3C, 0xCCB04DA20D28A523, 0x74444C33E9423F86, 
+0xDBCB430C7A88143E, 0x9F1E8118BBFC2FF9, 0x675C73D1C6A14D88, 0x0012E5EECE618A7C, 
+0x45F24B59909B3533, 0x452D5BEAB376A1B4, 0x7719D1E8E42FAB99, 0x00CF61F0B196A43D, 
+0x81A5A94EB2704E06, 0xF41F1B2EC5DC3CFA, 0x3F1EDD1BCF1EB772, 0x002DCC930794315D, 
+0x96406E40BC275E27, 0x1B2E0A94BA714DCA, 0x080385201764E876, 0xA535613039D9159D, 
+0xFB964250428B88BA, 0x68B9166BEF801377, 0x1EC3E34FD5FEDAEC, 0x000A4698CCDA17AD, 
+0x55B7EB1C06A0E248, 0xA2354B60D0542C4A, 0x9CD29952A759A7E3, 0x5B4BEAA8CEAD7723, 
+0x0A9AEDB02B34C59A, 0xA89C54F8A18985C3, 0x1BF3524E692212C5, 0x00033EE1F44EE7FB, 
+0x86522610CEE88F49, 0xA762903FC3380ED1, 0x5822DAD483C4E94A, 0xF3A40597270706DE, 
+0x85B15A2DDD9383C5, 0xB357BA58A49638BD, 0xEDAADCBBB4BC5054, 0x003E2A8A5ADF0973, 
+0xEE8232B9CCB17E18, 0x3B3F24752CD9560F, 0x00B07153DAB186FC, 0xD0FCF39B1C2188F3, 
+0xB6344291EC2969DA, 0xE70C9922E82266E4, 0x7C44D978B140ED1E, 0x000CEB78579550F2, 
+0x206CB0C395E20F39, 0x77E731B1E710F86D, 0xE6D84260094F3A42, 0xA0405608B7758382, 
+0x10CE19E3D7E5BD56, 0xEE58FA3852EEB6F6, 0x853D95D83107E9FE, 0x001C3E1B6E466D60, 
+0x6A34A7BCFDAB0CE0, 0xFFEF1837968C194D, 0x4701DA71EABF4935, 0xE4685E3D89509748, 
+0x21197CB5B2447486, 0x013D0E278A639FE1, 0xAE12C14BA1171F86, 0x001CACAD605BB8AD, 
+0x602C957C9C8CED00, 0xD807F2E3CCB92945, 0x43F3B5D94E3C4617, 0x0BD50BB15A9DC93F, 
+0xCDCAC362AC2E8C71, 0x198A053142D088F7, 0x2722653E3D1E0F6D, 0x00144C420FEF8888, 
+0x4C71BC46849BFB46, 0xEB13F0881F0C6A73, 0x1C8FDE62BEC4B630, 0x91B180AAB458E72D, 
+0x114DB42E63DC224C, 0x1983A4351127DCD8, 0x59E84BFDB6F0820B, 0x003ECC5940089909, 
+0x15DF9DFCD1A17972, 0x6C5285882FD98D32, 0x7ECC8E002848FA67, 0x51862B46C05E81FD, 
+0x63789D412CE9B27C, 0x45C48605D2ECD6E9, 0xB320E1F1667164F7, 0x0035C43BF4E31F67, 
+0x912A65ABF03C988A, 0x90BC131A983603DD, 0x0BDC67780E8CBD53, 0x65D9F888591D0F46, 
+0x7BD764ABD1D094F5, 0x53D428056323A452, 0xA774B0999D748A9F, 0x0031FE71C599B9A9, 
+0xB6F2F296D3A31FA8, 0x838F694210611402, 0xA38CA9795BC21BA3, 0x6AC44A55D9AF7CAB, 
+0x09BEE19D151620C1, 0x3DC1E50D4357DFAD, 0x7950AF671ECA89F1, 0x003E6D1ECA6F3BB7, 
+0x83BB429725F6457A, 0xC8983F056D3E59C7, 0x65121EE1C71A6CF8, 0x782ADD479979D71A, 
+0x4238A4EA7AAA1DD1, 0x562EEFE7BECDE956, 0xE3EED6EBC437EDC6, 0x00303D99DCE702A6, 
+0x01E781FBBAF5772E, 0xE26F78E01A1A9828, 0x0BE96959BE098F48, 0x96369496133DEF9B, 
+0x5A7EA4378E3B369E, 0xF9CB5CF1BFDB8E66, 0xBC3A3402F1ED59B6, 0x003CDD5355ED2237, 
+0x3440110448994E63, 0x9134EF34593237E1, 0x62713AC29404AB6F, 0xD17734A1DB809F7C, 
+0xA02A93FC4792D930, 0x74550E5998324844, 0xE77309F146926701, 0x003BA83C7FADD443, 
+0xB7C3CA121355409E, 0x397378D54C01CF35, 0x8D5564DC0A6E8D3E, 0xCD162473E3C7C075, 
+0x2EB3E463DFEDC4F4, 0x3DB87FACB1AED31E, 0xA562B8C45EA74461, 0x0028A5FF8744602F, 
+0xBCBB1208F1C0E9EB, 0x972BE5FF699DEFD5, 0xEEB12031A5FF3F69, 0x2003768687B9896E, 
+0x8F45C7BC7C572963, 0x5C4E58A9F00BC523, 0xB5F357B659CC6966, 0x00018260485F433E, 
+0x95A327CF209DDAE6, 0xC419791DF349E21B, 0xDE87FA17ACCC05CC, 0x4C5B4D19761A7A11, 
+0xABD86789D0A8F0AC, 0xCF4A97E0EFFB6C0F, 0x5B7EC7B3F5895588, 0x003A087A0F076169, 
+0x2ABC8CB20D6EDC6E, 0xF89A6D79F35DA244, 0x5DB2CF0944F9278F, 0x00354987F6197418, 
+0x5745F03ED26B6BAE, 0xCAAAF439426F2B7B, 0x2E9663B48D6D3902, 0x002EBFE7E9182B33, 
+0x7B9C736E4EB0A188, 0xAE68AFF878DD0146, 0x858980F31140E5A2, 0xE39D11D9FD9A561A, 
+0xB6FAE06B30B2432E, 0x6B9F44906D9E56BB, 0xDFA91836973B8B6E, 0x003D20942862797E, 
+0x09EFA4ACE389200C, 0x0A8F7B5D6331D5A7, 0x70333F26077D3CB9, 0xEE4A2FD88C23AE5E, 
+0x02521A34318283D2, 0xD43F9646474AC2CE, 0xA437A852621CD1CB, 0x0015E2ADA2E1AB55, 
+0x3350883F69CA8D30, 0x60FF394BE091905E, 0x32AD7C0ED0BC9BB8, 0x659A75113CFF537C, 
+0x9D98BDCE01FFD958, 0xC5DF731C543013D6, 0x57C76E62E23CD457, 0x002E4F4B49027458, 
+0xF9ADB97DFDA93AE0, 0x8B49000636762D11, 0x99F3F0BA9CF08D42, 0x13B23AFA60FCB3AA, 
+0x073D16FD02F5C9DF, 0x806908D3F8889E21, 0x254D05D080559CEF, 0x0023E6D3EC140F96, 
+0xDEC37AE0D176BE78, 0xBA56D2E01868B3B8, 0xE5F9E505480825F5, 0xEFE6BF758BF8A9DD, 
+0x67FB24BE20B5D761, 0xD157EBD6D6B00E40, 0x178EA6DEEDC14405, 0x0015ECF975C1ACF3, 
+0x96E2C24C9C4A0FB1, 0x88F34C1E220657A9, 0x8170993E8EE329F3, 0x09A8113B75DE4047, 
+0xCFE514AC127628FE, 0x30E2B766472E1F19, 0x6C896D1D865A3C79, 0x002F7C1489AD26BC, 
+0xB9B14D91650E3B9A, 0x0E25992FCD03CAD2, 0x962192762883B508, 0x26C8895A85A23EB1, 
+0xF7328F3A639B7003, 0x9636886CB097BFBF, 0xEAAD56620E88B21B, 0x00357C7B58BC4818, 
+0xE45A4570CF9DBF75, 0xAD13B70F1F40328F, 0x0223EEC3FBA6B5DD, 0xA47131C6120FE23D, 
+0xCFA8FA58FF79FB98, 0x9B853D3D0A711A45, 0x6B25717EE870B0E1, 0x000D23B1C3BB81EB, 
+0x00894EB8D9766670, 0x02E7DF909ACA51E9, 0x32DC32084D71E9AF, 0xB5293C972137801F, 
+0xF92EF7763C54148A, 0x603F39CD2582E460, 0x9724447C8DDC10D3, 0x002095A415240CAA, 
+0x8E520BA393CF6F40, 0xCBA3379F07DDE9E5, 0x2419D54D1C788D3E, 0x715803144021E357, 
+0xC35AEBC221416B34, 0x7FCE8EBB144149C2, 0x3F567361C7232BCA, 0x002A1B3B9B40A314, 
+0x466251429FAE682E, 0xB8BE0E975DA3A584, 0xEAAA6663A3184614, 0x8ED426B7A60FE131, 
+0xD8190FD3680C093E, 0x4D023CFA4C00B24F, 0x3F58E17659A9D54F, 0x00342BECE93DB8C6, 
+0xACE5B815308DCAB1, 0xC83C68612FF7AD3B, 0x204C0A3BB1811AA7, 0xF34FABC147D3478C, 
+0x1BBB6CE12B1C7347, 0x2BAFC88E464568B2, 0xDE93A27875316656, 0x00144AF3AB4C9CE0, 
+0x9E14B9AED188CFF8, 0x6060519C4DB978C6, 0x6D20F2415FE64EF9, 0xA21A3FA93C94AD83, 
+0xA09374AA2D93CA72, 0x9877F12109AFEBAD, 0x8E92EA850B9481DD, 0x000980EB744A6E4E, 
+0x94C4985CFB628013, 0xE7504E3F9257A2F9, 0x777376A3C179C3D0, 0xD9A7034DB62E5A7F, 
+0x2FBEEB51D3A868FE, 0x9400BDFD400D48B8, 0xAE432898E6D1F025, 0x00304E1BAB9BB293, 
+0x1EC4AD562565AD32, 0x68A5074C053C0B5C, 0x7EB9195238250C22, 0xA51E6068AD245998, 
+0xC94866B441BE7A5C, 0x0DE05E4214F5B881, 0x1E15862A11CD171E, 0x000AFC0A472A220A, 
+0x53B4398C2069A1E9, 0xDDA9CF93F1D8ED81, 0x111CD6EFF00E4AE4, 0xAB2CD850A78B7291, 
+0x435577773F2C137C, 0xE3D9E8541BE25336, 0x92515ECE2F073D26, 0x0031CEE040A6D20F, 
+0x6F94C8FAFE1AF745, 0x6CCE05FC6F5656A9, 0xA1107E8368F7128E, 0x069AF61CF494E264, 
+0x409C2A4442FFF034, 0xE6D0B2A0738641B6, 0x56253B5CD87D11D0, 0x0010600FDD8DC21B, 
+0xA8C74B8C83576AE6, 0xDF3D5EB78FA32663, 0xBF993A8AEA7CE956, 0xE7CFCF9A8F597060, 
+0xD4EBC2757E9D5CA1, 0x3B88EBF73971F28F, 0x2C6B7B7C3CAB4D4C, 0x003702445C422FCD, 
+0x7B1F71AE06BB808D, 0xE657243067867980, 0x2CD27C1268DEBBCE, 0xD6E687292D970209, 
+0xE93291F7BF44CD6C, 0x7E6FBF3F3F46A069, 0x40FF2CC8E8A2A6AF, 0x003C5BFACC8B8478, 
+0x65E21B0439516168, 0xB375C4EBA3A27563, 0xF43CBA1DAB514C99, 0x418FDE17F64E3E48, 
+0xE60BCD719CA62067, 0xE6E9D5C290EE384C, 0x933B0A51F9F9A5EF, 0x003EB06F76D2E651, 
+0xB8311007454AF65F, 0x0417E4C793C69DF9, 0xC60189666C96E766, 0xEF08D9E8644F7420, 
+0x475401A9B74331C3, 0x4019C45EB2920993, 0x1836C140827957EC, 0x00198B9F656C6245, 
+0x44394610524E6ED6, 0x636C16A015BDDF8C, 0x5FA8AD760B51D871, 0xAAB82DD23C6252C9, 
+0xCC1516C200C44A5F, 0x73CCAE7DD72E4303, 0x02C307290220B380, 0x00126791899670E5, 
+0xEBAB5FFA4D97DF95, 0x1380EE35EA2B4408, 0x142BB27902DF5A16, 0xFF837C07EADCC2D9, 
+0xE7E6F54048CD2A05, 0x1BBEBD345E306C0F, 0xA46B985A224BE93E, 0x000C73DB628EDFE3, 
+0x091C3602BE78B9BF, 0x4CB8A9F3A2CDF0B8, 0xCEBF2C3F8E137580, 0x7D7D9E1D3B0E94A8, 
+0x32C5EB2739E146E1, 0x110A7A076B531707, 0x8AB631FF9BB0AF5F, 0x0025F69E9E08EFE3, 
+0x1A64E2A442561354, 0x4D730EEB3198C431, 0x8AE79356FA8DCE88, 0xA00397BD05456B89, 
+0xD894089840075199, 0x3DAEE38D1085B671, 0x390CC282F39BD976, 0x0014EB74761E641F, 
+0x3F3305DF21633EAF, 0x6FA727884CBCFE4F, 0x19A7082D9EE01883, 0x2A8C2C6384270B8E, 
+0xD793C9285C714D9E, 0x291C09B25D0EBC9A, 0xC93893BE9331245E, 0x0032EE512FE93B25, 
+0x548586BD9C5C4967, 0xC84CAF55204F08CD, 0xF3972226ABD95EB2, 0x98CB71BCBCE5DA51, 
+0x18CC11B914433FEC, 0x6E72647ECBB5A86E, 0xA11C2FE17E41E69F, 0x002018B4436C6BF5, 
+0x7FF1BEE50AD161F2, 0x34A53D3047289596, 0x9C5D23281D2AE637, 0x6275CC17EB3C87A5, 
+0xB039D71E9443B60C, 0xFDE025124C68D250, 0x6E06B95CBF54B153, 0x0016FB2AD490C49A, 
+0xC1C1A9C8982EF6CD, 0x78DF9CF2F601DF40, 0x6DB10989A3DC9208, 0xD16F2BD54A7AF94B, 
+0xF67F767AB140858C, 0x2F8398B288C362B1, 0xA21F78FBEF9E27B0, 0x000E288B6F83CDA3, 
+0x7B9E63612D7BF22A, 0x587754ACCA18D0A5, 0x5186B61EE3BC3818, 0xF61321B5F915A958, 
+0x4983FAB259787AB8, 0xD7F3A8AFAB6748F4, 0xDF86D20DDF38D6A4, 0x002A75BBFBF5238C, 
+0x5B217709D5419A34, 0xE1C61C1AC3128E12, 0x7E02691F789DCA2E, 0xD22BD8C96305924F, 
+0xB7C0E80402FC9E7F, 0x2F54966FD57B63C4, 0x4F06406B27BF5AE1, 0x000180CBC7365526, 
+0xC8D49493E25919F9, 0xE252510B9B0E6BD8, 0x094EDD956D4D7615, 0x27145D00D42022AB, 
+0x4F6A0B23D7F42ED4, 0x655B241FE3A5E256, 0xBB981CEDA658EFB2, 0x002A400116C825AA, 
+0x08686D73CA09237D, 0x221CD85715A2FD9F, 0xE326FA7A7306BA66, 0x9E8217A1DB6B9710, 
+0x9B15752F278FA95D, 0x9E38823710F2F0B6, 0x9C81D89C2724EF3F, 0x000E016D780FE897, 
+0x0A7AF747241D4819, 0x998395F665EBA1ED, 0xA3486EBB8FB349D0, 0xD1C36CECC83299E6, 
+0xBE18F67BAD99C195, 0x3E5A1ABF68F7F2CE, 0xABD949721CDFDB26, 0x0036842EFF9B132B, 
+0xEDF80BF9712CF67D, 0x1CDD381465D06698, 0x6C334B3AF08B3D23, 0x380E8DFECA9A9E1A, 
+0x0012588BC85A9DD8, 0xF43529FE48AC31BE, 0xCE3E94F40569F836, 0x0011F3B9AC3016DC, 
+0xFC40ACBCD357F77D, 0x9B8E43EB5D973C21, 0x15DF9545581C04DD, 0xB5FBC3B77B1FE595, 
+0xEBB52A4138B983F3, 0xB2AF7AD96FA3804F, 0x3D73CCB8179A4A2C, 0x002CDB24EF9D06F4, 
+0x9985D2D9467172A7, 0x5D9B1AF04BDB8393, 0x31625268330092BF, 0xE53B9CBBCAAC2778, 
+0x62C7BE66BAC12B92, 0x7510DC9555026342, 0x3E8CF980CE803AA0, 0x002EC3CCDEF13110, 
+0x7DE6B9968F980C42, 0x7AFFC4201BE8F16D, 0x6CD9135D61B63434, 0x0F80974034E30402, 
+0x8AE45243CBFAFC8F, 0x259331834C7139D0, 0x7D541FBC0E714B9B, 0x002BFF63D0605B36, 
+0x4BCE5BFCB28BB0E9, 0xBBAF7470D87CC5CA, 0x2B2BF4195C23FBC1, 0x0A2921C640F42CFF, 
+0x20256F56282EFF86, 0x50803F96C9F24096, 0xEF8703027781F116, 0x0022A63408D7CB44, 
+0x602BD41C3D160989, 0xD6EC06C4D289EEA1, 0x89DDECA42400E53A, 0x12A5D6407F1DC144, 
+0xD62B290424E30AFF, 0x68AA7467FD85B5ED, 0x8E0A192909C7F2B9, 0x002C33F04799A184, 
+0x279A4B158404A15D, 0x98A6AF6142454236, 0x80C436067F811C5B, 0x033013315D406DBB, 
+0x24670E15B00CD44F, 0xADAC04D6CE186B8C, 0xF9E53670074B5D3C, 0x00188C48BC1F740A, 
+0xDE462A10107AE584, 0xDD9A8838ED4E7517, 0xCE51A30951EB4C73, 0x82D98BF27F85A3C6, 
+0x03D7BD7359C747F7, 0x0A949C4764DE608E, 0xB2EC5EE1697AF816, 0x0002126585EF6B3D, 
+0xD984B1A6D2EA8EAD, 0xA9CAE64844ED88F6, 0x9A0424494D4296FF, 0x55B0698E1C73AE7D, 
+0x4005966C21F17CAB, 0x411D4CB45DAFA8EB, 0x554DEE536601B904, 0x0028474284252925, 
+0xB4285E3F442B6D56, 0x3327850491DF3EED, 0xBDCC828C1B4478D1, 0xB197C0465E36E5E0, 
+0x7DD13CD29051FDEF, 0xF9940ED719AEE268, 0xB727A45F12858ECB, 0x0015187B6EBB0C44, 
+0xB632A66395C0A910, 0xFADCA0B4BF485A7A, 0xE5F2EF87EAECFA5F, 0x5C43B7686F420684, 
+0x7CB84B166BDA295B, 0x05CCE9D2762BA800, 0x8681935D4267F09C, 0x002C13AA0A6C8CED, 
+0xF3BA1C6655359AA6, 0x6F5F22D411A8F4AB, 0x59521EBB8E932458, 0x5980AFFE94ACBB34, 
+0x03807CB03DD118A5, 0x8D10B390D066CAAD, 0xEF4FE4761DEED7C9, 0x001E93315E5A9F1E, 
+0xCD2357F3AC481854, 0x81BAD5D6330F498D, 0xC2C26A0DF9355607, 0xBC57F378FEF92C8A, 
+0xADA1D919144CFA90, 0xA64F078897B1BE23, 0xE6274F9AC918B8A0, 0x000F7DF68E0BF45B, 
+0x3F0BEDE8E202810C, 0xACBF03321366ABAC, 0x444D52702466E94F, 0xDC387775D1FA7A16, 
+0x5EA76E436BD8506B, 0xDEE3971A31DAD06C, 0xC05F9D71F9555138, 0x000A6615DB677D82, 
+0x2E07FFD7D3012092, 0x2A4DCA2BCC770AE8, 0xEBBA33E324672C81, 0x51DD12644FD1819B, 
+0x9D644C395D71FCDD, 0x06833A82C5947CDC, 0x0F99EAC4C247CAC0, 0x0013D77F628164F3, 
+0x61203A1D0917414F, 0x89B36BF6E7ADBA7B, 0x9DE032348B24F40B, 0xC3F6E5D00C381F9A, 
+0xF276BDA920E6574D, 0x4840F73891AF8E33, 0xBE2AD34608EC0418, 0x0008F276264E8DD1, 
+0x166D9413851858F2, 0x0C6F8863708556D6, 0xB6323AA25D0BD884, 0xC87044A801020CDD, 
+0xBFF133D0B402D3CC, 0x8E28F5B53C169E09, 0x0DC0490C3F44E75E, 0x00094C8FE740AF6F, 
+0xB1B6AC0E02CFA738, 0x5E4A7BC24C46EAEA, 0xE1D9BCCCC511D492, 0x7755A4F98B1AB1C9, 
+0x622A7680062B8F29, 0x28E332B259EF3634, 0xA19F27AD4CC9792A, 0x003F546BAC04AA22, 
+0x840E9DAD1BB47B05, 0x4CDFC42C0A4856D0, 0x78DBB8A2B3D8584D, 0x3772335CB3E6598F, 
+0xE5DA5F9A6B61B451, 0x00594AC631A6875D, 0x4AF891AA5F78C207, 0x002CC466699E39CB, 
+0x2232E09BEDEEFECB, 0xD3538F4F742A9BAA, 0xA255CAF3E5868A24, 0xD8C09763235D3F78, 
+0x334395417F815B1B, 0x6F337D95963BF4E7, 0x8E1CF5C7A1D5E0C9, 0x001295860EBCD1C6, 
+0xB52078C24D38B4F2, 0x39FA3F522C81654D, 0x871646C21BE07EC9, 0xCD807DCA86CC5FD2, 
+0x4B1C1762882C77ED, 0x1B3DFFEF856D63AC, 0xE16ECE597BA48638, 0x0022506EFB53C6BA, 
+0x17F45E74738FBBBA, 0x4067D2BE13ABA6F1, 0xAD1A1BC35D26B2DD, 0x455B4532F11B1C42, 
+0x039129973E1DA917, 0xEEFE940096466196, 0xFB778FBDA7D23523, 0x002FC0B117728BE9, 
+0x778363A74ADCF180, 0xCB626166D039055A, 0x98ADF304E55E3595, 0x6B4D428BC5E10450, 
+0x693086AB46F58963, 0x420BA8AF2B3DB3C3, 0xA851B057846B6022, 0x000D398FD0FD52DD, 
+0xCA7D782FC4C7B4B7, 0x6575989E8BECF99B, 0x7207A6900E94DF90, 0xE47393D929AE655D, 
+0xDB4182F56DAA3D96, 0xB462F3B934B79AF7, 0xB83DCCE4ACF063FC, 0x00233EC238A7CD3C, 
+0xBB4F467136B5A32E, 0xA166177DC8816A45, 0xFC41450B54D29E2B, 0xE95A5860043E0D2C, 
+0x01169FC56155D64F, 0xEF81BCC28C90C378, 0x353B8C85284B09CA, 0x0030A006C77983B2, 
+0x70012EEC675D19B0, 0xE93E9B3320FDB96E, 0xCC2967108A5CDDD8, 0xEE930BD6C73D46AE, 
+0xA8D97E7310F1DC7C, 0xFEE9A877EA2A336D, 0x68D47EF972913AD8, 0x0012D5B1E7F96241, 
+0x7E8FFE72164A02AD, 0x699AB0FCCD26FE84, 0x823A716BBDE96FA1, 0x1908AC0B1F550C5A, 
+0x9852E814BE6D788D, 0x942ECB2C80E10AE1, 0xF07E15B438694362, 0x00055AE1AA4866D8, 
+0x035BFBCD0295571C, 0x9BB1FC2C548BD750, 0x00613968DF120084, 0x73141DD3447D71AD, 
+0xDA381BD9A8FDBB25, 0x58115B31594F5942, 0xA2E2D770E469EF02, 0x0001F68C59BE551A, 
+0x4BA1FA9C50141937, 0xE66E05D8F927D46E, 0x57CCF9FCD302C376, 0x37A93D8C45206CAD, 
+0x08F68AEA4523D291, 0x3F274EA4560193C2, 0xE65BD7AD7860E4DA, 0x0005EF2934636A4E, 
+0x14C6B5A8B4FDF9AB, 0x6C0A771F9A48DB84, 0xEFD3AC61BF863627, 0x96ED9B4FA54B59EC, 
+0xDA82EECF213B9BA9, 0xE967C47479329433, 0xD937552E13F2187F, 0x0028E75D0B23A86D, 
+0x8B04BF2D8FEAFF53, 0x6829633D814AC42A, 0xAC79CCE536B25233, 0x54B282B43C61990E, 
+0xA10C8EF41F642484, 0x59947ED17872512B, 0x3742A8D43A508052, 0x0031E167328EC529, 
+0x71D529347357B6D5, 0x695D723AD084BA5A, 0x8D2166B1AED4B60B, 0x6257C624CF14977B, 
+0x6CEBD29EEBCD9BA4, 0x5AF5E54BBFD81032, 0x7874AD6408DEEAD0, 0x0030E022A4E2E767, 
+0xAFD17E4284AD53DD, 0x23026273F7E87A8B, 0x8111F1DBAAEE0C93, 0xCCB1B2AD364231DC, 
+0x7AB10CA2A2C76022, 0xBE1602931D1C8181, 0x540462C6ACD56F92, 0x003A83A97878E1A5, 
+0xDEFFBADD326AE6BA, 0x04BAAE1D8E63EC56, 0xD11F8C71B905482A, 0x76F2BD036E524344, 
+0x59B850EC3CF15CFE, 0x135B446CFEC3E268, 0x574706B7AE97A4B5, 0x0000A738A41CE418, 
+0x3653AAE3DC3FADA0, 0xDFCFB31BFA48B760, 0x1C9465141BA4E6D6, 0x2341FD34A4F82E80, 
+0x453A2B04E72CA60D, 0xFC7C843E88657FDF, 0x700CB68218F95365, 0x0015DB25E5FE73F6, 
+0x95F369719714E0EF, 0x6616C808583BE557, 0x01EC17921680EE99, 0xB2B9C8509619D5F0, 
+0x5AC9BEF1F1DDEBD9, 0x408A78F1CB7CA6B9, 0x6A52651A2BCB0AE5, 0x003252D6B7D3D571, 
+0x933DBA778FE583A0, 0xD7F1B49547B18635, 0x69AF44FE83F152CC, 0x89E8BCDBA2203C10, 
+0xB0A4EE2C669D8AE4, 0x4C0AA9C8FC3A232A, 0xC52B0FE9BA1EE3C0, 0x003AEC92E1A9008C, 
+0x3B4C0960C644389D, 0x7BFE961839338C5F, 0xB256BA9AF16A471D, 0xEE93870D61332C52, 
+0x7F9ADE8DF4D531E6, 0xBD39D87756F9161E, 0x0BA4DABEB1A52CD2, 0x003E1A16957BB479, 
+0xD32A74392406A04F, 0x6A99845FD8997994, 0x7ACC5ECC68E11FA3, 0x939E34CCE0697039, 
+0xE14DBA3635D1C004, 0xE8C222DA9A067F09, 0x974077722CF0E4AB, 0x00017B8681098FC9, 
+0xE567F65D43F8DA6D, 0x00F42C2C5E52FC16, 0x474A5A03C8B36C64, 0xC72F9FC5CA3AF20F, 
+0x4AF5BD6E5671023C, 0x2B5624F3333421D1, 0x4F2BC64F15CF447A, 0x0025D7D4DAF00684, 
+0x41B15E91D1BC8AE3, 0xBA4EBCCFD965B8B6, 0x91B49B5550C73081, 0x95337C15FAA38F48, 
+0xA8DCD574AD80F016, 0x68FED8A76F3B1D66, 0xB6D9B66E7E4043C9, 0x00171286FA1C5422, 
+0xE5D7D5FD0B09BF7D, 0x05E601F37DDDD66A, 0xE5E7A75265E4E354, 0x965EFEB9C15E94AB, 
+0x916FF9C5409946D0, 0xA9ABFF437FE3E57B, 0x862D257CD5ECF069, 0x002C6BEE2BCC8E8F, 
+0xE3183444B3123A84, 0x396846C507DB9DB5, 0xEB745FF67C8EA2BB, 0x2CB17A375E8792A7, 
+0xB43A8CB30FBDDE7A, 0x98752E34D3EDE8C4, 0x5D5C413360CF25B6, 0x001BEBBD4ABFC185, 
+0x9BFE974991F8ED4C, 0xE0D96AAF7FE8466F, 0xBE8F7522A1AF5E4C, 0x31B15CAC0EB503C8, 
+0xEAEA1976281A0BED, 0x5237F5F61B6A4FA5, 0x8D8AB2E61998FDAC, 0x00089EBD2674976F, 
+0x9C06609167B9CCAC, 0xD7C81068F49A6824, 0x67C0F2685ABAF1F4, 0xBA65516CA745CB0F, 
+0x8B24FEFD0A1135F0, 0xA8365F44A26B2A30, 0xD1F2E3AD7D5F7079, 0x003B71BD7212FA9A, 
+0xF642765D784875A8, 0xDBCD15685D3BA74A, 0x593935B71973AC8B, 0x33CE6C58AA314C19, 
+0x24099651868FA8E3, 0x4F9C565504B12956, 0x525B91E9EB07C9E6, 0x00043FA2332D2C52, 
+0x2D9C6AF9C9C34C54, 0x7BC4C7A7738C00EB, 0x390090C9483ADDF0, 0xD44B63543FC74682, 
+0x39CB1EFE6D6CD586, 0x0B3D7ACD87F61034, 0xD578621BB75A3643, 0x0006747029C65F70, 
+0x94B2E068E871F76F, 0x7F411C831C55B6AD, 0xD4C904955F0C394D, 0xF748D016679B7649, 
+0xA2308219258F414C, 0x1324BBE56717B75D, 0x1AC72AE97C5A3EFA, 0x0014C04CD0EE5434, 
+0x4E161EDC3876CAD1, 0xF1E7E618953912BD, 0xD866974838E63049, 0xBB15B50A854388C4, 
+0x7DDA0EC167496E1C, 0x5EF37BFC83559573, 0x1F7E89D9FB982189, 0x0018081725091F7F, 
+0x0D0F0B189A5B3C9A, 0x1E71F7EC31DB27A3, 0x8DC9703A6395BFE6, 0x63EC9980DDA8B3D3, 
+0x805FF80D6E252570, 0x5A53A62D8EDE517A, 0x5158AA7574D15BE8, 0x00308EEB3C3F4800, 
+0xA9E56E289E18CDA1, 0x5AC53FCE62A591D2, 0x02C0967C829D1652, 0xCB44C8B46871F407, 
+0xD35050141C5D34BD, 0xDB97D42A3C21F38D, 0x66CBDD57C078B6CC, 0x002BC4DC2FC8C732, 
+0x1379C4267D4639C5, 0xABA39D113D9D5143, 0xD61EF8C6AFC9F16F, 0xAC87BDD430D98A20, 
+0x0C120578A516360F, 0xEF5522750838B7D9, 0x15DF8B0B2E29EC6C, 0x002792D647AF3404, 
+0x7212CC1FD4016514, 0xDB3A7CC1AF94A4DF, 0x02ED65E9808F2C9B, 0xEFB6C8139B390EE3, 
+0x0AAA37DAA7DE07AE, 0xAC687ABB09599B4C, 0x9ACFC31181B2CA14, 0x002404333D8ACBC9, 
+0xA3D63A133C088990, 0xD775377222A454CF, 0xEF6BB30852E6BE2A, 0xAC9C69226CB92EA7, 
+0xB2E0016DD04BB593, 0x18E946D9ABD9961D, 0xC29239B010417BD9, 0x0015B121BEE9D161, 
+0x1F33BB2430CADEB3, 0xE0BB99EEB5B42BD0, 0x7DB6F801D0AED738, 0x6086F6C778D45CBA, 
+0x4B3887A9833122B9, 0x102A70BBAA2AC743, 0x8AC172C94E1ECD90, 0x0002325383A38E5D, 
+0xC46661EB2945D5F9, 0x2F78D4AAFF52AF92, 0x2281F465213A3A4F, 0x03FF9B7043B60F67, 
+0xE42AF574A3BF75A8, 0xFACE5DD5DF6F7FA6, 0xD9E87047B54F505F, 0x0016743101D4573C, 
+0x0D4F20CB8970FDDB, 0x9F24CCEEC9ECBEC7, 0x0F4E5BA2A84E1ACD, 0x83745728C85BCE2F, 
+0xA09C69E1FD6782CF, 0x3978E0D502E83FC7, 0xF21D4DB934C8ADBF, 0x002D586C2AF644BC, 
+0x157AA06E4743BB70, 0x2238CF2A9F46210C, 0x8FB0B7BA7E0246C9, 0x293410738DAB1D32, 
+0x6B0D6B45EF1800A7, 0x4BE28274F4B9786E, 0x9411298D139331A5, 0x00112798A27CD7FA, 
+0x720695D9BD79D9A0, 0xBB0CE512862FE69B, 0x9F76B378AD1F5284, 0x6A2C8572A8E18D63, 
+0xE0773FC8910DB921, 0x41C8DEF418F7FE47, 0x4CFEEFBC904E2201, 0x00120F7E67E002F0, 
+0xEF8D51CB3594A718, 0xB623850853C2EC96, 0x0F8F0D6CA51DC94D, 0x60DBE937F9604D32, 
+0x120FA51079538CAE, 0x3F5B8B8B9D97BDD4, 0xFC640BC7EAF782A4, 0x002BA4A209644C9B, 
+0x70E0D5E5B7D4C394, 0x5AD701F7FBB36D4C, 0x05909F34522634C9, 0x1CDBC11EECE49662, 
+0x8312FF42302B8E83, 0xC2A041443EAF7C69, 0xAB193D33A56F0E30, 0x003AF5162A94D95E, 
+0x4E402E436376DFCC, 0x60F831F545A411B4, 0xBD5062E7883543DA, 0x541DB60E63BE2590, 
+0xBC906A3B78BD4C99, 0x8ED7967EE319DC73, 0x2B43403D1059E3D5, 0x00296D1B9B42DC08, 
+0x328665BCC7E55686, 0x2E01AC75150E8776, 0x42E7942FFF9F6112, 0x303D7E873F1DF82F, 
+0x3F679A9785B72C8F, 0x4ED3882681E1FB78, 0xD7F4A4F225C11B27, 0x0032E0BD3CA1FB98, 
+0x92A0A4A5B717A19A, 0xD6C0A5A77233A547, 0x4DEA20D9140125E9, 0xD32B4B14CEDAC348, 
+0x307FF7BAFC524AFC, 0xEE5A17A329F8A48F, 0x21B1917C11BCECAB, 0x0033C8AF7150AE00, 
+0xF99F9882FEBFDFC0, 0x642C129FF432C551, 0x54CB0D8177688563, 0x68A1235F2133147B, 
+0xDF6DCCE940037A57, 0x941E6C2469D3D59D, 0xCC54A7F708875444, 0x001118EE842A535A, 
+0xD2A44404694446BD, 0x349E7C703C5F278C, 0x1AFF878A68A88CA9, 0xF86B0CF1DF86AE2B, 
+0x915B519AE9391FFC, 0xF0908CCEBC5E91F2, 0x4A9222152F47974B, 0x00246A13FD0A0B0A, 
+0x546B5E3BC9A6E68F, 0x2A4CBB70A8A5EA39, 0x01089F011026F838, 0xDD9C62A2960842DF, 
+0xE94CBB967ADDA821, 0x31B73C08CA3C011D, 0xC01148BC0F8F5322, 0x001E0EF8E4278C99, 
+0x5DCF8115B22F2F89, 0x2C7F8C25D87E9E8E, 0x8AC5D0D41B7FE4F2, 0xF946C2AF174535A9, 
+0x4B42ACEB181D861E, 0xE367279EDBF0729C, 0xF6EF3D0D67C9F960, 0x0002CF3E45A35B7F, 
+0x3290A9E8AB20695A, 0xE4E87F70549EDE50, 0xC68E57112AE81783, 0x34E3E903CD6C90E8, 
+0xB7F66231FBDE1244, 0x88ECE3972A9D6275, 0xBCCEEBD339ADB112, 0x000DF3DD792F7214, 
+0xE092991ED2B83ABA, 0x3C1A5DF2700E6B3C, 0x2F1BAB1FFC825B33, 0x792FA4FE1C265995, 
+0x35CE7109FA006350, 0xCA5A65C92659A1F3, 0x708F0181323A4CB6, 0x001EB3E1774CB6C8, 
+0xFD1749D9687AABE1, 0xC5874882F592F790, 0x9E59F3DE9CE85D1B, 0xD5DFE1D588B27568, 
+0xED4667668219BE80, 0x5E63546DE9E89BBA, 0x5DC2DDECFF16FC89, 0x000B9ACB5A9C47B0, 
+0xDFD6C71C0B4B8598, 0x0E75098911B9AEE5, 0xF91C046A7E8DEF8C, 0x90145C966DA855BB, 
+0x17A3E7B921B0B2ED, 0x1B8C567781B65CA1, 0x8244F651052F9F22, 0x00226F3D46AF2EC6, 
+0x65A41BE48E64E887, 0x5AF73A2C662F790A, 0xE898BCB99A9C3C8F, 0xFEAD69B86267575D, 
+0x299C629DC26057D3, 0x6827DFD9D92BC725, 0xC3ADBA501A320AF3, 0x0026FB8950BBD71C, 
+0x6A809446A243A4B3, 0xE0EBF9FB746512B6, 0xBCF28CCF59F79E1C, 0xF0F39C022B2BDF7E, 
+0x55AEEC87ABCF748A, 0xC88D08A0F69BAC2C, 0x83A704174504428B, 0x00203B4AB178EE01, 
+0x0E38488A56B53CDA, 0xE1BDB514865D987D, 0x95DC63480274EB8F, 0xCE7CC597640AFFAF, 
+0x37738E3E749D03C2, 0x1D49EE42BCC71A3D, 0xA1ABB3CF5A612B44, 0x003B7D4BE5B63522, 
+0x2F574A5E2729BBAE, 0x21909BC157120A0E, 0x937A792A3A841CD2, 0xCE4CBC5EED91DF4D, 
+0x65DFE0C7D1C18A8D, 0xA6E1E65003B665C3, 0xEF185089C100378B, 0x0034AE5848ED15DD, 
+0x6AE86820618A829F, 0x49FAC1C5E7D927EC, 0x5972D4CFE2479390, 0x9C973854654FBE3A, 
+0x1D29E25CABD26A15, 0x6B86308DF3FDBAD5, 0x234613BFF17F41F0, 0x000D88D5634E5CBF, 
+0x0801C6077D627AE5, 0xB2E24123F881C3BA, 0x6D3C4E8973942F72, 0x0BAAE6115EF31C41, 
+0x607FC12C283058DF, 0x21473E401AB5AF56, 0x21131C3604FCF77A, 0x0011789F93D7E26C, 
+0xC7942CAF6E7F6CC5, 0xD01AF8E2E9B75ACF, 0xFA0944227B5421BF, 0x49C8469169A76FA0, 
+0xE106E33DC2E85457, 0xC5C70EE4409E6A25, 0xA43E77ED43F19EF4, 0x00337F0BDE2F2581, 
+0x1986D53D2CB5C109, 0xDE40BC6BD4141ACD, 0xE0D23F89A1A229D8, 0xCB902BD820BAFF59, 
+0xF69764357003A131, 0x82F31BCAAB793E56, 0x8595E3FFEDA73CAD, 0x00308D07627B5D27, 
+0x387C4746FCE2873A, 0x2A49C681C525EC25, 0xF51D29C56BEAE25B, 0x888FBC06F56C59FD, 
+0xADCD46221E88F72B, 0x74A67C64E62BE16E, 0xE04DEEB65953052A, 0x003B30E165EC0F07, 
+0xD8101B881178B3B3, 0x1700F7C503C5B3CC, 0xA69062E4B73CA451, 0xCC0C49550C6DC15F, 
+0x913BC896A0410BEC, 0x0C16AC55F74410A0, 0xF5F89849B56FF63E, 0x00299C5799E6B038, 
+0xAB3E4E1566723BBD, 0xEB01D3A905EBD62C, 0x4926F9E840D90A19, 0x737B33254AAFB7D5, 
+0x0FC6A67414EE7EC7, 0x8C309085238560F5, 0x27F220EB2A2AA04A, 0x00334EA14B5BCEBD, 
+0x11E5B1464E061627, 0xF87E77DCBD42C98A, 0x7F65A620A39CADA1, 0x276D25A02C28B240, 
+0xF0C5C73DD9A8FA01, 0x95FF06011D2DC182, 0x3C014B44E94157C2, 0x002EDA9BB9A8A8FE, 
+0xE391D9C6E3E0FBA0, 0x7472BC1FA98EA197, 0x02F4C2191F9DB53D, 0x31A5069D3A856F0E, 
+0xF135CCD41EC9B74A, 0x39B5B0ABDC082B90, 0x602B5BE404BAC076, 0x000CC7C375203DE5, 
+0x9B1EDCB5FF036413, 0x3322876560E82907, 0x10AD9B8859BD0562, 0xE051E11448560196, 
+0x3B0341754E5B4DF1, 0x493CB8CAB09BB9FF, 0xB5E4176AAA7C316C, 0x001BEA3ECB5653C8, 
+0x9360BC0598C84B97, 0xAD92FFA7C472A284, 0x7055334BA8BA4038, 0x5C5A84A021DA8F15, 
+0x5593713D281C1462, 0xF9F5554B78F60C51, 0xB351CBE858A846A8, 0x001E28CA838172DC, 
+0x0B78F7E7E82F97E4, 0x690B574793558BE8, 0x878880451D54F997, 0x51CCD40DBB1C3ABC, 
+0xA591AB2372744735, 0x91B59342A900A8E2, 0x9F051223AD333771, 0x003A65027FA80425, 
+0xE9FECE661E2A845C, 0x850F206B547B9DF6, 0x1ADC5585BE4D33D7, 0x1C629DD1EAD1CCCA, 
+0x143CD57067AEA361, 0x8F2E5ABEC826FA55, 0x9EA41C7C534ED2B3, 0x000D789153F15EDE, 
+0xB8F7B5CDCF40A642, 0xFC50F987F202FE59, 0xDCEDBBF45D5D9D6E, 0xB39ACE42EB318F4C, 
+0xE34A3F6661D7E005, 0xB84E535BD4CC6598, 0xABBD03036DA074A7, 0x000FA78B5D9C6BDA, 
+0xBE26B3B0811596E0, 0xE3D9816D57DC4DD9, 0xE6B6BEE8F8DBF9C9, 0x8F0FADC4200AA9E9, 
+0x8C9D1E61B2CBDC1F, 0x6A8534C369BA7A81, 0x639834480B09CAD1, 0x003EA5358CAED8A1, 
+0x389B898C413C9902, 0x6B345D3F2C056CB6, 0x2B122D044B001057, 0x03E409034C0F008E, 
+0x99415B3B59268677, 0xC3D4FECB1D5C45F5, 0x0E156D4AA48281E3, 0x0029C4D9B2A3F53A, 
+0x64AEDBA42A571399, 0xC3D2BB0FADEC5A23, 0x5D94A14C80539DB8, 0xBE9ED549C4820007, 
+0x6351D9FE017814EE, 0x62FDC7671F7F8639, 0xE85C137E09E119F8, 0x001D4C849D2CEF35, 
+0x86495321269F8476, 0x7E8707AE5B5417FB, 0x0D5303128216EAA8, 0x34900AEC222DEC8A, 
+0xD17A3AC9CBCC58DE, 0xB0019F232374376A, 0xCA61BDEBF6F650CC, 0x0006F0BCC22D845A, 
+0xD51824D1F0AF0105, 0x4F0A91525AD17519, 0x3ECA8F6722346F4D, 0x0C5A7C4FE91F5501, 
+0x1F0AAD4B0A80F664, 0x2C5B52F9867D18B4, 0x930074266BF98CDC, 0x000220DEDD630258, 
+0x959B633456504E72, 0xD740CA4631F68C6E, 0xA342968A66E14D52, 0x350E1CEA9A4BEC0E, 
+0x070216B06473AE80, 0xD0C8739A20796726, 0xC692B2843F13D154, 0x00327552F66185E7, 
+0x89F009F87DBCE620, 0xA1A060CD9599CAEF, 0x6A9282E2D11FF442, 0x717E4FCBD4BB2F66, 
+0xC6ACB7AAA5D2E385, 0x18F2297535F376A5, 0x146D07011E866634, 0x0006817ABBF93044, 
+0x2084D52F1DFF818B, 0x4AEAD1108D03BA23, 0x01EADF8227E2B808, 0x83614924104B7108, 
+0xA906C270DD08C41F, 0x9D33FECE1B4708DF, 0x4CF702E9307A37C8, 0x002A4C961164F51B, 
+0x32A7BD48D6862C38, 0xFB82349EDA116C64, 0xCDC649124FBFBBAD, 0xACD0A9338F951541, 
+0x9AEBE8F0112ABCDE, 0xC838FA1605F5F70E, 0x0727357986DC3037, 0x0038A8A69212997E, 
+0x4A6D06491E32CE38, 0x68B9282A5F041D73, 0x64BD428A0ED8ABC7, 0x8099ED21BC892165, 
+0xA6633038D34F600A, 0x886B5772AFB9997B, 0xACBE1DF1E4676077, 0x0014659A17CE81D2, 
+0x38BC1B7E15362386, 0xFB7B8342AB0943AE, 0x691F52408414E144, 0x95CD82C3246B5E4D, 
+0x1D16EF5329C20A3F, 0x0B49EFECF9AE4103, 0x6F922B549C83C4AB, 0x003803BD91FAB7AE, 
+0x84408365578D247C, 0x0B0D911E6C2A5C77, 0x07521AEDD43886FC, 0x464C5058653C477C, 
+0xE16FD8C66BF5D7B8, 0xDE41858AC064A48D, 0xD44D9FA70AC9C511, 0x000C986010CBFF6B, 
+0x6466FCA8D13720C8, 0xE918E9EB010C023C, 0xB6ADBF0D682C3005, 0x74BA056C60CDFE8A, 
+0x7E1CC7B3B3DF6ADE, 0x14DED0A200EB3906, 0xC38015E00A344EDF, 0x0035DA17FE1780FB, 
+0x04B1F48475A6785C, 0xACE6957A4370DD92, 0xDE062582FF06760C, 0xC94CA76D981CF863, 
+0x9362CDAE7F9DB54E, 0xA29C3FE80EC70218, 0x590E4614879DB81D, 0x0009ABA18BF4473A, 
+0x5D3D8CDDBAD9AECE, 0x7A7D3965D495982E, 0x5FB3ABF8FF79A4FE, 0x20D61BA238C53F33, 
+0x3791E99251509CFD, 0x0837C24E9B20538A, 0x728D3BCD3BC095C3, 0x00361F6C5167F940, 
+0xE575F38582EA47FD, 0x592BF24B6B0F1EA2, 0x6A14289F651C2322, 0x76CEFFCB62BF1E13, 
+0x599FF700F1B8E2DA, 0xAC04BF9FE0CDA624, 0x5B9605DF04C48384, 0x0012E8E1720A9C43, 
+0x4A49EF7EB6D853FE, 0x356A49489EEC9EAC, 0x6FD1E9FD28A7FC6F, 0xB0F7B9FADA02BBA1, 
+0xE86C1C07DC657232, 0x79EF196BA9C6F031, 0x2FA2827EA0EBC669, 0x000068BD4DC00FFD, 
+0xEFCDE2EF3C4A6C4E, 0xDBB15115412EE844, 0x87503A44A6E016C4, 0x5A014825F2AA7DBF, 
+0x1401A7FF08193126, 0xCDBE9AD726DF8BC5, 0x5299EF0B0705A984, 0x000AE04A44D1650E, 
+0xE0019C211C9817AA, 0xD80F23E066EA5F4A, 0xC51FE450AFFB20C5, 0xF633E86C1FDA735C, 
+0xF1E60BB471DB9F62, 0x4B5CEE27BFB66362, 0x1C2628F9652A9FDB, 0x0006D099B8A90DDA, 
+0x6A443DD465795D12, 0xEC01BA996F42F391, 0x22B7FE5E9E621622, 0xDD15C1C5A1EF7835, 
+0x4E6349BA70459BD5, 0x5C0DF3FC131BE525, 0x09C52CE35EBBE595, 0x002735C2A025CED4, 
+0xBD21E0E9ED9DAD3B, 0xE382551F465B67D0, 0x1778F6B45F79D591, 0x709706F3185B1CB8, 
+0x4B9CA3042E3D55A9, 0xFC1A3125ECC71D59, 0x433CEDB743C06133, 0x0029E1AADC075849, 
+0x6F79092C9A30E0EA, 0x4026CECC0C085073, 0xD8ABB917E19D716C, 0xCFE046E31DD31052, 
+0x0ABD7280AE1B2C27, 0xC7D7AF32FBBA65A6, 0x3FFD16CBCE336C8C, 0x0008EF9E50012852, 
+0xE684727A1126C219, 0xA5DD0B92369D8F46, 0xE5B8C36C4667E98B, 0x81EBC57FF53A6CA2, 
+0x1F4589E364B5A820, 0x11ADB9FFA0D8C5AF, 0x19A74F96C8A5A1D1, 0x0007B4DA60B9A732, 
+0x6A578A5B7CE0BA05, 0x9B513ACEAECF0AB3, 0xD13A57918C17F619, 0x4181B61EFFB0E493, 
+0x470A868AB1F50318, 0x0FCC1915109D126B, 0xD9772CF65F138D0C, 0x002DB4FD9EA29852, 
+0x77247EC23191EF13, 0xFE8F1EE8D8A6F585, 0x6B430397B59F0AAD, 0xD29AEABCD8CF597A, 
+0xA10A0AE1100C81D3, 0x1B555196D847D94A, 0xE74588159173DADF, 0x001ACE2A07C14AED, 
+0x2BE5E38B774A4D1A, 0x4EDFB3D29E61E30A, 0x4A3305EE2B741E84, 0x10E004855C6D8A8D, 
+0x7D0BC6BC6E2B39E2, 0x476B6A08998B3B71, 0x005D1E3818BD8897, 0x001B38FD80972FE5, 
+0xD636390FF936DD5E, 0x32F34A71CB9B18F5, 0x200108E1D75C3CAF, 0xDFC9C23FEA4F6C2E, 
+0x6FEE50DEEDCFB3B6, 0xA5BD4E1183005C79, 0x8D961C4C42FBDA10, 0x001480A41677D327, 
+0xC0114DF72443DCCE, 0x2904D2282FEB3371, 0x0D2C3C678AB03020, 0x1037ED4F827FC303, 
+0x0C8015982C0E879F, 0x65DCD98CC0CE3B57, 0xAAE4042E73171614, 0x001A9CFE711A6E12, 
+0xBC1DCDF2B813F60A, 0xC85DA52217D4C19A, 0x74672A9D07C1399F, 0xA532E63C25E84324, 
+0x2BD2C5DA7BC91003, 0x19D3F1A8CBABA981, 0xB0E0D6DF3143C5C1, 0x000596DFD78CB62C, 
+0xB53EC22B278DE60B, 0xB3C3916EB5ED28FB, 0x73CF5179163906A2, 0x1F2BBFDDEBE41465, 
+0x35049D4067077930, 0xF12AA77A1E0789E9, 0x1BF7CFD443126CEB, 0x0032E247CDAEB2F6, 
+0x7AC4E71DE04864D6, 0x590883FB15C58A9A, 0x7D077D6A300ACAC0, 0xEE311E779A53B9C2, 
+0x2D43E3F9E2E4A739, 0xDC52161C53A5ED40, 0x8EC2223BB753EFB6, 0x0007D787461D5611, 
+0xF350A7A84DBA25ED, 0xD8A3F75B0A649AEE, 0x537ACD1BEDA15323, 0x388A02865B47C680, 
+0x69EDBE73BC68BAD2, 0x1C750EDB107F7C15, 0xB789A8C2C9076D28, 0x0001CAE1A0391623, 
+0x1BBE1BC2DEFC03BF, 0x70A8E4344433B1B7, 0x6ADEB6F54E473E6B, 0x732F5A896FB49DE0, 
+0xE9D297E76998C5FF, 0xFD68195D28D3BCC8, 0x9C4DAB2ABADDFE97, 0x0030CC33E10683E9, 
+0x03D3E850423F6257, 0x3DA13931B3B0DED1, 0x84329C8430441B45, 0x42463E50080858DB, 
+0x038DDDB0DE3C2C03, 0x7CC51BD5D9EB108E, 0x15D2E53587FC4B7E, 0x00129595FD1C6826, 
+0x123116BA60831F4E, 0xA75547AD87ABD956, 0x3BAA216CD9954B8A, 0x84115A32C8772EE4, 
+0xBFF1E699974F673A, 0x850383587722EEFD, 0x87C210C34B902D0C, 0x0013406A1F5458CD, 
+0x72CE25092624FA45, 0xA8E4CCF6F83F6F3C, 0xA0BF03858A2F3E8C, 0xE321C559853A4355, 
+0x732982BF56EDAD23, 0x5436D0EF62EAA318, 0x5F8CD1CCEEA59F01, 0x0033FE6C031DD667, 
+0x04A9A76CD28350BB, 0x16A178B2673BDD51, 0x6270BC2B91042F86, 0x87F8BB5014163994, 
+0xAB29AAD5BA560C44, 0x7EF8333F3615605D, 0x5DB28D8DCC0AB50D, 0x003277E5FFD2CFA3, 
+0x3313883958CC595C, 0x25B06DE8B2D0DF32, 0x722B7C1A41E98B15, 0xFF413E3CBC9550B7, 
+0x73737C3861D6508F, 0x6638F86B305AF9B8, 0xA071D8BC63ED5690, 0x001F796709A24FB9, 
+0xA7EBF952B8D561EE, 0x8163B610F37E202E, 0x32AB8E994D0E8CC8, 0x2911B108188B4F96, 
+0x065B8E4BA02D2EC7, 0x866E5547325B9284, 0x75DEB67DA4877122, 0x0001D7F0D3F364EA, 
+0xA6FDEE5078B68618, 0xC1AF669157D1B947, 0x7ACD97102B01F3B5, 0x5F6DDB45D789BB3C, 
+0xEA17470FB8806DA3, 0x1B0D3D8835EE19DC, 0x9D5BE021802EE62E, 0x00401A803EFF3FD2, 
+0xEAABE0B9AE328F7C, 0x9527FFB8BAF6A164, 0xBEF662228DAA0527, 0x8A691C53E738D233, 
+0x0EBA46BED99E5BB1, 0x91C99B901DA7E38D, 0xD0CECC930EA0F08F, 0x00152502C213CBCB, 
+0xFAC9A49CE19E7AAC, 0x711F27DA1A82D302, 0x89FB29AC4368AAE5, 0x1CAB1666440EA09D, 
+0x9896240FB88106B4, 0x5282AD52BAB27241, 0xBB0DA4530D0B08B1, 0x001E7D45EA5A5244, 
+0x9B2E114061535C71, 0x36FD5BE5CB9D51E2, 0xED853FEEA2762F1A, 0x3897225E99DF9933, 
+0xFFDDEDC1F01026C6, 0x7F53E25835E12042, 0x6B3959567FDFC66C, 0x0015DD18953D9FCF, 
+0x3D9C26C417160BDC, 0xF887D809893B6868, 0x4EAB7987C7F162C1, 0x3BA41BE8B2F84D73, 
+0x1D789C5F9D2D726A, 0x55EA8B08D9C724E2, 0x19A959A101423FAD, 0x00147B5159C63B36, 
+0x632380D9B51E3413, 0xFFFEF64132A6DA67, 0xD2DD4F1D336331C7, 0x3F7334C1ED074F51, 
+0xB91524F194540350, 0x304542CA81CF7286, 0xF14007CED8218B55, 0x0005F8F45E028BF8, 
+0x5DD4A21AC892AF91, 0x89CEA9469F5A9462, 0xE355E3879DE05C68, 0xFE78CF0361C815A9, 
+0x2F03BA3A0DAEEBF0, 0x7AA988184A8FEB02, 0x6BBEDE70B9EA9E22, 0x00363D89BAE50105, 
+0x321FF44AD41C0CB7, 0x969E4F6280BAB2BD, 0x462D4A4FFEB3A5F6, 0x55E3034AE4439880, 
+0xD4CA6453FC45EA11, 0x1C3584CC69A8EBDC, 0x3AEF087A113A70DF, 0x00226214AACA27D7, 
+0xD1F80714CA5B0FF3, 0x34C86257B391785E, 0xF00EEBE1E330D924, 0xF2AD7F75A752AD7D, 
+0x027CFFC3E149BB38, 0xBD6D904DA1BEA616, 0x42FAD8A96342596A, 0x00257A34C1D2E582, 
+0xDB94C72BF1AE01C8, 0xAE723CA44B929C14, 0xF94A4BBF4D0B2F3A, 0x6CECB2E9C0AA2D51, 
+0x9195DED281D84652, 0x16FF6CD5D75498A0, 0xBD1224228772E077, 0x00354D89D859E381, 
+0xC2829D06CB1028C5, 0x39C740CF7854D19C, 0x1505FF175E12FA40, 0xE12CCA90A757B12A, 
+0x44EA3237630E4C4F, 0x9DFCA1E2EBA998C5, 0xF3607ED699D3D236, 0x0026BDD12828822F, 
+0x8CFCB9DA6ABFCA51, 0x9F1D97770C623581, 0xC2D6B2DE98D0E27C, 0x3F23D1964E548654, 
+0x3BF9180BD0503043, 0x09B36E1E482AE05B, 0x16F1A9ED89328B75, 0x00179447B9522A56, 
+0x9C61D004DE666010, 0x07F7FDBB06F9D2A0, 0x31774AFDA617AC07, 0x4FB909F837413E12, 
+0xF73141A335964ADF, 0xD3A2EFB4E2FB74D7, 0x4AF684012786CB0D, 0x0032ADD2CD008A66, 
+0xF24A3835956B0F2A, 0xE0B25C6AAF06CDD6, 0xAB7B00110184F327, 0xB27A404DBE9919E6, 
+0x292699094C94E333, 0x67C945589F40D372, 0x58DDB78B833DA334, 0x003DB1931969CE94, 
+0x5FDF49BD8D7C80C1, 0x1235F0A125ED5BC0, 0xB4D4FE3A0BC2009E, 0x0951CEBB08725183, 
+0xFCA4A71A127801F4, 0x7724804FDBBE8CA2, 0xB46E9BFDD9A6DDC3, 0x002A9E8DC346CA5B, 
+0x8ED52DA6AE784FE2, 0xE6C1D0DC7D0283D4, 0xC9CD237FF6F555C9, 0xBF7DA32F75B6638B, 
+0xA7DC6BB59E2186C3, 0x0B65982DA124BCF8, 0x5687477BD64B4E95, 0x003C6DAA523F5692, 
+0x75D974704B0A3CD8, 0x9E33A5713603E239, 0xE3F4170E71A601DB, 0xBFDDEA845839D1AE, 
+0x8565F9E2330DACB3, 0xD2CBBDC6395D4BC6, 0x0C7FD318BD21A95A, 0x003D31C9EEA3104B, 
+0x554B8C40E6189C87, 0xF1E601FCDE4D681C, 0x89F9426D82E31FD9, 0xEA2F64B27FAF021F, 
+0x6E41A66CE43DDBC9, 0x06004A54C439DE73, 0xB4F24F14CBECDE65, 0x001F25D46B5E9443, 
+0x55D848BEB9801CCE, 0xEDDE095B0C3A4059, 0xA60F12EC7B136420, 0x15E5ABF603BC3242, 
+0xFE669BA1A5ED9531, 0x9A94B20C43823D58, 0x7B345C1CDA474E00, 0x00056CACACB4389C, 
+0xAFCC2168995F6DA8, 0x630C0BD2ABEEB08A, 0x9998CC9A086086C8, 0x031AE9896CCBAD55, 
+0xD1BC091D9C75E860, 0x317268C5E8F5C147, 0xB295A83583806BDA, 0x001BE2177B4B120D, 
+0xAD746DF288CCB19C, 0xF7B55A59069E1B60, 0xDE0501DDF90DEB65, 0xD3E3F1ED3FBB63F7, 
+0x1C837DA7EB214099, 0x1AF0937EAF893159, 0xDEFBE620060CB109, 0x003DF3C4E943B115, 
+0xCAFFF696C067118C, 0xA5442A576E3032C7, 0xF0D04B4A6990C401, 0x4A4384852FC739EC, 
+0x6315CFD57ED3968C, 0x60026DBD9B7F15E3, 0x188F9DA0E731D7BF, 0x0033C66E1473F28A, 
+0x535AFEB47523D35C, 0xFEE64FA29A229A54, 0xEEA6165077236D70, 0xB0E097B799BD7D1A, 
+0xB1BE71CC9DB5A647, 0xA9E91083EEF461FB, 0x14D42851952434A4, 0x0038766DF5995230, 
+0x286C54BE1F47EF0F, 0xF779BC3F5135CEC7, 0xE97B040219D649D3, 0xB60034EA3E8E3544, 
+0x84DFBB2F4FB67552, 0x09B7FF36ADEAB66D, 0x1E03FA7D450CDE06, 0x00274FC12A68B48A, 
+0x4A35F967B466CB0A, 0x8CE91210415C44E1, 0x3600C22599CEAB47, 0x4D8F99A691A18309, 
+0x51EBF08358501635, 0x14A47CEA2F252531, 0x8066B52434BA4755, 0x002A8C33D6E5035A, 
+0x63A50D11534FC407, 0x60919D03F031F43A, 0x9C8286C269CF8A33, 0xF59BB672E9BE64DA, 
+0x7F17A59032C24E3F, 0x52E754CEB31D7872, 0x1444C7859BD86205, 0x0016AADABC6EA74E, 
+0x1DF1F65EF81C7E17, 0x9645EF77A0D7F0F3, 0x63B60D1C5D20B64A, 0x7BDCCA2D092361F0, 
+0x5AEEB6F4792E0AE7, 0x3AF594CFDAB204AA, 0x17229FEA201B4C7B, 0x00038A3D3CF5B94B, 
+0xB79261EC6B7F1CBB, 0xA702AD736DEB2C33, 0x880BF859E10A79A9, 0x89EC2BCBC3D13B07, 
+0x4BC56B334A4AD601, 0x097063DD1F85AFA9, 0x5A0C64107FA025E4, 0x001110BA686E3404, 
+0x5B0BE1E7BEA9BD41, 0xA48F0028F1D4ED47, 0xE78ED6167B61DB65, 0xC24700DA8AC7E8B9, 
+0xAF79822CA2F074A8, 0x77591946F3AE5C89, 0xE487E426199D2B3A, 0x0033497CAD711272, 
+0xBF4F705D4F5CF966, 0xE1EF1498BC882D24, 0x4C324CC4C418F287, 0xEE23EC453E0F3D08, 
+0x149D9B207AB785E2, 0xD917EF473A448A69, 0x1D606DD323C9891E, 0x002FAF420D85A256, 
+0x521B5D9A95A36DE7, 0xEEF80C36B4CABDA7, 0xEFC371B38D752930, 0xA64EC6A682D4DD57, 
+0x0E65B86557CDA81F, 0x0F35A5DCD59924A8, 0x04A7CCDE2CA19B10, 0x00294964580576F1, 
+0x077BCFCA2452171F, 0x607F4801CF73AFE9, 0x0B42CE598464BD15, 0x056417531E3B2963, 
+0x5D9D34838BAFC0B3, 0xA3C28143CE0E9D14, 0x03A8E8E1B55F33E2, 0x00365BB4FA363FE6, 
+0xB50350C2F0DCE94D, 0xD99AF7E15FF72343, 0x872D4B372FD4ED0E, 0xEEB1C59A3083046B, 
+0x8842706CC48AF440, 0xD61DDAAF5BE0058B, 0xF88D6B58F36CC6F4, 0x0006B19E86162394, 
+0x9579C3C4AD578FE6, 0x0434C85AC6598067, 0x62E2D6492200498A, 0x46F400BA63B1A9B3, 
+0xC012BF760E2240C3, 0x8AB08A8ECEB62F41, 0x58D84819BAE46343, 0x00240D89E41DB0F6, 
+0x5CC16A366B8C412C, 0xF01FED9EAE84520A, 0x8BAD28E7572CF420, 0x8E0356E912AD6C78, 
+0x42CAEE78E88EA633, 0x2E6CA0DECDAB825A, 0x5C0C4D4CFCAD7D78, 0x000EF673DA867CF5, 
+0xF2D43ABE6A3A7FDE, 0xA7B0DFEABC11C82C, 0x2548AF691BCA30D5, 0x2CFE85BA7CEEFAB3, 
+0x9E34F1B24D09142E, 0xED29030FF1A02A53, 0x20655B4558D83E0A, 0x000EF4A66E546F7B, 
+0x046AE0597E2F60B4, 0xFFF2A7D8D2E52CFC, 0x8675D11283B8EFE6, 0x6BBA112A5E7A5047, 
+0xC0D4636C29F7BC54, 0x60D877075F138877, 0x7F79BE7BD468B222, 0x00323802343636AC, 
+0x567EF3368E973885, 0xDB2BED7975F72A96, 0x8A54A7F179C7A28E, 0xEB1A3AFD3068D504, 
+0x6D94FF79E129D729, 0x7B5A99939F1FABE8, 0xEC6E91AC34EB24B8, 0x002630FFE4199F67, 
+0xF38D3B7B1258EE19, 0x56FF965FC040774D, 0x776ECADE2B5413A4, 0xBA77CF5330EAF8AA, 
+0x07ECAAD9376A9CCB, 0x42C14D0546DB717B, 0xD013D8E63F8B9068, 0x0031F9E3F486721C, 
+0x83B81BCFD39764FE, 0x578DF036893B20C3, 0x5506AFFE5D89287A, 0x6E20C1C266E9C064, 
+0x08BDD3AB9C4DD2F9, 0x6CD4527BD2DA2744, 0xBEE010B285959521, 0x00111E543B819B83, 
+0x43D134B42AF58BDA, 0xA5ACC7F037975804, 0x8A2A21EDA34157B6, 0xA92267A0618E2D01, 
+0x631AD91949E22523, 0x919C6DDD9BC3DBB8, 0x3BB724BEA7AB9497, 0x0017A234B950AA2F, 
+0xB5D31CD28E0CBBEB, 0x6CA23E60EDBF006A, 0x8FAB8EC1B7F1552B, 0xE3BFD39B62150E4C, 
+0x8851D65CB1215262, 0x739BD2DDDD71D5B0, 0x267F8077951BD856, 0x002B2CC64D072CC7, 
+0x786DD261B637BF8B, 0xD59AC3D6952ACC60, 0x849D7F43DF3C655A, 0x3584E11C94EFB292, 
+0xAECCF94D360AC814, 0x3884FFE2C459B082, 0xB02F461758A04559, 0x002C5C0576BC831D, 
+0xACA39FB98FD81C15, 0x4F4933653DCFAE1A, 0xFA0F5697970B6F05, 0x2003FA423FD6726E, 
+0x32F38E291DB1364B, 0xD89EB3CDCCA0400E, 0xE2C79735F1E0A490, 0x000E1F500CC00FED, 
+0x37439B16BF5527B9, 0x28E6D61845E523F9, 0xE845E3108E626158, 0x37C03A4702D3AFDA, 
+0xE5FC5E6047D4F70A, 0xC91CA8A1EAE7D925, 0x1E48DB760583EDA7, 0x002EA6E7CC0B0838, 
+0xBBB3668CDD9BE54D, 0xD872140E03507398, 0x5856FBCE61770FD4, 0x293D4E0B5ACFC2B0, 
+0x3D5D0781F02435C2, 0xF7CEE60E88D85036, 0xF1E1E50F580F6B23, 0x003C673756EB13A9, 
+0x07FE0EB61741C70D, 0xE84B5A379FDF2353, 0x585C0AA265489476, 0xD36FB92B386447F6, 
+0xF048099232B03E85, 0x11779EC2AEFC4777, 0xE553EDEC13213C4B, 0x003996729596CCE4, 
+0x33D1B96B73AD4DE1, 0x6D81829A77A03910, 0x622E94C4C7D3605A, 0xBF04731ADB299FFA, 
+0x26F7057A705CADAD, 0xCA4F671D631C0605, 0x76637A5367886D6C, 0x00219C9FCF49FA3D, 
+0xB9E381CD125B527E, 0x5B79AD0EC410932F, 0x388FD3BE86ABD239, 0xFD59229303F41CD0, 
+0x60954C81916E364A, 0x2FCA9169C6FDF78F, 0x9D718BBF04B75053, 0x00120DA4528C202B, 
+0xC7C2FCEC8E2DC725, 0x0D104B9ACF5EEDB1, 0xC6AA8BDF829F1017, 0xE916701218328133, 
+0x45DADA9455F23DBC, 0xE8DCC868E83F9447, 0xE2F615A1FE5FB48D, 0x000DB090F93A15CC, 
+0xFB6E0BCB9B0C4633, 0xE10FD63F0C5C29C3, 0x01E7A4D0986851F2, 0xA9BAC79FFFBC4CD3, 
+0xD9E42CF5DA9737A6, 0xAF8773A21395E705, 0x9611EB7862712D8C, 0x002676F90D15833F, 
+0xD03858F4A305479F, 0x56AFDAD41AB738C7, 0x48C604A5C79DD067, 0x50F8AB72533541F4, 
+0x02D202B60EE2DFF1, 0x0A82FF9C90EEE895, 0xA0C148C3351E0B05, 0x0027B315A9553AF6, 
+0x7403B7E565989BB3, 0x000EC544E2C022E9, 0xABC7D652129341C4, 0xDFA28461CB8FFD39, 
+0xC871244519842FAA, 0x23CB5479BBF6E3A6, 0x3A41924C8D1DD033, 0x000C30E7C867536C, 
+0xEE29EB43BF85388A, 0x23A2A76AA4EDE890, 0xFEA05B6E40E8283A, 0x23AADDBBAC94B808, 
+0x1AC52F2B86047279, 0x06356164C4FC4595, 0x0FC4EBE208A65001, 0x0006B7A43208AE9A, 
+0xBFB7D94D000C9B7A, 0x8C57953283D89633, 0x4976745B9AAE337A, 0xFC0D9DC7C28901AC, 
+0x120035E24BD88F82, 0x77E7E5491E6F58A6, 0xF5393482C4ADA070, 0x0014EFDE39051CD0, 
+0x08E1E44F60757DBB, 0x63ECAD0BF584A566, 0xA5F59A77047FCB9C, 0x0A8349387FA8B152, 
+0xFE8296C179E63FA6, 0xBDBCD516704598DA, 0x9BCA8C052F103C59, 0x000B370DFEB2B7BD, 
+0x6766C344F2C88032, 0xCDB74E31454BCE9A, 0xAF0BDABCF8495FD5, 0x72AFD1FEA17B7795, 
+0x71708BD09AD22A43, 0x09FB50EBDEDA585E, 0x860A971A116570A6, 0x00331D0CEFAF0689, 
+0xF971421321BF0EEF, 0xB6801FD559814C3B, 0x87B4F44F4ADD7435, 0x1EB4A359B648DD1A, 
+0x882C2AAC43043F88, 0x49B7B41DED57BA25, 0x53BDA025F6FC526C, 0x003E23BC4E30BC8C, 
+0x3E452F19E6A2A2B7, 0x3A2C298AAEC2550B, 0xA6E34AAB3243255B, 0xBDAE4A7654AC874E, 
+0x90DEDC47AD58380C, 0x21DD25554C341118, 0xB6C59EC10A5AA3CC, 0x003CC50B37E10BD5, 
+0x4BA78447D734CEBA, 0x72042E0938A0E28F, 0x22DA6DC14342CAE6, 0x4B1DE0B02BC895E1, 
+0x740613E67DB66935, 0xCDCD54964A369755, 0xB2C719875F0F1751, 0x001E27C8BDC04CED, 
+0xFB5E379CF5B93CC0, 0x540B4F28A4A9B127, 0x5260EA7152D08F5E, 0x35832DD3E180E60C, 
+0x4CBFDDA18180A789, 0x937BC87003EB24BB, 0x447BEE522A3EBEBB, 0x0039958EEF3179E5, 
+0x6BBE484A927815DF, 0x46B3EF30D9652054, 0xD82CE2DF79F56F77, 0xA2EBC82B8D9BE3A0, 
+0xCF800369FB4EF3CF, 0xD610A522917DE72D, 0xC4BBA84BA0358B2F, 0x003C1F6A123B3E44, 
+0xB05BB185D0743EAB, 0x8FE6067271639D58, 0xADA7C103C63A7AF3, 0x1443FB3F7E317497, 
+0x4C8E72AB9C785436, 0xED4778B96FD1FE79, 0x72483882EC6AA07E, 0x00211EB6F8C984AD, 
+0xDDC29241F865EBC9, 0x3AC0E41B9175D8B7, 0xF72AA436FC3AAFFC, 0xB16A204BFA0967CD, 
+0x8032BAA41773334F, 0xF3575520FADD110C, 0x052540EB5C984C1D, 0x002289CBAC7451E0
+};
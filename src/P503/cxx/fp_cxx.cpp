@@ -0,0 +1,124 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: modular arithmetic for P503 instantiated from the header-only C++ field backend
+*********************************************************************************************/
+
+extern "C" {
+#include "../P503_internal.h"
+#include "../../internal.h"
+}
+#include "../../cxx/fp.hpp"
+
+
+struct P503_params {
+    static constexpr unsigned nwords = NWORDS64_FIELD;
+    static constexpr sidh::limb_t p[NWORDS64_FIELD] = { 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xABFFFFFFFFFFFFFF, 0x13085BDA2211E7A0, 0x1B9BF6C87B7E7DAF, 0x6045C6BDDA77A4D0, 0x004066F541811E1E };
+};
+
+typedef sidh::Fp<P503_params> fp503;
+typedef sidh::Fp2<P503_params> fp2_503;
+
+static_assert(fp503::zero_words == p503_ZERO_WORDS, "p503_ZERO_WORDS does not match p503+1");
+static_assert(sizeof(digit_t) == sizeof(sidh::limb_t), "the C++ field backend requires 64-bit digits");
+
+
+extern "C" {
+
+void mp_sub503_p2(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Multiprecision subtraction with correction with 2*p, c = a-b+2p.
+    fp503::sub_p2(a, b, c);
+}
+
+
+void mp_sub503_p4(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Multiprecision subtraction with correction with 4*p, c = a-b+4p.
+    fp503::sub_p4(a, b, c);
+}
+
+
+void fpadd503(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Modular addition, c = a+b mod p503.
+  // Inputs: a, b in [0, 2*p503-1]
+  // Output: c in [0, 2*p503-1]
+    fp503::add(a, b, c);
+}
+
+
+void fpsub503(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Modular subtraction, c = a-b mod p503.
+  // Inputs: a, b in [0, 2*p503-1]
+  // Output: c in [0, 2*p503-1]
+    fp503::sub(a, b, c);
+}
+
+
+void fpneg503(digit_t* a)
+{ // Modular negation, a = -a mod p503.
+  // Input/output: a in [0, 2*p503-1]
+    fp503::neg(a);
+}
+
+
+void fpdiv2_503(const digit_t* a, digit_t* c)
+{ // Modular division by two, c = a/2 mod p503.
+  // Input : a in [0, 2*p503-1]
+  // Output: c in [0, 2*p503-1]
+    fp503::div2(a, c);
+}
+
+
+void fpcorrection503(digit_t* a)
+{ // Modular correction to reduce field element a in [0, 2*p503-1] to [0, p503-1].
+    fp503::correction(a);
+}
+
+
+void digit_x_digit(const digit_t a, const digit_t b, digit_t* c)
+{ // Digit multiplication, digit * digit -> 2-digit result
+    sidh::dlimb_t t = (sidh::dlimb_t)a*b;
+
+    c[0] = (digit_t)t;
+    c[1] = (digit_t)(t >> 64);
+}
+
+
+void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords)
+{ // Multiprecision multiply, c = a*b, where lng(a) = lng(b) = nwords.
+
+    UNREFERENCED_PARAMETER(nwords);
+
+    fp503::mul(a, b, c);
+}
+
+
+void mp_sqr(const digit_t* a, digit_t* c, const unsigned int nwords)
+{ // Multiprecision squaring, c = a^2, where lng(a) = nwords.
+
+    UNREFERENCED_PARAMETER(nwords);
+
+    fp503::sqr(a, c);
+}
+
+
+void rdc_mont(digit_t* ma, digit_t* mc)
+{ // Efficient Montgomery reduction using comba and exploiting the special form of the prime p503.
+  // mc = ma*R^-1 mod p503x2, where R = 2^512.
+  // If ma < 2^512*p503, the output mc is in the range [0, 2*p503-1].
+  // ma is assumed to be in Montgomery representation.
+    fp503::rdc(ma, mc);
+}
+
+
+void fp2mul503_cxx(const f2elm_t a, const f2elm_t b, f2elm_t c)
+{ // GF(p503^2) multiplication using Montgomery arithmetic, c = a*b in GF(p503^2).
+    fp2_503::mul(a, b, c);
+}
+
+
+void fp2sqr503_cxx(const f2elm_t a, f2elm_t c)
+{ // GF(p503^2) squaring using Montgomery arithmetic, c = a^2 in GF(p503^2).
+    fp2_503::sqr(a, c);
+}
+
+}
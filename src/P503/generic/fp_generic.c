@@ -166,6 +166,23 @@ void digit_x_digit(const digit_t a, const digit_t b, digit_t* c)
 }
 
 
+#if defined(REDUCED_RADIX_IMPLEMENTATION)
+
+// p503 + 1 in radix 2^RR_BITS
+#if (RR_BITS == 56)
+    static const rr_limb_t p503p1_rr[10] = { 0x00000000000000, 0x00000000000000, 0x00000000000000, 0x00000000000000, 0x11E7A0AC000000, 0x7DAF13085BDA22,
+                                             0xD01B9BF6C87B7E, 0x6045C6BDDA77A4, 0x4066F541811E1E, 0x00000000000000 };
+#elif (RR_BITS == 28)
+    static const rr_limb_t p503p1_rr[19] = { 0x0000000, 0x0000000, 0x0000000, 0x0000000, 0x0000000, 0x0000000, 0x0000000, 0x0000000,
+                                             0xC000000, 0x11E7A0A, 0x85BDA22, 0x7DAF130, 0x6C87B7E, 0xD01B9BF, 0xDDA77A4, 0x6045C6B,
+                                             0x1811E1E, 0x4066F54, 0x0000000 };
+#endif
+#define RR_PRIME_P1    p503p1_rr
+
+#include "../../fp_reduced_radix.c"
+
+#else
+
 void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords)
 { // Multiprecision comba multiply, c = a*b, where lng(a) = lng(b) = nwords.   
     unsigned int i, j;
@@ -201,6 +218,36 @@ void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int n
 }
 
 
+void mp_sqr(const digit_t* a, digit_t* c, const unsigned int nwords)
+{ // Multiprecision comba squaring, c = a^2, where lng(a) = nwords.
+    unsigned int i, j, carry = 0;
+    digit_t t = 0, u = 0, v = 0, UV[2];
+    
+    for (i = 0; i < 2*nwords-1; i++) {
+        for (j = (i < nwords) ? 0 : i-nwords+1; j < i-j; j++) {
+            MUL(a[j], a[i-j], UV+1, UV[0]);          // Cross products are computed once and added twice
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+        }
+        if ((i & 1) == 0) {
+            MUL(a[i/2], a[i/2], UV+1, UV[0]); 
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+        }
+        c[i] = v;
+        v = u; 
+        u = t;
+        t = 0;
+    }
+    c[2*nwords-1] = v; 
+}
+
+
 void rdc_mont(digit_t* ma, digit_t* mc)
 { // Efficient Montgomery reduction using comba and exploiting the special form of the prime p503.
   // mc = ma*R^-1 mod p503x2, where R = 2^512.
@@ -253,4 +300,6 @@ void rdc_mont(digit_t* ma, digit_t* mc)
     }
     ADDC(0, v, ma[2*NWORDS_FIELD-1], carry, v); 
     mc[NWORDS_FIELD-1] = v;
-}
\ No newline at end of file
+}
+
+#endif
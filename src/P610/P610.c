@@ -70,8 +70,37 @@ const uint64_t Montgomery_R2[NWORDS64_FIELD]     = { 0xE75F5D201A197727, 0xE0B85
 const uint64_t Montgomery_one[NWORDS64_FIELD]    = { 0x00000000670CC8E6, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x9A34000000000000,
                                                      0x4D99C2BD28717A3F, 0x0A4A1839A323D41C, 0xD2B62215D06AD1E2, 0x1369026E862CAF3D, 0x000000010894E964 };
 
+#ifdef AVX2_X4_IMPLEMENTATION
+// Constants for the 4-way AVX2 representation in radix 2^29, with Montgomery constant R' = 2^(29*NLIMBS_X4)
+// p610 + 1 in radix 2^29
+const uint64_t p610p1_x4[NLIMBS_X4]             = { 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                                                    0x00000000, 0x00000000, 0x1B808000, 0x14B5605C, 0x1784DE8A, 0x07FCD5D8, 0x1EFD1412, 0x04A5535C,
+                                                    0x12FA10C4, 0x046592AD, 0x109479F6, 0x11032021, 0x07BF6A76, 0x00000001, 0x00000000 };
+// p610 x 2 in radix 2^29
+const uint64_t p610x2_x4[NLIMBS_X4]             = { 0x1FFFFFFE, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF,
+                                                    0x1FFFFFFF, 0x1FFFFFFF, 0x1700FFFF, 0x096AC0B9, 0x0F09BD15, 0x0FF9ABB1, 0x1DFA2824, 0x094AA6B9,
+                                                    0x05F42188, 0x08CB255B, 0x0128F3EC, 0x02064043, 0x0F7ED4ED, 0x00000002, 0x00000000 };
+// p610 x 4 in radix 2^29
+const uint64_t p610x4_x4[NLIMBS_X4]             = { 0x1FFFFFFC, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF,
+                                                    0x1FFFFFFF, 0x1FFFFFFF, 0x0E01FFFF, 0x12D58173, 0x1E137A2A, 0x1FF35762, 0x1BF45048, 0x12954D73,
+                                                    0x0BE84310, 0x11964AB6, 0x0251E7D8, 0x040C8086, 0x1EFDA9DA, 0x00000004, 0x00000000 };
+// Conversion constant Montgomery_R2_x4 = (2^667)^2/2^640 mod p610, in radix 2^29
+const uint64_t Montgomery_R2_x4[NLIMBS_X4]      = { 0x012BACC9, 0x0CD50241, 0x0670CC8E, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                                                    0x00000000, 0x00000000, 0x121B8000, 0x17C37A98, 0x1B902E78, 0x0FE37A69, 0x0FE59122, 0x161EC18E,
+                                                    0x1ED88993, 0x19C3F0B0, 0x15C23C4D, 0x02FC16BA, 0x0C882125, 0x00000000, 0x00000000 };
+// Conversion constant Montgomery_R_x4 = 2^640 mod p610, in radix 2^29
+const uint64_t Montgomery_R_x4[NLIMBS_X4]       = { 0x070CC8E6, 0x00000003, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                                                    0x00000000, 0x00000000, 0x068D0000, 0x10E2F47F, 0x199C2BD2, 0x11EA0E26, 0x0860E68C, 0x1A3C4149,
+                                                    0x0215D06A, 0x19EE95B1, 0x1BA18B2B, 0x0826D204, 0x10894E96, 0x00000000, 0x00000000 };
+#endif
+
 
 // Fixed parameters for isogeny tree computation
+#if defined(TUNED_STRATEGIES)
+const unsigned int strat_Alice[MAX_Alice-1] = STRAT_ALICE_TUNED;
+
+const unsigned int strat_Bob[MAX_Bob-1] = STRAT_BOB_TUNED;
+#else
 const unsigned int strat_Alice[MAX_Alice-1] = { 
 67, 37, 21, 12, 7, 4, 2, 1, 1, 2, 1, 1, 3, 2, 1, 1, 1, 1, 5, 3, 2, 1, 1, 1, 1, 
 2, 1, 1, 1, 9, 5, 3, 2, 1, 1, 1, 1, 2, 1, 1, 1, 4, 2, 1, 1, 1, 2, 1, 1, 16, 9, 
@@ -89,6 +118,7 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 9, 5, 3, 2, 1, 1, 1, 1, 2, 1, 1, 1, 4, 2, 1, 1, 1, 2, 1, 1, 17, 9, 5, 3, 2, 1, 1, 
 1, 1, 2, 1, 1, 1, 4, 2, 1, 1, 1, 2, 1, 1, 8, 4, 2, 1, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 
 1, 1 };
+#endif
 
 // Setting up macro defines and including GF(p), GF(p^2), curve, isogeny and kex functions
 #define fpcopy                        fpcopy610
@@ -103,6 +133,7 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 #define fpinv_mont                    fpinv610_mont
 #define fpinv_chain_mont              fpinv610_chain_mont
 #define fpinv_mont_bingcd             fpinv610_mont_bingcd
+#define fpinv_mont_safegcd            fpinv610_mont_safegcd
 #define fp2copy                       fp2copy610
 #define fp2zero                       fp2zero610
 #define fp2add                        fp2add610
@@ -121,17 +152,39 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 #define mp_add_asm                    mp_add610_asm
 #define mp_subaddx2_asm               mp_subadd610x2_asm
 #define mp_dblsubx2_asm               mp_dblsub610x2_asm
+#define fp2sqr_asm                    fp2sqr610_asm
+#define fp2mul_cxx                    fp2mul610_cxx
+#define fp2sqr_cxx                    fp2sqr610_cxx
 #define crypto_kem_keypair            crypto_kem_keypair_SIKEp610
 #define crypto_kem_enc                crypto_kem_enc_SIKEp610
 #define crypto_kem_dec                crypto_kem_dec_SIKEp610
+#define crypto_kem_dec_x4             crypto_kem_dec_x4_SIKEp610
+#define crypto_kem_pk_expand          crypto_kem_pk_expand_SIKEp610
+#define crypto_kem_enc_ctx            crypto_kem_enc_ctx_SIKEp610
+#define sike_pk_ctx                   sike_pk_ctx_SIKEp610
+#define crypto_kem_enc_batch          crypto_kem_enc_batch_SIKEp610
+#define crypto_kem_dec_batch          crypto_kem_dec_batch_SIKEp610
 #define random_mod_order_A            random_mod_order_A_SIDHp610
 #define random_mod_order_B            random_mod_order_B_SIDHp610
 #define EphemeralKeyGeneration_A      EphemeralKeyGeneration_A_SIDHp610
 #define EphemeralKeyGeneration_B      EphemeralKeyGeneration_B_SIDHp610
 #define EphemeralSecretAgreement_A    EphemeralSecretAgreement_A_SIDHp610
 #define EphemeralSecretAgreement_B    EphemeralSecretAgreement_B_SIDHp610
+#define EphemeralKeyGeneration_A_x4   EphemeralKeyGeneration_A_x4_SIDHp610
+#define EphemeralSecretAgreement_B_x4 EphemeralSecretAgreement_B_x4_SIDHp610
+#define EphemeralKeyPoolStart_A       EphemeralKeyPoolStart_A_SIDHp610
+#define EphemeralKeyPoolStart_B       EphemeralKeyPoolStart_B_SIDHp610
+#define EphemeralKeyPoolStop          EphemeralKeyPoolStop_SIDHp610
+#define EphemeralKeyPair_A            EphemeralKeyPair_A_SIDHp610
+#define EphemeralKeyPair_B            EphemeralKeyPair_B_SIDHp610
 
 #include "../fpx.c"
+#include "P610_fixed_base_tables.c"
 #include "../ec_isogeny.c"
 #include "../sidh.c"
+#ifdef AVX2_X4_IMPLEMENTATION
+    #include "../fpx_x4.c"
+    #include "../ec_isogeny_x4.c"
+    #include "../sidh_x4.c"
+#endif
 #include "../sike.c"
\ No newline at end of file
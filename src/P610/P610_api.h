@@ -18,6 +18,9 @@
 // Algorithm name
 #define CRYPTO_ALGNAME "SIKEp610"  
 
+// Size of a public key context for repeated encapsulations to the same public key
+#define CRYPTO_PKCTXBYTES      50064
+
 // SIKE's key generation
 // It produces a private key sk and computes the public key pk.
 // Outputs: secret key sk (CRYPTO_SECRETKEYBYTES = 524 bytes)
@@ -36,6 +39,43 @@ int crypto_kem_enc_SIKEp610(unsigned char *ct, unsigned char *ss, const unsigned
 // Outputs: shared secret ss      (CRYPTO_BYTES = 24 bytes)
 int crypto_kem_dec_SIKEp610(unsigned char *ss, const unsigned char *ct, const unsigned char *sk);
 
+// SIKE's decapsulation of 4 independent ciphertexts, computed together using the 4-way AVX2 engine.
+// Available when the library is compiled with AVX2 code generation (e.g., with -march=native on processors supporting AVX2).
+// Input:   secret keys sk[i]         (CRYPTO_SECRETKEYBYTES = 524 bytes each)
+//          ciphertext messages ct[i] (CRYPTO_CIPHERTEXTBYTES = 486 bytes each) 
+// Outputs: shared secrets ss[i]      (CRYPTO_BYTES = 24 bytes each)
+int crypto_kem_dec_x4_SIKEp610(unsigned char* const ss[4], const unsigned char* const ct[4], const unsigned char* const sk[4]);
+
+// Public key context, which holds a public key together with the values precomputed by crypto_kem_pk_expand_SIKEp610()
+typedef struct { unsigned long long opaque[CRYPTO_PKCTXBYTES/8]; } sike_pk_ctx_SIKEp610;
+
+// SIKE's public key expansion
+// It precomputes the values that depend only on the public key, for repeated encapsulations with crypto_kem_enc_ctx_SIKEp610().
+// Input:   public key pk         (CRYPTO_PUBLICKEYBYTES = 462 bytes)
+// Output:  public key context ctx
+int crypto_kem_pk_expand_SIKEp610(sike_pk_ctx_SIKEp610 *ctx, const unsigned char *pk);
+
+// SIKE's encapsulation to a public key expanded by crypto_kem_pk_expand_SIKEp610(). The results are the same as with crypto_kem_enc_SIKEp610().
+// Input:   public key context ctx
+// Outputs: shared secret ss      (CRYPTO_BYTES = 24 bytes)
+//          ciphertext message ct (CRYPTO_CIPHERTEXTBYTES = 486 bytes)
+int crypto_kem_enc_ctx_SIKEp610(unsigned char *ct, unsigned char *ss, const sike_pk_ctx_SIKEp610 *ctx);
+
+// SIKE's encapsulation of n independent operations, which are computed in groups sharing their field inversions.
+// In the parallel traversal mode (USE_PARALLEL_TRAVERSAL=TRUE), the operations are distributed over the worker pool.
+// Each operation is equivalent to a call to crypto_kem_enc_SIKEp610().
+// Input:   public keys pk[i]         (CRYPTO_PUBLICKEYBYTES = 462 bytes each)
+// Outputs: shared secrets ss[i]      (CRYPTO_BYTES = 24 bytes each)
+//          ciphertext messages ct[i] (CRYPTO_CIPHERTEXTBYTES = 486 bytes each)
+int crypto_kem_enc_batch_SIKEp610(unsigned char* const ct[], unsigned char* const ss[], const unsigned char* const pk[], unsigned int n);
+
+// SIKE's decapsulation of n independent ciphertexts, computed like crypto_kem_enc_batch_SIKEp610().
+// The results are the same as with crypto_kem_dec_SIKEp610().
+// Input:   secret keys sk[i]         (CRYPTO_SECRETKEYBYTES = 524 bytes each)
+//          ciphertext messages ct[i] (CRYPTO_CIPHERTEXTBYTES = 486 bytes each) 
+// Outputs: shared secrets ss[i]      (CRYPTO_BYTES = 24 bytes each)
+int crypto_kem_dec_batch_SIKEp610(unsigned char* const ss[], const unsigned char* const ct[], const unsigned char* const sk[], unsigned int n);
+
 
 // Encoding of keys for KEM-based isogeny system "SIKEp610" (wire format):
 // ----------------------------------------------------------------------
@@ -93,6 +133,27 @@ int EphemeralSecretAgreement_A_SIDHp610(const unsigned char* PrivateKeyA, const
 // Output: a shared secret SharedSecretB that consists of one element in GF(p610^2) encoded in 154 bytes. 
 int EphemeralSecretAgreement_B_SIDHp610(const unsigned char* PrivateKeyB, const unsigned char* PublicKeyA, unsigned char* SharedSecretB);
 
+// 4-way versions of Alice's ephemeral public key generation and Bob's ephemeral shared secret computation.
+// They process 4 independent inputs together using the 4-way AVX2 engine, with the same encodings as the functions above.
+// Available when the library is compiled with AVX2 code generation (e.g., with -march=native on processors supporting AVX2).
+int EphemeralKeyGeneration_A_x4_SIDHp610(const unsigned char* const PrivateKeyA[4], unsigned char* const PublicKeyA[4]);
+int EphemeralSecretAgreement_B_x4_SIDHp610(const unsigned char* const PrivateKeyB[4], const unsigned char* const PublicKeyA[4], unsigned char* const SharedSecretB[4]);
+
+// Pool of ephemeral key pairs pre-generated by background threads, which takes the key generation off the critical path of a key exchange.
+// EphemeralKeyPoolStart_A/B_SIDHp610() start nthreads threads that keep up to capacity key pairs of Alice or Bob ready, and return 0 on success.
+// The pools are available when the library is built with USE_KEY_POOL=TRUE, and are stopped by EphemeralKeyPoolStop_SIDHp610(), which erases
+// the unused key pairs. The start functions are thread-safe. The stop function must not run concurrently with other calls to the pool functions.
+int EphemeralKeyPoolStart_A_SIDHp610(const unsigned int capacity, const unsigned int nthreads);
+int EphemeralKeyPoolStart_B_SIDHp610(const unsigned int capacity, const unsigned int nthreads);
+void EphemeralKeyPoolStop_SIDHp610(void);
+
+// Alice's and Bob's ephemeral key pairs, taken from the pool when it holds one and generated by the calling thread otherwise.
+// They can be called by any number of threads. In a child process after fork(), the key pairs are always generated by the calling thread.
+// Outputs: Alice's private key PrivateKeyA (39 bytes) or Bob's private key PrivateKeyB (38 bytes), 
+//          and the corresponding public key (462 bytes).
+int EphemeralKeyPair_A_SIDHp610(unsigned char* PrivateKeyA, unsigned char* PublicKeyA);
+int EphemeralKeyPair_B_SIDHp610(unsigned char* PrivateKeyB, unsigned char* PublicKeyB);
+
 
 // Encoding of keys for KEX-based isogeny system "SIDHp610" (wire format):
 // ----------------------------------------------------------------------
@@ -346,6 +346,7 @@ const uint64_t v_3_torsion[TABLE_V3_LEN][2 * NWORDS64_FIELD] =
 #define fpinv_mont                    fpinv610_mont
 #define fpinv_chain_mont              fpinv610_chain_mont
 #define fpinv_mont_bingcd             fpinv610_mont_bingcd
+#define fpinv_mont_safegcd            fpinv610_mont_safegcd
 #define fp2copy                       fp2copy610
 #define fp2zero                       fp2zero610
 #define fp2add                        fp2add610
@@ -364,6 +365,9 @@ const uint64_t v_3_torsion[TABLE_V3_LEN][2 * NWORDS64_FIELD] =
 #define mp_add_asm                    mp_add610_asm
 #define mp_subaddx2_asm               mp_subadd610x2_asm
 #define mp_dblsubx2_asm               mp_dblsub610x2_asm
+#define fp2sqr_asm                    fp2sqr610_asm
+#define fp2mul_cxx                    fp2mul610_cxx
+#define fp2sqr_cxx                    fp2sqr610_cxx
 #define random_mod_order_A            random_mod_order_A_SIDHp610
 #define random_mod_order_B            random_mod_order_B_SIDHp610
 #define EphemeralKeyGeneration_A      EphemeralKeyGeneration_A_SIDHp610_Compressed
@@ -0,0 +1,124 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: modular arithmetic for P610 instantiated from the header-only C++ field backend
+*********************************************************************************************/
+
+extern "C" {
+#include "../P610_internal.h"
+#include "../../internal.h"
+}
+#include "../../cxx/fp.hpp"
+
+
+struct P610_params {
+    static constexpr unsigned nwords = NWORDS64_FIELD;
+    static constexpr sidh::limb_t p[NWORDS64_FIELD] = { 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0x6E01FFFFFFFFFFFF, 0xB1784DE8AA5AB02E, 0x9AE7BF45048FF9AB, 0xB255B2FA10C4252A, 0x819010C251E7D88C, 0x000000027BF6A768 };
+};
+
+typedef sidh::Fp<P610_params> fp610;
+typedef sidh::Fp2<P610_params> fp2_610;
+
+static_assert(fp610::zero_words == p610_ZERO_WORDS, "p610_ZERO_WORDS does not match p610+1");
+static_assert(sizeof(digit_t) == sizeof(sidh::limb_t), "the C++ field backend requires 64-bit digits");
+
+
+extern "C" {
+
+void mp_sub610_p2(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Multiprecision subtraction with correction with 2*p, c = a-b+2p.
+    fp610::sub_p2(a, b, c);
+}
+
+
+void mp_sub610_p4(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Multiprecision subtraction with correction with 4*p, c = a-b+4p.
+    fp610::sub_p4(a, b, c);
+}
+
+
+void fpadd610(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Modular addition, c = a+b mod p610.
+  // Inputs: a, b in [0, 2*p610-1]
+  // Output: c in [0, 2*p610-1]
+    fp610::add(a, b, c);
+}
+
+
+void fpsub610(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Modular subtraction, c = a-b mod p610.
+  // Inputs: a, b in [0, 2*p610-1]
+  // Output: c in [0, 2*p610-1]
+    fp610::sub(a, b, c);
+}
+
+
+void fpneg610(digit_t* a)
+{ // Modular negation, a = -a mod p610.
+  // Input/output: a in [0, 2*p610-1]
+    fp610::neg(a);
+}
+
+
+void fpdiv2_610(const digit_t* a, digit_t* c)
+{ // Modular division by two, c = a/2 mod p610.
+  // Input : a in [0, 2*p610-1]
+  // Output: c in [0, 2*p610-1]
+    fp610::div2(a, c);
+}
+
+
+void fpcorrection610(digit_t* a)
+{ // Modular correction to reduce field element a in [0, 2*p610-1] to [0, p610-1].
+    fp610::correction(a);
+}
+
+
+void digit_x_digit(const digit_t a, const digit_t b, digit_t* c)
+{ // Digit multiplication, digit * digit -> 2-digit result
+    sidh::dlimb_t t = (sidh::dlimb_t)a*b;
+
+    c[0] = (digit_t)t;
+    c[1] = (digit_t)(t >> 64);
+}
+
+
+void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords)
+{ // Multiprecision multiply, c = a*b, where lng(a) = lng(b) = nwords.
+
+    UNREFERENCED_PARAMETER(nwords);
+
+    fp610::mul(a, b, c);
+}
+
+
+void mp_sqr(const digit_t* a, digit_t* c, const unsigned int nwords)
+{ // Multiprecision squaring, c = a^2, where lng(a) = nwords.
+
+    UNREFERENCED_PARAMETER(nwords);
+
+    fp610::sqr(a, c);
+}
+
+
+void rdc_mont(digit_t* ma, digit_t* mc)
+{ // Efficient Montgomery reduction using comba and exploiting the special form of the prime p610.
+  // mc = ma*R^-1 mod p610x2, where R = 2^640.
+  // If ma < 2^640*p610, the output mc is in the range [0, 2*p610-1].
+  // ma is assumed to be in Montgomery representation.
+    fp610::rdc(ma, mc);
+}
+
+
+void fp2mul610_cxx(const f2elm_t a, const f2elm_t b, f2elm_t c)
+{ // GF(p610^2) multiplication using Montgomery arithmetic, c = a*b in GF(p610^2).
+    fp2_610::mul(a, b, c);
+}
+
+
+void fp2sqr610_cxx(const f2elm_t a, f2elm_t c)
+{ // GF(p610^2) squaring using Montgomery arithmetic, c = a^2 in GF(p610^2).
+    fp2_610::sqr(a, c);
+}
+
+}
@@ -6,6 +6,9 @@
 
 #include "../P751_internal.h"
 #include "../../internal.h"
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+    #include "../../cpu_features.h"
+#endif
 
 
 // Global constants
@@ -15,6 +18,52 @@ extern const uint64_t p751x2[NWORDS_FIELD];
 extern const uint64_t p751x4[NWORDS_FIELD];
 
 
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+// Variants of the multiplication, squaring and Montgomery reduction, the fastest one supported by the host is bound at load time
+void mul751_asm_adx(const digit_t* a, const digit_t* b, digit_t* c);
+void mul751_asm_mulx(const digit_t* a, const digit_t* b, digit_t* c);
+void rdc751_asm_adx(digit_t* ma, digit_t* mc);
+void rdc751_asm_mulx(digit_t* ma, digit_t* mc);
+void mul751_asm_nomulx(const digit_t* a, const digit_t* b, digit_t* c);
+void rdc751_asm_nomulx(digit_t* ma, digit_t* mc);
+void sqr751_asm_adx(const digit_t* a, digit_t* c);
+void sqr751_asm_mulx(const digit_t* a, digit_t* c);
+void sqr751_asm_nomulx(const digit_t* a, digit_t* c);
+
+static void (*mul751_kernel)(const digit_t* a, const digit_t* b, digit_t* c) = mul751_asm_nomulx;
+static void (*rdc751_kernel)(digit_t* ma, digit_t* mc) = rdc751_asm_nomulx;
+static void (*sqr751_kernel)(const digit_t* a, digit_t* c) = sqr751_asm_nomulx;
+
+// Variants of the fused GF(p751^2) squaring, processors without MULX compose it from the kernels above
+void fp2sqr751_asm_adx(const f2elm_t a, f2elm_t c);
+void fp2sqr751_asm_mulx(const f2elm_t a, f2elm_t c);
+static void fp2sqr751_karatsuba(const f2elm_t a, f2elm_t c);
+
+static void (*fp2sqr751_kernel)(const f2elm_t a, f2elm_t c) = fp2sqr751_karatsuba;
+
+
+__attribute__((constructor)) static void fp751_dispatch_init(void)
+{ // Selection of the multiplication, squaring, reduction and fused GF(p^2) squaring kernels according to the host's support for MULX and ADX.
+  // Processors without MULX keep the baseline x64 assembly.
+    unsigned int features = cpu_features();
+
+    if ((features & CPU_FEATURE_MULX) && (features & CPU_FEATURE_ADX)) {
+        mul751_kernel = mul751_asm_adx;
+        rdc751_kernel = rdc751_asm_adx;
+        sqr751_kernel = sqr751_asm_adx;
+        fp2sqr751_kernel = fp2sqr751_asm_adx;
+    } else if (features & CPU_FEATURE_MULX) {
+        mul751_kernel = mul751_asm_mulx;
+        rdc751_kernel = rdc751_asm_mulx;
+        sqr751_kernel = sqr751_asm_mulx;
+        fp2sqr751_kernel = fp2sqr751_asm_mulx;
+    }
+}
+
+#endif
+
+
 __inline void mp_sub751_p2(const digit_t* a, const digit_t* b, digit_t* c)
 { // Multiprecision subtraction with correction with 2*p, c = a-b+2p.    
 #if (OS_TARGET == OS_WIN) || defined(GENERIC_IMPLEMENTATION) || (TARGET == TARGET_ARM) || (TARGET == TARGET_ARM64 && NBITS_FIELD == 751)
@@ -571,6 +620,10 @@ void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int n
     c[22] = uv[0];
     c[23] = uv[1];
 
+#elif (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+    mul751_kernel(a, b, c);
+
 #elif (OS_TARGET == OS_NIX)
     
     mul751_asm(a, b, c);
@@ -579,6 +632,27 @@ void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int n
 }
 
 
+void mp_sqr(const digit_t* a, digit_t* c, const unsigned int nwords)
+{ // Multiprecision squaring, c = a^2, where lng(a) = nwords.
+        
+    UNREFERENCED_PARAMETER(nwords);
+
+#if (OS_TARGET == OS_WIN)
+
+    mp_mul(a, a, c, NWORDS_FIELD);
+
+#elif (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+    sqr751_kernel(a, c);
+
+#elif (OS_TARGET == OS_NIX)
+    
+    sqr751_asm(a, c);
+
+#endif
+}
+
+
 void rdc_mont(digit_t* ma, digit_t* mc)
 { // Montgomery reduction exploiting special form of the prime.
   // mc = ma*R^-1 mod p751x2, where R = 2^768.
@@ -899,9 +973,39 @@ void rdc_mont(digit_t* ma, digit_t* mc)
     ADDC(carry, uv[1], 0, carry, uv[1]); 
     ADDC(0, uv[1], ma[23], carry, mc[11]); 
     
+#elif (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+    rdc751_kernel(ma, mc);
+
 #elif (OS_TARGET == OS_NIX)                 
     
     rdc751_asm(ma, mc);    
 
 #endif
-}
\ No newline at end of file
+}
+
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+
+void fp2sqr751_asm(const f2elm_t a, f2elm_t c)
+{ // GF(p751^2) squaring using Montgomery arithmetic, c = a^2 in GF(p751^2), through the kernel bound at load time.
+    fp2sqr751_kernel(a, c);
+}
+
+
+static void fp2sqr751_karatsuba(const f2elm_t a, f2elm_t c)
+{ // GF(p751^2) squaring for processors without MULX, c = a^2 in GF(p751^2).
+  // Inputs: a = a0+a1*i, where a0, a1 are in [0, 2*p751-1] 
+  // Output: c = c0+c1*i, where c0, c1 are in [0, 2*p751-1] 
+    felm_t t1, t2, t3;
+    dfelm_t tt;
+    
+    mp_add751_asm(a[0], a[1], t1);                   // t1 = a0+a1 
+    mp_sub751_p4_asm(a[0], a[1], t2);                // t2 = a0-a1
+    mp_add751_asm(a[0], a[0], t3);                   // t3 = 2a0
+    mul751_kernel(t1, t2, tt);
+    rdc751_kernel(tt, c[0]);                         // c0 = (a0+a1)(a0-a1)
+    mul751_kernel(t3, a[1], tt);
+    rdc751_kernel(tt, c[1]);                         // c1 = 2a0*a1
+}
+
+#endif
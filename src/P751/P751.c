@@ -70,8 +70,42 @@ const uint64_t Montgomery_R2[NWORDS64_FIELD]     = { 0x233046449DAD4058, 0xDB010
 const uint64_t Montgomery_one[NWORDS64_FIELD]    = { 0x00000000000249ad, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x8310000000000000,
                                                      0x5527b1e4375c6c66, 0x697797bf3f4f24d0, 0xc89db7b2ac5c4e2e, 0x4ca4b439d2076956, 0x10f7926c7512c7e9, 0x00002d5b24bce5e2 };
 
+#ifdef AVX2_X4_IMPLEMENTATION
+// Constants for the 4-way AVX2 representation in radix 2^29, with Montgomery constant R' = 2^(29*NLIMBS_X4)
+// p751 + 1 in radix 2^29
+const uint64_t p751p1_x4[NLIMBS_X4]             = { 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                                                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0B000000, 0x1C3C5477, 0x125A1527, 0x198EDC7D,
+                                                    0x1B1A13F7, 0x03B6D4AC, 0x19F5BAFA, 0x10109D30, 0x05CB2574, 0x02B15A82, 0x1EEB719A, 0x025213F2,
+                                                    0x01F71C0E, 0x037F2EAA, 0x00000000 };
+// p751 x 2 in radix 2^29
+const uint64_t p751x2_x4[NLIMBS_X4]             = { 0x1FFFFFFE, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF,
+                                                    0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x15FFFFFF, 0x1878A8EE, 0x04B42A4F, 0x131DB8FB,
+                                                    0x163427EF, 0x076DA959, 0x13EB75F4, 0x00213A61, 0x0B964AE9, 0x0562B504, 0x1DD6E334, 0x04A427E5,
+                                                    0x03EE381C, 0x06FE5D54, 0x00000000 };
+// p751 x 4 in radix 2^29
+const uint64_t p751x4_x4[NLIMBS_X4]             = { 0x1FFFFFFC, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF,
+                                                    0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x1FFFFFFF, 0x0BFFFFFF, 0x10F151DD, 0x0968549F, 0x063B71F6,
+                                                    0x0C684FDF, 0x0EDB52B3, 0x07D6EBE8, 0x004274C3, 0x172C95D2, 0x0AC56A08, 0x1BADC668, 0x09484FCB,
+                                                    0x07DC7038, 0x0DFCBAA8, 0x00000000 };
+// Conversion constant Montgomery_R2_x4 = (2^783)^2/2^768 mod p751, in radix 2^29
+const uint64_t Montgomery_R2_x4[NLIMBS_X4]      = { 0x19F0FFFB, 0x0004935A, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                                                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x17000000, 0x033BCE54, 0x089407F1, 0x07CBD938,
+                                                    0x117760F2, 0x0A2C29FE, 0x12566F43, 0x0A6DC35F, 0x14E03A37, 0x1CA35A80, 0x091515D4, 0x124DD519,
+                                                    0x1EA88DA7, 0x01A5D27D, 0x00000000 };
+// Conversion constant Montgomery_R_x4 = 2^768 mod p751, in radix 2^29
+const uint64_t Montgomery_R_x4[NLIMBS_X4]       = { 0x000249AD, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+                                                    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x11000000, 0x0E363341, 0x1EC790DD, 0x049A0AA4,
+                                                    0x17BF3F4F, 0x11734BBC, 0x0CAB1713, 0x0D913B6F, 0x1D207695, 0x06525A1C, 0x144B1FA5, 0x1EF24D8E,
+                                                    0x1CE5E210, 0x016AD925, 0x00000000 };
+#endif
+
 
 // Fixed parameters for isogeny tree computation
+#if defined(TUNED_STRATEGIES)
+const unsigned int strat_Alice[MAX_Alice-1] = STRAT_ALICE_TUNED;
+
+const unsigned int strat_Bob[MAX_Bob-1] = STRAT_BOB_TUNED;
+#else
 const unsigned int strat_Alice[MAX_Alice-1] = { 
 80, 48, 27, 15, 8, 4, 2, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 7, 4, 2, 1, 1, 2, 1, 
 1, 3, 2, 1, 1, 1, 1, 12, 7, 4, 2, 1, 1, 2, 1, 1, 3, 2, 1, 1, 1, 1, 5, 3, 2, 1, 1, 
@@ -91,6 +125,7 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 15, 8, 4, 2, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 7, 4, 2, 1, 1, 2, 1, 1, 3, 2, 1, 
 1, 1, 1, 21, 12, 8, 4, 2, 1, 1, 2, 1, 1, 4, 2, 1, 1, 2, 1, 1, 5, 3, 2, 1, 1, 1, 1, 
 2, 1, 1, 1, 9, 5, 3, 2, 1, 1, 1, 1, 2, 1, 1, 1, 4, 2, 1, 1, 1, 2, 1, 1 };
+#endif
 
 // Setting up macro defines and including GF(p), GF(p^2), curve, isogeny and kex functions
 #define fpcopy                        fpcopy751
@@ -105,6 +140,7 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 #define fpinv_mont                    fpinv751_mont
 #define fpinv_chain_mont              fpinv751_chain_mont
 #define fpinv_mont_bingcd             fpinv751_mont_bingcd
+#define fpinv_mont_safegcd            fpinv751_mont_safegcd
 #define fp2copy                       fp2copy751
 #define fp2zero                       fp2zero751
 #define fp2add                        fp2add751
@@ -123,17 +159,39 @@ const unsigned int strat_Bob[MAX_Bob-1] = {
 #define mp_add_asm                    mp_add751_asm
 #define mp_subaddx2_asm               mp_subadd751x2_asm
 #define mp_dblsubx2_asm               mp_dblsub751x2_asm
+#define fp2sqr_asm                    fp2sqr751_asm
+#define fp2mul_cxx                    fp2mul751_cxx
+#define fp2sqr_cxx                    fp2sqr751_cxx
 #define crypto_kem_keypair            crypto_kem_keypair_SIKEp751
 #define crypto_kem_enc                crypto_kem_enc_SIKEp751
 #define crypto_kem_dec                crypto_kem_dec_SIKEp751
+#define crypto_kem_dec_x4             crypto_kem_dec_x4_SIKEp751
+#define crypto_kem_pk_expand          crypto_kem_pk_expand_SIKEp751
+#define crypto_kem_enc_ctx            crypto_kem_enc_ctx_SIKEp751
+#define sike_pk_ctx                   sike_pk_ctx_SIKEp751
+#define crypto_kem_enc_batch          crypto_kem_enc_batch_SIKEp751
+#define crypto_kem_dec_batch          crypto_kem_dec_batch_SIKEp751
 #define random_mod_order_A            random_mod_order_A_SIDHp751
 #define random_mod_order_B            random_mod_order_B_SIDHp751
 #define EphemeralKeyGeneration_A      EphemeralKeyGeneration_A_SIDHp751
 #define EphemeralKeyGeneration_B      EphemeralKeyGeneration_B_SIDHp751
 #define EphemeralSecretAgreement_A    EphemeralSecretAgreement_A_SIDHp751
 #define EphemeralSecretAgreement_B    EphemeralSecretAgreement_B_SIDHp751
+#define EphemeralKeyGeneration_A_x4   EphemeralKeyGeneration_A_x4_SIDHp751
+#define EphemeralSecretAgreement_B_x4 EphemeralSecretAgreement_B_x4_SIDHp751
+#define EphemeralKeyPoolStart_A       EphemeralKeyPoolStart_A_SIDHp751
+#define EphemeralKeyPoolStart_B       EphemeralKeyPoolStart_B_SIDHp751
+#define EphemeralKeyPoolStop          EphemeralKeyPoolStop_SIDHp751
+#define EphemeralKeyPair_A            EphemeralKeyPair_A_SIDHp751
+#define EphemeralKeyPair_B            EphemeralKeyPair_B_SIDHp751
 
 #include "../fpx.c"
+#include "P751_fixed_base_tables.c"
 #include "../ec_isogeny.c"
 #include "../sidh.c"
+#ifdef AVX2_X4_IMPLEMENTATION
+    #include "../fpx_x4.c"
+    #include "../ec_isogeny_x4.c"
+    #include "../sidh_x4.c"
+#endif
 #include "../sike.c"
\ No newline at end of file
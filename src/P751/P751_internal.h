@@ -40,8 +40,12 @@
 #define PARAM_A                 6  
 #define PARAM_C                 1
 // Fixed parameters for isogeny tree computation
-#define MAX_INT_POINTS_ALICE    8      
-#define MAX_INT_POINTS_BOB      10 
+#if defined(TUNED_STRATEGIES) && !defined(COMPRESS)
+    #include "P751_strategies.h"            // Generated in strategies/ by "make strategies", not used with compression
+#else
+    #define MAX_INT_POINTS_ALICE    8
+    #define MAX_INT_POINTS_BOB      10
+#endif
 #define MAX_Alice               186
 #define MAX_Bob                 239
 #define MSG_BYTES               32
@@ -105,6 +109,22 @@ typedef felm_t  f2elm_t[2];                                           // Datatyp
 typedef struct { f2elm_t X; f2elm_t Z; } point_proj;                  // Point representation in projective XZ Montgomery coordinates.
 typedef point_proj point_proj_t[1]; 
 
+#ifdef AVX2_X4_IMPLEMENTATION
+    #include <immintrin.h>
+
+    #define NLIMBS_X4           27                                    // Number of 29-bit limbs of a field element in the 4-way AVX2 representation
+    #define ZERO_LIMBS_X4       12                                    // Number of "0" limbs in the least significant part of p751 + 1 in radix 2^29
+    #define PRIMEP1_X4          p751p1_x4
+    #define PRIMEx2_X4          p751x2_x4
+    #define PRIMEx4_X4          p751x4_x4
+
+    typedef __m256i vfelm_t[NLIMBS_X4];                               // Datatype for representing 4 field elements in radix 2^29, one per 64-bit lane
+    typedef vfelm_t vf2elm_t[2];                                      // Datatype for representing 4 quadratic extension field elements GF(p751^2)
+
+    typedef struct { vf2elm_t X; vf2elm_t Z; } vpoint_proj;           // 4 points in projective XZ Montgomery coordinates, one per 64-bit lane
+    typedef vpoint_proj vpoint_proj_t[1];
+#endif
+
 #ifdef COMPRESS
     typedef struct { f2elm_t X; f2elm_t Y; f2elm_t Z; } point_full_proj;  // Point representation in full projective XYZ Montgomery coordinates 
     typedef point_full_proj point_full_proj_t[1]; 
@@ -173,6 +193,7 @@ void mul751_asm(const digit_t* a, const digit_t* b, digit_t* c);
    
 // Field squaring using Montgomery arithmetic, c = a*b*R^-1 mod p751, where R=2^768
 void fpsqr751_mont(const digit_t* ma, digit_t* mc);
+void sqr751_asm(const digit_t* a, digit_t* c);
 
 // Field inversion, a = a^-1 in GF(p751)
 void fpinv751_mont(digit_t* a);
@@ -180,6 +201,9 @@ void fpinv751_mont(digit_t* a);
 // Field inversion, a = a^-1 in GF(p751) using the binary GCD 
 void fpinv751_mont_bingcd(digit_t* a);
 
+// Constant-time field inversion, a = a^-1 in GF(p751) using safegcd
+void fpinv751_mont_safegcd(digit_t* a);
+
 // Chain to compute (p751-3)/4 using Montgomery arithmetic
 void fpinv751_chain_mont(digit_t* a);
 
@@ -212,6 +236,13 @@ void fp2sqr751_mont(const f2elm_t a, f2elm_t c);
 // GF(p751^2) multiplication using Montgomery arithmetic, c = a*b in GF(p751^2)
 void fp2mul751_mont(const f2elm_t a, const f2elm_t b, f2elm_t c);
 
+// Fused GF(p751^2) squaring in x64 assembly, with the same inputs and outputs as fp2sqr751_mont
+void fp2sqr751_asm(const f2elm_t a, f2elm_t c);
+
+// GF(p751^2) multiplication and squaring from the C++ field backend, with the same inputs and outputs as fp2mul751_mont and fp2sqr751_mont
+void fp2mul751_cxx(const f2elm_t a, const f2elm_t b, f2elm_t c);
+void fp2sqr751_cxx(const f2elm_t a, f2elm_t c);
+
 // GF(p751^2) inversion using Montgomery arithmetic, a = (a0-i*a1)/(a0^2+a1^2)
 void fp2inv751_mont(f2elm_t a);
 
@@ -0,0 +1,124 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: modular arithmetic for P751 instantiated from the header-only C++ field backend
+*********************************************************************************************/
+
+extern "C" {
+#include "../P751_internal.h"
+#include "../../internal.h"
+}
+#include "../../cxx/fp.hpp"
+
+
+struct P751_params {
+    static constexpr unsigned nwords = NWORDS64_FIELD;
+    static constexpr sidh::limb_t p[NWORDS64_FIELD] = { 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xEEAFFFFFFFFFFFFF, 0xE3EC968549F878A8, 0xDA959B1A13F7CC76, 0x084E9867D6EBE876, 0x8562B5045CB25748, 0x0E12909F97BADC66, 0x00006FE5D541F71C };
+};
+
+typedef sidh::Fp<P751_params> fp751;
+typedef sidh::Fp2<P751_params> fp2_751;
+
+static_assert(fp751::zero_words == p751_ZERO_WORDS, "p751_ZERO_WORDS does not match p751+1");
+static_assert(sizeof(digit_t) == sizeof(sidh::limb_t), "the C++ field backend requires 64-bit digits");
+
+
+extern "C" {
+
+void mp_sub751_p2(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Multiprecision subtraction with correction with 2*p, c = a-b+2p.
+    fp751::sub_p2(a, b, c);
+}
+
+
+void mp_sub751_p4(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Multiprecision subtraction with correction with 4*p, c = a-b+4p.
+    fp751::sub_p4(a, b, c);
+}
+
+
+void fpadd751(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Modular addition, c = a+b mod p751.
+  // Inputs: a, b in [0, 2*p751-1]
+  // Output: c in [0, 2*p751-1]
+    fp751::add(a, b, c);
+}
+
+
+void fpsub751(const digit_t* a, const digit_t* b, digit_t* c)
+{ // Modular subtraction, c = a-b mod p751.
+  // Inputs: a, b in [0, 2*p751-1]
+  // Output: c in [0, 2*p751-1]
+    fp751::sub(a, b, c);
+}
+
+
+void fpneg751(digit_t* a)
+{ // Modular negation, a = -a mod p751.
+  // Input/output: a in [0, 2*p751-1]
+    fp751::neg(a);
+}
+
+
+void fpdiv2_751(const digit_t* a, digit_t* c)
+{ // Modular division by two, c = a/2 mod p751.
+  // Input : a in [0, 2*p751-1]
+  // Output: c in [0, 2*p751-1]
+    fp751::div2(a, c);
+}
+
+
+void fpcorrection751(digit_t* a)
+{ // Modular correction to reduce field element a in [0, 2*p751-1] to [0, p751-1].
+    fp751::correction(a);
+}
+
+
+void digit_x_digit(const digit_t a, const digit_t b, digit_t* c)
+{ // Digit multiplication, digit * digit -> 2-digit result
+    sidh::dlimb_t t = (sidh::dlimb_t)a*b;
+
+    c[0] = (digit_t)t;
+    c[1] = (digit_t)(t >> 64);
+}
+
+
+void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords)
+{ // Multiprecision multiply, c = a*b, where lng(a) = lng(b) = nwords.
+
+    UNREFERENCED_PARAMETER(nwords);
+
+    fp751::mul(a, b, c);
+}
+
+
+void mp_sqr(const digit_t* a, digit_t* c, const unsigned int nwords)
+{ // Multiprecision squaring, c = a^2, where lng(a) = nwords.
+
+    UNREFERENCED_PARAMETER(nwords);
+
+    fp751::sqr(a, c);
+}
+
+
+void rdc_mont(digit_t* ma, digit_t* mc)
+{ // Efficient Montgomery reduction using comba and exploiting the special form of the prime p751.
+  // mc = ma*R^-1 mod p751x2, where R = 2^768.
+  // If ma < 2^768*p751, the output mc is in the range [0, 2*p751-1].
+  // ma is assumed to be in Montgomery representation.
+    fp751::rdc(ma, mc);
+}
+
+
+void fp2mul751_cxx(const f2elm_t a, const f2elm_t b, f2elm_t c)
+{ // GF(p751^2) multiplication using Montgomery arithmetic, c = a*b in GF(p751^2).
+    fp2_751::mul(a, b, c);
+}
+
+
+void fp2sqr751_cxx(const f2elm_t a, f2elm_t c)
+{ // GF(p751^2) squaring using Montgomery arithmetic, c = a^2 in GF(p751^2).
+    fp2_751::sqr(a, c);
+}
+
+}
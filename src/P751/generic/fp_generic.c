@@ -166,6 +166,25 @@ void digit_x_digit(const digit_t a, const digit_t b, digit_t* c)
 }
 
 
+#if defined(REDUCED_RADIX_IMPLEMENTATION)
+
+// p751 + 1 in radix 2^RR_BITS
+#if (RR_BITS == 56)
+    static const rr_limb_t p751p1_rr[14] = { 0x00000000000000, 0x00000000000000, 0x00000000000000, 0x00000000000000, 0x00000000000000, 0x00000000000000,
+                                             0xA8EEB000000000, 0xE3EC968549F878, 0x959B1A13F7CC76, 0x9867D6EBE876DA, 0x045CB25748084E, 0x97BADC668562B5,
+                                             0x41F71C0E12909F, 0x000000006FE5D5 };
+#elif (RR_BITS == 28)
+    static const rr_limb_t p751p1_rr[28] = { 0x0000000, 0x0000000, 0x0000000, 0x0000000, 0x0000000, 0x0000000, 0x0000000, 0x0000000,
+                                             0x0000000, 0x0000000, 0x0000000, 0x0000000, 0x0000000, 0xA8EEB00, 0x549F878, 0xE3EC968,
+                                             0x3F7CC76, 0x959B1A1, 0xBE876DA, 0x9867D6E, 0x748084E, 0x045CB25, 0x68562B5, 0x97BADC6,
+                                             0xE12909F, 0x41F71C0, 0x06FE5D5, 0x0000000 };
+#endif
+#define RR_PRIME_P1    p751p1_rr
+
+#include "../../fp_reduced_radix.c"
+
+#else
+
 void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords)
 { // Multiprecision comba multiply, c = a*b, where lng(a) = lng(b) = nwords.   
     unsigned int i, j;
@@ -201,6 +220,36 @@ void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int n
 }
 
 
+void mp_sqr(const digit_t* a, digit_t* c, const unsigned int nwords)
+{ // Multiprecision comba squaring, c = a^2, where lng(a) = nwords.
+    unsigned int i, j, carry = 0;
+    digit_t t = 0, u = 0, v = 0, UV[2];
+    
+    for (i = 0; i < 2*nwords-1; i++) {
+        for (j = (i < nwords) ? 0 : i-nwords+1; j < i-j; j++) {
+            MUL(a[j], a[i-j], UV+1, UV[0]);          // Cross products are computed once and added twice
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+        }
+        if ((i & 1) == 0) {
+            MUL(a[i/2], a[i/2], UV+1, UV[0]); 
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+        }
+        c[i] = v;
+        v = u; 
+        u = t;
+        t = 0;
+    }
+    c[2*nwords-1] = v; 
+}
+
+
 void rdc_mont(digit_t* ma, digit_t* mc)
 { // Efficient Montgomery reduction using comba and exploiting the special form of the prime p751.
   // mc = ma*R^-1 mod p751x2, where R = 2^768.
@@ -253,4 +302,6 @@ void rdc_mont(digit_t* ma, digit_t* mc)
     }
     ADDC(0, v, ma[2*NWORDS_FIELD-1], carry, v); 
     mc[NWORDS_FIELD-1] = v;
-}
\ No newline at end of file
+}
+
+#endif
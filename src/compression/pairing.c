@@ -4,6 +4,9 @@
 * Abstract: pairing computation for compression
 *********************************************************************************************/
 
+#if defined(PARALLEL_TRAVERSAL)
+    #include "../threads/thread_pool.h"
+#endif
 
 #define t_points  2
 
@@ -46,19 +49,22 @@ static void final_exponentiation_3_torsion(f2elm_t f, const f2elm_t finv, f2elm_
 }
 
 
-void Tate3_pairings(point_full_proj_t *Qj, f2elm_t* f)
-{
+static void Tate3_miller(point_full_proj_t R, f2elm_t f0, f2elm_t f1)
+{ // Miller loops of the two 3^eB-torsion pairings at the point R, before the final exponentiation
+  // Either f0 or f1 can be NULL to skip that pairing. The line values shared by the two pairings are then computed for one pairing only.
     felm_t *x, *y, *l1, *l2, *n1, *n2, *x2, *x23, *x2p3;
-    f2elm_t xQ2s[t_points], finv[2*t_points], one = {0};
+    f2elm_t xR2, one = {0};
     f2elm_t t0, t1, t2, t3, t4, t5, g, h, tf;
 
     fpcopy((digit_t*)&Montgomery_one, one[0]);
 
-    for (int j = 0; j < t_points; j++) {
-        fp2copy(one, f[j]);
-        fp2copy(one, f[j+t_points]);
-        fp2sqr_mont(Qj[j]->X, xQ2s[j]);
+    if (f0 != NULL) {
+        fp2copy(one, f0);
+    }
+    if (f1 != NULL) {
+        fp2copy(one, f1);
     }
+    fp2sqr_mont(R->X, xR2);
 
     for (int k = 0; k < OBOB_EXPON - 1; k++) {
         l1   = (felm_t*)T_tate3 + 6*k + 0;
@@ -67,35 +73,37 @@ void Tate3_pairings(point_full_proj_t *Qj, f2elm_t* f)
         n2   = (felm_t*)T_tate3 + 6*k + 3;
         x23  = (felm_t*)T_tate3 + 6*k + 4;
         x2p3 = (felm_t*)T_tate3 + 6*k + 5;
-        for (int j = 0; j < t_points; j++) {
-            fpmul_mont(Qj[j]->X[0], *l1, t0[0]);
-            fpmul_mont(Qj[j]->X[1], *l1, t0[1]);
-            fpmul_mont(Qj[j]->X[0], *l2, t2[0]);
-            fpmul_mont(Qj[j]->X[1], *l2, t2[1]);
-            fpadd(xQ2s[j][0], *x23, t4[0]);
-            fpcopy(xQ2s[j][1], t4[1]);
-            fpmul_mont(Qj[j]->X[0], *x2p3, t5[0]);
-            fpmul_mont(Qj[j]->X[1], *x2p3, t5[1]);
-
-            fp2sub(t0, Qj[j]->Y, t1);
+        fpmul_mont(R->X[0], *l1, t0[0]);
+        fpmul_mont(R->X[1], *l1, t0[1]);
+        fpmul_mont(R->X[0], *l2, t2[0]);
+        fpmul_mont(R->X[1], *l2, t2[1]);
+        fpadd(xR2[0], *x23, t4[0]);
+        fpcopy(xR2[1], t4[1]);
+        fpmul_mont(R->X[0], *x2p3, t5[0]);
+        fpmul_mont(R->X[1], *x2p3, t5[1]);
+
+        if (f0 != NULL) {
+            fp2sub(t0, R->Y, t1);
             fpadd(t1[0], *n1, t1[0]);
-            fp2sub(t2, Qj[j]->Y, t3);
+            fp2sub(t2, R->Y, t3);
             fpadd(t3[0], *n2, t3[0]);
             fp2mul_mont(t1, t3, g);
             fp2sub(t4, t5, h);
             fp2_conj(h, h);
             fp2mul_mont(g, h, g);
 
-            fp2sqr_mont(f[j], tf);
-            fp2mul_mont(f[j], tf, f[j]);
-            fp2mul_mont(f[j], g, f[j]);
+            fp2sqr_mont(f0, tf);
+            fp2mul_mont(f0, tf, f0);
+            fp2mul_mont(f0, g, f0);
+        }
 
-            fpsub(t0[1], Qj[j]->Y[0], t1[0]);
-            fpadd(t0[0], Qj[j]->Y[1], t1[1]);
+        if (f1 != NULL) {
+            fpsub(t0[1], R->Y[0], t1[0]);
+            fpadd(t0[0], R->Y[1], t1[1]);
             fpneg(t1[1]);
             fpadd(t1[1], *n1, t1[1]);
-            fpsub(t2[1], Qj[j]->Y[0], t3[0]);
-            fpadd(t2[0], Qj[j]->Y[1], t3[1]);
+            fpsub(t2[1], R->Y[0], t3[0]);
+            fpadd(t2[0], R->Y[1], t3[1]);
             fpneg(t3[1]);
             fpadd(t3[1], *n2, t3[1]);
 
@@ -104,69 +112,62 @@ void Tate3_pairings(point_full_proj_t *Qj, f2elm_t* f)
             fp2_conj(h, h);
             fp2mul_mont(g, h, g);
 
-            fp2sqr_mont(f[j+t_points], tf);
-            fp2mul_mont(f[j+t_points], tf, f[j+t_points]);
-            fp2mul_mont(f[j+t_points], g, f[j+t_points]);
+            fp2sqr_mont(f1, tf);
+            fp2mul_mont(f1, tf, f1);
+            fp2mul_mont(f1, g, f1);
         }
     }
-    for (int j = 0; j < t_points; j++) {
-        x  = (felm_t*)T_tate3 + 6*(OBOB_EXPON-1) + 0;
-        y  = (felm_t*)T_tate3 + 6*(OBOB_EXPON-1) + 1;
-        l1 = (felm_t*)T_tate3 + 6*(OBOB_EXPON-1) + 2;
-        x2 = (felm_t*)T_tate3 + 6*(OBOB_EXPON-1) + 3;
+    x  = (felm_t*)T_tate3 + 6*(OBOB_EXPON-1) + 0;
+    y  = (felm_t*)T_tate3 + 6*(OBOB_EXPON-1) + 1;
+    l1 = (felm_t*)T_tate3 + 6*(OBOB_EXPON-1) + 2;
+    x2 = (felm_t*)T_tate3 + 6*(OBOB_EXPON-1) + 3;
         
-        fpsub(Qj[j]->X[0], *x, t0[0]);
-        fpcopy(Qj[j]->X[1], t0[1]);
+    fpcopy(R->X[1], t0[1]);
+    fpmul_mont(*l1, t0[1], t1[1]);
+    fpcopy(R->X[1], h[1]);
+    fpneg(h[1]);
+
+    if (f0 != NULL) {
+        fpsub(R->X[0], *x, t0[0]);
         fpmul_mont(*l1, t0[0], t1[0]);
-        fpmul_mont(*l1, t0[1], t1[1]);
-        fp2sub(t1, Qj[j]->Y, t2);
+        fp2sub(t1, R->Y, t2);
         fpadd(t2[0], *y, t2[0]);
         fp2mul_mont(t0, t2, g);
-        fpsub(Qj[j]->X[0], *x2, h[0]);
-        fpcopy(Qj[j]->X[1], h[1]);
-        fpneg(h[1]);
+        fpsub(R->X[0], *x2, h[0]);
         fp2mul_mont(g, h, g);
 
-        fp2sqr_mont(f[j], tf);
-        fp2mul_mont(f[j], tf, f[j]);
-        fp2mul_mont(f[j], g, f[j]);
+        fp2sqr_mont(f0, tf);
+        fp2mul_mont(f0, tf, f0);
+        fp2mul_mont(f0, g, f0);
+    }
 
-        fpadd(Qj[j]->X[0], *x, t0[0]);
+    if (f1 != NULL) {
+        fpadd(R->X[0], *x, t0[0]);
         fpmul_mont(*l1, t0[0], t1[0]);
-        fpsub(Qj[j]->Y[0], t1[1], t2[0]);
-        fpadd(Qj[j]->Y[1], t1[0], t2[1]);
+        fpsub(R->Y[0], t1[1], t2[0]);
+        fpadd(R->Y[1], t1[0], t2[1]);
         fpsub(t2[1], *y, t2[1]);
         fp2mul_mont(t0, t2, g);
-        fpadd(Qj[j]->X[0], *x2, h[0]);
+        fpadd(R->X[0], *x2, h[0]);
         fp2mul_mont(g, h, g);
 
-        fp2sqr_mont(f[j+t_points], tf);
-        fp2mul_mont(f[j+t_points], tf, f[j+t_points]);
-        fp2mul_mont(f[j+t_points], g, f[j+t_points]);
+        fp2sqr_mont(f1, tf);
+        fp2mul_mont(f1, tf, f1);
+        fp2mul_mont(f1, g, f1);
     }
 
-    // Final exponentiation:
-    mont_n_way_inv(f, 2*t_points, finv);
-    for (int j = 0; j < 2*t_points; j++) {
-        final_exponentiation_3_torsion(f[j], finv[j], f[j]);
-    }
 }
 
 
-void Tate2_pairings(const point_t P, const point_t Q, point_full_proj_t *Qj, f2elm_t* f)
-{
+static void Tate2_miller_P(const point_t P, point_full_proj_t R, f2elm_t f0)
+{ // Miller loop of the 2^eA-torsion pairing with P at the point R, before the final exponentiation
     felm_t *x, *y, *x_, *y_, *l1;
-    f2elm_t finv[2*t_points], one = {0};
+    f2elm_t one = {0};
     f2elm_t *x_first, *y_first, l1_first, t0, t1, g, h;
     
     fpcopy((digit_t*)&Montgomery_one, one[0]);
+    fp2copy(one, f0);
 
-    for (int j = 0; j < t_points; j++) {
-        fp2copy(one, f[j]);
-        fp2copy(one, f[j+t_points]);
-    }
-
-    // Pairings with P
     x_first = (f2elm_t*)P->x;
     y_first = (f2elm_t*)P->y;
 
@@ -175,20 +176,18 @@ void Tate2_pairings(const point_t P, const point_t Q, point_full_proj_t *Qj, f2e
     fpcopy((digit_t*)T_tate2_firststep_P + 2*NWORDS_FIELD, l1_first[0]);         
     fpcopy((digit_t*)T_tate2_firststep_P + 3*NWORDS_FIELD, l1_first[1]);         
     
-    for (int j = 0; j < t_points; j++) {
-        fp2sub(Qj[j]->X, *x_first, t0);
-        fp2sub(Qj[j]->Y, *y_first, t1);
-        fp2mul_mont(l1_first, t0, t0);
-        fp2sub(t0, t1, g);
-
-        fpsub(Qj[j]->X[0], *x_, h[0]);
-        fpcopy(Qj[j]->X[1], h[1]);
-        fpneg(h[1]);
-        fp2mul_mont(g, h, g);
-
-        fp2sqr_mont(f[j], f[j]);
-        fp2mul_mont(f[j], g, f[j]);
-    }
+    fp2sub(R->X, *x_first, t0);
+    fp2sub(R->Y, *y_first, t1);
+    fp2mul_mont(l1_first, t0, t0);
+    fp2sub(t0, t1, g);
+
+    fpsub(R->X[0], *x_, h[0]);
+    fpcopy(R->X[1], h[1]);
+    fpneg(h[1]);
+    fp2mul_mont(g, h, g);
+
+    fp2sqr_mont(f0, f0);
+    fp2mul_mont(f0, g, f0);
     x = x_;
     y = y_;
     
@@ -196,33 +195,39 @@ void Tate2_pairings(const point_t P, const point_t Q, point_full_proj_t *Qj, f2e
         x_ = (felm_t*)T_tate2_P + 3 * k + 0;
         y_ = (felm_t*)T_tate2_P + 3 * k + 1;
         l1 = (felm_t*)T_tate2_P + 3 * k + 2;
-        for (int j = 0; j < t_points; j++) {
-            fpsub(*x, Qj[j]->X[0], t0[1]);
-            fpmul_mont(*l1, t0[1], t0[1]);
-            fpmul_mont(*l1, Qj[j]->X[1], t0[0]);
-            fpsub(Qj[j]->Y[1], *y, t1[1]);
-            fpsub(t0[1], t1[1], g[1]);
-            fpsub(t0[0], Qj[j]->Y[0], g[0]);
-
-            fpsub(Qj[j]->X[0], *x_, h[0]);
-            fpcopy(Qj[j]->X[1], h[1]);
-            fpneg(h[1]);
-            fp2mul_mont(g, h, g);
+        fpsub(*x, R->X[0], t0[1]);
+        fpmul_mont(*l1, t0[1], t0[1]);
+        fpmul_mont(*l1, R->X[1], t0[0]);
+        fpsub(R->Y[1], *y, t1[1]);
+        fpsub(t0[1], t1[1], g[1]);
+        fpsub(t0[0], R->Y[0], g[0]);
+
+        fpsub(R->X[0], *x_, h[0]);
+        fpcopy(R->X[1], h[1]);
+        fpneg(h[1]);
+        fp2mul_mont(g, h, g);
 
-            fp2sqr_mont(f[j], f[j]);
-            fp2mul_mont(f[j], g, f[j]);
-        }
+        fp2sqr_mont(f0, f0);
+        fp2mul_mont(f0, g, f0);
         x = x_;
         y = y_;
     }
-    for (int j = 0; j < t_points; j++) {
-        fpsub(Qj[j]->X[0], *x, g[0]);
-        fpcopy(Qj[j]->X[1], g[1]);
-        fp2sqr_mont(f[j], f[j]);
-        fp2mul_mont(f[j], g, f[j]);
-    }
+    fpsub(R->X[0], *x, g[0]);
+    fpcopy(R->X[1], g[1]);
+    fp2sqr_mont(f0, f0);
+    fp2mul_mont(f0, g, f0);
+}
+
+
+static void Tate2_miller_Q(const point_t Q, point_full_proj_t R, f2elm_t f1)
+{ // Miller loop of the 2^eA-torsion pairing with Q at the point R, before the final exponentiation
+    felm_t *x, *y, *x_, *y_, *l1;
+    f2elm_t one = {0};
+    f2elm_t *x_first, *y_first, l1_first, t0, t1, g, h;
+    
+    fpcopy((digit_t*)&Montgomery_one, one[0]);
+    fp2copy(one, f1);
 
-    // Pairings with Q
     x_first = (f2elm_t*)Q->x;
     y_first = (f2elm_t*)Q->y; 
     x_ = (felm_t*)T_tate2_firststep_Q + 0;
@@ -230,20 +235,18 @@ void Tate2_pairings(const point_t P, const point_t Q, point_full_proj_t *Qj, f2e
     fpcopy(((felm_t*)T_tate2_firststep_Q)[2], l1_first[0]);
     fpcopy(((felm_t*)T_tate2_firststep_Q)[3], l1_first[1]);
 
-    for (int j = 0; j < t_points; j++) {
-        fp2sub(Qj[j]->X, *x_first, t0);
-        fp2sub(Qj[j]->Y, *y_first, t1);
-        fp2mul_mont(l1_first, t0, t0);
-        fp2sub(t0, t1, g);
+    fp2sub(R->X, *x_first, t0);
+    fp2sub(R->Y, *y_first, t1);
+    fp2mul_mont(l1_first, t0, t0);
+    fp2sub(t0, t1, g);
 
-        fpsub(Qj[j]->X[0], *x_, h[0]);
-        fpcopy(Qj[j]->X[1], h[1]);
-        fpneg(h[1]);
-        fp2mul_mont(g, h, g);
+    fpsub(R->X[0], *x_, h[0]);
+    fpcopy(R->X[1], h[1]);
+    fpneg(h[1]);
+    fp2mul_mont(g, h, g);
 
-        fp2sqr_mont(f[j+t_points], f[j+t_points]);
-        fp2mul_mont(f[j+t_points], g, f[j+t_points]);
-    }
+    fp2sqr_mont(f1, f1);
+    fp2mul_mont(f1, g, f1);
     x = x_;
     y = y_;
     
@@ -251,36 +254,119 @@ void Tate2_pairings(const point_t P, const point_t Q, point_full_proj_t *Qj, f2e
         x_ = (felm_t*)T_tate2_Q + 3*k + 0;
         y_ = (felm_t*)T_tate2_Q + 3*k + 1;
         l1 = (felm_t*)T_tate2_Q + 3*k + 2;
-        for (int j = 0; j < t_points; j++) {
-            fpsub(Qj[j]->X[0], *x, t0[0]);
-            fpmul_mont(*l1, t0[0], t0[0]);
-            fpmul_mont(*l1, Qj[j]->X[1], t0[1]);
-            fpsub(Qj[j]->Y[0], *y, t1[0]);
-            fpsub(t0[0], t1[0], g[0]);
-            fpsub(t0[1], Qj[j]->Y[1], g[1]);
-
-            fpsub(Qj[j]->X[0], *x_, h[0]);
-            fpcopy(Qj[j]->X[1], h[1]);
-            fpneg(h[1]);
-            fp2mul_mont(g, h, g);
+        fpsub(R->X[0], *x, t0[0]);
+        fpmul_mont(*l1, t0[0], t0[0]);
+        fpmul_mont(*l1, R->X[1], t0[1]);
+        fpsub(R->Y[0], *y, t1[0]);
+        fpsub(t0[0], t1[0], g[0]);
+        fpsub(t0[1], R->Y[1], g[1]);
+
+        fpsub(R->X[0], *x_, h[0]);
+        fpcopy(R->X[1], h[1]);
+        fpneg(h[1]);
+        fp2mul_mont(g, h, g);
 
-            fp2sqr_mont(f[j+t_points], f[j+t_points]);
-            fp2mul_mont(f[j+t_points], g, f[j+t_points]);
-        }
+        fp2sqr_mont(f1, f1);
+        fp2mul_mont(f1, g, f1);
         x = x_;
         y = y_;
     }
     // Last iteration
-    for (int j = 0; j < t_points; j++) {
-        fpsub(Qj[j]->X[0], *x, g[0]);
-        fpcopy(Qj[j]->X[1], g[1]);
+    fpsub(R->X[0], *x, g[0]);
+    fpcopy(R->X[1], g[1]);
+
+    fp2sqr_mont(f1, f1);
+    fp2mul_mont(f1, g, f1);
+
+}
+
+
+// Miller loops of the 2*t_points pairings at the points Qj[0], ..., Qj[t_points-1]. Task 2*j computes f[j] and task 2*j+1 computes 
+// f[j+t_points], which are the two pairings at the point Qj[j] (with the bases P and Q for the 2^eA-torsion pairings).
+typedef struct {
+    point_full_proj_t* Qj;
+    f2elm_t* f;
+    const point_affine* P;                  // Base points of the 2^eA-torsion pairings, NULL for the 3^eB-torsion pairings
+    const point_affine* Q;
+} miller_t;
+
+
+static void miller_range(const miller_t* m, unsigned int first, const unsigned int last)
+{ // Tasks first, ..., last-1. The two 3^eB-torsion pairings at a point share their line values, so they are computed in one call
+  // when both of their tasks are in the range.
+    unsigned int j;
+
+    for (; first < last; first++) {
+        j = first/2;
+        if (m->P == NULL) {
+            if (first % 2 == 0 && first + 1 < last) {
+                Tate3_miller(m->Qj[j], m->f[j], m->f[j+t_points]);
+                first++;
+            } else {
+                Tate3_miller(m->Qj[j], (first % 2 == 0) ? m->f[j] : NULL, (first % 2 == 1) ? m->f[j+t_points] : NULL);
+            }
+        } else if (first % 2 == 0) {
+            Tate2_miller_P(m->P, m->Qj[j], m->f[j]);
+        } else {
+            Tate2_miller_Q(m->Q, m->Qj[j], m->f[j+t_points]);
+        }
+    }
+}
+
+
+#if defined(PARALLEL_TRAVERSAL)
+
+static void miller_task(void* arg, const unsigned int worker, const unsigned int nworkers)
+{ // Worker task: the pairings are split into nworkers+1 contiguous shares, the last of which is computed by the calling thread
+    const miller_t* m = (const miller_t*)arg;
+
+    miller_range(m, worker*2*t_points/(nworkers + 1), (worker + 1)*2*t_points/(nworkers + 1));
+}
+
+#endif
+
+
+static void miller_run(const miller_t* m)
+{ // Computes the Miller loops. In the parallel traversal mode, the pairings are distributed over the calling thread and the workers
+  // if the pool is available.
+#if defined(PARALLEL_TRAVERSAL)
+    int nworkers;
 
-        fp2sqr_mont(f[j+t_points], f[j+t_points]);
-        fp2mul_mont(f[j+t_points], g, f[j+t_points]);
+    if ((nworkers = thread_pool_acquire()) > 0) {
+        thread_pool_run(miller_task, (void*)m);
+        miller_range(m, nworkers*2*t_points/(nworkers + 1), 2*t_points);
+        thread_pool_release();
+        return;
     }
+#endif
+    miller_range(m, 0, 2*t_points);
+}
+
+
+void Tate3_pairings(point_full_proj_t *Qj, f2elm_t* f)
+{
+    f2elm_t finv[2*t_points];
+    const miller_t m = { Qj, f, NULL, NULL };
+
+    miller_run(&m);
+
+    // Final exponentiation:
+    fp2_batch_inv(f, 2*t_points, finv, finv);
+    for (int j = 0; j < 2*t_points; j++) {
+        final_exponentiation_3_torsion(f[j], finv[j], f[j]);
+    }
+}
+
+
+void Tate2_pairings(const point_t P, const point_t Q, point_full_proj_t *Qj, f2elm_t* f)
+{
+    f2elm_t finv[2*t_points];
+    const miller_t m = { Qj, f, P, Q };
+
+    miller_run(&m);
 
     // Final exponentiation:
-    mont_n_way_inv(f, 2*t_points, finv);
+    fp2_batch_inv(f, 2*t_points, finv, finv);
     for (int j = 0; j < 2*t_points; j++) {
         final_exponentiation_2_torsion(f[j], finv[j], f[j]);
     }
@@ -5,6 +5,9 @@
 **************************************************************************************************/ 
 
 #include "../random/random.h"
+#if defined(PARALLEL_TRAVERSAL)
+    #include "../threads/thread_pool.h"
+#endif
 #include <string.h>
 
 
@@ -55,7 +58,7 @@ static void FullIsogeny_A_dual(unsigned char* PrivateKeyA, f2elm_t As[][5], f2el
   // Input:  a private key PrivateKeyA in the range [0, 2^eA - 1]. 
   // Output: the public key PublicKeyA consisting of 3 elements in GF(p^2) which are encoded by removing leading 0 bytes.
     point_proj_t R, pts[MAX_INT_POINTS_ALICE];
-    f2elm_t XPA, XQA, XRA, coeff[5], A24 = {0}, C24 = {0}, A = {0};
+    f2elm_t XPA, XQA, XRA, coeff[5], A24 = {0}, C24 = {0};
     unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0, ii = 0;
     digit_t SecretKeyA[NWORDS_ORDER] = {0};
 
@@ -66,12 +69,11 @@ static void FullIsogeny_A_dual(unsigned char* PrivateKeyA, f2elm_t As[][5], f2el
     fpcopy((digit_t*)&Montgomery_one, A24[0]);
     fp2add(A24, A24, A24);
     fp2add(A24, A24, C24);
-    fp2add(A24, C24, A);
     fp2add(C24, C24, A24);
     
     // Retrieve kernel point
     decode_to_digits(PrivateKeyA, SecretKeyA, SECRETKEY_A_BYTES, NWORDS_ORDER);
-    LADDER3PT(XPA, XQA, XRA, SecretKeyA, ALICE, R, A);
+    LADDER3PT_E0(XPA, XQA, XRA, SecretKeyA, ALICE, R);
     fp2inv_mont(R->Z);
     fp2mul_mont(R->X,R->Z,R->X);
     fpcopy((digit_t*)&Montgomery_one, R->Z[0]);
@@ -126,12 +128,58 @@ static void FullIsogeny_A_dual(unsigned char* PrivateKeyA, f2elm_t As[][5], f2el
 }
 
 
-static void Dlogs3_dual(const f2elm_t *f, int *D, digit_t *d0, digit_t *c0, digit_t *d1, digit_t *c1)
+// Discrete logs of the four pairing values f[0], ..., f[3] computed during a key generation
+typedef struct {
+    const f2elm_t* f;
+    digit_t* d[4];
+    int ell;
+} dlogs_t;
+
+
+static void dlogs_range(const dlogs_t* t, unsigned int first, const unsigned int last)
+{ // Discrete logs d[i] of f[i] for i = first, ..., last-1
+    int D[(DLEN_2 > DLEN_3) ? DLEN_2 : DLEN_3] = {0};
+
+    for (; first < last; first++) {
+        solve_dlog(t->f[first], D, t->d[first], t->ell);
+    }
+}
+
+
+#if defined(PARALLEL_TRAVERSAL)
+
+static void dlogs_task(void* arg, const unsigned int worker, const unsigned int nworkers)
+{ // Worker task: the discrete logs are split into nworkers+1 contiguous shares, the last of which is solved by the calling thread
+    const dlogs_t* t = (const dlogs_t*)arg;
+
+    dlogs_range(t, worker*4/(nworkers + 1), (worker + 1)*4/(nworkers + 1));
+}
+
+#endif
+
+
+static void dlogs_run(const dlogs_t* t)
+{ // Solves the four discrete logs. In the parallel traversal mode, they are distributed over the calling thread and the workers
+  // if the pool is available.
+#if defined(PARALLEL_TRAVERSAL)
+    int nworkers;
+
+    if ((nworkers = thread_pool_acquire()) > 0) {
+        thread_pool_run(dlogs_task, (void*)t);
+        dlogs_range(t, nworkers*4/(nworkers + 1), 4);
+        thread_pool_release();
+        return;
+    }
+#endif
+    dlogs_range(t, 0, 4);
+}
+
+
+static void Dlogs3_dual(const f2elm_t *f, digit_t *d0, digit_t *c0, digit_t *d1, digit_t *c1)
 {
-    solve_dlog(f[0], D, d0, 3);    
-    solve_dlog(f[2], D, c0, 3);
-    solve_dlog(f[1], D, d1, 3);     
-    solve_dlog(f[3], D, c1, 3);    
+    const dlogs_t t = { f, { d0, d1, c0, c1 }, 3 };
+
+    dlogs_run(&t);
     mp_sub((digit_t*)Bob_order, c0, c0, NWORDS_ORDER);    
     mp_sub((digit_t*)Bob_order, c1, c1, NWORDS_ORDER);  
 }
@@ -253,7 +301,6 @@ static int EphemeralKeyGeneration_A_extended(unsigned char* PrivateKeyA, unsigne
 { // Alice's ephemeral public key generation using compression -- SIKE protocol
   // Output: PrivateKeyA[MSG_BYTES + SECRETKEY_A_BYTES] <- x(K_A) where K_A = PA + sk_A*Q_A 
     unsigned int rs[3];
-    int D[DLEN_3];
     f2elm_t a24, As[MAX_Alice+1][5], f[4];
     digit_t c0[NWORDS_ORDER] = {0}, d0[NWORDS_ORDER] = {0}, c1[NWORDS_ORDER] = {0}, d1[NWORDS_ORDER] = {0}; 
     point_full_proj_t Rs[2];
@@ -261,7 +308,7 @@ static int EphemeralKeyGeneration_A_extended(unsigned char* PrivateKeyA, unsigne
     FullIsogeny_A_dual(PrivateKeyA, As, a24, 1);
     BuildOrdinary3nBasis_dual(a24, As, Rs, rs, &rs[2]);
     Tate3_pairings(Rs, f);
-    Dlogs3_dual(f, D, d0, c0, d1, c1);
+    Dlogs3_dual(f, d0, c0, d1, c1);
     Compress_PKA_dual(d0, c0, d1, c1, a24, rs, CompressedPKA);
     return 0;
 }
@@ -271,7 +318,6 @@ int EphemeralKeyGeneration_A(const unsigned char* PrivateKeyA, unsigned char* Co
 { // Alice's ephemeral public key generation using compression -- SIDH protocol
   // Output: PrivateKeyA[MSG_BYTES + SECRETKEY_A_BYTES] <- x(K_A) where K_A = PA + sk_A*Q_A 
     unsigned int rs[3];
-    int D[DLEN_3];
     f2elm_t a24, As[MAX_Alice+1][5], f[4];
     digit_t c0[NWORDS_ORDER] = {0}, d0[NWORDS_ORDER] = {0}, c1[NWORDS_ORDER] = {0}, d1[NWORDS_ORDER] = {0}; 
     point_full_proj_t Rs[2];
@@ -279,7 +325,7 @@ int EphemeralKeyGeneration_A(const unsigned char* PrivateKeyA, unsigned char* Co
     FullIsogeny_A_dual((unsigned char*)PrivateKeyA, As, a24, 0);
     BuildOrdinary3nBasis_dual(a24, As, Rs, rs, &rs[2]);
     Tate3_pairings(Rs, f);
-    Dlogs3_dual(f, D, d0, c0, d1, c1);
+    Dlogs3_dual(f, d0, c0, d1, c1);
     Compress_PKA_dual(d0, c0, d1, c1, a24, rs, CompressedPKA);
     return 0;
 }
@@ -357,12 +403,11 @@ static void FullIsogeny_B_dual(const unsigned char* PrivateKeyB, f2elm_t Ds[][2]
     fpcopy((digit_t*)&Montgomery_one, A24plus[0]);
     fp2add(A24plus, A24plus, A24plus);
     fp2add(A24plus, A24plus, A24minus);
-    fp2add(A24plus, A24minus, A);
     fp2add(A24minus, A24minus, A24plus);
     
     // Retrieve kernel point
     decode_to_digits(PrivateKeyB, SecretKeyB, SECRETKEY_B_BYTES, NWORDS_ORDER);    
-    LADDER3PT(XPB, XQB, XRB, SecretKeyB, BOB, R, A);
+    LADDER3PT_E0(XPB, XQB, XRB, SecretKeyB, BOB, R);
     
     // Traverse tree
     index = 0;
@@ -401,12 +446,11 @@ static void FullIsogeny_B_dual(const unsigned char* PrivateKeyB, f2elm_t Ds[][2]
 }
 
 
-static void Dlogs2_dual(const f2elm_t *f, int *D, digit_t *d0, digit_t *c0, digit_t *d1, digit_t *c1)
+static void Dlogs2_dual(const f2elm_t *f, digit_t *d0, digit_t *c0, digit_t *d1, digit_t *c1)
 {
-    solve_dlog(f[0], D, d0, 2);
-    solve_dlog(f[2], D, c0, 2);
-    solve_dlog(f[1], D, d1, 2);
-    solve_dlog(f[3], D, c1, 2);
+    const dlogs_t t = { f, { d0, d1, c0, c1 }, 2 };
+
+    dlogs_run(&t);
     mp_sub((digit_t*)Alice_order, c0, c0, NWORDS_ORDER);
     mp_sub((digit_t*)Alice_order, c1, c1, NWORDS_ORDER);
 }
@@ -620,7 +664,6 @@ static void Compress_PKB_dual(digit_t *d0, digit_t *c0, digit_t *d1, digit_t *c1
 static int EphemeralKeyGeneration_B_extended(const unsigned char* PrivateKeyB, unsigned char* CompressedPKB, unsigned int sike)
 { // Bob's ephemeral public key generation using compression -- SIKE protocol
     unsigned char qnr, ind;
-    int D[DLEN_2] = {0};
     digit_t c0[NWORDS_ORDER] = {0}, d0[NWORDS_ORDER] = {0}, c1[NWORDS_ORDER] = {0}, d1[NWORDS_ORDER] = {0}; 
     f2elm_t Ds[MAX_Bob][2] = {0}, f[4] = {0}, A = {0};
     point_full_proj_t Rs[2] = {0};
@@ -649,7 +692,7 @@ static int EphemeralKeyGeneration_B_extended(const unsigned char* PrivateKeyB, u
     fp2correction(f[2]);
     fp2correction(f[3]);
 
-    Dlogs2_dual(f, D, d0, c0, d1, c1);
+    Dlogs2_dual(f, d0, c0, d1, c1);
     if (sike == 1)
         Compress_PKB_dual_extended(d0, c0, d1, c1, A, qnr, ind, CompressedPKB);  
     else
@@ -756,12 +799,11 @@ int8_t validate_ciphertext(const unsigned char* ephemeralsk_, const unsigned cha
     fpcopy(one[0], A24plus[0]);
     fp2add(A24plus, A24plus, A24plus);
     fp2add(A24plus, A24plus, A24minus);  // A24minus = 4
-    fp2add(A24plus, A24minus, A);        // A = 6
     fp2add(A24minus, A24minus, A24plus); // A24plus = 8
     
     // Retrieve kernel point
     decode_to_digits(ephemeralsk_, sk, SECRETKEY_B_BYTES, NWORDS_ORDER);
-    LADDER3PT(XPB, XQB, XRB, sk, BOB, R, A);
+    LADDER3PT_E0(XPB, XQB, XRB, sk, BOB, R);
     
     // Traverse tree
     index = 0;
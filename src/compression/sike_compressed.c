@@ -35,12 +35,16 @@ int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk
     unsigned char ephemeralsk[SECRETKEY_B_BYTES] = {0};
     unsigned char jinvariant[FP2_ENCODED_BYTES] = {0};
     unsigned char h[MSG_BYTES];
-    unsigned char temp[CRYPTO_CIPHERTEXTBYTES + MSG_BYTES] = {0};
+    unsigned char m[MSG_BYTES];
+    uint64_t s[SHAKE_INC_STATE_WORDS];
 
     // Generate ephemeralsk <- G(m||pk) mod oB 
-    randombytes(temp, MSG_BYTES);    
-    memcpy(&temp[MSG_BYTES], pk, CRYPTO_PUBLICKEYBYTES);        
-    shake256(ephemeralsk, SECRETKEY_B_BYTES, temp, MSG_BYTES + CRYPTO_PUBLICKEYBYTES);
+    randombytes(m, MSG_BYTES);    
+    shake256_inc_init(s);
+    shake256_inc_absorb(s, m, MSG_BYTES);
+    shake256_inc_absorb(s, pk, CRYPTO_PUBLICKEYBYTES);
+    shake256_inc_finalize(s);
+    shake256_inc_squeeze(ephemeralsk, SECRETKEY_B_BYTES, s);
     FormatPrivKey_B(ephemeralsk);
     
     // Encrypt
@@ -48,12 +52,15 @@ int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk
     EphemeralSecretAgreement_B(ephemeralsk, pk, jinvariant);  
     shake256(h, MSG_BYTES, jinvariant, FP2_ENCODED_BYTES);          
     for (int i = 0; i < MSG_BYTES; i++) {
-        ct[i + PARTIALLY_COMPRESSED_CHUNK_CT] = temp[i] ^ h[i];
+        ct[i + PARTIALLY_COMPRESSED_CHUNK_CT] = m[i] ^ h[i];
     }
 
     // Generate shared secret ss <- H(m||ct)
-    memcpy(&temp[MSG_BYTES], ct, CRYPTO_CIPHERTEXTBYTES);      
-    shake256(ss, CRYPTO_BYTES, temp, CRYPTO_CIPHERTEXTBYTES + MSG_BYTES);
+    shake256_inc_init(s);
+    shake256_inc_absorb(s, m, MSG_BYTES);
+    shake256_inc_absorb(s, ct, CRYPTO_CIPHERTEXTBYTES);
+    shake256_inc_finalize(s);
+    shake256_inc_squeeze(ss, CRYPTO_BYTES, s);
 
     return 0;
 }
@@ -66,7 +73,8 @@ int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned ch
   // Outputs: shared secret ss                      (CRYPTO_BYTES bytes)
     unsigned char ephemeralsk_[SECRETKEY_B_BYTES] = {0};
     unsigned char jinvariant_[FP2_ENCODED_BYTES + 2*FP2_ENCODED_BYTES + SECRETKEY_A_BYTES] = {0}, h_[MSG_BYTES];
-    unsigned char temp[CRYPTO_CIPHERTEXTBYTES + MSG_BYTES] = {0};   
+    unsigned char m_[MSG_BYTES];
+    uint64_t s[SHAKE_INC_STATE_WORDS];
     unsigned char* tphiBKA_t = &jinvariant_[FP2_ENCODED_BYTES];
     
     // Decrypt 
@@ -74,21 +82,27 @@ int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned ch
     shake256(h_, MSG_BYTES, jinvariant_, FP2_ENCODED_BYTES);   
     
     for (int i = 0; i < MSG_BYTES; i++) {
-        temp[i] = ct[i + PARTIALLY_COMPRESSED_CHUNK_CT] ^ h_[i];                         
+        m_[i] = ct[i + PARTIALLY_COMPRESSED_CHUNK_CT] ^ h_[i];                         
     }     
     
     // Generate ephemeralsk_ <- G(m||pk) mod oB
-    memcpy(&temp[MSG_BYTES], &sk[MSG_BYTES + SECRETKEY_A_BYTES], CRYPTO_PUBLICKEYBYTES);            
-    shake256(ephemeralsk_, SECRETKEY_B_BYTES, temp, MSG_BYTES + CRYPTO_PUBLICKEYBYTES);
+    shake256_inc_init(s);
+    shake256_inc_absorb(s, m_, MSG_BYTES);
+    shake256_inc_absorb(s, &sk[MSG_BYTES + SECRETKEY_A_BYTES], CRYPTO_PUBLICKEYBYTES);
+    shake256_inc_finalize(s);
+    shake256_inc_squeeze(ephemeralsk_, SECRETKEY_B_BYTES, s);
     FormatPrivKey_B(ephemeralsk_);
     
     // Generate shared secret ss <- H(m||ct), or output ss <- H(s||ct) in case of ct verification failure
     // No need to recompress, just check if x(phi(P) + t*phi(Q)) == x((a0 + t*a1)*R1 + (b0 + t*b1)*R2)    
     int8_t selector = validate_ciphertext(ephemeralsk_, ct, &sk[MSG_BYTES + SECRETKEY_A_BYTES + CRYPTO_PUBLICKEYBYTES], tphiBKA_t);
     // If ct validation passes (selector = 0) then do ss = H(m||ct), otherwise (selector = -1) load s to do ss = H(s||ct)
-    ct_cmov(temp, sk, MSG_BYTES, selector);
-    memcpy(&temp[MSG_BYTES], ct, CRYPTO_CIPHERTEXTBYTES);  
-    shake256(ss, CRYPTO_BYTES, temp, CRYPTO_CIPHERTEXTBYTES + MSG_BYTES);
+    ct_cmov(m_, sk, MSG_BYTES, selector);
+    shake256_inc_init(s);
+    shake256_inc_absorb(s, m_, MSG_BYTES);
+    shake256_inc_absorb(s, ct, CRYPTO_CIPHERTEXTBYTES);
+    shake256_inc_finalize(s);
+    shake256_inc_squeeze(ss, CRYPTO_BYTES, s);
 
     return 0;
 }
@@ -107,7 +107,7 @@ static void FinalExpo3_2way(f2elm_t *gX, f2elm_t *gZ)
         fpneg(f_[i][1]);    // Conjugate
         fp2mul_mont(gX[i], f_[i], f_[i]);
     }
-    mont_n_way_inv(f_,2,finv);
+    fp2_batch_inv(f_, 2, finv, finv);
     for(i = 0; i < 2; i++) {
         fpneg(gX[i][1]);
         fp2mul_mont(gX[i], gZ[i], gX[i]);
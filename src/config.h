@@ -97,6 +97,72 @@
 #endif
 
 
+// Selection of the header-only C++17 field backend (portable, replaces the generic C arithmetic in src/PXXX/generic/)
+
+#if defined(_CXX_BACKEND_)
+    #if !defined(GENERIC_IMPLEMENTATION) || (RADIX != 64)
+        #error -- "The C++ field backend requires a 64-bit generic build"
+    #endif
+    #define CXX_BACKEND_IMPLEMENTATION
+#endif
+
+
+// Selection of the multiplication and Montgomery reduction using unsaturated limbs in the generic implementation
+
+#if defined(GENERIC_IMPLEMENTATION) && defined(_REDUCED_RADIX_)
+    #define REDUCED_RADIX_IMPLEMENTATION
+#endif
+
+
+// Selection of the isogeny tree traversal strategies generated for the target machine by "make strategies"
+
+#if defined(_TUNED_STRATEGIES_)
+    #define TUNED_STRATEGIES
+#endif
+
+
+// Selection of the isogeny tree traversal that evaluates the intermediate points with a pool of worker threads (requires pthreads)
+
+#if defined(_PARALLEL_TRAVERSAL_) && (OS_TARGET == OS_NIX)
+    #define PARALLEL_TRAVERSAL
+#endif
+
+
+// Selection of the pool of ephemeral key pairs pre-generated by background threads (requires pthreads)
+
+#if defined(_KEY_POOL_) && (OS_TARGET == OS_NIX)
+    #define KEY_POOL
+#endif
+
+
+// Selection of the per-thread deterministic random bit generator seeded by the system for randombytes() (requires pthreads)
+
+#if defined(_DRBG_) && (OS_TARGET == OS_NIX)
+    #define DRBG
+#endif
+
+
+// Selection of the dedicated multiprecision squaring mp_sqr (the ARMv8 assembly implementation does not provide one and squares with the multiplication)
+
+#if !(TARGET == TARGET_ARM64 && defined(FAST_IMPLEMENTATION))
+    #define MP_SQR_IMPLEMENTATION
+#endif
+
+
+// Selection of the fused GF(p^2) squaring routine in x64 assembly (require MULX, either at compile time or through run-time dispatch)
+
+#if (TARGET == TARGET_AMD64 && OS_TARGET == OS_NIX) && defined(FAST_IMPLEMENTATION) && (defined(_MULX_) || defined(_CPU_DISPATCH_))
+    #define FP2_ASM_IMPLEMENTATION
+#endif
+
+
+// Selection of the 4-way AVX2 engine used by the lane-parallel key exchange functions (requires AVX2 code generation, e.g., -march=native)
+
+#if (TARGET == TARGET_AMD64 && OS_TARGET == OS_NIX) && (COMPILER == COMPILER_GCC || COMPILER == COMPILER_CLANG) && defined(__AVX2__)
+    #define AVX2_X4_IMPLEMENTATION
+#endif
+
+
 // Extended datatype support
 
 #if defined(GENERIC_IMPLEMENTATION)                       
@@ -108,6 +174,19 @@
 #elif (TARGET == TARGET_AMD64) && (OS_TARGET == OS_WIN && COMPILER == COMPILER_VC)
     typedef uint64_t uint128_t[2];
 #endif
+
+// Limbs and column accumulators of the reduced-radix arithmetic: the sum of the products of a column fits in an accumulator
+#if defined(REDUCED_RADIX_IMPLEMENTATION)
+    #if (RADIX == 64) && defined(__SIZEOF_INT128__)
+        #define RR_BITS    56                       // 56-bit limbs in 64-bit words, 128-bit column accumulators
+        typedef uint64_t rr_limb_t;
+        typedef unsigned rr_acc_t __attribute__((mode(TI)));
+    #else
+        #define RR_BITS    28                       // 28-bit limbs in 32-bit words, 64-bit column accumulators
+        typedef uint32_t rr_limb_t;
+        typedef uint64_t rr_acc_t;
+    #endif
+#endif
     
 
 // Macro definitions
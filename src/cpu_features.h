@@ -0,0 +1,43 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: run-time detection of x64 instruction set extensions used by the field arithmetic
+*********************************************************************************************/
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include "config.h"
+
+#if (TARGET == TARGET_AMD64) && (COMPILER == COMPILER_GCC || COMPILER == COMPILER_CLANG)
+    #include <cpuid.h>
+#endif
+
+
+#define CPU_FEATURE_MULX    0x01    // MULX instruction (BMI2)
+#define CPU_FEATURE_ADX     0x02    // ADCX and ADOX instructions (ADX)
+
+
+static __inline unsigned int cpu_features(void)
+{ // Returns a bitmask of the CPU_FEATURE_* flags supported by the host processor
+    unsigned int features = 0;
+
+#if (TARGET == TARGET_AMD64) && (COMPILER == COMPILER_GCC || COMPILER == COMPILER_CLANG)
+    unsigned int eax, ebx, ecx, edx;
+
+    if (__get_cpuid_max(0, NULL) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        if (ebx & (1 << 8)) {                   // CPUID.(EAX=7,ECX=0):EBX[8] = BMI2
+            features |= CPU_FEATURE_MULX;
+        }
+        if (ebx & (1 << 19)) {                  // CPUID.(EAX=7,ECX=0):EBX[19] = ADX
+            features |= CPU_FEATURE_ADX;
+        }
+    }
+#endif
+
+    return features;
+}
+
+
+#endif
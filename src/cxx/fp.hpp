@@ -0,0 +1,310 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: header-only C++17 templates for the arithmetic over GF(p) and GF(p^2)
+*
+* A prime is described by a parameter class P providing
+*     static constexpr unsigned nwords;                 // Number of 64-bit words of p
+*     static constexpr uint64_t p[nwords];              // p, little-endian words
+* The constants 2*p, 4*p, p+1 and the number of zero low words of p+1 are derived at compile time.
+* All limb loops have compile-time trip counts and are fully unrolled, products use unsigned __int128.
+* Every function runs in constant time with respect to the values of its operands.
+*********************************************************************************************/
+
+#ifndef SIDH_CXX_FP_HPP
+#define SIDH_CXX_FP_HPP
+
+#include <cstdint>
+
+#if !defined(__SIZEOF_INT128__)
+    #error -- "The C++ field backend requires a 64-bit target with unsigned __int128 support"
+#endif
+
+#define SIDH_UNROLL    _Pragma("GCC unroll 64")
+
+
+namespace sidh {
+
+typedef std::uint64_t limb_t;
+typedef unsigned __int128 dlimb_t;
+
+template <unsigned N>
+struct limbs {
+    limb_t v[N];
+};
+
+
+namespace detail {
+
+template <unsigned N>
+constexpr limbs<N> mul_small(const limb_t (&a)[N], limb_t k)
+{ // a*k for a single-word k, the result is assumed to fit in N words
+    limbs<N> r = {};
+    dlimb_t carry = 0;
+    for (unsigned i = 0; i < N; i++) {
+        carry += (dlimb_t)a[i]*k;
+        r.v[i] = (limb_t)carry;
+        carry >>= 64;
+    }
+    return r;
+}
+
+template <unsigned N>
+constexpr limbs<N> add_one(const limb_t (&a)[N])
+{ // a+1
+    limbs<N> r = {};
+    limb_t carry = 1;
+    for (unsigned i = 0; i < N; i++) {
+        r.v[i] = a[i] + carry;
+        carry = (r.v[i] < carry);
+    }
+    return r;
+}
+
+template <unsigned N>
+constexpr unsigned zero_words(const limbs<N>& a)
+{ // Number of zero words at the bottom of a
+    unsigned i = 0;
+    while (i < N && a.v[i] == 0) {
+        i++;
+    }
+    return i;
+}
+
+static inline limb_t addc(limb_t a, limb_t b, limb_t& carry)
+{ // a+b+carry, the carry is updated
+    dlimb_t s = (dlimb_t)a + b + carry;
+    carry = (limb_t)(s >> 64);
+    return (limb_t)s;
+}
+
+static inline limb_t subb(limb_t a, limb_t b, limb_t& borrow)
+{ // a-b-borrow, the borrow is updated
+    dlimb_t d = (dlimb_t)a - b - borrow;
+    borrow = (limb_t)(d >> 64) & 1;
+    return (limb_t)d;
+}
+
+}
+
+
+template <class P>
+struct Fp {
+    static constexpr unsigned N = P::nwords;
+    static constexpr limbs<N> p2 = detail::mul_small(P::p, 2);
+    static constexpr limbs<N> p4 = detail::mul_small(P::p, 4);
+    static constexpr limbs<N> p1 = detail::add_one(P::p);
+    static constexpr unsigned zero_words = detail::zero_words(p1);
+    static_assert(zero_words >= 1, "p must be congruent to -1 modulo 2^64");
+
+    typedef limb_t elm_t[N];
+    typedef limb_t delm_t[2*N];
+
+    static inline void add(const limb_t* a, const limb_t* b, limb_t* c)
+    { // Modular addition, c = a+b mod p, where a, b, c are in [0, 2*p-1]
+        limb_t carry = 0, borrow = 0, mask;
+
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) c[i] = detail::addc(a[i], b[i], carry);
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) c[i] = detail::subb(c[i], p2.v[i], borrow);
+        mask = 0 - borrow;
+        carry = 0;
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) c[i] = detail::addc(c[i], p2.v[i] & mask, carry);
+    }
+
+    static inline void sub(const limb_t* a, const limb_t* b, limb_t* c)
+    { // Modular subtraction, c = a-b mod p, where a, b, c are in [0, 2*p-1]
+        limb_t carry = 0, borrow = 0, mask;
+
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) c[i] = detail::subb(a[i], b[i], borrow);
+        mask = 0 - borrow;
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) c[i] = detail::addc(c[i], p2.v[i] & mask, carry);
+    }
+
+    static inline void sub_p2(const limb_t* a, const limb_t* b, limb_t* c)
+    { // Subtraction with correction with 2*p, c = a-b+2p
+        limb_t carry = 0, borrow = 0;
+
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) c[i] = detail::subb(a[i], b[i], borrow);
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) c[i] = detail::addc(c[i], p2.v[i], carry);
+    }
+
+    static inline void sub_p4(const limb_t* a, const limb_t* b, limb_t* c)
+    { // Subtraction with correction with 4*p, c = a-b+4p
+        limb_t carry = 0, borrow = 0;
+
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) c[i] = detail::subb(a[i], b[i], borrow);
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) c[i] = detail::addc(c[i], p4.v[i], carry);
+    }
+
+    static inline void neg(limb_t* a)
+    { // Modular negation, a = -a mod p, where a is in [0, 2*p-1]
+        limb_t borrow = 0;
+
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) a[i] = detail::subb(p2.v[i], a[i], borrow);
+    }
+
+    static inline void div2(const limb_t* a, limb_t* c)
+    { // Modular division by two, c = a/2 mod p, where a, c are in [0, 2*p-1]
+        limb_t carry = 0, mask = 0 - (a[0] & 1);       // If a is odd compute a+p
+        elm_t t;
+
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) t[i] = detail::addc(a[i], P::p[i] & mask, carry);
+        SIDH_UNROLL for (unsigned i = 0; i < N-1; i++) c[i] = (t[i] >> 1) ^ (t[i+1] << 63);
+        c[N-1] = t[N-1] >> 1;
+    }
+
+    static inline void correction(limb_t* a)
+    { // Modular correction, reduces a in [0, 2*p-1] to [0, p-1]
+        limb_t carry = 0, borrow = 0, mask;
+
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) a[i] = detail::subb(a[i], P::p[i], borrow);
+        mask = 0 - borrow;
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) a[i] = detail::addc(a[i], P::p[i] & mask, carry);
+    }
+
+    static inline void mul(const limb_t* a, const limb_t* b, limb_t* c)
+    { // Integer multiplication, c = a*b, where c has 2*N words
+        delm_t t = {};
+
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) {
+            limb_t carry = 0;
+            SIDH_UNROLL for (unsigned j = 0; j < N; j++) {
+                dlimb_t s = (dlimb_t)a[i]*b[j] + t[i+j] + carry;
+                t[i+j] = (limb_t)s;
+                carry = (limb_t)(s >> 64);
+            }
+            t[i+N] = carry;
+        }
+        SIDH_UNROLL for (unsigned i = 0; i < 2*N; i++) c[i] = t[i];
+    }
+
+    static inline void sqr(const limb_t* a, limb_t* c)
+    { // Integer squaring, c = a^2, where c has 2*N words. The off-diagonal products are computed once and doubled
+        delm_t t = {};
+        limb_t carry = 0, top = 0;
+
+        SIDH_UNROLL for (unsigned i = 0; i < N-1; i++) {
+            limb_t cc = 0;
+            SIDH_UNROLL for (unsigned j = i+1; j < N; j++) {
+                dlimb_t s = (dlimb_t)a[i]*a[j] + t[i+j] + cc;
+                t[i+j] = (limb_t)s;
+                cc = (limb_t)(s >> 64);
+            }
+            t[i+N] = cc;
+        }
+        SIDH_UNROLL for (unsigned i = 0; i < 2*N; i++) {
+            limb_t w = t[i];
+            t[i] = (w << 1) | top;
+            top = w >> 63;
+        }
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) {
+            dlimb_t s = (dlimb_t)a[i]*a[i];
+            t[2*i] = detail::addc(t[2*i], (limb_t)s, carry);
+            t[2*i+1] = detail::addc(t[2*i+1], (limb_t)(s >> 64), carry);
+        }
+        SIDH_UNROLL for (unsigned i = 0; i < 2*N; i++) c[i] = t[i];
+    }
+
+    static inline void rdc(const limb_t* ma, limb_t* mc)
+    { // Montgomery reduction exploiting the special form of the prime, mc = ma*R^-1 mod p, where R = 2^(64*N).
+      // Since p = -1 mod 2^64 the quotient digit is the current low word, and the zero low words of p+1 are skipped.
+      // If ma < R*p, the output mc is in the range [0, 2*p-1].
+        delm_t t;
+        limb_t hi = 0;
+
+        SIDH_UNROLL for (unsigned i = 0; i < 2*N; i++) t[i] = ma[i];
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) {
+            limb_t m = t[i], carry = 0;
+            SIDH_UNROLL for (unsigned j = zero_words; j < N; j++) {
+                dlimb_t s = (dlimb_t)m*p1.v[j] + t[i+j] + carry;
+                t[i+j] = (limb_t)s;
+                carry = (limb_t)(s >> 64);
+            }
+            dlimb_t s = (dlimb_t)t[i+N] + carry + hi;
+            t[i+N] = (limb_t)s;
+            hi = (limb_t)(s >> 64);
+        }
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) mc[i] = t[i+N];
+    }
+
+    static inline void mul_mont(const limb_t* a, const limb_t* b, limb_t* c)
+    { // Field multiplication using Montgomery arithmetic, c = a*b*R^-1 mod p
+        delm_t t;
+
+        mul(a, b, t);
+        rdc(t, c);
+    }
+
+    static inline void sqr_mont(const limb_t* a, limb_t* c)
+    { // Field squaring using Montgomery arithmetic, c = a^2*R^-1 mod p
+        delm_t t;
+
+        sqr(a, t);
+        rdc(t, c);
+    }
+};
+
+
+template <class P>
+struct Fp2 {
+    typedef Fp<P> F;
+    static constexpr unsigned N = P::nwords;
+    typedef limb_t elm_t[2][N];
+
+    static inline void add(const elm_t a, const elm_t b, elm_t c)
+    { // GF(p^2) addition, c = a+b in GF(p^2)
+        F::add(a[0], b[0], c[0]);
+        F::add(a[1], b[1], c[1]);
+    }
+
+    static inline void sub(const elm_t a, const elm_t b, elm_t c)
+    { // GF(p^2) subtraction, c = a-b in GF(p^2)
+        F::sub(a[0], b[0], c[0]);
+        F::sub(a[1], b[1], c[1]);
+    }
+
+    static inline void mul(const elm_t a, const elm_t b, elm_t c)
+    { // GF(p^2) multiplication using Montgomery arithmetic, c = a*b in GF(p^2).
+      // Inputs: a = a0+a1*i and b = b0+b1*i, where a0, a1, b0, b1 are in [0, 2*p-1]
+      // Output: c = c0+c1*i, where c0, c1 are in [0, 2*p-1]
+        typename F::elm_t t1, t2;
+        typename F::delm_t tt1, tt2, tt3;
+        limb_t carry = 0, borrow = 0, mask;
+
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) t1[i] = detail::addc(a[0][i], a[1][i], carry);    // t1 = a0+a1
+        carry = 0;
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) t2[i] = detail::addc(b[0][i], b[1][i], carry);    // t2 = b0+b1
+        F::mul(a[0], b[0], tt1);                                                                       // tt1 = a0*b0
+        F::mul(a[1], b[1], tt2);                                                                       // tt2 = a1*b1
+        F::mul(t1, t2, tt3);                                                                           // tt3 = (a0+a1)*(b0+b1)
+        SIDH_UNROLL for (unsigned i = 0; i < 2*N; i++) tt3[i] = detail::subb(tt3[i], tt1[i], borrow);
+        borrow = 0;
+        SIDH_UNROLL for (unsigned i = 0; i < 2*N; i++) tt3[i] = detail::subb(tt3[i], tt2[i], borrow);  // tt3 = (a0+a1)*(b0+b1) - a0*b0 - a1*b1
+        borrow = 0;
+        SIDH_UNROLL for (unsigned i = 0; i < 2*N; i++) tt1[i] = detail::subb(tt1[i], tt2[i], borrow);  // tt1 = a0*b0 - a1*b1
+        mask = 0 - borrow;
+        carry = 0;
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) tt1[N+i] = detail::addc(tt1[N+i], P::p[i] & mask, carry);  // + p*2^(64*N) if negative
+        F::rdc(tt3, c[1]);
+        F::rdc(tt1, c[0]);
+    }
+
+    static inline void sqr(const elm_t a, elm_t c)
+    { // GF(p^2) squaring using Montgomery arithmetic, c = a^2 in GF(p^2).
+      // Inputs: a = a0+a1*i, where a0, a1 are in [0, 2*p-1]
+      // Output: c = c0+c1*i, where c0, c1 are in [0, 2*p-1]
+        typename F::elm_t t1, t2, t3;
+        limb_t carry = 0;
+
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) t1[i] = detail::addc(a[0][i], a[1][i], carry);    // t1 = a0+a1
+        F::sub_p4(a[0], a[1], t2);                                                                     // t2 = a0-a1
+        carry = 0;
+        SIDH_UNROLL for (unsigned i = 0; i < N; i++) t3[i] = detail::addc(a[0][i], a[0][i], carry);    // t3 = 2a0
+        F::mul_mont(t1, t2, c[0]);                                                                     // c0 = (a0+a1)(a0-a1)
+        F::mul_mont(t3, a[1], c[1]);                                                                   // c1 = 2a0*a1
+    }
+};
+
+}
+
+#endif
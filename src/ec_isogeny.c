@@ -112,6 +112,18 @@ void eval_4_isog(point_proj_t P, f2elm_t* coeff)
 }
 
 
+void eval_4_isog_many(point_proj* P, const unsigned int n, f2elm_t* coeff)
+{ // Evaluates the 4-isogeny defined by coeff (computed in the function get_4_isog()) at the n points P[0], ..., P[n-1].
+  // Inputs: the coefficients defining the isogeny, and the contiguous projective points P[i] = (X:Z).
+  // Output: the projective points P[i] = phi(P[i]) in the codomain.
+    unsigned int i;
+
+    for (i = 0; i < n; i++) {
+        eval_4_isog(&P[i], coeff);
+    }
+}
+
+
 void xTPL(const point_proj_t P, point_proj_t Q, const f2elm_t A24minus, const f2elm_t A24plus)              
 { // Tripling of a Montgomery point in projective coordinates (X:Z).
   // Input: projective Montgomery x-coordinates P = (X:Z), where x=X/Z and Montgomery curve constants A24plus = A+2C and A24minus = A-2C.
@@ -202,20 +214,15 @@ void eval_3_isog(point_proj_t Q, const f2elm_t* coeff)
 }
 
 
-void inv_3_way(f2elm_t z1, f2elm_t z2, f2elm_t z3)
-{ // 3-way simultaneous inversion
-  // Input:  z1,z2,z3
-  // Output: 1/z1,1/z2,1/z3 (override inputs).
-    f2elm_t t0, t1, t2;
+void eval_3_isog_many(point_proj* Q, const unsigned int n, const f2elm_t* coeff)
+{ // Evaluates the 3-isogeny defined by coeff (computed in the function get_3_isog()) at the n points Q[0], ..., Q[n-1].
+  // Inputs: the coefficients defining the isogeny, and the contiguous projective points Q[i] = (X:Z).
+  // Output: the projective points Q[i] = phi(Q[i]) in the codomain.
+    unsigned int i;
 
-    fp2mul_mont(z1, z2, t0);                      // t0 = z1*z2
-    fp2mul_mont(z3, t0, t1);                      // t1 = z1*z2*z3
-    fp2inv_mont(t1);                              // t1 = 1/(z1*z2*z3)
-    fp2mul_mont(z3, t1, t2);                      // t2 = 1/(z1*z2)
-    fp2mul_mont(t0, t1, z3);                      // z3 = 1/z3
-    fp2mul_mont(t2, z2, t0);                      // z1 = 1/z1
-    fp2mul_mont(t2, z1, z2);                      // z2 = 1/z2
-    fp2copy(t0, z1);
+    for (i = 0; i < n; i++) {
+        eval_3_isog(&Q[i], coeff);
+    }
 }
 
 
@@ -242,6 +249,34 @@ void get_A(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xR, f2elm_t A)
 }
 
 
+void get_A_many(const f2elm_t (*PK)[3], const unsigned int n, f2elm_t* A, f2elm_t* scratch)
+{ // Computes the values A of get_A() for the n triples of x-coordinates (xP, xQ, xR) = PK[i], sharing a single inversion.
+  // The caller supplies scratch space for 3n elements in GF(p^2).
+    f2elm_t t1, one = {0}, *den = scratch, *inv = scratch + n;
+    unsigned int i;
+
+    fpcopy((digit_t*)&Montgomery_one, one[0]);
+    for (i = 0; i < n; i++) {
+        fp2add(PK[i][0], PK[i][1], t1);           // t1 = xP+xQ
+        fp2mul_mont(PK[i][0], PK[i][1], den[i]);  // den = xP*xQ
+        fp2mul_mont(PK[i][2], t1, A[i]);          // A = xR*t1
+        fp2add(den[i], A[i], A[i]);               // A = A+den
+        fp2mul_mont(den[i], PK[i][2], den[i]);    // den = den*xR
+        fp2sub(A[i], one, A[i]);                  // A = A-1
+        fp2add(den[i], den[i], den[i]);           // den = den+den
+        fp2add(den[i], den[i], den[i]);           // den = den+den
+        fp2sqr_mont(A[i], A[i]);                  // A = A^2
+    }
+    fp2_batch_inv_masked(den, n, inv, scratch + 2*n);    // inv = 1/den
+    for (i = 0; i < n; i++) {
+        fp2add(PK[i][0], PK[i][1], t1);           // t1 = xP+xQ+xR
+        fp2add(t1, PK[i][2], t1);
+        fp2mul_mont(A[i], inv[i], A[i]);          // A = A*inv
+        fp2sub(A[i], t1, A[i]);                   // Afinal = A-t1
+    }
+}
+
+
 void j_inv(const f2elm_t A, const f2elm_t C, f2elm_t jinv)
 { // Computes the j-invariant of a Montgomery curve with projective constant.
   // Input: A,C in GF(p^2).
@@ -267,6 +302,45 @@ void j_inv(const f2elm_t A, const f2elm_t C, f2elm_t jinv)
 }
 
 
+void j_inv_fraction(const f2elm_t A, const f2elm_t C, f2elm_t num, f2elm_t den)
+{ // Computes the j-invariant of a Montgomery curve with projective constant as a fraction, j = num/den, without inversion.
+  // Input: A,C in GF(p^2).
+  // Output: num = 256*(A^2-3*C^2)^3 and den = C^4*(A^2-4*C^2), as in j_inv().
+    f2elm_t t1;
+
+    fp2sqr_mont(A, den);                            // den = A^2
+    fp2sqr_mont(C, t1);                             // t1 = C^2
+    fp2add(t1, t1, num);                            // num = t1+t1
+    fp2sub(den, num, num);                          // num = den-num
+    fp2sub(num, t1, num);                           // num = num-t1
+    fp2sub(num, t1, den);                           // den = num-t1
+    fp2sqr_mont(t1, t1);                            // t1 = t1^2
+    fp2mul_mont(den, t1, den);                      // den = den*t1
+    fp2add(num, num, num);                          // num = num+num
+    fp2add(num, num, num);                          // num = num+num
+    fp2sqr_mont(num, t1);                           // t1 = num^2
+    fp2mul_mont(num, t1, num);                      // num = num*t1
+    fp2add(num, num, num);                          // num = num+num
+    fp2add(num, num, num);                          // num = num+num
+}
+
+
+void j_inv_many(const f2elm_t* A, const f2elm_t* C, const unsigned int n, f2elm_t* jinv, f2elm_t* scratch)
+{ // Computes the j-invariants of n Montgomery curves with projective constants (A[i]:C[i]) as in j_inv(), sharing a single inversion.
+  // The caller supplies scratch space for 3n elements in GF(p^2).
+    f2elm_t *num = scratch, *den = scratch + n;
+    unsigned int i;
+
+    for (i = 0; i < n; i++) {
+        j_inv_fraction(A[i], C[i], num[i], den[i]);
+    }
+    fp2_batch_inv_masked(den, n, jinv, scratch + 2*n);    // jinv = 1/den
+    for (i = 0; i < n; i++) {
+        fp2mul_mont(jinv[i], num[i], jinv[i]);      // jinv = num*jinv
+    }
+}
+
+
 void xDBLADD(point_proj_t P, point_proj_t Q, const f2elm_t XPQ, const f2elm_t ZPQ, const f2elm_t A24)
 { // Simultaneous doubling and differential addition.
   // Input: projective Montgomery points P=(XP:ZP) and Q=(XQ:ZQ) such that xP=XP/ZP and xQ=XQ/ZQ, affine difference xPQ=x(P-Q) and Montgomery curve constant A24=(A+2)/4.
@@ -318,6 +392,8 @@ static void swap_points(point_proj_t P, point_proj_t Q, const digit_t option)
 }
 
 
+#ifndef COMPRESS
+
 static void LADDER3PT(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xPQ, const digit_t* m, const unsigned int AliceOrBob, point_proj_t R, const f2elm_t A)
 {
     point_proj_t R0 = {0}, R2 = {0};
@@ -362,6 +438,135 @@ static void LADDER3PT(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xPQ, con
     swap_points(R, R2, mask);
 }
 
+#else
+
+static void LADDER3PT_E0(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xPQ, const digit_t* m, const unsigned int AliceOrBob, point_proj_t R)
+{ // Variant of LADDER3PT on the starting curve E0: y^2 = x^3 + 6x^2 + x, R = P + [m]Q.
+  // Since A24 = (6+2)/4 = 2, the multiplication by A24 in every doubling is replaced by an addition.
+    point_proj_t R0 = {0}, R2 = {0};
+    f2elm_t t0, t1, t2;
+    digit_t mask;
+    int i, nbits, bit, swap, prevbit = 0;
+
+    if (AliceOrBob == ALICE) {
+        nbits = OALICE_BITS;
+    } else {
+        nbits = OBOB_BITS - 1;
+    }
+
+    // Initializing points
+    fp2copy(xQ, R0->X);
+    fpcopy((digit_t*)&Montgomery_one, (digit_t*)R0->Z);
+    fp2copy(xPQ, R2->X);
+    fpcopy((digit_t*)&Montgomery_one, (digit_t*)R2->Z);
+    fp2copy(xP, R->X);
+    fpcopy((digit_t*)&Montgomery_one, (digit_t*)R->Z);
+    fpzero((digit_t*)(R->Z)[1]);
+
+    // Main loop
+    for (i = 0; i < nbits; i++) {
+        bit = (m[i >> LOG2RADIX] >> (i & (RADIX-1))) & 1;
+        swap = bit ^ prevbit;
+        prevbit = bit;
+        mask = 0 - (digit_t)swap;
+
+        swap_points(R, R2, mask);
+        // R0 <- 2*R0 and R2 <- R0 + R2, where R = R2 - R0, as in xDBLADD()
+        mp2_add(R0->X, R0->Z, t0);                  // t0 = X0+Z0
+        mp2_sub_p2(R0->X, R0->Z, t1);               // t1 = X0-Z0
+        fp2sqr_mont(t0, R0->X);                     // X0 = (X0+Z0)^2
+        mp2_sub_p2(R2->X, R2->Z, t2);               // t2 = X2-Z2
+        mp2_add(R2->X, R2->Z, R2->X);               // X2 = X2+Z2
+        fp2mul_mont(t0, t2, t0);                    // t0 = (X0+Z0)*(X2-Z2)
+        fp2sqr_mont(t1, R0->Z);                     // Z0 = (X0-Z0)^2
+        fp2mul_mont(t1, R2->X, t1);                 // t1 = (X0-Z0)*(X2+Z2)
+        fp2sub(R0->X, R0->Z, t2);                   // t2 = (X0+Z0)^2-(X0-Z0)^2
+        fp2mul_mont(R0->X, R0->Z, R0->X);           // X0 = (X0+Z0)^2*(X0-Z0)^2
+        fp2add(t2, t2, R2->X);                      // X2 = A24*[(X0+Z0)^2-(X0-Z0)^2]
+        mp2_sub_p2(t0, t1, R2->Z);                  // Z2 = (X0+Z0)*(X2-Z2)-(X0-Z0)*(X2+Z2)
+        mp2_add(R2->X, R0->Z, R0->Z);               // Z0 = A24*[(X0+Z0)^2-(X0-Z0)^2]+(X0-Z0)^2
+        mp2_add(t0, t1, R2->X);                     // X2 = (X0+Z0)*(X2-Z2)+(X0-Z0)*(X2+Z2)
+        fp2mul_mont(R0->Z, t2, R0->Z);              // Z0 = [A24*[(X0+Z0)^2-(X0-Z0)^2]+(X0-Z0)^2]*[(X0+Z0)^2-(X0-Z0)^2]
+        fp2sqr_mont(R2->Z, R2->Z);                  // Z2 = [(X0+Z0)*(X2-Z2)-(X0-Z0)*(X2+Z2)]^2
+        fp2sqr_mont(R2->X, R2->X);                  // X2 = [(X0+Z0)*(X2-Z2)+(X0-Z0)*(X2+Z2)]^2
+        fp2mul_mont(R2->Z, R->X, R2->Z);            // Z2 = X*[(X0+Z0)*(X2-Z2)-(X0-Z0)*(X2+Z2)]^2
+        fp2mul_mont(R2->X, R->Z, R2->X);            // X2 = Z*[(X0+Z0)*(X2-Z2)+(X0-Z0)*(X2+Z2)]^2
+    }
+    swap = 0 ^ prevbit;
+    mask = 0 - (digit_t)swap;
+    swap_points(R, R2, mask);
+}
+
+#endif
+
+#ifndef COMPRESS
+
+static void LADDER3PT_fixed_base(const f2elm_t xP, const f2elm_t xPQ, const digit_t* table, const digit_t* m, const unsigned int AliceOrBob, point_proj_t R)
+{ // Fixed-base variant of LADDER3PT for points {P, Q, P-Q} with precomputed multiples of Q, R = P + [m]Q.
+  // The multiples [2^i]Q are not computed by doubling but read from the affine x-coordinates in table, which are in GF(p^2) for Alice
+  // (A_fixed_base for the public generators) and in GF(p) for Bob (B_fixed_base), so that every step is a differential addition with an
+  // affine point. The table is scanned in the same order for every scalar.
+    point_proj_t R2 = {0};
+    f2elm_t t0, t1, t2, t3;
+    const digit_t* xQ;
+    digit_t mask;
+    int i, nbits, bit, swap, prevbit = 0;
+
+    if (AliceOrBob == ALICE) {
+        nbits = OALICE_BITS;
+    } else {
+        nbits = OBOB_BITS - 1;
+    }
+
+    // Initializing points
+    fp2copy(xPQ, R2->X);
+    fpcopy((digit_t*)&Montgomery_one, (digit_t*)R2->Z);
+    fp2copy(xP, R->X);
+    fpcopy((digit_t*)&Montgomery_one, (digit_t*)R->Z);
+    fpzero((digit_t*)(R->Z)[1]);
+
+    // Main loop
+    for (i = 0; i < nbits; i++) {
+        bit = (m[i >> LOG2RADIX] >> (i & (RADIX-1))) & 1;
+        swap = bit ^ prevbit;
+        prevbit = bit;
+        mask = 0 - (digit_t)swap;
+
+        swap_points(R, R2, mask);
+        // R2 <- R2 + [2^i]Q, where R = R2 - [2^i]Q 
+        mp2_add(R2->X, R2->Z, t0);                  // t0 = X2+Z2
+        mp2_sub_p2(R2->X, R2->Z, t1);               // t1 = X2-Z2
+        if (AliceOrBob == ALICE) {
+            xQ = table + 2*i*NWORDS_FIELD;
+            fpsub(xQ, (digit_t*)&Montgomery_one, t2[0]);
+            fpcopy(xQ + NWORDS_FIELD, t2[1]);       // t2 = xQ-1
+            fpadd(xQ, (digit_t*)&Montgomery_one, t3[0]);
+            fpcopy(xQ + NWORDS_FIELD, t3[1]);       // t3 = xQ+1
+            fp2mul_mont(t0, t2, t0);                // t0 = (X2+Z2)*(xQ-1)
+            fp2mul_mont(t1, t3, t1);                // t1 = (X2-Z2)*(xQ+1)
+        } else {                                    // Bob's xQ is in GF(p)
+            xQ = table + i*NWORDS_FIELD;
+            fpsub(xQ, (digit_t*)&Montgomery_one, t2[0]);   // t2 = xQ-1
+            fpadd(xQ, (digit_t*)&Montgomery_one, t3[0]);   // t3 = xQ+1
+            fpmul_mont(t0[0], t2[0], t0[0]);        // t0 = (X2+Z2)*(xQ-1)
+            fpmul_mont(t0[1], t2[0], t0[1]);
+            fpmul_mont(t1[0], t3[0], t1[0]);        // t1 = (X2-Z2)*(xQ+1)
+            fpmul_mont(t1[1], t3[0], t1[1]);
+        }
+        mp2_add(t0, t1, R2->X);                     // X2 = (X2+Z2)*(xQ-1) + (X2-Z2)*(xQ+1)
+        mp2_sub_p2(t0, t1, R2->Z);                  // Z2 = (X2+Z2)*(xQ-1) - (X2-Z2)*(xQ+1)
+        fp2sqr_mont(R2->X, R2->X);
+        fp2sqr_mont(R2->Z, R2->Z);
+        fp2mul_mont(R->Z, R2->X, R2->X);            // X2 = Z*[(X2+Z2)*(xQ-1) + (X2-Z2)*(xQ+1)]^2
+        fp2mul_mont(R->X, R2->Z, R2->Z);            // Z2 = X*[(X2+Z2)*(xQ-1) - (X2-Z2)*(xQ+1)]^2
+    }
+    swap = 0 ^ prevbit;
+    mask = 0 - (digit_t)swap;
+    swap_points(R, R2, mask);
+}
+
+#endif
+
 #ifdef COMPRESS
 
 
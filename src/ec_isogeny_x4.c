@@ -0,0 +1,293 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: 4-way AVX2 elliptic curve and isogeny functions
+*********************************************************************************************/
+
+
+static void xDBL_x4(const vpoint_proj_t P, vpoint_proj_t Q, const vf2elm_t A24plus, const vf2elm_t C24)
+{ // 4-way doubling of a Montgomery point in projective coordinates (X:Z).
+  // Input: projective Montgomery x-coordinates P = (X1:Z1), where x1=X1/Z1 and Montgomery curve constants A+2C and 4C.
+  // Output: projective Montgomery x-coordinates Q = 2*P = (X2:Z2).
+    vf2elm_t t0, t1;
+
+    mp2_sub_p2_x4(P->X, P->Z, t0);                  // t0 = X1-Z1
+    mp2_add_x4(P->X, P->Z, t1);                     // t1 = X1+Z1
+    fp2sqr_mont_x4(t0, t0);                         // t0 = (X1-Z1)^2
+    fp2sqr_mont_x4(t1, t1);                         // t1 = (X1+Z1)^2
+    fp2mul_mont_x4(C24, t0, Q->Z);                  // Z2 = C24*(X1-Z1)^2
+    fp2mul_mont_x4(t1, Q->Z, Q->X);                 // X2 = C24*(X1-Z1)^2*(X1+Z1)^2
+    mp2_sub_p2_x4(t1, t0, t1);                      // t1 = (X1+Z1)^2-(X1-Z1)^2
+    fp2mul_mont_x4(A24plus, t1, t0);                // t0 = A24plus*[(X1+Z1)^2-(X1-Z1)^2]
+    mp2_add_x4(Q->Z, t0, Q->Z);                     // Z2 = A24plus*[(X1+Z1)^2-(X1-Z1)^2] + C24*(X1-Z1)^2
+    fp2mul_mont_x4(Q->Z, t1, Q->Z);                 // Z2 = [A24plus*[(X1+Z1)^2-(X1-Z1)^2] + C24*(X1-Z1)^2]*[(X1+Z1)^2-(X1-Z1)^2]
+}
+
+
+static void xDBLe_x4(const vpoint_proj_t P, vpoint_proj_t Q, const vf2elm_t A24plus, const vf2elm_t C24, const int e)
+{ // 4-way computation of [2^e](X:Z) on Montgomery curve with projective constant via e repeated doublings.
+  // Input: projective Montgomery x-coordinates P = (XP:ZP), such that xP=XP/ZP and Montgomery curve constants A+2C and 4C.
+  // Output: projective Montgomery x-coordinates Q <- (2^e)*P.
+    int i;
+
+    fp2copy_x4(P->X, Q->X);
+    fp2copy_x4(P->Z, Q->Z);
+
+    for (i = 0; i < e; i++) {
+        xDBL_x4(Q, Q, A24plus, C24);
+    }
+}
+
+#if (OALICE_BITS % 2 == 1)
+
+static void get_2_isog_x4(const vpoint_proj_t P, vf2elm_t A, vf2elm_t C)
+{ // 4-way computation of the corresponding 2-isogeny of a projective Montgomery point (X2:Z2) of order 2.
+  // Input:  projective point of order two P = (X2:Z2).
+  // Output: the 2-isogenous Montgomery curve with projective coefficients A/C.
+
+    fp2sqr_mont_x4(P->X, A);                        // A = X2^2
+    fp2sqr_mont_x4(P->Z, C);                        // C = Z2^2
+    mp2_sub_p2_x4(C, A, A);                         // A = Z2^2 - X2^2
+}
+
+
+static void eval_2_isog_x4(vpoint_proj_t P, vpoint_proj_t Q)
+{ // 4-way evaluation of the isogeny at the point (X:Z) in the domain of the isogeny, given a 2-isogeny phi.
+  // Inputs: the projective point P = (X:Z) and the 2-isogeny kernel projetive point Q = (X2:Z2).
+  // Output: the projective point P = phi(P) = (X:Z) in the codomain.
+    vf2elm_t t0, t1, t2, t3;
+
+    mp2_add_x4(Q->X, Q->Z, t0);                     // t0 = X2+Z2
+    mp2_sub_p2_x4(Q->X, Q->Z, t1);                  // t1 = X2-Z2
+    mp2_add_x4(P->X, P->Z, t2);                     // t2 = X+Z
+    mp2_sub_p2_x4(P->X, P->Z, t3);                  // t3 = X-Z
+    fp2mul_mont_x4(t0, t3, t0);                     // t0 = (X2+Z2)*(X-Z)
+    fp2mul_mont_x4(t1, t2, t1);                     // t1 = (X2-Z2)*(X+Z)
+    mp2_add_x4(t0, t1, t2);                         // t2 = (X2+Z2)*(X-Z) + (X2-Z2)*(X+Z)
+    mp2_sub_p2_x4(t0, t1, t3);                      // t3 = (X2+Z2)*(X-Z) - (X2-Z2)*(X+Z)
+    fp2mul_mont_x4(P->X, t2, P->X);                 // Xfinal
+    fp2mul_mont_x4(P->Z, t3, P->Z);                 // Zfinal
+}
+
+#endif
+
+static void get_4_isog_x4(const vpoint_proj_t P, vf2elm_t A24plus, vf2elm_t C24, vf2elm_t* coeff)
+{ // 4-way computation of the corresponding 4-isogeny of a projective Montgomery point (X4:Z4) of order 4.
+  // Input:  projective point of order four P = (X4:Z4).
+  // Output: the 4-isogenous Montgomery curve with projective coefficients A+2C/4C and the 3 coefficients
+  //         that are used to evaluate the isogeny at a point in eval_4_isog_x4().
+
+    mp2_sub_p2_x4(P->X, P->Z, coeff[1]);            // coeff[1] = X4-Z4
+    mp2_add_x4(P->X, P->Z, coeff[2]);               // coeff[2] = X4+Z4
+    fp2sqr_mont_x4(P->Z, coeff[0]);                 // coeff[0] = Z4^2
+    fp2add_x4(coeff[0], coeff[0], coeff[0]);        // coeff[0] = 2*Z4^2
+    fp2sqr_mont_x4(coeff[0], C24);                  // C24 = 4*Z4^4
+    fp2add_x4(coeff[0], coeff[0], coeff[0]);        // coeff[0] = 4*Z4^2
+    fp2sqr_mont_x4(P->X, A24plus);                  // A24plus = X4^2
+    mp2_add_x4(A24plus, A24plus, A24plus);          // A24plus = 2*X4^2
+    fp2sqr_mont_x4(A24plus, A24plus);               // A24plus = 4*X4^4
+}
+
+
+static void eval_4_isog_x4(vpoint_proj_t P, vf2elm_t* coeff)
+{ // 4-way evaluation of the isogeny at the point (X:Z) in the domain of the isogeny, given a 4-isogeny phi defined
+  // by the 3 coefficients in coeff (computed in the function get_4_isog_x4()).
+  // Inputs: the coefficients defining the isogeny, and the projective point P = (X:Z).
+  // Output: the projective point P = phi(P) = (X:Z) in the codomain.
+    vf2elm_t t0, t1;
+
+    mp2_add_x4(P->X, P->Z, t0);                     // t0 = X+Z
+    mp2_sub_p2_x4(P->X, P->Z, t1);                  // t1 = X-Z
+    fp2mul_mont_x4(t0, coeff[1], P->X);             // X = (X+Z)*coeff[1]
+    fp2mul_mont_x4(t1, coeff[2], P->Z);             // Z = (X-Z)*coeff[2]
+    fp2mul_mont_x4(t0, t1, t0);                     // t0 = (X+Z)*(X-Z)
+    fp2mul_mont_x4(coeff[0], t0, t0);               // t0 = coeff[0]*(X+Z)*(X-Z)
+    mp2_add_x4(P->X, P->Z, t1);                     // t1 = (X-Z)*coeff[2] + (X+Z)*coeff[1]
+    mp2_sub_p2_x4(P->X, P->Z, P->Z);                // Z = (X-Z)*coeff[2] - (X+Z)*coeff[1]
+    fp2sqr_mont_x4(t1, t1);                         // t1 = [(X-Z)*coeff[2] + (X+Z)*coeff[1]]^2
+    fp2sqr_mont_x4(P->Z, P->Z);                     // Z = [(X-Z)*coeff[2] - (X+Z)*coeff[1]]^2
+    mp2_add_x4(t1, t0, P->X);                       // X = coeff[0]*(X+Z)*(X-Z) + [(X-Z)*coeff[2] + (X+Z)*coeff[1]]^2
+    mp2_sub_p2_x4(P->Z, t0, t0);                    // t0 = [(X-Z)*coeff[2] - (X+Z)*coeff[1]]^2 - coeff[0]*(X+Z)*(X-Z)
+    fp2mul_mont_x4(P->X, t1, P->X);                 // Xfinal
+    fp2mul_mont_x4(P->Z, t0, P->Z);                 // Zfinal
+}
+
+
+static void xTPL_x4(const vpoint_proj_t P, vpoint_proj_t Q, const vf2elm_t A24minus, const vf2elm_t A24plus)
+{ // 4-way tripling of a Montgomery point in projective coordinates (X:Z).
+  // Input: projective Montgomery x-coordinates P = (X:Z), where x=X/Z and Montgomery curve constants A24plus = A+2C and A24minus = A-2C.
+  // Output: projective Montgomery x-coordinates Q = 3*P = (X3:Z3).
+    vf2elm_t t0, t1, t2, t3, t4, t5, t6;
+
+    mp2_sub_p2_x4(P->X, P->Z, t0);                  // t0 = X-Z
+    fp2sqr_mont_x4(t0, t2);                         // t2 = (X-Z)^2
+    mp2_add_x4(P->X, P->Z, t1);                     // t1 = X+Z
+    fp2sqr_mont_x4(t1, t3);                         // t3 = (X+Z)^2
+    mp2_add_x4(P->X, P->X, t4);                     // t4 = 2*X
+    mp2_add_x4(P->Z, P->Z, t0);                     // t0 = 2*Z
+    fp2sqr_mont_x4(t4, t1);                         // t1 = 4*X^2
+    fp2sub_x4(t1, t3, t1);                          // t1 = 4*X^2 - (X+Z)^2
+    mp2_sub_p2_x4(t1, t2, t1);                      // t1 = 4*X^2 - (X+Z)^2 - (X-Z)^2
+    fp2mul_mont_x4(A24plus, t3, t5);                // t5 = A24plus*(X+Z)^2
+    fp2mul_mont_x4(t3, t5, t3);                     // t3 = A24plus*(X+Z)^4
+    fp2mul_mont_x4(A24minus, t2, t6);               // t6 = A24minus*(X-Z)^2
+    fp2mul_mont_x4(t2, t6, t2);                     // t2 = A24minus*(X-Z)^4
+    fp2sub_x4(t2, t3, t3);                          // t3 = A24minus*(X-Z)^4 - A24plus*(X+Z)^4
+    mp2_sub_p2_x4(t5, t6, t2);                      // t2 = A24plus*(X+Z)^2 - A24minus*(X-Z)^2
+    fp2mul_mont_x4(t1, t2, t1);                     // t1 = [4*X^2 - (X+Z)^2 - (X-Z)^2]*[A24plus*(X+Z)^2 - A24minus*(X-Z)^2]
+    fp2add_x4(t3, t1, t2);                          // t2 = [4*X^2 - (X+Z)^2 - (X-Z)^2]*[A24plus*(X+Z)^2 - A24minus*(X-Z)^2] + A24minus*(X-Z)^4 - A24plus*(X+Z)^4
+    fp2sqr_mont_x4(t2, t2);                         // t2 = t2^2
+    fp2mul_mont_x4(t4, t2, Q->X);                   // X3 = 2*X*t2
+    fp2sub_x4(t3, t1, t1);                          // t1 = A24minus*(X-Z)^4 - A24plus*(X+Z)^4 - [4*X^2 - (X+Z)^2 - (X-Z)^2]*[A24plus*(X+Z)^2 - A24minus*(X-Z)^2]
+    fp2sqr_mont_x4(t1, t1);                         // t1 = t1^2
+    fp2mul_mont_x4(t0, t1, Q->Z);                   // Z3 = 2*Z*t1
+}
+
+
+static void xTPLe_x4(const vpoint_proj_t P, vpoint_proj_t Q, const vf2elm_t A24minus, const vf2elm_t A24plus, const int e)
+{ // 4-way computation of [3^e](X:Z) on Montgomery curve with projective constant via e repeated triplings.
+  // Input: projective Montgomery x-coordinates P = (XP:ZP), such that xP=XP/ZP and Montgomery curve constants A24plus = A+2C and A24minus = A-2C.
+  // Output: projective Montgomery x-coordinates Q <- (3^e)*P.
+    int i;
+
+    fp2copy_x4(P->X, Q->X);
+    fp2copy_x4(P->Z, Q->Z);
+
+    for (i = 0; i < e; i++) {
+        xTPL_x4(Q, Q, A24minus, A24plus);
+    }
+}
+
+
+static void get_3_isog_x4(const vpoint_proj_t P, vf2elm_t A24minus, vf2elm_t A24plus, vf2elm_t* coeff)
+{ // 4-way computation of the corresponding 3-isogeny of a projective Montgomery point (X3:Z3) of order 3.
+  // Input:  projective point of order three P = (X3:Z3).
+  // Output: the 3-isogenous Montgomery curve with projective coefficient A/C.
+    vf2elm_t t0, t1, t2, t3, t4;
+
+    mp2_sub_p2_x4(P->X, P->Z, coeff[0]);            // coeff0 = X-Z
+    fp2sqr_mont_x4(coeff[0], t0);                   // t0 = (X-Z)^2
+    mp2_add_x4(P->X, P->Z, coeff[1]);               // coeff1 = X+Z
+    fp2sqr_mont_x4(coeff[1], t1);                   // t1 = (X+Z)^2
+    mp2_add_x4(P->X, P->X, t3);                     // t3 = 2*X
+    fp2sqr_mont_x4(t3, t3);                         // t3 = 4*X^2
+    fp2sub_x4(t3, t0, t2);                          // t2 = 4*X^2 - (X-Z)^2
+    fp2sub_x4(t3, t1, t3);                          // t3 = 4*X^2 - (X+Z)^2
+    fp2add_x4(t0, t3, t4);                          // t4 = 4*X^2 - (X+Z)^2 + (X-Z)^2
+    fp2add_x4(t4, t4, t4);                          // t4 = 2(4*X^2 - (X+Z)^2 + (X-Z)^2)
+    mp2_add_x4(t1, t4, t4);                         // t4 = 8*X^2 - (X+Z)^2 + 2*(X-Z)^2
+    fp2mul_mont_x4(t2, t4, A24minus);               // A24minus = [4*X^2 - (X-Z)^2]*[8*X^2 - (X+Z)^2 + 2*(X-Z)^2]
+    fp2add_x4(t1, t2, t4);                          // t4 = 4*X^2 + (X+Z)^2 - (X-Z)^2
+    fp2add_x4(t4, t4, t4);                          // t4 = 2(4*X^2 + (X+Z)^2 - (X-Z)^2)
+    mp2_add_x4(t0, t4, t4);                         // t4 = 8*X^2 + 2*(X+Z)^2 - (X-Z)^2
+    fp2mul_mont_x4(t3, t4, A24plus);                // A24plus = [4*X^2 - (X+Z)^2]*[8*X^2 + 2*(X+Z)^2 - (X-Z)^2]
+}
+
+
+static void eval_3_isog_x4(vpoint_proj_t Q, const vf2elm_t* coeff)
+{ // 4-way computation of the 3-isogeny R=phi(X:Z), given projective point (X3:Z3) of order 3 on a Montgomery curve and
+  // a point P with 2 coefficients in coeff (computed in the function get_3_isog_x4()).
+  // Inputs: projective points P = (X3:Z3) and Q = (X:Z).
+  // Output: the projective point Q <- phi(Q) = (X3:Z3).
+    vf2elm_t t0, t1, t2;
+
+    mp2_add_x4(Q->X, Q->Z, t0);                     // t0 = X+Z
+    mp2_sub_p2_x4(Q->X, Q->Z, t1);                  // t1 = X-Z
+    fp2mul_mont_x4(coeff[0], t0, t0);               // t0 = coeff0*(X+Z)
+    fp2mul_mont_x4(coeff[1], t1, t1);               // t1 = coeff1*(X-Z)
+    mp2_add_x4(t0, t1, t2);                         // t2 = coeff0*(X+Z) + coeff1*(X-Z)
+    mp2_sub_p2_x4(t1, t0, t0);                      // t0 = coeff1*(X-Z) - coeff0*(X+Z)
+    fp2sqr_mont_x4(t2, t2);                         // t2 = [coeff0*(X+Z) + coeff1*(X-Z)]^2
+    fp2sqr_mont_x4(t0, t0);                         // t0 = [coeff1*(X-Z) - coeff0*(X+Z)]^2
+    fp2mul_mont_x4(Q->X, t2, Q->X);                 // X3final = X*[coeff0*(X+Z) + coeff1*(X-Z)]^2
+    fp2mul_mont_x4(Q->Z, t0, Q->Z);                 // Z3final = Z*[coeff1*(X-Z) - coeff0*(X+Z)]^2
+}
+
+
+static void xDBLADD_x4(vpoint_proj_t P, vpoint_proj_t Q, const vf2elm_t XPQ, const vf2elm_t ZPQ, const vf2elm_t A24)
+{ // 4-way simultaneous doubling and differential addition.
+  // Input: projective Montgomery points P=(XP:ZP) and Q=(XQ:ZQ) such that xP=XP/ZP and xQ=XQ/ZQ, affine difference xPQ=x(P-Q) and Montgomery curve constant A24=(A+2)/4.
+  // Output: projective Montgomery points P <- 2*P = (X2P:Z2P) such that x(2P)=X2P/Z2P, and Q <- P+Q = (XQP:ZQP) such that = x(Q+P)=XQP/ZQP.
+    vf2elm_t t0, t1, t2;
+
+    mp2_add_x4(P->X, P->Z, t0);                     // t0 = XP+ZP
+    mp2_sub_p2_x4(P->X, P->Z, t1);                  // t1 = XP-ZP
+    fp2sqr_mont_x4(t0, P->X);                       // XP = (XP+ZP)^2
+    mp2_sub_p2_x4(Q->X, Q->Z, t2);                  // t2 = XQ-ZQ
+    mp2_add_x4(Q->X, Q->Z, Q->X);                   // XQ = XQ+ZQ
+    fp2mul_mont_x4(t0, t2, t0);                     // t0 = (XP+ZP)*(XQ-ZQ)
+    fp2sqr_mont_x4(t1, P->Z);                       // ZP = (XP-ZP)^2
+    fp2mul_mont_x4(t1, Q->X, t1);                   // t1 = (XP-ZP)*(XQ+ZQ)
+    mp2_sub_p2_x4(P->X, P->Z, t2);                  // t2 = (XP+ZP)^2-(XP-ZP)^2
+    fp2mul_mont_x4(P->X, P->Z, P->X);               // XP = (XP+ZP)^2*(XP-ZP)^2
+    fp2mul_mont_x4(A24, t2, Q->X);                  // XQ = A24*[(XP+ZP)^2-(XP-ZP)^2]
+    mp2_sub_p2_x4(t0, t1, Q->Z);                    // ZQ = (XP+ZP)*(XQ-ZQ)-(XP-ZP)*(XQ+ZQ)
+    mp2_add_x4(Q->X, P->Z, P->Z);                   // ZP = A24*[(XP+ZP)^2-(XP-ZP)^2]+(XP-ZP)^2
+    mp2_add_x4(t0, t1, Q->X);                       // XQ = (XP+ZP)*(XQ-ZQ)+(XP-ZP)*(XQ+ZQ)
+    fp2mul_mont_x4(P->Z, t2, P->Z);                 // ZP = [A24*[(XP+ZP)^2-(XP-ZP)^2]+(XP-ZP)^2]*[(XP+ZP)^2-(XP-ZP)^2]
+    fp2sqr_mont_x4(Q->Z, Q->Z);                     // ZQ = [(XP+ZP)*(XQ-ZQ)-(XP-ZP)*(XQ+ZQ)]^2
+    fp2sqr_mont_x4(Q->X, Q->X);                     // XQ = [(XP+ZP)*(XQ-ZQ)+(XP-ZP)*(XQ+ZQ)]^2
+    fp2mul_mont_x4(Q->Z, XPQ, Q->Z);                // ZQ = xPQ*[(XP+ZP)*(XQ-ZQ)-(XP-ZP)*(XQ+ZQ)]^2
+    fp2mul_mont_x4(Q->X, ZPQ, Q->X);                // XQ = ZPQ*[(XP+ZP)*(XQ-ZQ)+(XP-ZP)*(XQ+ZQ)]^2
+}
+
+
+static void swap_points_x4(vpoint_proj_t P, vpoint_proj_t Q, const __m256i option)
+{ // 4-way swap of points.
+  // In each lane, if option = 0 then P <- P and Q <- Q, else if option = 0xFF...FF then P <- Q and Q <- P
+    __m256i temp;
+    unsigned int i, j;
+
+    for (j = 0; j < 2; j++) {
+        for (i = 0; i < NLIMBS_X4; i++) {
+            temp = _mm256_and_si256(option, _mm256_xor_si256(P->X[j][i], Q->X[j][i]));
+            P->X[j][i] = _mm256_xor_si256(temp, P->X[j][i]);
+            Q->X[j][i] = _mm256_xor_si256(temp, Q->X[j][i]);
+            temp = _mm256_and_si256(option, _mm256_xor_si256(P->Z[j][i], Q->Z[j][i]));
+            P->Z[j][i] = _mm256_xor_si256(temp, P->Z[j][i]);
+            Q->Z[j][i] = _mm256_xor_si256(temp, Q->Z[j][i]);
+        }
+    }
+}
+
+
+static void LADDER3PT_x4(const vf2elm_t xP, const vf2elm_t xQ, const vf2elm_t xPQ, const digit_t* m[4], const unsigned int AliceOrBob, vpoint_proj_t R, const vf2elm_t A24)
+{ // 4-way three-point Montgomery ladder. Each lane uses its own scalar m[i], and A24 = (A+2)/4 is given per lane.
+    vpoint_proj_t R0, R2;
+    vf2elm_t one;
+    f2elm_t one_ = {0};
+    __m256i mask;
+    int i, j, nbits;
+    digit_t bit[4], swap[4], prevbit[4] = {0};
+
+    if (AliceOrBob == ALICE) {
+        nbits = OALICE_BITS;
+    } else {
+        nbits = OBOB_BITS - 1;
+    }
+
+    // Initializing points
+    fpcopy((digit_t*)&Montgomery_one, one_[0]);
+    fp2_set1_x4(one_, one);
+    fp2copy_x4(xQ, R0->X);
+    fp2copy_x4(one, R0->Z);
+    fp2copy_x4(xPQ, R2->X);
+    fp2copy_x4(one, R2->Z);
+    fp2copy_x4(xP, R->X);
+    fp2copy_x4(one, R->Z);
+
+    // Main loop
+    for (i = 0; i < nbits; i++) {
+        for (j = 0; j < 4; j++) {
+            bit[j] = (m[j][i >> LOG2RADIX] >> (i & (RADIX-1))) & 1;
+            swap[j] = bit[j] ^ prevbit[j];
+            prevbit[j] = bit[j];
+        }
+        mask = _mm256_set_epi64x(-(long long)swap[3], -(long long)swap[2], -(long long)swap[1], -(long long)swap[0]);
+
+        swap_points_x4(R, R2, mask);
+        xDBLADD_x4(R0, R2, R->X, R->Z, A24);
+    }
+    mask = _mm256_set_epi64x(-(long long)prevbit[3], -(long long)prevbit[2], -(long long)prevbit[1], -(long long)prevbit[0]);
+    swap_points_x4(R, R2, mask);
+}
@@ -0,0 +1,163 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: portable multiprecision multiplication, squaring and Montgomery reduction using
+*           unsaturated limbs of RR_BITS bits with delayed carry propagation
+*
+* Field elements keep their saturated representation in digits of RADIX bits. Operands are split into
+* limbs of RR_BITS bits, so that all the products of a column (and the reduction terms added to it) can be
+* accumulated in a double-size word without carry handling. Carries are propagated once per column.
+* The Montgomery reduction computes ma*2^-MAXBITS_FIELD mod p as in the saturated code: MAXBITS_FIELD =
+* RR_STEPS*RR_BITS + RR_LAST_BITS, where the last step reduces the remaining RR_LAST_BITS bits.
+* Since p+1 = 2^eA*3^eB, the lowest RR_ZERO_LIMBS limbs of p+1 are zero and are skipped.
+*
+* Requires the prime-specific definition of the limbs of p+1 in radix 2^RR_BITS, RR_PRIME_P1.
+*********************************************************************************************/
+
+#define RR_MASK          (((rr_limb_t)1 << RR_BITS) - 1)
+#define RR_NLIMBS        ((MAXBITS_FIELD+RR_BITS-1)/RR_BITS)    // Number of limbs of a field element
+#define RR_STEPS         (MAXBITS_FIELD/RR_BITS)                // Number of full reduction steps
+#define RR_LAST_BITS     (MAXBITS_FIELD%RR_BITS)                // Number of bits reduced by the last step
+#define RR_ZERO_LIMBS    (OALICE_BITS/RR_BITS)                  // Number of "0" limbs in the least significant part of p+1
+#define RR_LAST_STEP     ((RR_LAST_BITS > 0) ? RR_STEPS : RR_STEPS-1)
+
+// Loops have constant trip counts and are fully unrolled, so that the limb indices are resolved at compile time
+#if (COMPILER == COMPILER_GCC || COMPILER == COMPILER_CLANG)
+    #define RR_UNROLL    _Pragma("GCC unroll 64")
+#else
+    #define RR_UNROLL
+#endif
+
+
+static __inline void rr_from_digits(const digit_t* a, const unsigned int nwords, rr_limb_t* A, const unsigned int nlimbs)
+{ // Conversion from nwords digits to nlimbs limbs of RR_BITS bits
+    unsigned int i, pos, idx, shift;
+    digit_t t;
+
+    RR_UNROLL
+    for (i = 0, pos = 0; i < nlimbs; i++, pos += RR_BITS) {
+        idx = pos/RADIX;
+        shift = pos%RADIX;
+        t = 0;
+        if (idx < nwords) {
+            t = a[idx] >> shift;
+            if (shift + RR_BITS > RADIX && idx+1 < nwords) {
+                t |= a[idx+1] << (RADIX - shift);
+            }
+        }
+        A[i] = (rr_limb_t)t & RR_MASK;
+    }
+}
+
+
+static __inline void rr_to_digits(const rr_limb_t* A, const unsigned int nlimbs, const unsigned int offset, digit_t* c, const unsigned int nwords)
+{ // Conversion from nlimbs limbs of RR_BITS bits to nwords digits, starting at bit position "offset" of A
+  // The limbs must be normalized, i.e., A[i] < 2^RR_BITS
+    unsigned int i, j, pos, bits;
+    digit_t t;
+
+    RR_UNROLL
+    for (i = 0, pos = offset; i < nwords; i++, pos += RADIX) {
+        j = pos/RR_BITS;
+        t = 0;
+        if (j < nlimbs) {
+            t = (digit_t)A[j] >> (pos%RR_BITS);
+            RR_UNROLL
+            for (bits = RR_BITS - pos%RR_BITS, j++; bits < RADIX && j < nlimbs; bits += RR_BITS, j++) {
+                t |= (digit_t)A[j] << bits;
+            }
+        }
+        c[i] = t;
+    }
+}
+
+
+void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords)
+{ // Multiprecision product scanning multiply with delayed carry propagation, c = a*b, where lng(a) = lng(b) = nwords.
+    unsigned int i, j;
+    rr_limb_t A[RR_NLIMBS], B[RR_NLIMBS], C[2*RR_NLIMBS];
+    rr_acc_t acc = 0;
+
+    UNREFERENCED_PARAMETER(nwords);
+
+    rr_from_digits(a, NWORDS_FIELD, A, RR_NLIMBS);
+    rr_from_digits(b, NWORDS_FIELD, B, RR_NLIMBS);
+
+    RR_UNROLL
+    for (i = 0; i < 2*RR_NLIMBS-1; i++) {
+        RR_UNROLL
+        for (j = (i < RR_NLIMBS) ? 0 : i-RR_NLIMBS+1; j <= i && j < RR_NLIMBS; j++) {
+            acc += (rr_acc_t)A[j]*B[i-j];
+        }
+        C[i] = (rr_limb_t)acc & RR_MASK;
+        acc >>= RR_BITS;
+    }
+    C[2*RR_NLIMBS-1] = (rr_limb_t)acc;
+
+    rr_to_digits(C, 2*RR_NLIMBS, 0, c, 2*NWORDS_FIELD);
+}
+
+
+void mp_sqr(const digit_t* a, digit_t* c, const unsigned int nwords)
+{ // Multiprecision product scanning squaring with delayed carry propagation, c = a^2, where lng(a) = nwords.
+    unsigned int i, j;
+    rr_limb_t A[RR_NLIMBS], C[2*RR_NLIMBS];
+    rr_acc_t acc = 0, cross;
+
+    UNREFERENCED_PARAMETER(nwords);
+
+    rr_from_digits(a, NWORDS_FIELD, A, RR_NLIMBS);
+
+    RR_UNROLL
+    for (i = 0; i < 2*RR_NLIMBS-1; i++) {
+        cross = 0;
+        RR_UNROLL
+        for (j = (i < RR_NLIMBS) ? 0 : i-RR_NLIMBS+1; j < i-j; j++) {
+            cross += (rr_acc_t)A[j]*A[i-j];                 // Cross products are computed once and added twice
+        }
+        acc += cross << 1;
+        if ((i & 1) == 0) {
+            acc += (rr_acc_t)A[i/2]*A[i/2];
+        }
+        C[i] = (rr_limb_t)acc & RR_MASK;
+        acc >>= RR_BITS;
+    }
+    C[2*RR_NLIMBS-1] = (rr_limb_t)acc;
+
+    rr_to_digits(C, 2*RR_NLIMBS, 0, c, 2*NWORDS_FIELD);
+}
+
+
+void rdc_mont(digit_t* ma, digit_t* mc)
+{ // Montgomery reduction with delayed carry propagation exploiting the special form of the prime, mc = ma*R^-1 mod p, where R = 2^MAXBITS_FIELD.
+  // If ma < R*p, the output mc is in the range [0, 2*p-1].
+  // ma is assumed to be in Montgomery representation.
+  // Since p = -1 mod 2^RR_BITS, the quotient limb q[i] of each step is the current column limb itself.
+    unsigned int i, j, jend;
+    rr_limb_t T[2*RR_NLIMBS], q[RR_STEPS+1];
+    rr_acc_t acc = 0;
+
+    rr_from_digits(ma, 2*NWORDS_FIELD, T, 2*RR_NLIMBS);
+
+    RR_UNROLL
+    for (i = 0; i < 2*RR_NLIMBS; i++) {
+        acc += T[i];
+        jend = (i < RR_ZERO_LIMBS) ? 0 : i-RR_ZERO_LIMBS+1;     // q[j] is multiplied by the nonzero limbs of p+1 only
+        if (jend > RR_LAST_STEP+1) {
+            jend = RR_LAST_STEP+1;
+        }
+        RR_UNROLL
+        for (j = (i < RR_NLIMBS) ? 0 : i-RR_NLIMBS+1; j < jend; j++) {
+            acc += (rr_acc_t)q[j]*RR_PRIME_P1[i-j];
+        }
+        if (i < RR_STEPS) {
+            q[i] = (rr_limb_t)acc & RR_MASK;
+        } else if (i == RR_STEPS && RR_LAST_BITS > 0) {
+            q[i] = (rr_limb_t)acc & (((rr_limb_t)1 << RR_LAST_BITS) - 1);
+        }
+        T[i] = (rr_limb_t)acc & RR_MASK;
+        acc >>= RR_BITS;
+    }
+
+    rr_to_digits(T, 2*RR_NLIMBS, MAXBITS_FIELD, mc, NWORDS_FIELD);
+}
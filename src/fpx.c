@@ -147,7 +147,11 @@ void fpsqr_mont(const felm_t ma, felm_t mc)
 { // Multiprecision squaring, c = a^2 mod p.
     dfelm_t temp = {0};
 
+#if defined(MP_SQR_IMPLEMENTATION)
+    mp_sqr(ma, temp, NWORDS_FIELD);
+#else
     mp_mul(ma, ma, temp, NWORDS_FIELD);
+#endif
     rdc_mont(temp, mc);
 }
 
@@ -257,6 +261,15 @@ void fp2sqr_mont(const f2elm_t a, f2elm_t c)
 { // GF(p^2) squaring using Montgomery arithmetic, c = a^2 in GF(p^2).
   // Inputs: a = a0+a1*i, where a0, a1 are in [0, 2*p-1] 
   // Output: c = c0+c1*i, where c0, c1 are in [0, 2*p-1] 
+#if defined(FP2_ASM_IMPLEMENTATION)
+
+    fp2sqr_asm(a, c);
+
+#elif defined(CXX_BACKEND_IMPLEMENTATION)
+
+    fp2sqr_cxx(a, c);
+
+#else
     felm_t t1, t2, t3;
     
     mp_addfast(a[0], a[1], t1);                      // t1 = a0+a1 
@@ -264,6 +277,7 @@ void fp2sqr_mont(const f2elm_t a, f2elm_t c)
     mp_addfast(a[0], a[0], t3);                      // t3 = 2a0
     fpmul_mont(t1, t2, c[0]);                        // c0 = (a0+a1)(a0-a1)
     fpmul_mont(t3, a[1], c[1]);                      // c1 = 2a0*a1
+#endif
 }
 
 
@@ -315,6 +329,11 @@ void fp2mul_mont(const f2elm_t a, const f2elm_t b, f2elm_t c)
 { // GF(p^2) multiplication using Montgomery arithmetic, c = a*b in GF(p^2).
   // Inputs: a = a0+a1*i and b = b0+b1*i, where a0, a1, b0, b1 are in [0, 2*p-1] 
   // Output: c = c0+c1*i, where c0, c1 are in [0, 2*p-1] 
+#if defined(CXX_BACKEND_IMPLEMENTATION)
+
+    fp2mul_cxx(a, b, c);
+
+#else
     felm_t t1, t2;
     dfelm_t tt1, tt2, tt3; 
     
@@ -327,6 +346,7 @@ void fp2mul_mont(const f2elm_t a, const f2elm_t b, f2elm_t c)
     mp_subaddfast(tt1, tt2, tt1);                    // tt1 = a0*b0 - a1*b1 + p*2^MAXBITS_FIELD if a0*b0 - a1*b1 < 0, else tt1 = a0*b0 - a1*b1
     rdc_mont(tt3, c[1]);                             // c[1] = (a0+a1)*(b0+b1) - a0*b0 - a1*b1 
     rdc_mont(tt1, c[0]);                             // c[0] = a0*b0 - a1*b1
+#endif
 }
 
 
@@ -749,6 +769,208 @@ void fpinv_chain_mont(felm_t a)
 }
 
 
+// Constant-time field inversion via the Bernstein-Yang "safegcd" algorithm (https://eprint.iacr.org/2019/266), 
+// using batches of divsteps on signed limbs in the style of libsecp256k1's modinv64.
+// Field elements are represented with SGCD_NLIMBS signed limbs of SGCD_BITS bits; all limbs except the top one are in [0, 2^SGCD_BITS).
+
+#if (RADIX == 64) && (COMPILER == COMPILER_GCC || COMPILER == COMPILER_CLANG)
+    #define SGCD_BITS       62
+    typedef int64_t         sgcd_limb_t;
+    typedef uint64_t        sgcd_ulimb_t;
+    typedef __int128        sgcd_wide_t;
+#else
+    #define SGCD_BITS       30
+    typedef int32_t         sgcd_limb_t;
+    typedef uint32_t        sgcd_ulimb_t;
+    typedef int64_t         sgcd_wide_t;
+#endif
+
+#define SGCD_MASK           (((sgcd_ulimb_t)1 << SGCD_BITS) - 1)
+#define SGCD_NLIMBS         ((NWORDS_FIELD*RADIX)/SGCD_BITS + 1)
+#define SGCD_SIGN(x)        ((x) >> (8*sizeof(sgcd_limb_t)-1))                                // All-ones if x < 0, zero otherwise
+#define SGCD_DIVSTEPS       ((49*NBITS_FIELD + 57 + 16)/17)                                   // Divsteps that suffice for inputs of NBITS_FIELD bits (Theorem 11.2 of Bernstein-Yang)
+#define SGCD_ITERATIONS     ((SGCD_DIVSTEPS + SGCD_BITS - 1)/SGCD_BITS)
+
+
+static __inline void fp_to_sgcd(const digit_t* a, sgcd_limb_t* r)
+{ // Conversion of a field element in [0, 2^(NWORDS_FIELD*RADIX)-1] to signed limbs.
+    unsigned int i, word, shift;
+    sgcd_ulimb_t x;
+
+    for (i = 0; i < SGCD_NLIMBS; i++) {
+        word = (i*SGCD_BITS)/RADIX;
+        shift = (i*SGCD_BITS)%RADIX;
+        x = 0;
+        if (word < NWORDS_FIELD) {
+            x = (sgcd_ulimb_t)(a[word] >> shift);
+        }
+        if (shift + SGCD_BITS > RADIX && word + 1 < NWORDS_FIELD) {
+            x |= (sgcd_ulimb_t)(a[word+1] << (RADIX - shift));
+        }
+        r[i] = (sgcd_limb_t)(x & SGCD_MASK);
+    }
+}
+
+
+static __inline void sgcd_to_fp(const sgcd_limb_t* a, digit_t* r)
+{ // Conversion of a value in signed limbs in the range [0, p-1] to a field element.
+    unsigned int i, j;
+    int shift;
+
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        r[i] = 0;
+        for (j = (i*RADIX)/SGCD_BITS; j <= (i*RADIX + RADIX - 1)/SGCD_BITS && j < SGCD_NLIMBS; j++) {
+            shift = (int)(j*SGCD_BITS) - (int)(i*RADIX);
+            if (shift >= 0) {
+                r[i] |= (digit_t)a[j] << shift;
+            } else {
+                r[i] |= (digit_t)((sgcd_ulimb_t)a[j] >> -shift);
+            }
+        }
+    }
+}
+
+
+static __inline sgcd_limb_t sgcd_divsteps(sgcd_limb_t delta, sgcd_ulimb_t f, sgcd_ulimb_t g, sgcd_limb_t* t)
+{ // Computes SGCD_BITS divsteps on the low limbs f and g of the current (f, g), and returns the updated delta.
+  // Output: transition matrix t = [u, v, q, r] scaled by 2^SGCD_BITS, such that [f, g]*2^SGCD_BITS = t*[f_in, g_in] after the divsteps.
+  // The matrix entries satisfy |u|+|v| <= 2^SGCD_BITS and |q|+|r| <= 2^SGCD_BITS.
+    sgcd_ulimb_t u = 1, v = 0, q = 0, r = 1, c1, c2, x, y, z;
+    unsigned int i;
+
+    for (i = 0; i < SGCD_BITS; i++) {
+        c1 = 0 - ((0 - (sgcd_ulimb_t)delta) >> (8*sizeof(sgcd_limb_t)-1));     // c1 = all-ones if delta > 0
+        c2 = 0 - (g & 1);                                                        // c2 = all-ones if g is odd
+        x = (f ^ c1) - c1;                                                       // x = -f if delta > 0, f otherwise
+        y = (u ^ c1) - c1;
+        z = (v ^ c1) - c1;
+        // If g is odd: g <- g-f if delta > 0, g+f otherwise
+        g += x & c2; q += y & c2; r += z & c2;
+        // If delta > 0 and g was odd: (delta, f) <- (-delta, g_old), using f+(g_old-f) = g_old 
+        c1 &= c2;
+        delta = (sgcd_limb_t)(((sgcd_ulimb_t)delta ^ c1) - c1);
+        f += g & c1; u += q & c1; v += r & c1;
+        // (delta, g) <- (delta+1, g/2)
+        g >>= 1; u <<= 1; v <<= 1;
+        delta += 1;
+    }
+    t[0] = (sgcd_limb_t)u; t[1] = (sgcd_limb_t)v; 
+    t[2] = (sgcd_limb_t)q; t[3] = (sgcd_limb_t)r;
+
+    return delta;
+}
+
+
+static __inline void sgcd_update_fg(sgcd_limb_t* f, sgcd_limb_t* g, const sgcd_limb_t* t)
+{ // Computes [f, g] = t*[f, g]/2^SGCD_BITS. The division is exact.
+    const sgcd_wide_t u = t[0], v = t[1], q = t[2], r = t[3];
+    sgcd_wide_t cf, cg;
+    unsigned int i;
+
+    cf = u*f[0] + v*g[0];
+    cg = q*f[0] + r*g[0];
+    cf >>= SGCD_BITS;
+    cg >>= SGCD_BITS;
+    for (i = 1; i < SGCD_NLIMBS; i++) {
+        cf += u*f[i] + v*g[i];
+        cg += q*f[i] + r*g[i];
+        f[i-1] = (sgcd_limb_t)(cf & SGCD_MASK);
+        g[i-1] = (sgcd_limb_t)(cg & SGCD_MASK);
+        cf >>= SGCD_BITS;
+        cg >>= SGCD_BITS;
+    }
+    f[SGCD_NLIMBS-1] = (sgcd_limb_t)cf;
+    g[SGCD_NLIMBS-1] = (sgcd_limb_t)cg;
+}
+
+
+static __inline void sgcd_update_de(sgcd_limb_t* d, sgcd_limb_t* e, const sgcd_limb_t* t, const sgcd_limb_t* p)
+{ // Computes [d, e] = t*[d, e]/2^SGCD_BITS mod p, by adding multiples md, me of p that clear the low SGCD_BITS bits.
+  // On input and output, d and e are in the range (-2*p, p).
+  // Since p = 2^eA*3^eB - 1 with eA > SGCD_BITS, -p^-1 = 1 mod 2^SGCD_BITS and the multiples are congruent to t*[d, e].
+    const sgcd_wide_t u = t[0], v = t[1], q = t[2], r = t[3];
+    const sgcd_limb_t sd = SGCD_SIGN(d[SGCD_NLIMBS-1]), se = SGCD_SIGN(e[SGCD_NLIMBS-1]);
+    sgcd_limb_t md, me;
+    sgcd_wide_t cd, ce;
+    unsigned int i;
+
+    md = (t[0] & sd) + (t[1] & se);
+    me = (t[2] & sd) + (t[3] & se);
+    cd = u*d[0] + v*e[0];
+    ce = q*d[0] + r*e[0];
+    md -= (sgcd_limb_t)(((sgcd_ulimb_t)md - (sgcd_ulimb_t)cd) & SGCD_MASK);
+    me -= (sgcd_limb_t)(((sgcd_ulimb_t)me - (sgcd_ulimb_t)ce) & SGCD_MASK);
+    cd += (sgcd_wide_t)p[0]*md;
+    ce += (sgcd_wide_t)p[0]*me;
+    cd >>= SGCD_BITS;
+    ce >>= SGCD_BITS;
+    for (i = 1; i < SGCD_NLIMBS; i++) {
+        cd += u*d[i] + v*e[i] + (sgcd_wide_t)p[i]*md;
+        ce += q*d[i] + r*e[i] + (sgcd_wide_t)p[i]*me;
+        d[i-1] = (sgcd_limb_t)(cd & SGCD_MASK);
+        e[i-1] = (sgcd_limb_t)(ce & SGCD_MASK);
+        cd >>= SGCD_BITS;
+        ce >>= SGCD_BITS;
+    }
+    d[SGCD_NLIMBS-1] = (sgcd_limb_t)cd;
+    e[SGCD_NLIMBS-1] = (sgcd_limb_t)ce;
+}
+
+
+static __inline void sgcd_normalize(sgcd_limb_t* d, const sgcd_limb_t sign, const sgcd_limb_t* p)
+{ // Computes d = d*sign mod p in the range [0, p-1], where d is in the range (-2*p, p) and sign = 1 or -1 is the top limb of f.
+    const sgcd_limb_t neg = SGCD_SIGN(sign);
+    sgcd_limb_t mask = SGCD_SIGN(d[SGCD_NLIMBS-1]), carry = 0;
+    unsigned int i;
+
+    for (i = 0; i < SGCD_NLIMBS; i++) {             // d = d+p if d < 0, then d = -d if sign = -1, giving d in (-p, p)
+        d[i] += p[i] & mask;
+        d[i] = (d[i] ^ neg) - neg;
+    }
+    for (i = 0; i < SGCD_NLIMBS-1; i++) {
+        carry += d[i];
+        d[i] = (sgcd_limb_t)((sgcd_ulimb_t)carry & SGCD_MASK);
+        carry >>= SGCD_BITS;
+    }
+    d[SGCD_NLIMBS-1] += carry;
+
+    mask = SGCD_SIGN(d[SGCD_NLIMBS-1]);              // d = d+p if d < 0
+    carry = 0;
+    for (i = 0; i < SGCD_NLIMBS-1; i++) {
+        carry += d[i] + (p[i] & mask);
+        d[i] = (sgcd_limb_t)((sgcd_ulimb_t)carry & SGCD_MASK);
+        carry >>= SGCD_BITS;
+    }
+    d[SGCD_NLIMBS-1] += carry + (p[SGCD_NLIMBS-1] & mask);
+}
+
+
+void fpinv_mont_safegcd(felm_t a)
+{ // Constant-time field inversion via safegcd using Montgomery arithmetic, a = a^(-1)*R mod p.
+  // The inverse of 0 is 0, as with the exponentiation in fpinv_mont().
+  // The Bezout coefficient e starts at R^2 so that the output is a^(-1)*R^2 = (a*R)^(-1)*R^3, i.e., the Montgomery representation of the inverse. 
+    sgcd_limb_t f[SGCD_NLIMBS], g[SGCD_NLIMBS], d[SGCD_NLIMBS] = {0}, e[SGCD_NLIMBS], p[SGCD_NLIMBS], t[4], delta = 1;
+    felm_t x;
+    unsigned int i;
+
+    fpcopy(a, x);
+    fpcorrection(x);                                 // The safegcd bound requires 0 <= g <= f = p
+    fp_to_sgcd((digit_t*)PRIME, p);
+    fp_to_sgcd((digit_t*)PRIME, f);
+    fp_to_sgcd(x, g);
+    fp_to_sgcd((digit_t*)&Montgomery_R2, e);
+
+    for (i = 0; i < SGCD_ITERATIONS; i++) {
+        delta = sgcd_divsteps(delta, (sgcd_ulimb_t)f[0], (sgcd_ulimb_t)g[0], t);
+        sgcd_update_fg(f, g, t);                     // Updating f, g first lets the next divsteps overlap with the update of d, e
+        sgcd_update_de(d, e, t, p);
+    }
+    // Now g = 0 and f = +-1 = gcd(p, a), and d*a = f*R^2 (mod p)
+    sgcd_normalize(d, f[SGCD_NLIMBS-1], p);
+    sgcd_to_fp(d, a);
+}
+
+
 void fp2inv_mont(f2elm_t a)
 {// GF(p^2) inversion using Montgomery arithmetic, a = (a0-i*a1)/(a0^2+a1^2).
     f2elm_t t1;
@@ -756,13 +978,79 @@ void fp2inv_mont(f2elm_t a)
     fpsqr_mont(a[0], t1[0]);                         // t10 = a0^2
     fpsqr_mont(a[1], t1[1]);                         // t11 = a1^2
     fpadd(t1[0], t1[1], t1[0]);                      // t10 = a0^2+a1^2
-    fpinv_mont(t1[0]);                               // t10 = (a0^2+a1^2)^-1
+    fpinv_mont_safegcd(t1[0]);                       // t10 = (a0^2+a1^2)^-1
     fpneg(a[1]);                                     // a = a0-i*a1
     fpmul_mont(a[0], t1[0], a[0]);
     fpmul_mont(a[1], t1[0], a[1]);                   // a = (a0-i*a1)*(a0^2+a1^2)^-1
 }
 
 
+void fp2_batch_inv(const f2elm_t* vec, const unsigned int n, f2elm_t* out, f2elm_t* scratch)
+{ // Constant-time n-way simultaneous GF(p^2) inversion using Montgomery's trick, out[i] = 1/vec[i] for i = 0,...,n-1, where n >= 1.
+  // It costs one inversion and 3*(n-1) multiplications. The caller supplies scratch space for n elements.
+  // out can be the same variable as vec (in-place inversion). Otherwise, scratch can be the same variable as out.
+  // If any of the inputs is zero, all the outputs are zero.
+    f2elm_t t1, t2;
+    unsigned int i;
+
+    fp2copy(vec[0], scratch[0]);                     // scratch[i] = vec[0]*...*vec[i]
+    for (i = 1; i < n; i++) {
+        fp2mul_mont(scratch[i-1], vec[i], scratch[i]);
+    }
+
+    fp2copy(scratch[n-1], t1);                       // t1 = 1/(vec[0]*...*vec[n-1])
+    fp2inv_mont(t1);
+
+    for (i = n-1; i >= 1; i--) {
+        fp2mul_mont(scratch[i-1], t1, t2);           // t2 = 1/vec[i]
+        fp2mul_mont(t1, vec[i], t1);                 // t1 = 1/(vec[0]*...*vec[i-1])
+        fp2copy(t2, out[i]);
+    }
+    fp2copy(t1, out[0]);
+}
+
+
+static __inline digit_t fp2_zero_mask(const f2elm_t a)
+{ // Constant-time test, returns all ones if a = 0 in GF(p^2) and 0 otherwise
+    f2elm_t t;
+    digit_t r = 0;
+    unsigned int i;
+
+    fp2copy(a, t);
+    fp2correction(t);
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        r |= t[0][i] | t[1][i];
+    }
+    return ((r | (0 - r)) >> (RADIX-1)) - 1;
+}
+
+
+void fp2_batch_inv_masked(const f2elm_t* vec, const unsigned int n, f2elm_t* out, f2elm_t* scratch)
+{ // Constant-time n-way simultaneous GF(p^2) inversion of independent inputs, out[i] = 1/vec[i] for i = 0,...,n-1, where n >= 1.
+  // Unlike fp2_batch_inv(), a zero input only gives a zero output, as with fp2inv_mont(): zero inputs are replaced by one before
+  // the inversion and their outputs are cleared. out must not be the same variable as vec, and the scratch space holds n elements.
+    digit_t mask;
+    unsigned int i, j;
+
+    for (i = 0; i < n; i++) {
+        fp2copy(vec[i], out[i]);
+        fp2correction(out[i]);
+        mask = fp2_zero_mask(out[i]);
+        for (j = 0; j < NWORDS_FIELD; j++) {
+            out[i][0][j] ^= mask & ((digit_t*)&Montgomery_one)[j];
+        }
+    }
+    fp2_batch_inv(out, n, out, scratch);
+    for (i = 0; i < n; i++) {
+        mask = ~fp2_zero_mask(vec[i]);
+        for (j = 0; j < NWORDS_FIELD; j++) {
+            out[i][0][j] &= mask;
+            out[i][1][j] &= mask;
+        }
+    }
+}
+
+
 void to_fp2mont(const f2elm_t a, f2elm_t mc)
 { // Conversion of a GF(p^2) element to Montgomery representation,
   // mc_i = a_i*R^2*R^(-1) = a_i*R in GF(p^2). 
@@ -1173,29 +1461,6 @@ void fp2inv_mont_bingcd(f2elm_t a)
 }
 
 
-void mont_n_way_inv(const f2elm_t* vec, const int n, f2elm_t* out)
-{ // n-way simultaneous inversion using Montgomery's trick.
-  // SECURITY NOTE: This function does not run in constant time.
-  // Also, vec and out CANNOT be the same variable!
-    f2elm_t t1;
-    int i;
-
-    fp2copy(vec[0], out[0]);                      // out[0] = vec[0]
-    for (i = 1; i < n; i++) {
-        fp2mul_mont(out[i-1], vec[i], out[i]);    // out[i] = out[i-1]*vec[i]
-    }
-
-    fp2copy(out[n-1], t1);                        // t1 = 1/out[n-1]
-    fp2inv_mont_bingcd(t1);
-    
-    for (i = n-1; i >= 1; i--) {
-        fp2mul_mont(out[i-1], t1, out[i]);        // out[i] = t1*out[i-1]
-        fp2mul_mont(t1, vec[i], t1);              // t1 = t1*vec[i]
-    }
-    fp2copy(t1, out[0]);                          // out[0] = t1
-}
-
-
 void multiply(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords)
 { // Multiprecision comba multiply, c = a*b, where lng(a) = lng(b) = nwords.
   // NOTE: a and c CANNOT be the same variable!
@@ -0,0 +1,394 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: 4-way AVX2 functions over GF(p) and GF(p^2)
+*
+* Each vector field element holds 4 independent elements of GF(p), one per 64-bit lane, split into
+* NLIMBS_X4 limbs of 29 bits (radix 2^29). Elements are kept in Montgomery representation with
+* respect to R' = 2^(29*NLIMBS_X4), in the range [0, 2*p-1] and with normalized limbs.
+* Since R' > 64*p, multiplication and squaring also accept unreduced inputs in [0, 4*p-1], which
+* allows the same lazy additions and subtractions (mp2_add_x4, mp2_sub_p2_x4) as in the scalar code.
+*********************************************************************************************/
+
+#define MASK29_X4    0x1FFFFFFF
+#define BIAS_X4      ((uint64_t)1 << 32)     // Multiple of 2^29 added to each limb so that signed carries can be extracted with logical shifts
+#define UNROLL_X4    _Pragma("GCC unroll 32")  // Full unrolling of the inner multiply-and-accumulate loop (GCC and clang)
+
+
+static __inline void fp_split_x4(const digit_t* a0, const digit_t* a1, const digit_t* a2, const digit_t* a3, vfelm_t c)
+{ // Converts 4 field elements in [0, 2^(29*NLIMBS_X4)-1] from 64-bit words to the 4-way radix 2^29 representation
+    const digit_t* a[4] = {a0, a1, a2, a3};
+    uint64_t l[4];
+    unsigned int i, k, w, sh;
+
+    for (i = 0; i < NLIMBS_X4; i++) {
+        w = (29*i) >> 6;
+        sh = (29*i) & 63;
+        for (k = 0; k < 4; k++) {
+            l[k] = (w < NWORDS_FIELD) ? (a[k][w] >> sh) : 0;
+            if (sh > 35 && w+1 < NWORDS_FIELD) {
+                l[k] |= a[k][w+1] << (64-sh);
+            }
+            l[k] &= MASK29_X4;
+        }
+        c[i] = _mm256_set_epi64x((long long)l[3], (long long)l[2], (long long)l[1], (long long)l[0]);
+    }
+}
+
+
+static __inline void fp_join_x4(const vfelm_t a, digit_t* c0, digit_t* c1, digit_t* c2, digit_t* c3)
+{ // Converts 4 field elements from the 4-way radix 2^29 representation (with normalized limbs) to 64-bit words
+    digit_t* c[4] = {c0, c1, c2, c3};
+    uint64_t l[4];
+    unsigned int i, k, w, sh;
+
+    for (k = 0; k < 4; k++) {
+        for (i = 0; i < NWORDS_FIELD; i++) {
+            c[k][i] = 0;
+        }
+    }
+    for (i = 0; i < NLIMBS_X4; i++) {
+        w = (29*i) >> 6;
+        sh = (29*i) & 63;
+        _mm256_storeu_si256((__m256i*)l, a[i]);
+        for (k = 0; k < 4 && w < NWORDS_FIELD; k++) {
+            c[k][w] |= l[k] << sh;
+            if (sh > 35 && w+1 < NWORDS_FIELD) {
+                c[k][w+1] |= l[k] >> (64-sh);
+            }
+        }
+    }
+}
+
+
+static __inline void fp_set1_x4(const uint64_t* a, vfelm_t c)
+{ // Broadcasts a constant given in radix 2^29 to the 4 lanes
+    for (unsigned int i = 0; i < NLIMBS_X4; i++) {
+        c[i] = _mm256_set1_epi64x((long long)a[i]);
+    }
+}
+
+
+static __inline void mp_add_x4(const vfelm_t a, const vfelm_t b, vfelm_t c)
+{ // 4-way multiprecision addition, c = a+b, with normalized limbs. The result must fit in NLIMBS_X4 limbs
+    const __m256i mask = _mm256_set1_epi64x(MASK29_X4);
+    __m256i t, carry = _mm256_setzero_si256();
+
+    for (unsigned int i = 0; i < NLIMBS_X4; i++) {
+        t = _mm256_add_epi64(_mm256_add_epi64(a[i], b[i]), carry);
+        carry = _mm256_srli_epi64(t, 29);
+        c[i] = _mm256_and_si256(t, mask);
+    }
+}
+
+
+static __inline void mp_sub_x4(const vfelm_t a, const vfelm_t b, vfelm_t c)
+{ // 4-way multiprecision subtraction, c = a-b, with normalized limbs. The result must be nonnegative
+    const __m256i mask = _mm256_set1_epi64x(MASK29_X4);
+    __m256i t, borrow = _mm256_setzero_si256();
+
+    for (unsigned int i = 0; i < NLIMBS_X4; i++) {
+        t = _mm256_sub_epi64(_mm256_sub_epi64(a[i], b[i]), borrow);
+        borrow = _mm256_srli_epi64(t, 63);
+        c[i] = _mm256_and_si256(t, mask);
+    }
+}
+
+
+static __inline void mp_subk_x4(const vfelm_t a, const vfelm_t b, const uint64_t* k, vfelm_t c)
+{ // 4-way multiprecision subtraction with correction, c = a-b+k, where k is a constant given in radix 2^29.
+  // The result must be nonnegative and fit in NLIMBS_X4 limbs. Output limbs are normalized
+    const __m256i mask = _mm256_set1_epi64x(MASK29_X4), bias = _mm256_set1_epi64x(BIAS_X4 >> 29);
+    __m256i t, carry = _mm256_setzero_si256();
+
+    for (unsigned int i = 0; i < NLIMBS_X4; i++) {
+        t = _mm256_add_epi64(_mm256_sub_epi64(a[i], b[i]), _mm256_set1_epi64x((long long)(k[i] + BIAS_X4)));
+        t = _mm256_add_epi64(t, carry);
+        carry = _mm256_sub_epi64(_mm256_srli_epi64(t, 29), bias);
+        c[i] = _mm256_and_si256(t, mask);
+    }
+}
+
+
+static __inline void fp2_addmask_x4(vf2elm_t a, const __m256i mask0, const __m256i mask1)
+{ // 4-way conditional correction with 2*p of both coordinates, a0 = a0 + (2p & mask0) and a1 = a1 + (2p & mask1), with normalized limbs.
+  // Both coordinates are processed in the same loop so that their carry chains are interleaved
+    const __m256i mask = _mm256_set1_epi64x(MASK29_X4);
+    __m256i p2, t0, t1, carry0 = _mm256_setzero_si256(), carry1 = _mm256_setzero_si256();
+
+    for (unsigned int i = 0; i < NLIMBS_X4; i++) {
+        p2 = _mm256_set1_epi64x((long long)PRIMEx2_X4[i]);
+        t0 = _mm256_add_epi64(_mm256_add_epi64(a[0][i], _mm256_and_si256(p2, mask0)), carry0);
+        t1 = _mm256_add_epi64(_mm256_add_epi64(a[1][i], _mm256_and_si256(p2, mask1)), carry1);
+        carry0 = _mm256_srli_epi64(t0, 29);
+        carry1 = _mm256_srli_epi64(t1, 29);
+        a[0][i] = _mm256_and_si256(t0, mask);
+        a[1][i] = _mm256_and_si256(t1, mask);
+    }
+}
+
+
+static __inline void mp_mac4_x4(const __m256i* a, const __m256i* b, const unsigned int jmin, __m256i* c)
+{ // 4-way multiply-and-accumulate of 4 consecutive rows, c[k] = c[k] + sum a[r]*b[k-r] for r = 0..3 and jmin <= k-r < NLIMBS_X4.
+  // Columns are not normalized. The limbs of b are loaded once and kept in registers across the 4 rows
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i b0, b1 = zero, b2 = zero, b3 = zero, acc;
+    unsigned int j;
+
+    UNROLL_X4
+    for (j = jmin; j < NLIMBS_X4; j++) {
+        b0 = b[j];
+        acc = _mm256_add_epi64(c[j], _mm256_mul_epu32(a[0], b0));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epu32(a[1], b1));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epu32(a[2], b2));
+        c[j] = _mm256_add_epi64(acc, _mm256_mul_epu32(a[3], b3));
+        b3 = b2; b2 = b1; b1 = b0;
+    }
+    acc = _mm256_add_epi64(c[NLIMBS_X4], _mm256_mul_epu32(a[1], b1));
+    acc = _mm256_add_epi64(acc, _mm256_mul_epu32(a[2], b2));
+    c[NLIMBS_X4] = _mm256_add_epi64(acc, _mm256_mul_epu32(a[3], b3));
+    acc = _mm256_add_epi64(c[NLIMBS_X4+1], _mm256_mul_epu32(a[2], b1));
+    c[NLIMBS_X4+1] = _mm256_add_epi64(acc, _mm256_mul_epu32(a[3], b2));
+    c[NLIMBS_X4+2] = _mm256_add_epi64(c[NLIMBS_X4+2], _mm256_mul_epu32(a[3], b1));
+}
+
+
+static __inline void mp_mac1_x4(const __m256i a, const __m256i* b, const unsigned int jmin, __m256i* c)
+{ // 4-way multiply-and-accumulate of one row, c[j] = c[j] + a*b[j] for jmin <= j < NLIMBS_X4. Columns are not normalized
+    for (unsigned int j = jmin; j < NLIMBS_X4; j++) {
+        c[j] = _mm256_add_epi64(c[j], _mm256_mul_epu32(a, b[j]));
+    }
+}
+
+
+static __inline void mp_mac_x4(const vfelm_t a, const vfelm_t b, __m256i* c)
+{ // 4-way schoolbook multiply-and-accumulate, c = c + a*b, where c consists of 2*NLIMBS_X4 64-bit columns
+    unsigned int i;
+
+    for (i = 0; i+4 <= NLIMBS_X4; i += 4) {
+        mp_mac4_x4(&a[i], b, 0, &c[i]);
+    }
+#if (NLIMBS_X4 % 4 == 3)
+    {   // The last 3 rows are processed as a block padded with a zero row
+        const __m256i t[4] = {a[i], a[i+1], a[i+2], _mm256_setzero_si256()};
+        mp_mac4_x4(t, b, 0, &c[i]);
+    }
+#else
+    for (; i < NLIMBS_X4; i++) {
+        mp_mac1_x4(a[i], b, 0, &c[i]);
+    }
+#endif
+}
+
+
+static void rdc_mont_x4(__m256i* ma, vfelm_t mc)
+{ // 4-way Montgomery reduction exploiting the special form of the prime, mc = ma*R'^-1 mod p, where R' = 2^(29*NLIMBS_X4).
+  // ma consists of 2*NLIMBS_X4 64-bit columns, each accumulating at most 2*NLIMBS_X4 products of 29-bit limbs, with a value in [0, p*R'-1].
+  // The output mc is in [0, 2*p-1] with normalized limbs.
+  // Since p = -1 mod 2^29, the Montgomery quotient of each step is the lowest limb, and only the limbs of p+1 starting at ZERO_LIMBS_X4 are
+  // nonzero. Because ZERO_LIMBS_X4 >= 4, four consecutive quotients can be computed before their multiples of p+1 are accumulated.
+    const __m256i mask = _mm256_set1_epi64x(MASK29_X4);
+    __m256i q[4], carry = _mm256_setzero_si256();
+    vfelm_t p1;
+    unsigned int i, r;
+
+#if (3*NLIMBS_X4 - ZERO_LIMBS_X4 > 63)
+    // Normalize the columns first, since adding the multiples of p+1 could otherwise overflow 64 bits
+    for (i = 0; i < 2*NLIMBS_X4; i++) {
+        ma[i] = _mm256_add_epi64(ma[i], carry);
+        carry = _mm256_srli_epi64(ma[i], 29);
+        ma[i] = _mm256_and_si256(ma[i], mask);
+    }
+#endif
+
+    fp_set1_x4(PRIMEP1_X4, p1);
+    for (i = 0; i+4 <= NLIMBS_X4; i += 4) {
+        for (r = 0; r < 4; r++) {
+            q[r] = _mm256_and_si256(ma[i+r], mask);
+            ma[i+r+1] = _mm256_add_epi64(ma[i+r+1], _mm256_srli_epi64(ma[i+r], 29));
+        }
+        mp_mac4_x4(q, p1, ZERO_LIMBS_X4, &ma[i]);
+    }
+#if (NLIMBS_X4 % 4 == 3)
+    for (r = 0; r < 3; r++) {                           // The last 3 quotients are processed as a block padded with a zero quotient
+        q[r] = _mm256_and_si256(ma[i+r], mask);
+        ma[i+r+1] = _mm256_add_epi64(ma[i+r+1], _mm256_srli_epi64(ma[i+r], 29));
+    }
+    q[3] = _mm256_setzero_si256();
+    mp_mac4_x4(q, p1, ZERO_LIMBS_X4, &ma[i]);
+#else
+    for (; i < NLIMBS_X4; i++) {
+        q[0] = _mm256_and_si256(ma[i], mask);
+        ma[i+1] = _mm256_add_epi64(ma[i+1], _mm256_srli_epi64(ma[i], 29));
+        mp_mac1_x4(q[0], p1, ZERO_LIMBS_X4, &ma[i]);
+    }
+#endif
+
+    carry = _mm256_setzero_si256();
+    for (i = 0; i < NLIMBS_X4; i++) {
+        ma[NLIMBS_X4+i] = _mm256_add_epi64(ma[NLIMBS_X4+i], carry);
+        carry = _mm256_srli_epi64(ma[NLIMBS_X4+i], 29);
+        mc[i] = _mm256_and_si256(ma[NLIMBS_X4+i], mask);
+    }
+}
+
+
+static void fpmul_mont_x4(const vfelm_t ma, const vfelm_t mb, vfelm_t mc)
+{ // 4-way field multiplication using Montgomery arithmetic, mc = ma*mb*R'^-1 mod p
+  // Inputs: ma, mb in [0, 4*p-1]
+  // Output: mc in [0, 2*p-1]
+    __m256i t[2*NLIMBS_X4] = {0};
+
+    mp_mac_x4(ma, mb, t);
+    rdc_mont_x4(t, mc);
+}
+
+
+static void fp2copy_x4(const vf2elm_t a, vf2elm_t c)
+{ // Copy of 4 GF(p^2) elements, c = a
+    for (unsigned int i = 0; i < NLIMBS_X4; i++) {
+        c[0][i] = a[0][i];
+        c[1][i] = a[1][i];
+    }
+}
+
+
+static void fp2add_x4(const vf2elm_t a, const vf2elm_t b, vf2elm_t c)
+{ // 4-way GF(p^2) addition, c = a+b in GF(p^2).
+  // Inputs: a, b with coordinates in [0, 2*p-1]
+  // Output: c with coordinates in [0, 2*p-1]
+    const __m256i mask = _mm256_set1_epi64x(MASK29_X4), bias = _mm256_set1_epi64x(BIAS_X4 >> 29);
+    __m256i k, t0, t1, carry0 = _mm256_setzero_si256(), carry1 = _mm256_setzero_si256();
+
+    for (unsigned int i = 0; i < NLIMBS_X4; i++) {      // c = a+b-2p, the final carries are -1 if the result is negative and 0 otherwise
+        k = _mm256_set1_epi64x((long long)(BIAS_X4 - PRIMEx2_X4[i]));
+        t0 = _mm256_add_epi64(_mm256_add_epi64(a[0][i], b[0][i]), _mm256_add_epi64(k, carry0));
+        t1 = _mm256_add_epi64(_mm256_add_epi64(a[1][i], b[1][i]), _mm256_add_epi64(k, carry1));
+        carry0 = _mm256_sub_epi64(_mm256_srli_epi64(t0, 29), bias);
+        carry1 = _mm256_sub_epi64(_mm256_srli_epi64(t1, 29), bias);
+        c[0][i] = _mm256_and_si256(t0, mask);
+        c[1][i] = _mm256_and_si256(t1, mask);
+    }
+    fp2_addmask_x4(c, carry0, carry1);
+}
+
+
+static void fp2sub_x4(const vf2elm_t a, const vf2elm_t b, vf2elm_t c)
+{ // 4-way GF(p^2) subtraction, c = a-b in GF(p^2).
+  // Inputs: a, b with coordinates in [0, 2*p-1]
+  // Output: c with coordinates in [0, 2*p-1]
+    const __m256i mask = _mm256_set1_epi64x(MASK29_X4);
+    __m256i t0, t1, borrow0 = _mm256_setzero_si256(), borrow1 = _mm256_setzero_si256();
+
+    for (unsigned int i = 0; i < NLIMBS_X4; i++) {
+        t0 = _mm256_sub_epi64(_mm256_sub_epi64(a[0][i], b[0][i]), borrow0);
+        t1 = _mm256_sub_epi64(_mm256_sub_epi64(a[1][i], b[1][i]), borrow1);
+        borrow0 = _mm256_srli_epi64(t0, 63);
+        borrow1 = _mm256_srli_epi64(t1, 63);
+        c[0][i] = _mm256_and_si256(t0, mask);
+        c[1][i] = _mm256_and_si256(t1, mask);
+    }
+    fp2_addmask_x4(c, _mm256_sub_epi64(_mm256_setzero_si256(), borrow0), _mm256_sub_epi64(_mm256_setzero_si256(), borrow1));
+}
+
+
+static void mp2_add_x4(const vf2elm_t a, const vf2elm_t b, vf2elm_t c)
+{ // 4-way GF(p^2) addition without correction, c = a+b in GF(p^2).
+  // Inputs: a, b with coordinates in [0, 2*p-1]
+  // Output: c with coordinates in [0, 4*p-1]
+    const __m256i mask = _mm256_set1_epi64x(MASK29_X4);
+    __m256i t0, t1, carry0 = _mm256_setzero_si256(), carry1 = _mm256_setzero_si256();
+
+    for (unsigned int i = 0; i < NLIMBS_X4; i++) {
+        t0 = _mm256_add_epi64(_mm256_add_epi64(a[0][i], b[0][i]), carry0);
+        t1 = _mm256_add_epi64(_mm256_add_epi64(a[1][i], b[1][i]), carry1);
+        carry0 = _mm256_srli_epi64(t0, 29);
+        carry1 = _mm256_srli_epi64(t1, 29);
+        c[0][i] = _mm256_and_si256(t0, mask);
+        c[1][i] = _mm256_and_si256(t1, mask);
+    }
+}
+
+
+static void mp2_sub_p2_x4(const vf2elm_t a, const vf2elm_t b, vf2elm_t c)
+{ // 4-way GF(p^2) subtraction with correction with 2*p, c = a-b+2p in GF(p^2).
+  // Inputs: a, b with coordinates in [0, 2*p-1]
+  // Output: c with coordinates in [1, 4*p-1]
+    const __m256i mask = _mm256_set1_epi64x(MASK29_X4), bias = _mm256_set1_epi64x(BIAS_X4 >> 29);
+    __m256i k, t0, t1, carry0 = _mm256_setzero_si256(), carry1 = _mm256_setzero_si256();
+
+    for (unsigned int i = 0; i < NLIMBS_X4; i++) {
+        k = _mm256_set1_epi64x((long long)(PRIMEx2_X4[i] + BIAS_X4));
+        t0 = _mm256_add_epi64(_mm256_sub_epi64(a[0][i], b[0][i]), _mm256_add_epi64(k, carry0));
+        t1 = _mm256_add_epi64(_mm256_sub_epi64(a[1][i], b[1][i]), _mm256_add_epi64(k, carry1));
+        carry0 = _mm256_sub_epi64(_mm256_srli_epi64(t0, 29), bias);
+        carry1 = _mm256_sub_epi64(_mm256_srli_epi64(t1, 29), bias);
+        c[0][i] = _mm256_and_si256(t0, mask);
+        c[1][i] = _mm256_and_si256(t1, mask);
+    }
+}
+
+
+static void fp2mul_mont_x4(const vf2elm_t a, const vf2elm_t b, vf2elm_t c)
+{ // 4-way GF(p^2) multiplication using Montgomery arithmetic, c = a*b in GF(p^2).
+  // Inputs: a = a0+a1*i and b = b0+b1*i, where a0, a1, b0, b1 are in [0, 4*p-1]
+  // Output: c = c0+c1*i, where c0 = a0*b0 + a1*(4p-b1) and c1 = a0*b1 + a1*b0, reduced to [0, 2*p-1]
+    __m256i t0[2*NLIMBS_X4] = {0}, t1[2*NLIMBS_X4] = {0};
+    vfelm_t t4p, nb1;
+
+    fp_set1_x4(PRIMEx4_X4, t4p);
+    mp_sub_x4(t4p, b[1], nb1);                      // nb1 = 4p-b1
+    mp_mac_x4(a[0], b[0], t0);                      // t0 = a0*b0
+    mp_mac_x4(a[1], nb1, t0);                       // t0 = a0*b0 + a1*(4p-b1)
+    mp_mac_x4(a[0], b[1], t1);                      // t1 = a0*b1
+    mp_mac_x4(a[1], b[0], t1);                      // t1 = a0*b1 + a1*b0
+    rdc_mont_x4(t0, c[0]);
+    rdc_mont_x4(t1, c[1]);
+}
+
+
+static void fp2sqr_mont_x4(const vf2elm_t a, vf2elm_t c)
+{ // 4-way GF(p^2) squaring using Montgomery arithmetic, c = a^2 in GF(p^2).
+  // Input:  a = a0+a1*i, where a0, a1 are in [0, 4*p-1]
+  // Output: c = c0+c1*i, where c0 = (a0+a1)(a0-a1) and c1 = 2a0*a1, reduced to [0, 2*p-1]
+    __m256i t0[2*NLIMBS_X4] = {0}, t1[2*NLIMBS_X4] = {0};
+    vfelm_t u, v, w;
+
+    mp_add_x4(a[0], a[1], u);                       // u = a0+a1
+    mp_subk_x4(a[0], a[1], PRIMEx4_X4, v);          // v = a0-a1+4p
+    mp_add_x4(a[0], a[0], w);                       // w = 2a0
+    mp_mac_x4(u, v, t0);
+    mp_mac_x4(w, a[1], t1);
+    rdc_mont_x4(t0, c[0]);
+    rdc_mont_x4(t1, c[1]);
+}
+
+
+static void fp2_to_x4(const f2elm_t a0, const f2elm_t a1, const f2elm_t a2, const f2elm_t a3, vf2elm_t c)
+{ // Conversion of 4 GF(p^2) elements in Montgomery representation to the 4-way representation
+    vfelm_t r2;
+
+    fp_set1_x4(Montgomery_R2_x4, r2);
+    for (unsigned int i = 0; i < 2; i++) {
+        fp_split_x4(a0[i], a1[i], a2[i], a3[i], c[i]);
+        fpmul_mont_x4(c[i], r2, c[i]);
+    }
+}
+
+
+static void fp2_from_x4(const vf2elm_t a, f2elm_t c0, f2elm_t c1, f2elm_t c2, f2elm_t c3)
+{ // Conversion of 4 GF(p^2) elements from the 4-way representation to Montgomery representation
+    vfelm_t r, t;
+
+    fp_set1_x4(Montgomery_R_x4, r);
+    for (unsigned int i = 0; i < 2; i++) {
+        fpmul_mont_x4(a[i], r, t);
+        fp_join_x4(t, c0[i], c1[i], c2[i], c3[i]);
+    }
+}
+
+
+static void fp2_set1_x4(const f2elm_t a, vf2elm_t c)
+{ // Conversion of a GF(p^2) element in Montgomery representation to the 4-way representation, broadcast to the 4 lanes
+    fp2_to_x4(a, a, a, a, c);
+}
@@ -44,6 +44,11 @@ void digit_x_digit(const digit_t a, const digit_t b, digit_t* c);
 // Multiprecision comba multiply, c = a*b, where lng(a) = lng(b) = nwords.
 void mp_mul(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords);
 
+#if defined(MP_SQR_IMPLEMENTATION)
+// Multiprecision squaring, c = a^2, where lng(a) = nwords.
+void mp_sqr(const digit_t* a, digit_t* c, const unsigned int nwords);
+#endif
+
 /************ Montgomery reduction and conversion functions *************/
 
 // Montgomery reduction, c = a mod p
@@ -61,14 +66,23 @@ void to_fp2mont(const f2elm_t a, f2elm_t mc);
 // Conversion of a GF(p^2) element from Montgomery representation to standard representation
 void from_fp2mont(const f2elm_t ma, f2elm_t c);
 
-// n-way Montgomery inversion
-void mont_n_way_inv(const f2elm_t* vec, const int n, f2elm_t* out);
+// Constant-time n-way simultaneous GF(p^2) inversion with caller-supplied scratch space of n elements
+void fp2_batch_inv(const f2elm_t* vec, const unsigned int n, f2elm_t* out, f2elm_t* scratch);
+
+// Constant-time n-way simultaneous GF(p^2) inversion of independent inputs, where a zero input does not affect the other outputs
+void fp2_batch_inv_masked(const f2elm_t* vec, const unsigned int n, f2elm_t* out, f2elm_t* scratch);
 
 /************ Elliptic curve and isogeny functions *************/
 
 // Computes the j-invariant of a Montgomery curve with projective constant.
 void j_inv(const f2elm_t A, const f2elm_t C, f2elm_t jinv);
 
+// Computes the j-invariant of a Montgomery curve with projective constant as a fraction num/den, without inversion.
+void j_inv_fraction(const f2elm_t A, const f2elm_t C, f2elm_t num, f2elm_t den);
+
+// Computes the j-invariants of n Montgomery curves with projective constants, sharing a single inversion.
+void j_inv_many(const f2elm_t* A, const f2elm_t* C, const unsigned int n, f2elm_t* jinv, f2elm_t* scratch);
+
 // Simultaneous doubling and differential addition.
 void xDBLADD(point_proj_t P, point_proj_t Q, const f2elm_t XPQ, const f2elm_t ZPQ, const f2elm_t A24);
 
@@ -87,6 +101,9 @@ void get_4_isog(const point_proj_t P, f2elm_t A24plus, f2elm_t C24, f2elm_t* coe
 // Evaluates the isogeny at the point (X:Z) in the domain of the isogeny.
 void eval_4_isog(point_proj_t P, f2elm_t* coeff);
 
+// Evaluates the isogeny at the n points P[0], ..., P[n-1].
+void eval_4_isog_many(point_proj* P, const unsigned int n, f2elm_t* coeff);
+
 // Tripling of a Montgomery point in projective coordinates (X:Z).
 void xTPL(const point_proj_t P, point_proj_t Q, const f2elm_t A24minus, const f2elm_t A24plus);
 
@@ -99,11 +116,14 @@ void get_3_isog(const point_proj_t P, f2elm_t A24minus, f2elm_t A24plus, f2elm_t
 // Computes the 3-isogeny R=phi(X:Z), given projective point (X3:Z3) of order 3 on a Montgomery curve and a point P with coefficients given in coeff.
 void eval_3_isog(point_proj_t Q, const f2elm_t* coeff);
 
-// 3-way simultaneous inversion
-void inv_3_way(f2elm_t z1, f2elm_t z2, f2elm_t z3);
+// Computes the 3-isogeny at the n points Q[0], ..., Q[n-1].
+void eval_3_isog_many(point_proj* Q, const unsigned int n, const f2elm_t* coeff);
 
 // Given the x-coordinates of P, Q, and R, returns the value A corresponding to the Montgomery curve E_A: y^2=x^3+A*x^2+x such that R=Q-P on E_A.
 void get_A(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xR, f2elm_t A);
 
+// Computes the values A of get_A() for n triples of x-coordinates, sharing a single inversion.
+void get_A_many(const f2elm_t (*PK)[3], const unsigned int n, f2elm_t* A, f2elm_t* scratch);
+
 
 #endif
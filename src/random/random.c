@@ -2,9 +2,19 @@
 * Hardware-based random number generation function
 *
 * It uses /dev/urandom in Linux and CNG's BCryptGenRandom function in Windows
+*
+* With DRBG, randombytes() instead outputs a SHAKE256-based generator kept by every thread, which is seeded with
+* getrandom() and reseeded after DRBG_RESEED_BYTES output bytes and in a child process after fork(). The generator
+* uses fast key erasure: every call to SHAKE256 derives the next key together with the output, and bytes handed
+* out from the buffer are wiped from it.
+*
+* An application can also install its own generator with randombytes_set_callback(), e.g., the deterministic generator
+* randombytes_det() for reproducible tests and benchmarks.
 *********************************************************************************************/ 
 
 #include "random.h"
+#include "../config.h"
+#include "../sha3/fips202.h"
 #include <stdlib.h>
 #if defined(__WINDOWS__)
     #include <windows.h>
@@ -14,10 +24,19 @@
     #include <fcntl.h>
     static int lock = -1;
 #endif
+#if defined(DRBG)
+    #include <errno.h>
+    #include <string.h>
+    #include <pthread.h>
+    #include <sys/random.h>
+#endif
 
 #define passed 0 
 #define failed 1
 
+static randombytes_callback_t callback = NULL;
+static void* callback_state = NULL;
+
 
 static __inline void delay(unsigned int count)
 {
@@ -25,8 +44,8 @@ static __inline void delay(unsigned int count)
 }
 
 
-int randombytes(unsigned char* random_array, unsigned long long nbytes)
-{ // Generation of "nbytes" of random values
+static int system_randombytes(unsigned char* random_array, unsigned long long nbytes)
+{ // Generation of "nbytes" of random values by the operating system
     
 #if defined(__WINDOWS__)   
     if (!BCRYPT_SUCCESS(BCryptGenRandom(NULL, random_array, (unsigned long)nbytes, BCRYPT_USE_SYSTEM_PREFERRED_RNG))) {
@@ -34,15 +53,18 @@ int randombytes(unsigned char* random_array, unsigned long long nbytes)
     }
 
 #elif defined(__NIX__)
-    int r, n = (int)nbytes, count = 0;
+    int r, fd, n = (int)nbytes, count = 0;
     
     if (lock == -1) {
         do {
-            lock = open("/dev/urandom", O_RDONLY);
-            if (lock == -1) {
+            fd = open("/dev/urandom", O_RDONLY);
+            if (fd == -1) {
                 delay(0xFFFFF);
             }
-        } while (lock == -1);
+        } while (fd == -1);
+        if (!__sync_bool_compare_and_swap(&lock, -1, fd)) {
+            close(fd);                      // Another thread has opened the device first
+        }
     }
 
     while (n > 0) {
@@ -57,5 +79,184 @@ int randombytes(unsigned char* random_array, unsigned long long nbytes)
     }
 #endif
 
+    return passed;
+}
+
+
+#if defined(DRBG)
+
+#define DRBG_KEY_BYTES        32
+#define DRBG_BUFFER_BYTES     1024              // Output generated per call to SHAKE256 for small requests
+#define DRBG_RESEED_BYTES     (1ULL << 20)      // Output bytes between reseedings
+
+static pthread_once_t drbg_once = PTHREAD_ONCE_INIT;
+static unsigned int fork_generation = 1;        // Incremented in the child process after fork()
+
+static __thread struct {
+    unsigned char key[DRBG_KEY_BYTES];
+    unsigned char buffer[DRBG_BUFFER_BYTES];
+    unsigned int available;                     // Number of unused bytes at the end of buffer
+    unsigned long long output;                  // Number of bytes output since the last seeding
+    unsigned int generation;                    // Fork generation of the last seeding, 0 if not seeded
+} drbg;
+
+
+static void clear_bytes(void* mem, const size_t nbytes)
+{ // Wipes memory, the volatile pointer prevents the compiler from removing the stores
+    volatile unsigned char* v = (volatile unsigned char*)mem;
+    size_t i;
+
+    for (i = 0; i < nbytes; i++) {
+        v[i] = 0;
+    }
+}
+
+
+static void drbg_after_fork(void)
+{
+    __atomic_add_fetch(&fork_generation, 1, __ATOMIC_RELAXED);
+}
+
+
+static void drbg_register(void)
+{
+    pthread_atfork(NULL, NULL, drbg_after_fork);
+}
+
+
+static void drbg_entropy(unsigned char* seed, size_t nbytes)
+{ // Reads seed material with getrandom(), or from /dev/urandom if the system call is not available
+    ssize_t r;
+
+    while (nbytes > 0) {
+        r = getrandom(seed, nbytes, 0);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            system_randombytes(seed, nbytes);
+            return;
+        }
+        seed += r;
+        nbytes -= (size_t)r;
+    }
+}
+
+
+static void drbg_seed(void)
+{ // Seeds the generator of the calling thread, key <- SHAKE256(key||seed), and discards the buffered output
+    unsigned char seed[2*DRBG_KEY_BYTES];
+
+    pthread_once(&drbg_once, drbg_register);
+    drbg.generation = __atomic_load_n(&fork_generation, __ATOMIC_RELAXED);
+    memcpy(seed, drbg.key, DRBG_KEY_BYTES);
+    drbg_entropy(seed + DRBG_KEY_BYTES, DRBG_KEY_BYTES);
+    shake256(drbg.key, DRBG_KEY_BYTES, seed, sizeof(seed));
+    clear_bytes(seed, sizeof(seed));
+    clear_bytes(drbg.buffer, DRBG_BUFFER_BYTES);
+    drbg.available = 0;
+    drbg.output = 0;
+}
+
+
+static void drbg_generate(unsigned char* output, const unsigned long long nbytes)
+{ // Outputs nbytes bytes and replaces the key: key||output <- SHAKE256(key)
+    uint64_t s[SHAKE_INC_STATE_WORDS];
+
+    shake256_inc_init(s);
+    shake256_inc_absorb(s, drbg.key, DRBG_KEY_BYTES);
+    shake256_inc_finalize(s);
+    shake256_inc_squeeze(drbg.key, DRBG_KEY_BYTES, s);
+    shake256_inc_squeeze(output, nbytes, s);
+    clear_bytes(s, sizeof(s));
+}
+
+
+static int default_randombytes(unsigned char* random_array, unsigned long long nbytes)
+{ // Generation of "nbytes" of random values with the generator of the calling thread
+    unsigned char* p;
+    unsigned int n;
+
+    if (drbg.generation != __atomic_load_n(&fork_generation, __ATOMIC_RELAXED) || drbg.output >= DRBG_RESEED_BYTES) {
+        drbg_seed();
+    }
+    drbg.output += nbytes;
+
+    if (nbytes > DRBG_BUFFER_BYTES/2) {
+        drbg_generate(random_array, nbytes);
+        return passed;
+    }
+    while (nbytes > 0) {
+        if (drbg.available == 0) {
+            drbg_generate(drbg.buffer, DRBG_BUFFER_BYTES);
+            drbg.available = DRBG_BUFFER_BYTES;
+        }
+        n = (nbytes < drbg.available) ? (unsigned int)nbytes : drbg.available;
+        p = drbg.buffer + DRBG_BUFFER_BYTES - drbg.available;
+        memcpy(random_array, p, n);
+        clear_bytes(p, n);
+        drbg.available -= n;
+        random_array += n;
+        nbytes -= n;
+    }
+
+    return passed;
+}
+
+#else
+
+static int default_randombytes(unsigned char* random_array, unsigned long long nbytes)
+{
+    return system_randombytes(random_array, nbytes);
+}
+
+#endif
+
+
+int randombytes(unsigned char* random_array, unsigned long long nbytes)
+{ // Generation of "nbytes" of random values with the installed generator, or with the default one
+    
+    if (callback != NULL) {
+        return callback(callback_state, random_array, nbytes);
+    }
+    return default_randombytes(random_array, nbytes);
+}
+
+
+void randombytes_set_callback(randombytes_callback_t cb, void* state)
+{
+    callback_state = state;
+    callback = cb;
+}
+
+
+void randombytes_det_init(randombytes_det_t* state, const unsigned char* seed, unsigned long long seedlen)
+{ // Initializes the deterministic generator with key = SHAKE256(seed)
+    
+    shake256(state->key, sizeof(state->key), seed, seedlen);
+    state->counter = 0;
+}
+
+
+int randombytes_det(void* state, unsigned char* random_array, unsigned long long nbytes)
+{ // Generation of "nbytes" bytes SHAKE256(key||i) for the i-th call since randombytes_det_init()
+    randombytes_det_t* det = (randombytes_det_t*)state;
+    unsigned char block[8];
+    uint64_t s[SHAKE_INC_STATE_WORDS], i;
+    unsigned int j;
+
+#if defined(__WINDOWS__)
+    i = (uint64_t)InterlockedExchangeAdd64((volatile LONG64*)&det->counter, 1);
+#else
+    i = __atomic_fetch_add(&det->counter, 1, __ATOMIC_RELAXED);
+#endif
+    for (j = 0; j < 8; j++) {
+        block[j] = (unsigned char)(i >> (8*j));
+    }
+    shake256_inc_init(s);
+    shake256_inc_absorb(s, det->key, sizeof(det->key));
+    shake256_inc_absorb(s, block, 8);
+    shake256_inc_finalize(s);
+    shake256_inc_squeeze(random_array, nbytes, s);
     return passed;
 }
\ No newline at end of file
@@ -1,9 +1,28 @@
 #ifndef RANDOM_H
 #define RANDOM_H
 
+#include <stdint.h>
+
 
 // Generate random bytes and output the result to random_array
 int randombytes(unsigned char* random_array, unsigned long long nbytes);
 
+// Generator called by randombytes() in place of the default one, with the state given when it is installed
+typedef int (*randombytes_callback_t)(void* state, unsigned char* random_array, unsigned long long nbytes);
+
+// Installs callback(state, ...) as the generator of randombytes(), or restores the default generator if callback is NULL.
+// It must not be called while other threads use randombytes(), and the callback must be thread-safe if several threads use it.
+void randombytes_set_callback(randombytes_callback_t callback, void* state);
+
+// Deterministic counter-based generator for reproducible tests and benchmarks, not for real keys. The output of the i-th call
+// is SHAKE256(key||i), where key is derived from the seed. It is thread-safe, but the order of the calls of several threads varies.
+typedef struct {
+    unsigned char key[32];
+    uint64_t counter;
+} randombytes_det_t;
+
+void randombytes_det_init(randombytes_det_t* state, const unsigned char* seed, unsigned long long seedlen);
+int randombytes_det(void* state, unsigned char* random_array, unsigned long long nbytes);
+
 
 #endif
\ No newline at end of file
@@ -375,6 +375,70 @@ static void keccak_squeezeblocks(unsigned char *h, unsigned long long int nblock
 }
 
 
+/* The incremental functions keep the number of bytes absorbed into (or remaining to be squeezed from) the current block in s_inc[25] */
+
+static void keccak_inc_init(uint64_t *s_inc)
+{
+  unsigned int i;
+
+  for (i = 0; i < 25; ++i)
+    s_inc[i] = 0;
+  s_inc[25] = 0;
+}
+
+
+static void keccak_inc_absorb(uint64_t *s_inc, unsigned int r, const unsigned char *m, unsigned long long mlen)
+{
+  unsigned long long pos = s_inc[25];
+
+  while (mlen > 0)
+  {
+    if ((pos & 7) == 0 && mlen >= 8) {
+      s_inc[pos >> 3] ^= load64(m);
+      pos += 8;
+      m += 8;
+      mlen -= 8;
+    } else {
+      s_inc[pos >> 3] ^= (uint64_t)*m << (8 * (pos & 7));
+      pos++;
+      m++;
+      mlen--;
+    }
+    if (pos == r) {
+      KeccakF1600_StatePermute(s_inc);
+      pos = 0;
+    }
+  }
+  s_inc[25] = pos;
+}
+
+
+static void keccak_inc_finalize(uint64_t *s_inc, unsigned int r, unsigned char p)
+{
+  s_inc[s_inc[25] >> 3] ^= (uint64_t)p << (8 * (s_inc[25] & 7));
+  s_inc[(r - 1) >> 3] ^= (uint64_t)128 << (8 * ((r - 1) & 7));
+  s_inc[25] = 0;
+}
+
+
+static void keccak_inc_squeeze(unsigned char *h, unsigned long long outlen, uint64_t *s_inc, unsigned int r)
+{
+  unsigned long long pos;
+
+  while (outlen > 0)
+  {
+    if (s_inc[25] == 0) {
+      KeccakF1600_StatePermute(s_inc);
+      s_inc[25] = r;
+    }
+    pos = r - s_inc[25];
+    *h++ = (unsigned char)(s_inc[pos >> 3] >> (8 * (pos & 7)));
+    s_inc[25]--;
+    outlen--;
+  }
+}
+
+
 /********** SHAKE128 ***********/
 
 void shake128_absorb(uint64_t *s, const unsigned char *input, unsigned int inputByteLen)
@@ -453,4 +517,28 @@ void shake256(unsigned char *output, unsigned long long outlen, const unsigned c
     for (i = 0; i < outlen; i++)
       output[i] = t[i];
   }
-}
\ No newline at end of file
+}
+
+
+void shake256_inc_init(uint64_t *s_inc)
+{
+  keccak_inc_init(s_inc);
+}
+
+
+void shake256_inc_absorb(uint64_t *s_inc, const unsigned char *input, unsigned long long inlen)
+{
+  keccak_inc_absorb(s_inc, SHAKE256_RATE, input, inlen);
+}
+
+
+void shake256_inc_finalize(uint64_t *s_inc)
+{
+  keccak_inc_finalize(s_inc, SHAKE256_RATE, 0x1F);
+}
+
+
+void shake256_inc_squeeze(unsigned char *output, unsigned long long outlen, uint64_t *s_inc)
+{
+  keccak_inc_squeeze(output, outlen, s_inc, SHAKE256_RATE);
+}
@@ -15,5 +15,14 @@ void shake256_absorb(uint64_t *s, const unsigned char *input, unsigned int input
 void shake256_squeezeblocks(unsigned char *output, unsigned long long nblocks, uint64_t *s);
 void shake256(unsigned char *output, unsigned long long outlen, const unsigned char *input,  unsigned long long inlen);
 
+// Incremental SHAKE256 over an input given in several segments. The state s_inc has SHAKE_INC_STATE_WORDS words:
+// shake256_inc_init(), then shake256_inc_absorb() for every segment, shake256_inc_finalize() and shake256_inc_squeeze().
+#define SHAKE_INC_STATE_WORDS 26
+
+void shake256_inc_init(uint64_t *s_inc);
+void shake256_inc_absorb(uint64_t *s_inc, const unsigned char *input, unsigned long long inlen);
+void shake256_inc_finalize(uint64_t *s_inc);
+void shake256_inc_squeeze(unsigned char *output, unsigned long long outlen, uint64_t *s_inc);
+
 
 #endif
@@ -0,0 +1,193 @@
+/********************************************************************************************
+* SHA3-derived function SHAKE, 4-way parallel implementation using AVX2
+*
+* The four Keccak states are interleaved so that every 256-bit register holds the same lane of the
+* four states, and one call to the permutation processes the four states. The absorbing and squeezing
+* functions follow the scalar implementation in fips202.c.
+*
+*********************************************************************************************/  
+
+#include "../config.h"
+
+#if defined(AVX2_X4_IMPLEMENTATION)
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+#include "fips202.h"
+#include "fips202x4.h"
+
+#define NROUNDS 24
+#define XOR(a, b)       _mm256_xor_si256(a, b)
+#define ANDNOT(a, b)    _mm256_andnot_si256(a, b)           // (~a) & b
+#define ROL(a, offset)  _mm256_or_si256(_mm256_slli_epi64(a, offset), _mm256_srli_epi64(a, 64-offset))
+
+
+static const uint64_t KeccakF_RoundConstants[NROUNDS] = 
+{
+    (uint64_t)0x0000000000000001ULL,
+    (uint64_t)0x0000000000008082ULL,
+    (uint64_t)0x800000000000808aULL,
+    (uint64_t)0x8000000080008000ULL,
+    (uint64_t)0x000000000000808bULL,
+    (uint64_t)0x0000000080000001ULL,
+    (uint64_t)0x8000000080008081ULL,
+    (uint64_t)0x8000000000008009ULL,
+    (uint64_t)0x000000000000008aULL,
+    (uint64_t)0x0000000000000088ULL,
+    (uint64_t)0x0000000080008009ULL,
+    (uint64_t)0x000000008000000aULL,
+    (uint64_t)0x000000008000808bULL,
+    (uint64_t)0x800000000000008bULL,
+    (uint64_t)0x8000000000008089ULL,
+    (uint64_t)0x8000000000008003ULL,
+    (uint64_t)0x8000000000008002ULL,
+    (uint64_t)0x8000000000000080ULL,
+    (uint64_t)0x000000000000800aULL,
+    (uint64_t)0x800000008000000aULL,
+    (uint64_t)0x8000000080008081ULL,
+    (uint64_t)0x8000000000008080ULL,
+    (uint64_t)0x0000000080000001ULL,
+    (uint64_t)0x8000000080008008ULL
+};
+
+
+static void KeccakF1600_StatePermute4x(__m256i* s)
+{ // Keccak-f[1600] applied to four interleaved states, where s[i] holds lane i of the four states
+    __m256i B[25], C[5], D[5];
+    int round, x;
+
+    for (round = 0; round < NROUNDS; round++)
+    {
+        // Theta
+        for (x = 0; x < 5; x++) {
+            C[x] = XOR(XOR(XOR(s[x], s[x + 5]), XOR(s[x + 10], s[x + 15])), s[x + 20]);
+        }
+        D[0] = XOR(C[4], ROL(C[1], 1));
+        D[1] = XOR(C[0], ROL(C[2], 1));
+        D[2] = XOR(C[1], ROL(C[3], 1));
+        D[3] = XOR(C[2], ROL(C[4], 1));
+        D[4] = XOR(C[3], ROL(C[0], 1));
+
+        // Rho and pi
+        B[ 0] = XOR(s[ 0], D[0]);
+        B[ 1] = ROL(XOR(s[ 6], D[1]), 44);
+        B[ 2] = ROL(XOR(s[12], D[2]), 43);
+        B[ 3] = ROL(XOR(s[18], D[3]), 21);
+        B[ 4] = ROL(XOR(s[24], D[4]), 14);
+        B[ 5] = ROL(XOR(s[ 3], D[3]), 28);
+        B[ 6] = ROL(XOR(s[ 9], D[4]), 20);
+        B[ 7] = ROL(XOR(s[10], D[0]),  3);
+        B[ 8] = ROL(XOR(s[16], D[1]), 45);
+        B[ 9] = ROL(XOR(s[22], D[2]), 61);
+        B[10] = ROL(XOR(s[ 1], D[1]),  1);
+        B[11] = ROL(XOR(s[ 7], D[2]),  6);
+        B[12] = ROL(XOR(s[13], D[3]), 25);
+        B[13] = ROL(XOR(s[19], D[4]),  8);
+        B[14] = ROL(XOR(s[20], D[0]), 18);
+        B[15] = ROL(XOR(s[ 4], D[4]), 27);
+        B[16] = ROL(XOR(s[ 5], D[0]), 36);
+        B[17] = ROL(XOR(s[11], D[1]), 10);
+        B[18] = ROL(XOR(s[17], D[2]), 15);
+        B[19] = ROL(XOR(s[23], D[3]), 56);
+        B[20] = ROL(XOR(s[ 2], D[2]), 62);
+        B[21] = ROL(XOR(s[ 8], D[3]), 55);
+        B[22] = ROL(XOR(s[14], D[4]), 39);
+        B[23] = ROL(XOR(s[15], D[0]), 41);
+        B[24] = ROL(XOR(s[21], D[1]),  2);
+
+        // Chi
+        for (x = 0; x < 25; x += 5) {
+            s[x + 0] = XOR(B[x + 0], ANDNOT(B[x + 1], B[x + 2]));
+            s[x + 1] = XOR(B[x + 1], ANDNOT(B[x + 2], B[x + 3]));
+            s[x + 2] = XOR(B[x + 2], ANDNOT(B[x + 3], B[x + 4]));
+            s[x + 3] = XOR(B[x + 3], ANDNOT(B[x + 4], B[x + 0]));
+            s[x + 4] = XOR(B[x + 4], ANDNOT(B[x + 0], B[x + 1]));
+        }
+
+        // Iota
+        s[0] = XOR(s[0], _mm256_set1_epi64x((long long)KeccakF_RoundConstants[round]));
+    }
+}
+
+
+static __inline __m256i load64x4(const unsigned char* const in[4], const unsigned long long offset)
+{ // Loads the 64-bit little-endian words at in[j] + offset, j = 0,...,3, into the lanes of a register
+    uint64_t w[4];
+    unsigned int j;
+
+    for (j = 0; j < 4; j++) {
+        memcpy(&w[j], in[j] + offset, 8);
+    }
+    return _mm256_loadu_si256((const __m256i*)w);
+}
+
+
+static void keccak_absorb4x(__m256i* s, const unsigned int r, const unsigned char* const in[4], unsigned long long inlen, const unsigned char p)
+{
+    const unsigned char* m[4] = {in[0], in[1], in[2], in[3]};
+    unsigned char t[4][200];
+    unsigned long long i;
+    unsigned int j;
+
+    while (inlen >= r) 
+    {
+        for (i = 0; i < r / 8; ++i)
+            s[i] = XOR(s[i], load64x4(m, 8 * i));
+
+        KeccakF1600_StatePermute4x(s);
+        inlen -= r;
+        for (j = 0; j < 4; j++)
+            m[j] += r;
+    }
+
+    for (j = 0; j < 4; j++) {
+        memset(t[j], 0, r);
+        memcpy(t[j], m[j], (size_t)inlen);
+        t[j][inlen] = p;
+        t[j][r - 1] |= 128;
+        m[j] = t[j];
+    }
+    for (i = 0; i < r / 8; ++i)
+        s[i] = XOR(s[i], load64x4(m, 8 * i));
+}
+
+
+static void keccak_squeezeblocks4x(unsigned char* const out[4], const unsigned long long offset, __m256i* s, const unsigned int r, const unsigned long long outlen)
+{ // Squeezes one block and writes min(r, outlen) bytes of every state to out[j] + offset
+    uint64_t w[25][4];
+    unsigned int i, j;
+
+    KeccakF1600_StatePermute4x(s);
+    for (i = 0; i < r / 8; i++)
+        _mm256_storeu_si256((__m256i*)w[i], s[i]);
+    for (j = 0; j < 4; j++) {
+        for (i = 0; i < r && i < outlen; i++)
+            out[j][offset + i] = (unsigned char)(w[i / 8][j] >> (8 * (i % 8)));
+    }
+}
+
+
+/********** SHAKE256 ***********/
+
+void shake256x4(unsigned char* out0, unsigned char* out1, unsigned char* out2, unsigned char* out3, unsigned long long outlen,
+                const unsigned char* in0, const unsigned char* in1, const unsigned char* in2, const unsigned char* in3, unsigned long long inlen)
+{
+    __m256i s[25];
+    unsigned char* const out[4] = {out0, out1, out2, out3};
+    const unsigned char* const in[4] = {in0, in1, in2, in3};
+    unsigned long long offset;
+    unsigned int i;
+
+    for (i = 0; i < 25; ++i)
+        s[i] = _mm256_setzero_si256();
+
+    /* Absorb input */
+    keccak_absorb4x(s, SHAKE256_RATE, in, inlen, 0x1F);
+
+    /* Squeeze output */
+    for (offset = 0; offset < outlen; offset += SHAKE256_RATE)
+        keccak_squeezeblocks4x(out, offset, s, SHAKE256_RATE, outlen - offset);
+}
+
+#endif
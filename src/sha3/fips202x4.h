@@ -0,0 +1,10 @@
+#ifndef FIPS202X4_H
+#define FIPS202X4_H
+
+
+// Computes SHAKE256 of four inputs of inlen bytes, outj = SHAKE256(inj), j = 0,...,3, with a 4-way parallel Keccak permutation
+void shake256x4(unsigned char *out0, unsigned char *out1, unsigned char *out2, unsigned char *out3, unsigned long long outlen,
+                const unsigned char *in0, const unsigned char *in1, const unsigned char *in2, const unsigned char *in3, unsigned long long inlen);
+
+
+#endif
@@ -5,6 +5,115 @@
 *********************************************************************************************/ 
 
 #include "random/random.h"
+#if defined(PARALLEL_TRAVERSAL)
+    #include "threads/thread_pool.h"
+#endif
+#if defined(KEY_POOL)
+    #include "threads/key_pool.h"
+#endif
+
+#define MAX_INT_POINTS    ((MAX_INT_POINTS_ALICE > MAX_INT_POINTS_BOB) ? MAX_INT_POINTS_ALICE : MAX_INT_POINTS_BOB)
+#define SIDH_BATCH        8             // Maximum number of operations sharing their inversions in the batched functions
+
+
+// State of the isogeny evaluations of a tree traversal. The points are the images of the basis points phis[] (key generation only)
+// followed by the intermediate points pts[] of the traversal, and are numbered in this order.
+typedef struct {
+    point_proj* phis;
+    point_proj* pts;
+    unsigned int nphis;
+    unsigned int npoints;                   // Number of points evaluated by the workers in the current step
+    unsigned int degree;
+    f2elm_t coeff[3];
+    int parallel;
+} traversal_t;
+
+
+static void eval_isog_range(const traversal_t* t, unsigned int first, const unsigned int last, f2elm_t* coeff)
+{ // Evaluation of the 4- or 3-isogeny of the traversal at the points first, ..., last-1
+
+    if (first < t->nphis) {
+        const unsigned int n = ((last < t->nphis) ? last : t->nphis) - first;
+        if (t->degree == 4) {
+            eval_4_isog_many(t->phis + first, n, coeff);
+        } else {
+            eval_3_isog_many(t->phis + first, n, coeff);
+        }
+        first += n;
+    }
+    if (first < last) {
+        if (t->degree == 4) {
+            eval_4_isog_many(t->pts + first - t->nphis, last - first, coeff);
+        } else {
+            eval_3_isog_many(t->pts + first - t->nphis, last - first, coeff);
+        }
+    }
+}
+
+
+#if defined(PARALLEL_TRAVERSAL)
+
+static void eval_isog_task(void* arg, const unsigned int worker, const unsigned int nworkers)
+{ // Worker task: each worker evaluates a contiguous range of points
+    traversal_t* t = (traversal_t*)arg;
+
+    eval_isog_range(t, worker*t->npoints/nworkers, (worker + 1)*t->npoints/nworkers, t->coeff);
+}
+
+#endif
+
+
+static void traversal_init(traversal_t* t, const unsigned int degree, point_proj_t* pts, point_proj_t* phis, const unsigned int nphis)
+{ // Initialization of the isogeny evaluations for the intermediate points pts[] and the nphis images of the basis points phis[].
+  // In the parallel traversal mode, the worker pool is reserved if it is available.
+
+    t->degree = degree;
+    t->pts = (point_proj*)pts;
+    t->phis = (point_proj*)phis;
+    t->nphis = nphis;
+#if defined(PARALLEL_TRAVERSAL)
+    t->parallel = thread_pool_acquire();
+#else
+    t->parallel = 0;
+#endif
+}
+
+
+static void traversal_eval(traversal_t* t, f2elm_t* coeff, const unsigned int npts)
+{ // Evaluates the isogeny given by coeff at pts[0], ..., pts[npts-1] and at the images of the basis points.
+  // In the parallel traversal mode, the caller evaluates the next kernel point pts[npts-1] and the other points are evaluated by the
+  // workers while the caller continues with the point multiplications. The workers complete the previous step before the next one starts.
+    const unsigned int n = t->nphis + npts;
+
+#if defined(PARALLEL_TRAVERSAL)
+    if (t->parallel) {
+        thread_pool_wait();
+        fp2copy(coeff[0], t->coeff[0]);
+        fp2copy(coeff[1], t->coeff[1]);
+        fp2copy(coeff[2], t->coeff[2]);
+        t->npoints = (npts > 0) ? n-1 : n;
+        thread_pool_run(eval_isog_task, t);
+        if (npts > 0) {
+            eval_isog_range(t, n-1, n, coeff);
+        }
+        return;
+    }
+#endif
+    eval_isog_range(t, 0, n, coeff);
+}
+
+
+static void traversal_finish(traversal_t* t)
+{ // Completes the pending isogeny evaluations and releases the worker pool
+
+#if defined(PARALLEL_TRAVERSAL)
+    if (t->parallel) {
+        thread_pool_release();
+    }
+#else
+    UNREFERENCED_PARAMETER(t);
+#endif
+}
 
 
 static void init_basis(digit_t *gen, f2elm_t XP, f2elm_t XQ, f2elm_t XR)
@@ -37,171 +146,234 @@ void random_mod_order_B(unsigned char* random_digits)
 }
 
 
-int EphemeralKeyGeneration_A(const unsigned char* PrivateKeyA, unsigned char* PublicKeyA)
-{ // Alice's ephemeral public key generation
+static void KeyGeneration_A(const unsigned char* PrivateKeyA, point_proj_t* phi)
+{ // Alice's isogeny computation for the public key
   // Input:  a private key PrivateKeyA in the range [0, 2^eA - 1]. 
-  // Output: the public key PublicKeyA consisting of 3 elements in GF(p^2) which are encoded by removing leading 0 bytes.
-    point_proj_t R, phiP = {0}, phiQ = {0}, phiR = {0}, pts[MAX_INT_POINTS_ALICE];
-    f2elm_t XPA, XQA, XRA, coeff[3], A24plus = {0}, C24 = {0}, A = {0};
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0, ii = 0;
+  // Output: the images phi[0], phi[1], phi[2] of Bob's basis points in projective coordinates.
+    point_proj_t pts[MAX_INT_POINTS_ALICE+1];    // The kernel point of the current step is pts[npts]
+    f2elm_t XPA, XQA, XRA, coeff[3], A24plus = {0}, C24 = {0};
+    unsigned int row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0, ii = 0;
     digit_t SecretKeyA[NWORDS_ORDER] = {0};
+    traversal_t trav;
 
     // Initialize basis points
     init_basis((digit_t*)A_gen, XPA, XQA, XRA);
-    init_basis((digit_t*)B_gen, phiP->X, phiQ->X, phiR->X);
-    fpcopy((digit_t*)&Montgomery_one, (phiP->Z)[0]);
-    fpcopy((digit_t*)&Montgomery_one, (phiQ->Z)[0]);
-    fpcopy((digit_t*)&Montgomery_one, (phiR->Z)[0]);
+    init_basis((digit_t*)B_gen, phi[0]->X, phi[1]->X, phi[2]->X);
+    fp2zero(phi[0]->Z);
+    fp2zero(phi[1]->Z);
+    fp2zero(phi[2]->Z);
+    fpcopy((digit_t*)&Montgomery_one, (phi[0]->Z)[0]);
+    fpcopy((digit_t*)&Montgomery_one, (phi[1]->Z)[0]);
+    fpcopy((digit_t*)&Montgomery_one, (phi[2]->Z)[0]);
 
     // Initialize constants: A24plus = A+2C, C24 = 4C, where A=6, C=1
     fpcopy((digit_t*)&Montgomery_one, A24plus[0]);
     mp2_add(A24plus, A24plus, A24plus);
     mp2_add(A24plus, A24plus, C24);
-    mp2_add(A24plus, C24, A);
     mp2_add(C24, C24, A24plus);
 
     // Retrieve kernel point
     decode_to_digits(PrivateKeyA, SecretKeyA, SECRETKEY_A_BYTES, NWORDS_ORDER);
-    LADDER3PT(XPA, XQA, XRA, SecretKeyA, ALICE, R, A);       
+    LADDER3PT_fixed_base(XPA, XRA, (digit_t*)&A_fixed_base, SecretKeyA, ALICE, pts[0]);       
 
 #if (OALICE_BITS % 2 == 1)
     point_proj_t S;
 
-    xDBLe(R, S, A24plus, C24, (int)(OALICE_BITS-1));
+    xDBLe(pts[0], S, A24plus, C24, (int)(OALICE_BITS-1));
     get_2_isog(S, A24plus, C24); 
-    eval_2_isog(phiP, S); 
-    eval_2_isog(phiQ, S); 
-    eval_2_isog(phiR, S);
-    eval_2_isog(R, S);
+    eval_2_isog(phi[0], S); 
+    eval_2_isog(phi[1], S); 
+    eval_2_isog(phi[2], S);
+    eval_2_isog(pts[0], S);
 #endif
 
     // Traverse tree
+    traversal_init(&trav, 4, pts, phi, 3);
     index = 0;        
     for (row = 1; row < MAX_Alice; row++) {
         while (index < MAX_Alice-row) {
-            fp2copy(R->X, pts[npts]->X);
-            fp2copy(R->Z, pts[npts]->Z);
-            pts_index[npts++] = index;
+            pts_index[npts] = index;
             m = strat_Alice[ii++];
-            xDBLe(R, R, A24plus, C24, (int)(2*m));
+            xDBLe(pts[npts], pts[npts+1], A24plus, C24, (int)(2*m));
+            npts++;
             index += m;
         }
-        get_4_isog(R, A24plus, C24, coeff);        
-
-        for (i = 0; i < npts; i++) {
-            eval_4_isog(pts[i], coeff);
-        }
-        eval_4_isog(phiP, coeff);
-        eval_4_isog(phiQ, coeff);
-        eval_4_isog(phiR, coeff);
-
-        fp2copy(pts[npts-1]->X, R->X); 
-        fp2copy(pts[npts-1]->Z, R->Z);
-        index = pts_index[npts-1];
+        get_4_isog(pts[npts], A24plus, C24, coeff);        
+        traversal_eval(&trav, coeff, npts);         // Evaluates pts[0], ..., pts[npts-1] and phi[]
         npts -= 1;
+        index = pts_index[npts];
     }
 
-    get_4_isog(R, A24plus, C24, coeff); 
-    eval_4_isog(phiP, coeff);
-    eval_4_isog(phiQ, coeff);
-    eval_4_isog(phiR, coeff);
+    get_4_isog(pts[0], A24plus, C24, coeff); 
+    traversal_eval(&trav, coeff, 0);
+    traversal_finish(&trav);
+}
+
 
-    inv_3_way(phiP->Z, phiQ->Z, phiR->Z);
-    fp2mul_mont(phiP->X, phiP->Z, phiP->X);
-    fp2mul_mont(phiQ->X, phiQ->Z, phiQ->X);
-    fp2mul_mont(phiR->X, phiR->Z, phiR->X);
+int EphemeralKeyGeneration_A(const unsigned char* PrivateKeyA, unsigned char* PublicKeyA)
+{ // Alice's ephemeral public key generation
+  // Input:  a private key PrivateKeyA in the range [0, 2^eA - 1]. 
+  // Output: the public key PublicKeyA consisting of 3 elements in GF(p^2) which are encoded by removing leading 0 bytes.
+    point_proj_t phi[3];
+    f2elm_t Z[3], scratch[3];
+
+    KeyGeneration_A(PrivateKeyA, phi);
+
+    fp2copy(phi[0]->Z, Z[0]);
+    fp2copy(phi[1]->Z, Z[1]);
+    fp2copy(phi[2]->Z, Z[2]);
+    fp2_batch_inv(Z, 3, Z, scratch);
+    fp2mul_mont(phi[0]->X, Z[0], phi[0]->X);
+    fp2mul_mont(phi[1]->X, Z[1], phi[1]->X);
+    fp2mul_mont(phi[2]->X, Z[2], phi[2]->X);
                 
     // Format public key                   
-    fp2_encode(phiP->X, PublicKeyA);
-    fp2_encode(phiQ->X, PublicKeyA + FP2_ENCODED_BYTES);
-    fp2_encode(phiR->X, PublicKeyA + 2*FP2_ENCODED_BYTES);
+    fp2_encode(phi[0]->X, PublicKeyA);
+    fp2_encode(phi[1]->X, PublicKeyA + FP2_ENCODED_BYTES);
+    fp2_encode(phi[2]->X, PublicKeyA + 2*FP2_ENCODED_BYTES);
 
     return 0;
 }
 
 
+static void EphemeralKeyGeneration_A_batch(const unsigned char* const PrivateKeyA[], unsigned char* const PublicKeyA[], const unsigned int n)
+{ // Alice's ephemeral public key generation for n <= SIDH_BATCH private keys, normalizing the 3n images with a single inversion.
+  // The public keys PublicKeyA[i] are the same as with EphemeralKeyGeneration_A().
+    point_proj_t phi[SIDH_BATCH][3];
+    f2elm_t Z[3*SIDH_BATCH], scratch[3*SIDH_BATCH];
+    unsigned int i, j;
+
+    for (i = 0; i < n; i++) {
+        KeyGeneration_A(PrivateKeyA[i], phi[i]);
+        for (j = 0; j < 3; j++) {
+            fp2copy(phi[i][j]->Z, Z[3*i+j]);
+        }
+    }
+    fp2_batch_inv(Z, 3*n, Z, scratch);
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < 3; j++) {
+            fp2mul_mont(phi[i][j]->X, Z[3*i+j], phi[i][j]->X);
+            fp2_encode(phi[i][j]->X, PublicKeyA[i] + j*FP2_ENCODED_BYTES);
+        }
+    }
+}
+
+
 int EphemeralKeyGeneration_B(const unsigned char* PrivateKeyB, unsigned char* PublicKeyB)
 { // Bob's ephemeral public key generation
   // Input:  a private key PrivateKeyB in the range [0, 2^Floor(Log(2,oB)) - 1]. 
   // Output: the public key PublicKeyB consisting of 3 elements in GF(p^2) which are encoded by removing leading 0 bytes.
-    point_proj_t R, phiP = {0}, phiQ = {0}, phiR = {0}, pts[MAX_INT_POINTS_BOB];
-    f2elm_t XPB, XQB, XRB, coeff[3], A24plus = {0}, A24minus = {0}, A = {0};
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_BOB], npts = 0, ii = 0;
+    point_proj_t phi[3] = {0}, pts[MAX_INT_POINTS_BOB+1];    // The kernel point of the current step is pts[npts]
+    f2elm_t XPB, XQB, XRB, coeff[3], A24plus = {0}, A24minus = {0}, Z[3], scratch[3];
+    unsigned int row, m, index = 0, pts_index[MAX_INT_POINTS_BOB], npts = 0, ii = 0;
     digit_t SecretKeyB[NWORDS_ORDER] = {0};
+    traversal_t trav;
 
     // Initialize basis points
     init_basis((digit_t*)B_gen, XPB, XQB, XRB);
-    init_basis((digit_t*)A_gen, phiP->X, phiQ->X, phiR->X);
-    fpcopy((digit_t*)&Montgomery_one, (phiP->Z)[0]);
-    fpcopy((digit_t*)&Montgomery_one, (phiQ->Z)[0]);
-    fpcopy((digit_t*)&Montgomery_one, (phiR->Z)[0]);
+    init_basis((digit_t*)A_gen, phi[0]->X, phi[1]->X, phi[2]->X);
+    fpcopy((digit_t*)&Montgomery_one, (phi[0]->Z)[0]);
+    fpcopy((digit_t*)&Montgomery_one, (phi[1]->Z)[0]);
+    fpcopy((digit_t*)&Montgomery_one, (phi[2]->Z)[0]);
 
     // Initialize constants: A24minus = A-2C, A24plus = A+2C, where A=6, C=1
     fpcopy((digit_t*)&Montgomery_one, A24plus[0]);
     mp2_add(A24plus, A24plus, A24plus);
     mp2_add(A24plus, A24plus, A24minus);
-    mp2_add(A24plus, A24minus, A);
     mp2_add(A24minus, A24minus, A24plus);
 
     // Retrieve kernel point
     decode_to_digits(PrivateKeyB, SecretKeyB, SECRETKEY_B_BYTES, NWORDS_ORDER);
-    LADDER3PT(XPB, XQB, XRB, SecretKeyB, BOB, R, A);
+    LADDER3PT_fixed_base(XPB, XRB, (digit_t*)&B_fixed_base, SecretKeyB, BOB, pts[0]);
     
     // Traverse tree
+    traversal_init(&trav, 3, pts, phi, 3);
     index = 0;  
     for (row = 1; row < MAX_Bob; row++) {
         while (index < MAX_Bob-row) {
-            fp2copy(R->X, pts[npts]->X);
-            fp2copy(R->Z, pts[npts]->Z);
-            pts_index[npts++] = index;
+            pts_index[npts] = index;
             m = strat_Bob[ii++];
-            xTPLe(R, R, A24minus, A24plus, (int)m);
+            xTPLe(pts[npts], pts[npts+1], A24minus, A24plus, (int)m);
+            npts++;
             index += m;
         } 
-        get_3_isog(R, A24minus, A24plus, coeff);
-
-        for (i = 0; i < npts; i++) {
-            eval_3_isog(pts[i], coeff);
-        }     
-        eval_3_isog(phiP, coeff);
-        eval_3_isog(phiQ, coeff);
-        eval_3_isog(phiR, coeff);
-
-        fp2copy(pts[npts-1]->X, R->X); 
-        fp2copy(pts[npts-1]->Z, R->Z);
-        index = pts_index[npts-1];
+        get_3_isog(pts[npts], A24minus, A24plus, coeff);
+        traversal_eval(&trav, coeff, npts);         // Evaluates pts[0], ..., pts[npts-1] and phi[]
         npts -= 1;
+        index = pts_index[npts];
     }
     
-    get_3_isog(R, A24minus, A24plus, coeff);
-    eval_3_isog(phiP, coeff);
-    eval_3_isog(phiQ, coeff);
-    eval_3_isog(phiR, coeff);
-
-    inv_3_way(phiP->Z, phiQ->Z, phiR->Z);
-    fp2mul_mont(phiP->X, phiP->Z, phiP->X);
-    fp2mul_mont(phiQ->X, phiQ->Z, phiQ->X);
-    fp2mul_mont(phiR->X, phiR->Z, phiR->X);
+    get_3_isog(pts[0], A24minus, A24plus, coeff);
+    traversal_eval(&trav, coeff, 0);
+    traversal_finish(&trav);
+
+    fp2copy(phi[0]->Z, Z[0]);
+    fp2copy(phi[1]->Z, Z[1]);
+    fp2copy(phi[2]->Z, Z[2]);
+    fp2_batch_inv(Z, 3, Z, scratch);
+    fp2mul_mont(phi[0]->X, Z[0], phi[0]->X);
+    fp2mul_mont(phi[1]->X, Z[1], phi[1]->X);
+    fp2mul_mont(phi[2]->X, Z[2], phi[2]->X);
 
     // Format public key
-    fp2_encode(phiP->X, PublicKeyB);
-    fp2_encode(phiQ->X, PublicKeyB + FP2_ENCODED_BYTES);
-    fp2_encode(phiR->X, PublicKeyB + 2*FP2_ENCODED_BYTES);
+    fp2_encode(phi[0]->X, PublicKeyB);
+    fp2_encode(phi[1]->X, PublicKeyB + FP2_ENCODED_BYTES);
+    fp2_encode(phi[2]->X, PublicKeyB + 2*FP2_ENCODED_BYTES);
 
     return 0;
 }
 
 
+static void SecretAgreement_A(point_proj_t* pts, f2elm_t A24plus, f2elm_t C24)
+{ // Alice's isogeny computation for the shared secret
+  // Inputs: the kernel point pts[0] on Bob's curve with constants A24plus = A+2C and C24 = 4C, and room for MAX_INT_POINTS_ALICE+1 points in pts[].
+  // Output: the projective constant (A24plus:C24) of the shared curve, whose j-invariant is the shared secret.
+    f2elm_t coeff[3];
+    unsigned int row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0, ii = 0;
+    traversal_t trav;
+
+#if (OALICE_BITS % 2 == 1)
+    point_proj_t S;
+
+    xDBLe(pts[0], S, A24plus, C24, (int)(OALICE_BITS-1));
+    get_2_isog(S, A24plus, C24);
+    eval_2_isog(pts[0], S);
+#endif
+
+    // Traverse tree
+    traversal_init(&trav, 4, pts, NULL, 0);
+    index = 0;        
+    for (row = 1; row < MAX_Alice; row++) {
+        while (index < MAX_Alice-row) {
+            pts_index[npts] = index;
+            m = strat_Alice[ii++];
+            xDBLe(pts[npts], pts[npts+1], A24plus, C24, (int)(2*m));
+            npts++;
+            index += m;
+        }
+        get_4_isog(pts[npts], A24plus, C24, coeff);        
+        traversal_eval(&trav, coeff, npts);
+        npts -= 1;
+        index = pts_index[npts];
+    }
+    traversal_finish(&trav);
+
+    get_4_isog(pts[0], A24plus, C24, coeff); 
+    mp2_add(A24plus, A24plus, A24plus);                                                
+    fp2sub(A24plus, C24, A24plus); 
+    fp2add(A24plus, A24plus, A24plus);                    
+}
+
+
 int EphemeralSecretAgreement_A(const unsigned char* PrivateKeyA, const unsigned char* PublicKeyB, unsigned char* SharedSecretA)
 { // Alice's ephemeral shared secret computation
   // It produces a shared secret key SharedSecretA using her secret key PrivateKeyA and Bob's public key PublicKeyB
   // Inputs: Alice's PrivateKeyA is an integer in the range [0, oA-1]. 
   //         Bob's PublicKeyB consists of 3 elements in GF(p^2) encoded by removing leading 0 bytes.
   // Output: a shared secret SharedSecretA that consists of one element in GF(p^2) encoded by removing leading 0 bytes.  
-    point_proj_t R, pts[MAX_INT_POINTS_ALICE];
-    f2elm_t coeff[3], PKB[3], jinv;
+    point_proj_t pts[MAX_INT_POINTS_ALICE+1];
+    f2elm_t PKB[3], jinv;
     f2elm_t A24plus = {0}, C24 = {0}, A = {0};
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0, ii = 0;
     digit_t SecretKeyA[NWORDS_ORDER] = {0};
       
     // Initialize images of Bob's basis
@@ -217,47 +389,177 @@ int EphemeralSecretAgreement_A(const unsigned char* PrivateKeyA, const unsigned
 
     // Retrieve kernel point
     decode_to_digits(PrivateKeyA, SecretKeyA, SECRETKEY_A_BYTES, NWORDS_ORDER);
-    LADDER3PT(PKB[0], PKB[1], PKB[2], SecretKeyA, ALICE, R, A);    
+    LADDER3PT(PKB[0], PKB[1], PKB[2], SecretKeyA, ALICE, pts[0], A);    
 
-#if (OALICE_BITS % 2 == 1)
-    point_proj_t S;
+    SecretAgreement_A(pts, A24plus, C24);
+    j_inv(A24plus, C24, jinv);
+    fp2_encode(jinv, SharedSecretA);    // Format shared secret
 
-    xDBLe(R, S, A24plus, C24, (int)(OALICE_BITS-1));
-    get_2_isog(S, A24plus, C24);
-    eval_2_isog(R, S);
-#endif
+    return 0;
+}
 
-    // Traverse tree
-    index = 0;        
-    for (row = 1; row < MAX_Alice; row++) {
-        while (index < MAX_Alice-row) {
-            fp2copy(R->X, pts[npts]->X);
-            fp2copy(R->Z, pts[npts]->Z);
-            pts_index[npts++] = index;
-            m = strat_Alice[ii++];
-            xDBLe(R, R, A24plus, C24, (int)(2*m));
-            index += m;
+
+#define EXPANSION_BATCH    32           // Number of multiples of Q normalized with one inversion in expand_public_key_B()
+
+// Bob's public key with the values precomputed for Alice's shared secret computations, see expand_public_key_B()
+typedef struct {
+    f2elm_t PKB[3];                     // Images of Alice's basis points x(P), x(Q), x(Q-P)
+    f2elm_t A24plus;                    // A24plus = A+2C, where C=1
+    f2elm_t C24;                        // C24 = 4C, where C=1
+    f2elm_t xQ[OALICE_BITS];            // Affine x-coordinates of the multiples [2^i]Q, in the format of A_fixed_base
+} expanded_public_key_B_t;
+
+
+static void expand_public_key_B(const unsigned char* PublicKeyB, expanded_public_key_B_t* pk)
+{ // Decoding of Bob's public key and precomputation of the values used by EphemeralKeyExchange_A_batch().
+  // The multiples [2^i]Q, which LADDER3PT computes by repeated doubling, are normalized in batches of EXPANSION_BATCH points
+  // so that the shared secret computations can use LADDER3PT_fixed_base().
+    point_proj_t Q = {0};
+    f2elm_t A = {0}, X[EXPANSION_BATCH], Z[EXPANSION_BATCH], scratch[EXPANSION_BATCH];
+    unsigned int i, j, n;
+
+    fp2_decode(PublicKeyB, pk->PKB[0]);
+    fp2_decode(PublicKeyB + FP2_ENCODED_BYTES, pk->PKB[1]);
+    fp2_decode(PublicKeyB + 2*FP2_ENCODED_BYTES, pk->PKB[2]);
+
+    fp2zero(pk->A24plus);
+    fp2zero(pk->C24);
+    get_A(pk->PKB[0], pk->PKB[1], pk->PKB[2], A);
+    mp_add((digit_t*)&Montgomery_one, (digit_t*)&Montgomery_one, pk->C24[0], NWORDS_FIELD);
+    mp2_add(A, pk->C24, pk->A24plus);
+    mp_add(pk->C24[0], pk->C24[0], pk->C24[0], NWORDS_FIELD);
+
+    fp2copy(pk->PKB[1], Q->X);
+    fpcopy((digit_t*)&Montgomery_one, Q->Z[0]);
+    for (i = 0; i < OALICE_BITS; i += n) {
+        n = (OALICE_BITS - i < EXPANSION_BATCH) ? OALICE_BITS - i : EXPANSION_BATCH;
+        for (j = 0; j < n; j++) {
+            fp2copy(Q->X, X[j]);
+            fp2copy(Q->Z, Z[j]);
+            xDBL(Q, Q, pk->A24plus, pk->C24);
+        }
+        fp2_batch_inv(Z, n, Z, scratch);
+        for (j = 0; j < n; j++) {
+            fp2mul_mont(X[j], Z[j], pk->xQ[i+j]);
+        }
+    }
+}
+
+
+static void EphemeralKeyExchange_A_batch(const unsigned char* const PrivateKeyA[], const unsigned char* const PublicKeyB[], const expanded_public_key_B_t* pkB, 
+                                         unsigned char* const PublicKeyA[], unsigned char* const SharedSecretA[], const unsigned int n)
+{ // Alice's ephemeral public key generation and shared secret computation for n <= SIDH_BATCH pairs of keys, as in SIKE's encapsulation.
+  // The normalization of the images of the public keys and the j-invariants share a single inversion, and the curve constants of Bob's
+  // public keys PublicKeyB[i] share another one. If pkB is not NULL, Bob's public key expanded by expand_public_key_B() is used instead.
+  // The results are the same as with EphemeralKeyGeneration_A() and EphemeralSecretAgreement_A().
+    point_proj_t phi[SIDH_BATCH][3], pts[MAX_INT_POINTS_ALICE+1];
+    f2elm_t PKB[SIDH_BATCH][3], A[SIDH_BATCH], A24plus, C24, num[SIDH_BATCH];
+    f2elm_t den[4*SIDH_BATCH], inv[4*SIDH_BATCH], scratch[4*SIDH_BATCH];    // Z-coordinates of the images followed by the j-invariant denominators
+    digit_t SecretKeyA[NWORDS_ORDER] = {0};
+    unsigned int i, j;
+
+    if (pkB == NULL) {
+        for (i = 0; i < n; i++) {
+            fp2_decode(PublicKeyB[i], PKB[i][0]);
+            fp2_decode(PublicKeyB[i] + FP2_ENCODED_BYTES, PKB[i][1]);
+            fp2_decode(PublicKeyB[i] + 2*FP2_ENCODED_BYTES, PKB[i][2]);
         }
-        get_4_isog(R, A24plus, C24, coeff);        
+        get_A_many((const f2elm_t (*)[3])PKB, n, A, scratch);
+    }
 
-        for (i = 0; i < npts; i++) {
-            eval_4_isog(pts[i], coeff);
+    for (i = 0; i < n; i++) {
+        KeyGeneration_A(PrivateKeyA[i], phi[i]);
+
+        // Retrieve kernel point on Bob's curve with constants A24plus = A+2C, C24 = 4C, where C=1
+        decode_to_digits(PrivateKeyA[i], SecretKeyA, SECRETKEY_A_BYTES, NWORDS_ORDER);
+        if (pkB == NULL) {
+            fp2zero(C24);
+            mp_add((digit_t*)&Montgomery_one, (digit_t*)&Montgomery_one, C24[0], NWORDS_FIELD);
+            mp2_add(A[i], C24, A24plus);
+            mp_add(C24[0], C24[0], C24[0], NWORDS_FIELD);
+            LADDER3PT(PKB[i][0], PKB[i][1], PKB[i][2], SecretKeyA, ALICE, pts[0], A[i]);
+        } else {
+            fp2copy(pkB->A24plus, A24plus);
+            fp2copy(pkB->C24, C24);
+            LADDER3PT_fixed_base(pkB->PKB[0], pkB->PKB[2], (digit_t*)pkB->xQ, SecretKeyA, ALICE, pts[0]);
         }
+        SecretAgreement_A(pts, A24plus, C24);
 
-        fp2copy(pts[npts-1]->X, R->X); 
-        fp2copy(pts[npts-1]->Z, R->Z);
-        index = pts_index[npts-1];
-        npts -= 1;
+        j_inv_fraction(A24plus, C24, num[i], den[3*n+i]);
+        for (j = 0; j < 3; j++) {
+            fp2copy(phi[i][j]->Z, den[3*i+j]);
+        }
     }
 
-    get_4_isog(R, A24plus, C24, coeff); 
-    mp2_add(A24plus, A24plus, A24plus);                                                
-    fp2sub(A24plus, C24, A24plus); 
-    fp2add(A24plus, A24plus, A24plus);                    
-    j_inv(A24plus, C24, jinv);
-    fp2_encode(jinv, SharedSecretA);    // Format shared secret
+    fp2_batch_inv_masked(den, 4*n, inv, scratch);
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < 3; j++) {
+            fp2mul_mont(phi[i][j]->X, inv[3*i+j], phi[i][j]->X);
+            fp2_encode(phi[i][j]->X, PublicKeyA[i] + j*FP2_ENCODED_BYTES);    // Format public key
+        }
+        fp2mul_mont(num[i], inv[3*n+i], num[i]);
+        fp2_encode(num[i], SharedSecretA[i]);    // Format shared secret
+    }
+}
 
-    return 0;
+
+static void SecretAgreement_B_batch(const digit_t* const SecretKeyB[], const unsigned char* const PublicKeyA[], unsigned char* const SharedSecretB[], const unsigned int n)
+{ // Bob's ephemeral shared secret computation for n <= SIDH_BATCH pairs of keys, with his secret keys decoded to NWORDS_ORDER digits.
+  // The inversions of get_A() and j_inv() are shared by the n computations.
+    point_proj_t pts[MAX_INT_POINTS_BOB+1];    // The kernel point of the current step is pts[npts]
+    f2elm_t coeff[3], PKA[SIDH_BATCH][3], A[SIDH_BATCH], C[SIDH_BATCH], jinv[SIDH_BATCH], scratch[3*SIDH_BATCH];
+    f2elm_t A24plus = {0}, A24minus = {0};
+    unsigned int i, row, m, index, pts_index[MAX_INT_POINTS_BOB], npts, ii;
+    traversal_t trav;
+      
+    // Initialize images of Alice's basis
+    for (i = 0; i < n; i++) {
+        fp2_decode(PublicKeyA[i], PKA[i][0]);
+        fp2_decode(PublicKeyA[i] + FP2_ENCODED_BYTES, PKA[i][1]);
+        fp2_decode(PublicKeyA[i] + 2*FP2_ENCODED_BYTES, PKA[i][2]);
+    }
+    get_A_many((const f2elm_t (*)[3])PKA, n, A, scratch);
+
+    for (i = 0; i < n; i++) {
+        // Initialize constants: A24plus = A+2C, A24minus = A-2C, where C=1
+        fp2zero(A24minus);
+        mp_add((digit_t*)&Montgomery_one, (digit_t*)&Montgomery_one, A24minus[0], NWORDS_FIELD);
+        mp2_add(A[i], A24minus, A24plus);
+        mp2_sub_p2(A[i], A24minus, A24minus);
+
+        // Retrieve kernel point
+        LADDER3PT(PKA[i][0], PKA[i][1], PKA[i][2], SecretKeyB[i], BOB, pts[0], A[i]);
+    
+        // Traverse tree
+        traversal_init(&trav, 3, pts, NULL, 0);
+        index = 0;  
+        npts = 0;
+        ii = 0;
+        for (row = 1; row < MAX_Bob; row++) {
+            while (index < MAX_Bob-row) {
+                pts_index[npts] = index;
+                m = strat_Bob[ii++];
+                xTPLe(pts[npts], pts[npts+1], A24minus, A24plus, (int)m);
+                npts++;
+                index += m;
+            }
+            get_3_isog(pts[npts], A24minus, A24plus, coeff);
+            traversal_eval(&trav, coeff, npts);
+            npts -= 1;
+            index = pts_index[npts];
+        }
+        traversal_finish(&trav);
+     
+        get_3_isog(pts[0], A24minus, A24plus, coeff);    
+        fp2add(A24plus, A24minus, A[i]);                 
+        fp2add(A[i], A[i], A[i]);
+        fp2sub(A24plus, A24minus, C[i]);                   
+    }
+
+    j_inv_many((const f2elm_t*)A, (const f2elm_t*)C, n, jinv, scratch);
+    for (i = 0; i < n; i++) {
+        fp2_encode(jinv[i], SharedSecretB[i]);    // Format shared secrets
+    }
 }
 
 
@@ -267,56 +569,115 @@ int EphemeralSecretAgreement_B(const unsigned char* PrivateKeyB, const unsigned
   // Inputs: Bob's PrivateKeyB is an integer in the range [0, 2^Floor(Log(2,oB)) - 1]. 
   //         Alice's PublicKeyA consists of 3 elements in GF(p^2) encoded by removing leading 0 bytes.
   // Output: a shared secret SharedSecretB that consists of one element in GF(p^2) encoded by removing leading 0 bytes.  
-    point_proj_t R, pts[MAX_INT_POINTS_BOB];
-    f2elm_t coeff[3], PKB[3], jinv;
-    f2elm_t A24plus = {0}, A24minus = {0}, A = {0};
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_BOB], npts = 0, ii = 0;
     digit_t SecretKeyB[NWORDS_ORDER] = {0};
-      
-    // Initialize images of Alice's basis
-    fp2_decode(PublicKeyA, PKB[0]);
-    fp2_decode(PublicKeyA + FP2_ENCODED_BYTES, PKB[1]);
-    fp2_decode(PublicKeyA + 2*FP2_ENCODED_BYTES, PKB[2]);
+    const digit_t* skB = SecretKeyB;
 
-    // Initialize constants: A24plus = A+2C, A24minus = A-2C, where C=1
-    get_A(PKB[0], PKB[1], PKB[2], A);
-    mp_add((digit_t*)&Montgomery_one, (digit_t*)&Montgomery_one, A24minus[0], NWORDS_FIELD);
-    mp2_add(A, A24minus, A24plus);
-    mp2_sub_p2(A, A24minus, A24minus);
-
-    // Retrieve kernel point
     decode_to_digits(PrivateKeyB, SecretKeyB, SECRETKEY_B_BYTES, NWORDS_ORDER);
-    LADDER3PT(PKB[0], PKB[1], PKB[2], SecretKeyB, BOB, R, A);
-    
-    // Traverse tree
-    index = 0;  
-    for (row = 1; row < MAX_Bob; row++) {
-        while (index < MAX_Bob-row) {
-            fp2copy(R->X, pts[npts]->X);
-            fp2copy(R->Z, pts[npts]->Z);
-            pts_index[npts++] = index;
-            m = strat_Bob[ii++];
-            xTPLe(R, R, A24minus, A24plus, (int)m);
-            index += m;
-        }
-        get_3_isog(R, A24minus, A24plus, coeff);
+    SecretAgreement_B_batch(&skB, &PublicKeyA, &SharedSecretB, 1);
 
-        for (i = 0; i < npts; i++) {
-            eval_3_isog(pts[i], coeff);
-        } 
+    return 0;
+}
 
-        fp2copy(pts[npts-1]->X, R->X); 
-        fp2copy(pts[npts-1]->Z, R->Z);
-        index = pts_index[npts-1];
-        npts -= 1;
-    }
-     
-    get_3_isog(R, A24minus, A24plus, coeff);    
-    fp2add(A24plus, A24minus, A);                 
-    fp2add(A, A, A);
-    fp2sub(A24plus, A24minus, A24plus);                   
-    j_inv(A, A24plus, jinv);
-    fp2_encode(jinv, SharedSecretB);    // Format shared secret
 
+#if defined(KEY_POOL)
+
+static key_pool_t* key_pool_A = NULL;      // Published with a compare-and-swap and read with acquire loads, see key_pool_start()
+static key_pool_t* key_pool_B = NULL;
+
+
+static void generate_key_pair_A(unsigned char* entry)
+{ // Entry of Alice's key pool: a private key followed by the corresponding public key
+
+    random_mod_order_A(entry);
+    EphemeralKeyGeneration_A(entry, entry + SECRETKEY_A_BYTES);
+}
+
+
+static void generate_key_pair_B(unsigned char* entry)
+{ // Entry of Bob's key pool: a private key followed by the corresponding public key
+
+    random_mod_order_B(entry);
+    EphemeralKeyGeneration_B(entry, entry + SECRETKEY_B_BYTES);
+}
+
+
+static int key_pool_start(key_pool_t** slot, const unsigned int capacity, const unsigned int entry_bytes, const unsigned int nthreads, void (*generate)(unsigned char*))
+{ // Creates a pool and publishes it in *slot unless a pool is already running. Concurrent calls create at most one running pool,
+  // a pool that loses the race for the slot is destroyed.
+    key_pool_t* pool;
+
+    if (__atomic_load_n(slot, __ATOMIC_ACQUIRE) != NULL) {
+        return 1;
+    }
+    pool = key_pool_create(capacity, entry_bytes, nthreads, generate);
+    if (pool == NULL) {
+        return 1;
+    }
+    if (!__sync_bool_compare_and_swap(slot, NULL, pool)) {
+        key_pool_destroy(pool);             // Another thread has started the pool first
+        return 1;
+    }
     return 0;
+}
+
+#endif
+
+
+int EphemeralKeyPoolStart_A(const unsigned int capacity, const unsigned int nthreads)
+{ // Starts nthreads background threads that keep up to capacity of Alice's ephemeral key pairs ready for EphemeralKeyPair_A().
+  // Returns 0 on success, or 1 if the pool is already running, cannot be created or is not supported by the build.
+#if defined(KEY_POOL)
+    return key_pool_start(&key_pool_A, capacity, SECRETKEY_A_BYTES + 3*FP2_ENCODED_BYTES, nthreads, generate_key_pair_A);
+#else
+    UNREFERENCED_PARAMETER(capacity);
+    UNREFERENCED_PARAMETER(nthreads);
+    return 1;
+#endif
+}
+
+
+int EphemeralKeyPoolStart_B(const unsigned int capacity, const unsigned int nthreads)
+{ // Starts nthreads background threads that keep up to capacity of Bob's ephemeral key pairs ready for EphemeralKeyPair_B().
+  // Returns 0 on success, or 1 if the pool is already running, cannot be created or is not supported by the build.
+#if defined(KEY_POOL)
+    return key_pool_start(&key_pool_B, capacity, SECRETKEY_B_BYTES + 3*FP2_ENCODED_BYTES, nthreads, generate_key_pair_B);
+#else
+    UNREFERENCED_PARAMETER(capacity);
+    UNREFERENCED_PARAMETER(nthreads);
+    return 1;
+#endif
+}
+
+
+void EphemeralKeyPoolStop(void)
+{ // Stops the background threads of both pools and erases the key pairs that were not used
+
+#if defined(KEY_POOL)
+    key_pool_destroy(__atomic_exchange_n(&key_pool_A, NULL, __ATOMIC_ACQ_REL));
+    key_pool_destroy(__atomic_exchange_n(&key_pool_B, NULL, __ATOMIC_ACQ_REL));
+#endif
+}
+
+
+int EphemeralKeyPair_A(unsigned char* PrivateKeyA, unsigned char* PublicKeyA)
+{ // Alice's ephemeral key pair, taken from the key pool when it holds one and generated by the calling thread otherwise
+#if defined(KEY_POOL)
+    if (key_pool_pop(__atomic_load_n(&key_pool_A, __ATOMIC_ACQUIRE), PrivateKeyA, SECRETKEY_A_BYTES, PublicKeyA)) {
+        return 0;
+    }
+#endif
+    random_mod_order_A(PrivateKeyA);
+    return EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA);
+}
+
+
+int EphemeralKeyPair_B(unsigned char* PrivateKeyB, unsigned char* PublicKeyB)
+{ // Bob's ephemeral key pair, taken from the key pool when it holds one and generated by the calling thread otherwise
+#if defined(KEY_POOL)
+    if (key_pool_pop(__atomic_load_n(&key_pool_B, __ATOMIC_ACQUIRE), PrivateKeyB, SECRETKEY_B_BYTES, PublicKeyB)) {
+        return 0;
+    }
+#endif
+    random_mod_order_B(PrivateKeyB);
+    return EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB);
 }
\ No newline at end of file
@@ -0,0 +1,194 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: 4-way AVX2 ephemeral supersingular isogeny Diffie-Hellman key exchange (SIDH).
+*           Four independent key exchange operations traverse the isogeny tree together, one per lane.
+*********************************************************************************************/
+
+
+static void init_basis_x4(digit_t *gen, vf2elm_t XP, vf2elm_t XQ, vf2elm_t XR)
+{ // Initialization of basis points, broadcast to the 4 lanes
+    f2elm_t XP_, XQ_, XR_;
+
+    init_basis(gen, XP_, XQ_, XR_);
+    fp2_set1_x4(XP_, XP);
+    fp2_set1_x4(XQ_, XQ);
+    fp2_set1_x4(XR_, XR);
+}
+
+
+int EphemeralKeyGeneration_A_x4(const unsigned char* const PrivateKeyA[4], unsigned char* const PublicKeyA[4])
+{ // Alice's ephemeral public key generation for 4 independent private keys
+  // Input:  4 private keys PrivateKeyA[i] in the range [0, 2^eA - 1].
+  // Output: the public keys PublicKeyA[i], each consisting of 3 elements in GF(p^2) which are encoded by removing leading 0 bytes.
+    vpoint_proj_t R, phiP, phiQ, phiR, pts[MAX_INT_POINTS_ALICE];
+    vf2elm_t XPA, XQA, XRA, coeff[3], A24plus, C24, A24;
+    f2elm_t A24plus_ = {0}, C24_ = {0}, A24_ = {0}, one = {0}, Z[3*4], X[3][4], scratch[3*4];
+    unsigned int i, j, row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0, ii = 0;
+    digit_t SecretKeyA[4][NWORDS_ORDER] = {{0}};
+    const digit_t* keys[4] = {SecretKeyA[0], SecretKeyA[1], SecretKeyA[2], SecretKeyA[3]};
+
+    // Initialize basis points
+    init_basis_x4((digit_t*)A_gen, XPA, XQA, XRA);
+    init_basis_x4((digit_t*)B_gen, phiP->X, phiQ->X, phiR->X);
+    fpcopy((digit_t*)&Montgomery_one, one[0]);
+    fp2_set1_x4(one, phiP->Z);
+    fp2_set1_x4(one, phiQ->Z);
+    fp2_set1_x4(one, phiR->Z);
+
+    // Initialize constants: A24plus = A+2C, C24 = 4C, where A=6, C=1, and A24 = (A+2)/4 = 2
+    fpcopy((digit_t*)&Montgomery_one, A24plus_[0]);
+    mp2_add(A24plus_, A24plus_, A24_);
+    mp2_add(A24plus_, A24plus_, A24plus_);
+    mp2_add(A24plus_, A24plus_, C24_);
+    mp2_add(C24_, C24_, A24plus_);
+    fp2_set1_x4(A24plus_, A24plus);
+    fp2_set1_x4(C24_, C24);
+    fp2_set1_x4(A24_, A24);
+
+    // Retrieve kernel points
+    for (j = 0; j < 4; j++) {
+        decode_to_digits(PrivateKeyA[j], SecretKeyA[j], SECRETKEY_A_BYTES, NWORDS_ORDER);
+    }
+    LADDER3PT_x4(XPA, XQA, XRA, keys, ALICE, R, A24);
+
+#if (OALICE_BITS % 2 == 1)
+    vpoint_proj_t S;
+
+    xDBLe_x4(R, S, A24plus, C24, (int)(OALICE_BITS-1));
+    get_2_isog_x4(S, A24plus, C24);
+    eval_2_isog_x4(phiP, S);
+    eval_2_isog_x4(phiQ, S);
+    eval_2_isog_x4(phiR, S);
+    eval_2_isog_x4(R, S);
+#endif
+
+    // Traverse tree
+    index = 0;
+    for (row = 1; row < MAX_Alice; row++) {
+        while (index < MAX_Alice-row) {
+            fp2copy_x4(R->X, pts[npts]->X);
+            fp2copy_x4(R->Z, pts[npts]->Z);
+            pts_index[npts++] = index;
+            m = strat_Alice[ii++];
+            xDBLe_x4(R, R, A24plus, C24, (int)(2*m));
+            index += m;
+        }
+        get_4_isog_x4(R, A24plus, C24, coeff);
+
+        for (i = 0; i < npts; i++) {
+            eval_4_isog_x4(pts[i], coeff);
+        }
+        eval_4_isog_x4(phiP, coeff);
+        eval_4_isog_x4(phiQ, coeff);
+        eval_4_isog_x4(phiR, coeff);
+
+        fp2copy_x4(pts[npts-1]->X, R->X);
+        fp2copy_x4(pts[npts-1]->Z, R->Z);
+        index = pts_index[npts-1];
+        npts -= 1;
+    }
+
+    get_4_isog_x4(R, A24plus, C24, coeff);
+    eval_4_isog_x4(phiP, coeff);
+    eval_4_isog_x4(phiQ, coeff);
+    eval_4_isog_x4(phiR, coeff);
+
+    // Normalize and format the public keys, lane by lane
+    fp2_from_x4(phiP->X, X[0][0], X[0][1], X[0][2], X[0][3]);
+    fp2_from_x4(phiQ->X, X[1][0], X[1][1], X[1][2], X[1][3]);
+    fp2_from_x4(phiR->X, X[2][0], X[2][1], X[2][2], X[2][3]);
+    fp2_from_x4(phiP->Z, Z[0], Z[1], Z[2], Z[3]);
+    fp2_from_x4(phiQ->Z, Z[4], Z[5], Z[6], Z[7]);
+    fp2_from_x4(phiR->Z, Z[8], Z[9], Z[10], Z[11]);
+    fp2_batch_inv(Z, 3*4, Z, scratch);               // A single inversion for the 12 Z coordinates
+
+    for (j = 0; j < 4; j++) {
+        for (i = 0; i < 3; i++) {
+            fp2mul_mont(X[i][j], Z[4*i+j], X[i][j]);
+            fp2_encode(X[i][j], PublicKeyA[j] + i*FP2_ENCODED_BYTES);
+        }
+    }
+
+    return 0;
+}
+
+
+int EphemeralSecretAgreement_B_x4(const unsigned char* const PrivateKeyB[4], const unsigned char* const PublicKeyA[4], unsigned char* const SharedSecretB[4])
+{ // Bob's ephemeral shared secret computation for 4 independent pairs of private and public keys
+  // It produces the shared secret keys SharedSecretB[i] using his secret keys PrivateKeyB[i] and Alice's public keys PublicKeyA[i]
+  // Inputs: Bob's PrivateKeyB[i] is an integer in the range [0, 2^Floor(Log(2,oB)) - 1].
+  //         Alice's PublicKeyA[i] consists of 3 elements in GF(p^2) encoded by removing leading 0 bytes.
+  // Output: the shared secrets SharedSecretB[i], each consisting of one element in GF(p^2) encoded by removing leading 0 bytes.
+    vpoint_proj_t R, pts[MAX_INT_POINTS_BOB];
+    vf2elm_t coeff[3], PKB[3], A24plus, A24minus, A24;
+    f2elm_t PKB_[3][4], A_[4], A24plus_[4], A24minus_[4], A24_[4], jinv;
+    unsigned int i, j, row, m, index = 0, pts_index[MAX_INT_POINTS_BOB], npts = 0, ii = 0;
+    digit_t SecretKeyB[4][NWORDS_ORDER] = {{0}};
+    const digit_t* keys[4] = {SecretKeyB[0], SecretKeyB[1], SecretKeyB[2], SecretKeyB[3]};
+
+    for (j = 0; j < 4; j++) {
+        // Initialize images of Alice's basis
+        fp2_decode(PublicKeyA[j], PKB_[0][j]);
+        fp2_decode(PublicKeyA[j] + FP2_ENCODED_BYTES, PKB_[1][j]);
+        fp2_decode(PublicKeyA[j] + 2*FP2_ENCODED_BYTES, PKB_[2][j]);
+
+        // Initialize constants: A24plus = A+2C, A24minus = A-2C, where C=1, and A24 = (A+2)/4
+        get_A(PKB_[0][j], PKB_[1][j], PKB_[2][j], A_[j]);
+        fp2zero(A24minus_[j]);
+        mp_add((digit_t*)&Montgomery_one, (digit_t*)&Montgomery_one, A24minus_[j][0], NWORDS_FIELD);
+        mp2_add(A_[j], A24minus_[j], A24plus_[j]);
+        mp2_sub_p2(A_[j], A24minus_[j], A24minus_[j]);
+        fp2div2(A24plus_[j], A24_[j]);
+        fp2div2(A24_[j], A24_[j]);
+
+        decode_to_digits(PrivateKeyB[j], SecretKeyB[j], SECRETKEY_B_BYTES, NWORDS_ORDER);
+    }
+    for (i = 0; i < 3; i++) {
+        fp2_to_x4(PKB_[i][0], PKB_[i][1], PKB_[i][2], PKB_[i][3], PKB[i]);
+    }
+    fp2_to_x4(A24plus_[0], A24plus_[1], A24plus_[2], A24plus_[3], A24plus);
+    fp2_to_x4(A24minus_[0], A24minus_[1], A24minus_[2], A24minus_[3], A24minus);
+    fp2_to_x4(A24_[0], A24_[1], A24_[2], A24_[3], A24);
+
+    // Retrieve kernel points
+    LADDER3PT_x4(PKB[0], PKB[1], PKB[2], keys, BOB, R, A24);
+
+    // Traverse tree
+    index = 0;
+    for (row = 1; row < MAX_Bob; row++) {
+        while (index < MAX_Bob-row) {
+            fp2copy_x4(R->X, pts[npts]->X);
+            fp2copy_x4(R->Z, pts[npts]->Z);
+            pts_index[npts++] = index;
+            m = strat_Bob[ii++];
+            xTPLe_x4(R, R, A24minus, A24plus, (int)m);
+            index += m;
+        }
+        get_3_isog_x4(R, A24minus, A24plus, coeff);
+
+        for (i = 0; i < npts; i++) {
+            eval_3_isog_x4(pts[i], coeff);
+        }
+
+        fp2copy_x4(pts[npts-1]->X, R->X);
+        fp2copy_x4(pts[npts-1]->Z, R->Z);
+        index = pts_index[npts-1];
+        npts -= 1;
+    }
+
+    get_3_isog_x4(R, A24minus, A24plus, coeff);
+    fp2_from_x4(A24plus, A24plus_[0], A24plus_[1], A24plus_[2], A24plus_[3]);
+    fp2_from_x4(A24minus, A24minus_[0], A24minus_[1], A24minus_[2], A24minus_[3]);
+
+    // Compute and format the shared secrets, lane by lane
+    for (j = 0; j < 4; j++) {
+        fp2add(A24plus_[j], A24minus_[j], A_[j]);
+        fp2add(A_[j], A_[j], A_[j]);
+        fp2sub(A24plus_[j], A24minus_[j], A24plus_[j]);
+        j_inv(A_[j], A24plus_[j], jinv);
+        fp2_encode(jinv, SharedSecretB[j]);
+    }
+
+    return 0;
+}
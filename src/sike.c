@@ -6,6 +6,9 @@
 
 #include <string.h>
 #include "sha3/fips202.h"
+#ifdef AVX2_X4_IMPLEMENTATION
+    #include "sha3/fips202x4.h"
+#endif
 
 #ifdef DO_VALGRIND_CHECK
 #include <valgrind/memcheck.h>
@@ -37,44 +40,91 @@ int crypto_kem_keypair(unsigned char *pk, unsigned char *sk)
 }
 
 
-int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk)
-{ // SIKE's encapsulation
-  // Input:   public key pk         (CRYPTO_PUBLICKEYBYTES bytes)
-  // Outputs: shared secret ss      (CRYPTO_BYTES bytes)
-  //          ciphertext message ct (CRYPTO_CIPHERTEXTBYTES = CRYPTO_PUBLICKEYBYTES + MSG_BYTES bytes)
+// Public key context for encapsulations, see crypto_kem_pk_expand()
+typedef struct {
+    expanded_public_key_B_t pkB;
+    unsigned char pk[CRYPTO_PUBLICKEYBYTES];
+} pk_ctx_t;
+
+typedef char pk_ctx_size_check[(sizeof(pk_ctx_t) <= sizeof(sike_pk_ctx)) ? 1 : -1];    // CRYPTO_PKCTXBYTES must be large enough
+
+
+static int kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk, const expanded_public_key_B_t* pkB)
+{ // SIKE's encapsulation to the public key pk, which has been expanded in pkB if pkB is not NULL
     unsigned char ephemeralsk[SECRETKEY_A_BYTES];
     unsigned char jinvariant[FP2_ENCODED_BYTES];
     unsigned char h[MSG_BYTES];
-    unsigned char temp[CRYPTO_CIPHERTEXTBYTES+MSG_BYTES];
+    unsigned char m[MSG_BYTES];
+    uint64_t s[SHAKE_INC_STATE_WORDS];
+    const unsigned char* ska = ephemeralsk;
+    unsigned char* jinv = jinvariant;
 
     // Generate ephemeralsk <- G(m||pk) mod oA 
-    randombytes(temp, MSG_BYTES);
+    randombytes(m, MSG_BYTES);
 #ifdef DO_VALGRIND_CHECK
-    VALGRIND_MAKE_MEM_UNDEFINED(temp, MSG_BYTES);
+    VALGRIND_MAKE_MEM_UNDEFINED(m, MSG_BYTES);
 #endif
-    memcpy(&temp[MSG_BYTES], pk, CRYPTO_PUBLICKEYBYTES);
-    shake256(ephemeralsk, SECRETKEY_A_BYTES, temp, CRYPTO_PUBLICKEYBYTES+MSG_BYTES);
+    shake256_inc_init(s);
+    shake256_inc_absorb(s, m, MSG_BYTES);
+    shake256_inc_absorb(s, pk, CRYPTO_PUBLICKEYBYTES);
+    shake256_inc_finalize(s);
+    shake256_inc_squeeze(ephemeralsk, SECRETKEY_A_BYTES, s);
     ephemeralsk[SECRETKEY_A_BYTES - 1] &= MASK_ALICE;
 
     // Encrypt
-    EphemeralKeyGeneration_A(ephemeralsk, ct);
-    EphemeralSecretAgreement_A(ephemeralsk, pk, jinvariant);
+    EphemeralKeyExchange_A_batch(&ska, &pk, pkB, &ct, &jinv, 1);
     shake256(h, MSG_BYTES, jinvariant, FP2_ENCODED_BYTES);
     for (int i = 0; i < MSG_BYTES; i++) {
-        ct[i + CRYPTO_PUBLICKEYBYTES] = temp[i] ^ h[i];
+        ct[i + CRYPTO_PUBLICKEYBYTES] = m[i] ^ h[i];
     }
 
     // Generate shared secret ss <- H(m||ct)
-    memcpy(&temp[MSG_BYTES], ct, CRYPTO_CIPHERTEXTBYTES);
-    shake256(ss, CRYPTO_BYTES, temp, CRYPTO_CIPHERTEXTBYTES+MSG_BYTES);
+    shake256_inc_init(s);
+    shake256_inc_absorb(s, m, MSG_BYTES);
+    shake256_inc_absorb(s, ct, CRYPTO_CIPHERTEXTBYTES);
+    shake256_inc_finalize(s);
+    shake256_inc_squeeze(ss, CRYPTO_BYTES, s);
 
 #ifdef DO_VALGRIND_CHECK
-    VALGRIND_MAKE_MEM_DEFINED(temp, MSG_BYTES);
+    VALGRIND_MAKE_MEM_DEFINED(m, MSG_BYTES);
 #endif
     return 0;
 }
 
 
+int crypto_kem_enc(unsigned char *ct, unsigned char *ss, const unsigned char *pk)
+{ // SIKE's encapsulation
+  // Input:   public key pk         (CRYPTO_PUBLICKEYBYTES bytes)
+  // Outputs: shared secret ss      (CRYPTO_BYTES bytes)
+  //          ciphertext message ct (CRYPTO_CIPHERTEXTBYTES = CRYPTO_PUBLICKEYBYTES + MSG_BYTES bytes)
+
+    return kem_enc(ct, ss, pk, NULL);
+}
+
+
+int crypto_kem_pk_expand(sike_pk_ctx *ctx, const unsigned char *pk)
+{ // SIKE's public key expansion for repeated encapsulations to the same public key
+  // Input:   public key pk         (CRYPTO_PUBLICKEYBYTES bytes)
+  // Output:  public key context ctx
+    pk_ctx_t* c = (pk_ctx_t*)ctx;
+
+    memcpy(c->pk, pk, CRYPTO_PUBLICKEYBYTES);
+    expand_public_key_B(pk, &c->pkB);
+    return 0;
+}
+
+
+int crypto_kem_enc_ctx(unsigned char *ct, unsigned char *ss, const sike_pk_ctx *ctx)
+{ // SIKE's encapsulation to the public key expanded in ctx by crypto_kem_pk_expand()
+  // Input:   public key context ctx
+  // Outputs: shared secret ss      (CRYPTO_BYTES bytes)
+  //          ciphertext message ct (CRYPTO_CIPHERTEXTBYTES = CRYPTO_PUBLICKEYBYTES + MSG_BYTES bytes)
+    const pk_ctx_t* c = (const pk_ctx_t*)ctx;
+
+    return kem_enc(ct, ss, c->pk, &c->pkB);
+}
+
+
 int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned char *sk)
 { // SIKE's decapsulation
   // Input:   secret key sk         (CRYPTO_SECRETKEYBYTES = MSG_BYTES + SECRETKEY_B_BYTES + CRYPTO_PUBLICKEYBYTES bytes)
@@ -84,7 +134,8 @@ int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned ch
     unsigned char jinvariant_[FP2_ENCODED_BYTES];
     unsigned char h_[MSG_BYTES];
     unsigned char c0_[CRYPTO_PUBLICKEYBYTES];
-    unsigned char temp[CRYPTO_CIPHERTEXTBYTES+MSG_BYTES];
+    unsigned char m_[MSG_BYTES];
+    uint64_t s[SHAKE_INC_STATE_WORDS];
 #ifdef DO_VALGRIND_CHECK
     VALGRIND_MAKE_MEM_UNDEFINED(sk, CRYPTO_SECRETKEYBYTES);
 #endif
@@ -93,24 +144,308 @@ int crypto_kem_dec(unsigned char *ss, const unsigned char *ct, const unsigned ch
     EphemeralSecretAgreement_B(sk + MSG_BYTES, ct, jinvariant_);
     shake256(h_, MSG_BYTES, jinvariant_, FP2_ENCODED_BYTES);
     for (int i = 0; i < MSG_BYTES; i++) {
-        temp[i] = ct[i + CRYPTO_PUBLICKEYBYTES] ^ h_[i];
+        m_[i] = ct[i + CRYPTO_PUBLICKEYBYTES] ^ h_[i];
     }
 
     // Generate ephemeralsk_ <- G(m||pk) mod oA
-    memcpy(&temp[MSG_BYTES], &sk[MSG_BYTES + SECRETKEY_B_BYTES], CRYPTO_PUBLICKEYBYTES);
-    shake256(ephemeralsk_, SECRETKEY_A_BYTES, temp, CRYPTO_PUBLICKEYBYTES+MSG_BYTES);
+    shake256_inc_init(s);
+    shake256_inc_absorb(s, m_, MSG_BYTES);
+    shake256_inc_absorb(s, &sk[MSG_BYTES + SECRETKEY_B_BYTES], CRYPTO_PUBLICKEYBYTES);
+    shake256_inc_finalize(s);
+    shake256_inc_squeeze(ephemeralsk_, SECRETKEY_A_BYTES, s);
     ephemeralsk_[SECRETKEY_A_BYTES - 1] &= MASK_ALICE;
     
     // Generate shared secret ss <- H(m||ct), or output ss <- H(s||ct) in case of ct verification failure
     EphemeralKeyGeneration_A(ephemeralsk_, c0_);
     // If selector = 0 then do ss = H(m||ct), else if selector = -1 load s to do ss = H(s||ct)
     int8_t selector = ct_compare(c0_, ct, CRYPTO_PUBLICKEYBYTES);
-    ct_cmov(temp, sk, MSG_BYTES, selector);
-    memcpy(&temp[MSG_BYTES], ct, CRYPTO_CIPHERTEXTBYTES);
-    shake256(ss, CRYPTO_BYTES, temp, CRYPTO_CIPHERTEXTBYTES+MSG_BYTES);
+    ct_cmov(m_, sk, MSG_BYTES, selector);
+    shake256_inc_init(s);
+    shake256_inc_absorb(s, m_, MSG_BYTES);
+    shake256_inc_absorb(s, ct, CRYPTO_CIPHERTEXTBYTES);
+    shake256_inc_finalize(s);
+    shake256_inc_squeeze(ss, CRYPTO_BYTES, s);
     
 #ifdef DO_VALGRIND_CHECK
     VALGRIND_MAKE_MEM_DEFINED(sk, CRYPTO_SECRETKEYBYTES);
 #endif
     return 0;
-}
\ No newline at end of file
+}
+
+
+static void shake256_many(unsigned char* const out[], const unsigned long long outlen, const unsigned char* const in[], const unsigned long long inlen, const unsigned int n)
+{ // Computes out[i] = SHAKE256(in[i]) for i = 0,...,n-1, hashing four inputs per Keccak permutation with the 4-way AVX2 engine if available
+    unsigned int i = 0;
+
+#ifdef AVX2_X4_IMPLEMENTATION
+    for (; i + 4 <= n; i += 4) {
+        shake256x4(out[i], out[i+1], out[i+2], out[i+3], outlen, in[i], in[i+1], in[i+2], in[i+3], inlen);
+    }
+#endif
+    for (; i < n; i++) {
+        shake256(out[i], outlen, in[i], inlen);
+    }
+}
+
+
+// Batch of encapsulations (ct != NULL) or decapsulations (ct_in != NULL), see kem_batch_run()
+typedef struct {
+    unsigned char* const* ct;                   // Ciphertexts computed by the encapsulations
+    const unsigned char* const* ct_in;          // Ciphertexts processed by the decapsulations
+    unsigned char* const* ss;
+    const unsigned char* const* key;            // Public keys of the encapsulations or secret keys of the decapsulations
+    unsigned int n;
+} kem_batch_t;
+
+
+static void kem_enc_group(unsigned char* const ct[], unsigned char* const ss[], const unsigned char* const pk[], const unsigned int n)
+{ // SIKE's encapsulation of n <= SIDH_BATCH independent operations, computed as in kem_enc() with batched SIDH functions
+    unsigned char ephemeralsk[SIDH_BATCH][SECRETKEY_A_BYTES];
+    unsigned char jinvariant[SIDH_BATCH][FP2_ENCODED_BYTES];
+    unsigned char h[SIDH_BATCH][MSG_BYTES];
+    unsigned char m[SIDH_BATCH][MSG_BYTES];
+    unsigned char temp[SIDH_BATCH][CRYPTO_CIPHERTEXTBYTES+MSG_BYTES];
+    const unsigned char *ska[SIDH_BATCH], *in[SIDH_BATCH];
+    unsigned char *jinv[SIDH_BATCH], *out[SIDH_BATCH];
+    unsigned int i, j;
+
+    // Generate ephemeralsk <- G(m||pk) mod oA 
+    randombytes(m[0], n*MSG_BYTES);
+#ifdef DO_VALGRIND_CHECK
+    VALGRIND_MAKE_MEM_UNDEFINED(m, n*MSG_BYTES);
+#endif
+    for (i = 0; i < n; i++) {
+        memcpy(temp[i], m[i], MSG_BYTES);
+        memcpy(&temp[i][MSG_BYTES], pk[i], CRYPTO_PUBLICKEYBYTES);
+        in[i] = temp[i];
+        out[i] = ephemeralsk[i];
+    }
+    shake256_many(out, SECRETKEY_A_BYTES, in, CRYPTO_PUBLICKEYBYTES+MSG_BYTES, n);
+    for (i = 0; i < n; i++) {
+        ephemeralsk[i][SECRETKEY_A_BYTES - 1] &= MASK_ALICE;
+        ska[i] = ephemeralsk[i];
+        jinv[i] = jinvariant[i];
+    }
+
+    // Encrypt
+    EphemeralKeyExchange_A_batch(ska, pk, NULL, ct, jinv, n);
+    for (i = 0; i < n; i++) {
+        in[i] = jinvariant[i];
+        out[i] = h[i];
+    }
+    shake256_many(out, MSG_BYTES, in, FP2_ENCODED_BYTES, n);
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < MSG_BYTES; j++) {
+            ct[i][j + CRYPTO_PUBLICKEYBYTES] = m[i][j] ^ h[i][j];
+        }
+
+        // Generate shared secret ss <- H(m||ct)
+        memcpy(temp[i], m[i], MSG_BYTES);
+        memcpy(&temp[i][MSG_BYTES], ct[i], CRYPTO_CIPHERTEXTBYTES);
+        in[i] = temp[i];
+    }
+    shake256_many(ss, CRYPTO_BYTES, in, CRYPTO_CIPHERTEXTBYTES+MSG_BYTES, n);
+
+#ifdef DO_VALGRIND_CHECK
+    VALGRIND_MAKE_MEM_DEFINED(m, n*MSG_BYTES);
+#endif
+}
+
+
+static void kem_dec_group(unsigned char* const ss[], const unsigned char* const ct[], const unsigned char* const sk[], const unsigned int n)
+{ // SIKE's decapsulation of n <= SIDH_BATCH independent ciphertexts, computed as in crypto_kem_dec() with batched SIDH functions
+    unsigned char ephemeralsk_[SIDH_BATCH][SECRETKEY_A_BYTES];
+    unsigned char jinvariant_[SIDH_BATCH][FP2_ENCODED_BYTES];
+    unsigned char h_[SIDH_BATCH][MSG_BYTES];
+    unsigned char c0_[SIDH_BATCH][CRYPTO_PUBLICKEYBYTES];
+    unsigned char temp[SIDH_BATCH][CRYPTO_CIPHERTEXTBYTES+MSG_BYTES];
+    digit_t SecretKeyB[SIDH_BATCH][NWORDS_ORDER];
+    const digit_t* skB[SIDH_BATCH];
+    const unsigned char *ska_[SIDH_BATCH], *in[SIDH_BATCH];
+    unsigned char *jinv_[SIDH_BATCH], *c0p_[SIDH_BATCH], *out[SIDH_BATCH];
+    unsigned int i, j;
+
+    for (i = 0; i < n; i++) {
+        decode_to_digits(sk[i] + MSG_BYTES, SecretKeyB[i], SECRETKEY_B_BYTES, NWORDS_ORDER);
+        skB[i] = SecretKeyB[i];
+        ska_[i] = ephemeralsk_[i];
+        jinv_[i] = jinvariant_[i];
+        c0p_[i] = c0_[i];
+    }
+
+    // Decrypt
+    SecretAgreement_B_batch(skB, ct, jinv_, n);
+    for (i = 0; i < n; i++) {
+        in[i] = jinvariant_[i];
+        out[i] = h_[i];
+    }
+    shake256_many(out, MSG_BYTES, in, FP2_ENCODED_BYTES, n);
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < MSG_BYTES; j++) {
+            temp[i][j] = ct[i][j + CRYPTO_PUBLICKEYBYTES] ^ h_[i][j];
+        }
+
+        // Generate ephemeralsk_ <- G(m||pk) mod oA
+        memcpy(&temp[i][MSG_BYTES], &sk[i][MSG_BYTES + SECRETKEY_B_BYTES], CRYPTO_PUBLICKEYBYTES);
+        in[i] = temp[i];
+        out[i] = ephemeralsk_[i];
+    }
+    shake256_many(out, SECRETKEY_A_BYTES, in, CRYPTO_PUBLICKEYBYTES+MSG_BYTES, n);
+    for (i = 0; i < n; i++) {
+        ephemeralsk_[i][SECRETKEY_A_BYTES - 1] &= MASK_ALICE;
+    }
+
+    // Generate shared secret ss <- H(m||ct), or output ss <- H(s||ct) in case of ct verification failure
+    EphemeralKeyGeneration_A_batch(ska_, c0p_, n);
+    for (i = 0; i < n; i++) {
+        // If selector = 0 then do ss = H(m||ct), else if selector = -1 load s to do ss = H(s||ct)
+        int8_t selector = ct_compare(c0_[i], ct[i], CRYPTO_PUBLICKEYBYTES);
+        ct_cmov(temp[i], sk[i], MSG_BYTES, selector);
+        memcpy(&temp[i][MSG_BYTES], ct[i], CRYPTO_CIPHERTEXTBYTES);
+        in[i] = temp[i];
+    }
+    shake256_many(ss, CRYPTO_BYTES, in, CRYPTO_CIPHERTEXTBYTES+MSG_BYTES, n);
+}
+
+
+static void kem_batch_range(const kem_batch_t* b, unsigned int first, const unsigned int last)
+{ // Processes the operations first, ..., last-1 of a batch in groups of SIDH_BATCH operations
+  // With the 4-way AVX2 engine, decapsulations are first processed four at a time by crypto_kem_dec_x4()
+    unsigned int n;
+
+#ifdef AVX2_X4_IMPLEMENTATION
+    if (b->ct == NULL) {
+        for (; last - first >= 4; first += 4) {
+            crypto_kem_dec_x4(b->ss + first, b->ct_in + first, b->key + first);
+        }
+    }
+#endif
+    for (; first < last; first += n) {
+        n = (last - first < SIDH_BATCH) ? last - first : SIDH_BATCH;
+        if (b->ct != NULL) {
+            kem_enc_group(b->ct + first, b->ss + first, b->key + first, n);
+        } else {
+            kem_dec_group(b->ss + first, b->ct_in + first, b->key + first, n);
+        }
+    }
+}
+
+
+#if defined(PARALLEL_TRAVERSAL)
+
+static void kem_batch_task(void* arg, const unsigned int worker, const unsigned int nworkers)
+{ // Worker task: the batch is split into nworkers+1 contiguous shares, the first of which is processed by the calling thread
+    const kem_batch_t* b = (const kem_batch_t*)arg;
+
+    kem_batch_range(b, (worker + 1)*b->n/(nworkers + 1), (worker + 2)*b->n/(nworkers + 1));
+}
+
+#endif
+
+
+static void kem_batch_run(kem_batch_t* b)
+{ // Processes a batch. In the parallel traversal mode, the operations are distributed over the calling thread and the workers
+  // if the pool is available, and the tree traversals of the individual operations are then serial.
+#if defined(PARALLEL_TRAVERSAL)
+    int nworkers;
+
+    if (b->n > 1 && (nworkers = thread_pool_acquire()) > 0) {
+        thread_pool_run(kem_batch_task, b);
+        kem_batch_range(b, 0, b->n/(nworkers + 1));
+        thread_pool_release();
+        return;
+    }
+#endif
+    kem_batch_range(b, 0, b->n);
+}
+
+
+int crypto_kem_enc_batch(unsigned char* const ct[], unsigned char* const ss[], const unsigned char* const pk[], unsigned int n)
+{ // SIKE's encapsulation of n independent operations
+  // Input:   public keys pk[i]         (CRYPTO_PUBLICKEYBYTES bytes each)
+  // Outputs: shared secrets ss[i]      (CRYPTO_BYTES bytes each)
+  //          ciphertext messages ct[i] (CRYPTO_CIPHERTEXTBYTES = CRYPTO_PUBLICKEYBYTES + MSG_BYTES bytes each)
+    kem_batch_t b = {ct, NULL, ss, pk, n};
+
+    kem_batch_run(&b);
+    return 0;
+}
+
+
+int crypto_kem_dec_batch(unsigned char* const ss[], const unsigned char* const ct[], const unsigned char* const sk[], unsigned int n)
+{ // SIKE's decapsulation of n independent ciphertexts
+  // Input:   secret keys sk[i]         (CRYPTO_SECRETKEYBYTES = MSG_BYTES + SECRETKEY_B_BYTES + CRYPTO_PUBLICKEYBYTES bytes each)
+  //          ciphertext messages ct[i] (CRYPTO_CIPHERTEXTBYTES = CRYPTO_PUBLICKEYBYTES + MSG_BYTES bytes each) 
+  // Outputs: shared secrets ss[i]      (CRYPTO_BYTES bytes each)
+    kem_batch_t b = {NULL, ct, ss, sk, n};
+#ifdef DO_VALGRIND_CHECK
+    for (unsigned int i = 0; i < n; i++)
+        VALGRIND_MAKE_MEM_UNDEFINED(sk[i], CRYPTO_SECRETKEYBYTES);
+#endif
+
+    kem_batch_run(&b);
+
+#ifdef DO_VALGRIND_CHECK
+    for (unsigned int i = 0; i < n; i++)
+        VALGRIND_MAKE_MEM_DEFINED(sk[i], CRYPTO_SECRETKEYBYTES);
+#endif
+    return 0;
+}
+
+
+#ifdef AVX2_X4_IMPLEMENTATION
+
+int crypto_kem_dec_x4(unsigned char* const ss[4], const unsigned char* const ct[4], const unsigned char* const sk[4])
+{ // SIKE's decapsulation of 4 independent ciphertexts, computed together using the 4-way AVX2 engine
+  // Input:   secret keys sk[i]         (CRYPTO_SECRETKEYBYTES = MSG_BYTES + SECRETKEY_B_BYTES + CRYPTO_PUBLICKEYBYTES bytes each)
+  //          ciphertext messages ct[i] (CRYPTO_CIPHERTEXTBYTES = CRYPTO_PUBLICKEYBYTES + MSG_BYTES bytes each) 
+  // Outputs: shared secrets ss[i]      (CRYPTO_BYTES bytes each)
+    unsigned char ephemeralsk_[4][SECRETKEY_A_BYTES];
+    unsigned char jinvariant_[4][FP2_ENCODED_BYTES];
+    unsigned char h_[4][MSG_BYTES];
+    unsigned char c0_[4][CRYPTO_PUBLICKEYBYTES];
+    unsigned char temp[4][CRYPTO_CIPHERTEXTBYTES+MSG_BYTES];
+    const unsigned char* skB[4] = {sk[0] + MSG_BYTES, sk[1] + MSG_BYTES, sk[2] + MSG_BYTES, sk[3] + MSG_BYTES};
+    const unsigned char* ska_[4] = {ephemeralsk_[0], ephemeralsk_[1], ephemeralsk_[2], ephemeralsk_[3]};
+    unsigned char* jinv_[4] = {jinvariant_[0], jinvariant_[1], jinvariant_[2], jinvariant_[3]};
+    unsigned char* c0p_[4] = {c0_[0], c0_[1], c0_[2], c0_[3]};
+    int j;
+#ifdef DO_VALGRIND_CHECK
+    for (j = 0; j < 4; j++)
+        VALGRIND_MAKE_MEM_UNDEFINED(sk[j], CRYPTO_SECRETKEYBYTES);
+#endif
+
+    // Decrypt
+    EphemeralSecretAgreement_B_x4(skB, ct, jinv_);
+    shake256x4(h_[0], h_[1], h_[2], h_[3], MSG_BYTES, jinvariant_[0], jinvariant_[1], jinvariant_[2], jinvariant_[3], FP2_ENCODED_BYTES);
+    for (j = 0; j < 4; j++) {
+        for (int i = 0; i < MSG_BYTES; i++) {
+            temp[j][i] = ct[j][i + CRYPTO_PUBLICKEYBYTES] ^ h_[j][i];
+        }
+
+        // Generate ephemeralsk_ <- G(m||pk) mod oA
+        memcpy(&temp[j][MSG_BYTES], &sk[j][MSG_BYTES + SECRETKEY_B_BYTES], CRYPTO_PUBLICKEYBYTES);
+    }
+    shake256x4(ephemeralsk_[0], ephemeralsk_[1], ephemeralsk_[2], ephemeralsk_[3], SECRETKEY_A_BYTES, temp[0], temp[1], temp[2], temp[3], CRYPTO_PUBLICKEYBYTES+MSG_BYTES);
+    for (j = 0; j < 4; j++) {
+        ephemeralsk_[j][SECRETKEY_A_BYTES - 1] &= MASK_ALICE;
+    }
+
+    // Generate shared secret ss <- H(m||ct), or output ss <- H(s||ct) in case of ct verification failure
+    EphemeralKeyGeneration_A_x4(ska_, c0p_);
+    for (j = 0; j < 4; j++) {
+        // If selector = 0 then do ss = H(m||ct), else if selector = -1 load s to do ss = H(s||ct)
+        int8_t selector = ct_compare(c0_[j], ct[j], CRYPTO_PUBLICKEYBYTES);
+        ct_cmov(temp[j], sk[j], MSG_BYTES, selector);
+        memcpy(&temp[j][MSG_BYTES], ct[j], CRYPTO_CIPHERTEXTBYTES);
+    }
+    shake256x4(ss[0], ss[1], ss[2], ss[3], CRYPTO_BYTES, temp[0], temp[1], temp[2], temp[3], CRYPTO_CIPHERTEXTBYTES+MSG_BYTES);
+
+#ifdef DO_VALGRIND_CHECK
+    for (j = 0; j < 4; j++)
+        VALGRIND_MAKE_MEM_DEFINED(sk[j], CRYPTO_SECRETKEYBYTES);
+#endif
+    return 0;
+}
+
+#endif
\ No newline at end of file
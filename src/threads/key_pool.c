@@ -0,0 +1,251 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: pool of ephemeral key pairs pre-generated by background threads
+*
+* The entries are stored in a bounded lock-free ring buffer with a sequence number per slot (D. Vyukov's multi-producer
+* multi-consumer queue): a producer or consumer claims a position with a compare-and-swap on the shared tail or head
+* counter, and the sequence number of the slot tells whether it holds an entry for that position. The threads sleep on a
+* condition variable while the pool is full and are woken up by the consumers that find them waiting.
+*********************************************************************************************/
+
+#include "key_pool.h"
+#include "../config.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE_BYTES    64
+
+
+typedef struct {
+    atomic_size_t seq;                      // Position + 1 when the slot holds the entry of that position, position otherwise
+    unsigned char* entry;
+} slot_t;
+
+struct key_pool {
+    _Alignas(CACHE_LINE_BYTES) atomic_size_t tail;         // Next position to be filled
+    _Alignas(CACHE_LINE_BYTES) atomic_size_t head;         // Next position to be consumed
+    _Alignas(CACHE_LINE_BYTES) slot_t* slots;
+    size_t mask;
+    unsigned int entry_bytes;
+    unsigned char* storage;
+    key_pool_generate_t generate;
+    pthread_t* threads;
+    unsigned int nthreads;
+    unsigned int generation;                // Fork generation in which the pool was created
+    atomic_int stop;
+    atomic_int waiting;                     // Number of threads sleeping because the pool is full
+    pthread_mutex_t lock;
+    pthread_cond_t wakeup;
+};
+
+
+static atomic_uint fork_generation;
+static pthread_once_t atfork_once = PTHREAD_ONCE_INIT;
+
+
+static void count_fork(void)
+{ // The background threads do not exist in a child process, whose pools must not hand out the parent's keys
+    atomic_fetch_add(&fork_generation, 1);
+}
+
+
+static void register_atfork(void)
+{
+    pthread_atfork(NULL, NULL, count_fork);
+}
+
+
+static void clear_bytes(unsigned char* p, size_t nbytes)
+{ // Erasure of key material that is not optimized away
+    volatile unsigned char* v = p;
+
+    while (nbytes--) {
+        *v++ = 0;
+    }
+}
+
+
+static int push(key_pool_t* pool, const unsigned char* entry)
+{ // Adds an entry to the pool. Returns 0 if the pool is full.
+    size_t pos = atomic_load_explicit(&pool->tail, memory_order_relaxed), seq;
+    slot_t* slot;
+
+    for (;;) {
+        slot = &pool->slots[pos & pool->mask];
+        seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq == pos) {
+            if (atomic_compare_exchange_weak_explicit(&pool->tail, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if ((ptrdiff_t)(seq - pos) < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&pool->tail, memory_order_relaxed);
+        }
+    }
+    memcpy(slot->entry, entry, pool->entry_bytes);
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return 1;
+}
+
+
+int key_pool_pop(key_pool_t* pool, unsigned char* entry, const unsigned int split, unsigned char* rest)
+{
+    size_t pos, seq;
+    slot_t* slot;
+
+    if (pool == NULL || pool->generation != atomic_load(&fork_generation)) {
+        return 0;
+    }
+
+    pos = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    for (;;) {
+        slot = &pool->slots[pos & pool->mask];
+        seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq == pos + 1) {
+            if (atomic_compare_exchange_weak_explicit(&pool->head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if ((ptrdiff_t)(seq - (pos + 1)) < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&pool->head, memory_order_relaxed);
+        }
+    }
+    memcpy(entry, slot->entry, split);
+    memcpy(rest, slot->entry + split, pool->entry_bytes - split);
+    clear_bytes(slot->entry, pool->entry_bytes);
+    atomic_store_explicit(&slot->seq, pos + pool->mask + 1, memory_order_release);
+
+    atomic_thread_fence(memory_order_seq_cst);          // Orders the update of head before the load of waiting, see producer_main()
+    if (atomic_load(&pool->waiting) > 0) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_signal(&pool->wakeup);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return 1;
+}
+
+
+static int is_full(key_pool_t* pool)
+{
+    return atomic_load(&pool->tail) - atomic_load(&pool->head) > pool->mask;
+}
+
+
+static void* producer_main(void* param)
+{ // Background thread: generates entries while the pool is not full
+    key_pool_t* pool = (key_pool_t*)param;
+    unsigned char* entry = (unsigned char*)malloc(pool->entry_bytes);
+    int pending = 0;
+
+    if (entry == NULL) {
+        return NULL;
+    }
+    while (!atomic_load(&pool->stop)) {
+        if (!pending) {
+            pool->generate(entry);
+            pending = 1;
+        }
+        if (push(pool, entry)) {
+            pending = 0;
+            continue;
+        }
+        pthread_mutex_lock(&pool->lock);
+        atomic_fetch_add(&pool->waiting, 1);            // Set before testing the pool, so that a consumer emptying a slot sees it
+        while (!atomic_load(&pool->stop) && is_full(pool)) {
+            pthread_cond_wait(&pool->wakeup, &pool->lock);
+        }
+        atomic_fetch_sub(&pool->waiting, 1);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    clear_bytes(entry, pool->entry_bytes);
+    free(entry);
+    return NULL;
+}
+
+
+key_pool_t* key_pool_create(const unsigned int capacity, const unsigned int entry_bytes, const unsigned int nthreads, key_pool_generate_t generate)
+{
+    key_pool_t* pool;
+    size_t i, n = 1;
+
+    if (capacity == 0 || entry_bytes == 0 || nthreads == 0) {
+        return NULL;
+    }
+    while (n < capacity) {
+        n <<= 1;
+    }
+    pthread_once(&atfork_once, register_atfork);
+
+    pool = (key_pool_t*)calloc(1, sizeof(key_pool_t));
+    if (pool == NULL) {
+        return NULL;
+    }
+    pool->slots = (slot_t*)calloc(n, sizeof(slot_t));
+    pool->storage = (unsigned char*)calloc(n, entry_bytes);
+    pool->threads = (pthread_t*)calloc(nthreads, sizeof(pthread_t));
+    if (pool->slots == NULL || pool->storage == NULL || pool->threads == NULL) {
+        free(pool->slots);
+        free(pool->storage);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+    for (i = 0; i < n; i++) {
+        atomic_init(&pool->slots[i].seq, i);
+        pool->slots[i].entry = pool->storage + i*entry_bytes;
+    }
+    atomic_init(&pool->tail, 0);
+    atomic_init(&pool->head, 0);
+    atomic_init(&pool->stop, 0);
+    atomic_init(&pool->waiting, 0);
+    pool->mask = n - 1;
+    pool->entry_bytes = entry_bytes;
+    pool->generate = generate;
+    pool->generation = atomic_load(&fork_generation);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wakeup, NULL);
+
+    for (pool->nthreads = 0; pool->nthreads < nthreads; pool->nthreads++) {
+        if (pthread_create(&pool->threads[pool->nthreads], NULL, producer_main, pool) != 0) {
+            break;
+        }
+    }
+    if (pool->nthreads == 0) {
+        key_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+
+void key_pool_destroy(key_pool_t* pool)
+{
+    unsigned int i;
+
+    if (pool == NULL) {
+        return;
+    }
+    if (pool->generation == atomic_load(&fork_generation)) {    // In a child process the threads and the state of the lock are gone
+        pthread_mutex_lock(&pool->lock);
+        atomic_store(&pool->stop, 1);
+        pthread_cond_broadcast(&pool->wakeup);
+        pthread_mutex_unlock(&pool->lock);
+        for (i = 0; i < pool->nthreads; i++) {
+            pthread_join(pool->threads[i], NULL);
+        }
+        pthread_mutex_destroy(&pool->lock);
+        pthread_cond_destroy(&pool->wakeup);
+    }
+
+    clear_bytes(pool->storage, (pool->mask + 1)*pool->entry_bytes);
+    free(pool->slots);
+    free(pool->storage);
+    free(pool->threads);
+    free(pool);
+}
@@ -0,0 +1,30 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: pool of ephemeral key pairs pre-generated by background threads
+*********************************************************************************************/
+
+#ifndef KEY_POOL_H
+#define KEY_POOL_H
+
+
+// Generates one entry of the pool, e.g., a private key followed by the corresponding public key
+typedef void (*key_pool_generate_t)(unsigned char* entry);
+
+typedef struct key_pool key_pool_t;
+
+
+// Creates a pool holding up to capacity entries of entry_bytes bytes, where capacity is rounded up to a power of 2, 
+// and starts nthreads threads that keep it filled with entries produced by generate. Returns NULL on failure.
+key_pool_t* key_pool_create(const unsigned int capacity, const unsigned int entry_bytes, const unsigned int nthreads, key_pool_generate_t generate);
+
+// Removes an entry from the pool, copies its first split bytes to entry and the remaining bytes to rest, and erases the slot.
+// No other copy of the entry is made. It is lock-free and can be called by any number of threads.
+// Returns 0 if the pool is empty, or in a child process after fork() since the parent holds the same entries.
+int key_pool_pop(key_pool_t* pool, unsigned char* entry, const unsigned int split, unsigned char* rest);
+
+// Stops the threads, erases the remaining entries and releases the pool. It must not run concurrently with key_pool_pop().
+void key_pool_destroy(key_pool_t* pool);
+
+
+#endif
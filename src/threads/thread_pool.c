@@ -0,0 +1,213 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: persistent worker pool used by the parallel isogeny tree traversal
+*
+* Tasks are handed off through an epoch counter: thread_pool_run() publishes the task and increments the epoch,
+* and every worker publishes the epoch of the last task it completed. While the pool is reserved the workers
+* spin on the epoch, so that a handoff costs a few cache-line transfers. Otherwise they sleep on a condition variable.
+*********************************************************************************************/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE                     // sched_getaffinity() and CPU_COUNT()
+#endif
+
+#include "thread_pool.h"
+#include "../config.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define CACHE_LINE_BYTES    64
+#define SPINS_BEFORE_YIELD  1024        // Busy-wait iterations before yielding the CPU, for oversubscribed machines
+
+
+static struct {
+    pthread_mutex_t lock;                   // Protects the initialization and the sleeping state of the workers
+    pthread_cond_t wakeup;
+    pthread_mutex_t owner;                  // Held by the thread that reserved the pool
+    int initialized;
+    unsigned int nworkers;
+    atomic_int active;                      // Set while the pool is reserved
+    atomic_uint epoch;                      // Number of tasks published
+    thread_pool_task_t task;
+    void* arg;
+    struct {
+        atomic_uint epoch;                  // Epoch of the last task completed by the worker
+        char padding[CACHE_LINE_BYTES - sizeof(atomic_uint)];
+    } done[THREAD_POOL_WORKERS];
+} pool = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_MUTEX_INITIALIZER };
+
+
+static __inline void cpu_relax(unsigned int* spins)
+{
+    if (++*spins % SPINS_BEFORE_YIELD == 0) {
+        sched_yield();
+        return;
+    }
+#if (TARGET == TARGET_AMD64 || TARGET == TARGET_x86) && (COMPILER == COMPILER_GCC || COMPILER == COMPILER_CLANG)
+    __builtin_ia32_pause();
+#elif (TARGET == TARGET_ARM64) && (COMPILER == COMPILER_GCC || COMPILER == COMPILER_CLANG)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+
+static void* worker_main(void* param)
+{
+    const unsigned int worker = (unsigned int)(uintptr_t)param;
+    unsigned int seen = 0, epoch, spins = 0;
+
+    for (;;) {
+        epoch = atomic_load_explicit(&pool.epoch, memory_order_acquire);
+        if (epoch != seen) {
+            seen = epoch;
+            pool.task(pool.arg, worker, pool.nworkers);
+            atomic_store_explicit(&pool.done[worker].epoch, epoch, memory_order_release);
+        } else if (atomic_load_explicit(&pool.active, memory_order_relaxed)) {
+            cpu_relax(&spins);
+        } else {
+            pthread_mutex_lock(&pool.lock);
+            while (!atomic_load(&pool.active) && atomic_load(&pool.epoch) == seen) {
+                pthread_cond_wait(&pool.wakeup, &pool.lock);
+            }
+            pthread_mutex_unlock(&pool.lock);
+        }
+    }
+    return NULL;
+}
+
+
+static void disable_after_fork(void)
+{ // The workers do not exist in a child process, which then uses the serial traversal
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_mutex_init(&pool.owner, NULL);
+    pthread_cond_init(&pool.wakeup, NULL);
+    pool.initialized = 1;
+    pool.nworkers = 0;
+}
+
+
+#if defined(__linux__)
+
+static int read_values(const char* path, long* value1, long* value2)
+{ // Reads one or two integers from a file. Returns the number of integers read
+    FILE* file = fopen(path, "r");
+    int n = 0;
+
+    if (file != NULL) {
+        n = (value2 != NULL) ? fscanf(file, "%ld %ld", value1, value2) : fscanf(file, "%ld", value1);
+        fclose(file);
+    }
+    return n;
+}
+
+#endif
+
+
+static long available_cpus(void)
+{ // Number of CPUs the process can use: the CPUs of its affinity mask, limited by the CPU quota of its cgroup (rounded up).
+  // The online CPUs of the machine are only used if the affinity mask is unavailable.
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+#if defined(__linux__)
+    cpu_set_t set;
+    long quota, period;
+
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        ncpus = CPU_COUNT(&set);
+    }
+    if (read_values("/sys/fs/cgroup/cpu.max", &quota, &period) != 2) {               // cgroup v2, "max <period>" without a quota
+        if (read_values("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", &quota, NULL) != 1 || // cgroup v1, -1 without a quota
+            read_values("/sys/fs/cgroup/cpu/cpu.cfs_period_us", &period, NULL) != 1) {
+            quota = 0;
+        }
+    }
+    if (quota > 0 && period > 0 && (quota + period - 1) / period < ncpus) {
+        ncpus = (quota + period - 1) / period;
+    }
+#endif
+    return ncpus;
+}
+
+
+static void initialize(void)
+{ // Starts min(THREAD_POOL_WORKERS, number of available CPUs - 1) workers, 
+  // further capped at run time by the environment variable SIDH_THREAD_POOL_WORKERS
+    pthread_t thread;
+    pthread_attr_t attr;
+    long ncpus = available_cpus();
+    const char* cap = getenv("SIDH_THREAD_POOL_WORKERS");
+    unsigned int i, n = THREAD_POOL_WORKERS;
+
+    pool.initialized = 1;
+    if (ncpus - 1 < (long)n) {
+        n = (ncpus > 1) ? (unsigned int)(ncpus - 1) : 0;
+    }
+    if (cap != NULL && *cap >= '0' && *cap <= '9' && strtol(cap, NULL, 10) < (long)n) {
+        n = (unsigned int)strtol(cap, NULL, 10);
+    }
+    if (n == 0 || pthread_attr_init(&attr) != 0) {
+        return;
+    }
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    for (i = 0; i < n; i++) {
+        if (pthread_create(&thread, &attr, worker_main, (void*)(uintptr_t)i) != 0) {
+            break;
+        }
+    }
+    pthread_attr_destroy(&attr);
+    pool.nworkers = i;
+    pthread_atfork(NULL, NULL, disable_after_fork);
+}
+
+
+int thread_pool_acquire(void)
+{
+    pthread_mutex_lock(&pool.lock);
+    if (!pool.initialized) {
+        initialize();
+    }
+    pthread_mutex_unlock(&pool.lock);
+
+    if (pool.nworkers == 0 || pthread_mutex_trylock(&pool.owner) != 0) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    atomic_store(&pool.active, 1);
+    pthread_cond_broadcast(&pool.wakeup);
+    pthread_mutex_unlock(&pool.lock);
+    return (int)pool.nworkers;
+}
+
+
+void thread_pool_run(thread_pool_task_t task, void* arg)
+{
+    pool.task = task;
+    pool.arg = arg;
+    atomic_fetch_add_explicit(&pool.epoch, 1, memory_order_release);
+}
+
+
+void thread_pool_wait(void)
+{
+    const unsigned int epoch = atomic_load_explicit(&pool.epoch, memory_order_relaxed);
+    unsigned int i, spins = 0;
+
+    for (i = 0; i < pool.nworkers; i++) {
+        while (atomic_load_explicit(&pool.done[i].epoch, memory_order_acquire) != epoch) {
+            cpu_relax(&spins);
+        }
+    }
+}
+
+
+void thread_pool_release(void)
+{
+    thread_pool_wait();
+    atomic_store(&pool.active, 0);
+    pthread_mutex_unlock(&pool.owner);
+}
@@ -0,0 +1,34 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: persistent worker pool used by the parallel isogeny tree traversal
+*********************************************************************************************/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+
+#if !defined(THREAD_POOL_WORKERS)
+    #define THREAD_POOL_WORKERS    2        // Maximum number of worker threads, in addition to the calling thread
+#endif
+
+// Task executed by every worker, where worker is in [0, nworkers-1]
+typedef void (*thread_pool_task_t)(void* arg, const unsigned int worker, const unsigned int nworkers);
+
+
+// Reserves the pool for the calling thread, starting the workers on first use. Returns the number of workers,
+// or 0 if the pool is unavailable (single available CPU, cap of 0 workers, thread creation failure, child process after fork) 
+// or already in use. The CPUs are counted from the affinity mask of the process and the CPU quota of its cgroup.
+int thread_pool_acquire(void);
+
+// Runs task(arg, worker, nworkers) on every worker and returns without waiting. The previous task must have completed.
+void thread_pool_run(thread_pool_task_t task, void* arg);
+
+// Waits until every worker has completed the last task
+void thread_pool_wait(void);
+
+// Waits for the last task and releases the pool
+void thread_pool_release(void);
+
+
+#endif
@@ -0,0 +1,32 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: benchmarking code for field arithmetic, elliptic curve and isogeny functions over GF(p434^2)
+*********************************************************************************************/
+
+#include "../src/config.h"
+#include "../src/P434/P434_internal.h"
+#include "../src/internal.h"
+#include "test_extras.h"
+
+
+#define PRIME_NAME               "p434"
+
+#define fprandom_test            fprandom434_test
+#define fp2random_test           fp2random434_test
+#define fpadd                    fpadd434
+#define fpsub                    fpsub434
+#define fpneg                    fpneg434
+#define fpdiv2                   fpdiv2_434
+#define fpcorrection             fpcorrection434
+#define fpmul_mont               fpmul434_mont
+#define fpsqr_mont               fpsqr434_mont
+#define fpinv_chain_mont         fpinv434_chain_mont
+#define fpinv_mont_safegcd       fpinv434_mont_safegcd
+#define fp2add                   fp2add434
+#define fp2sub                   fp2sub434
+#define fp2mul_mont              fp2mul434_mont
+#define fp2sqr_mont              fp2sqr434_mont
+#define fp2inv_mont              fp2inv434_mont
+
+#include "arith_bench.c"
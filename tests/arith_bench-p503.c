@@ -0,0 +1,32 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: benchmarking code for field arithmetic, elliptic curve and isogeny functions over GF(p503^2)
+*********************************************************************************************/
+
+#include "../src/config.h"
+#include "../src/P503/P503_internal.h"
+#include "../src/internal.h"
+#include "test_extras.h"
+
+
+#define PRIME_NAME               "p503"
+
+#define fprandom_test            fprandom503_test
+#define fp2random_test           fp2random503_test
+#define fpadd                    fpadd503
+#define fpsub                    fpsub503
+#define fpneg                    fpneg503
+#define fpdiv2                   fpdiv2_503
+#define fpcorrection             fpcorrection503
+#define fpmul_mont               fpmul503_mont
+#define fpsqr_mont               fpsqr503_mont
+#define fpinv_chain_mont         fpinv503_chain_mont
+#define fpinv_mont_safegcd       fpinv503_mont_safegcd
+#define fp2add                   fp2add503
+#define fp2sub                   fp2sub503
+#define fp2mul_mont              fp2mul503_mont
+#define fp2sqr_mont              fp2sqr503_mont
+#define fp2inv_mont              fp2inv503_mont
+
+#include "arith_bench.c"
@@ -0,0 +1,32 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: benchmarking code for field arithmetic, elliptic curve and isogeny functions over GF(p610^2)
+*********************************************************************************************/
+
+#include "../src/config.h"
+#include "../src/P610/P610_internal.h"
+#include "../src/internal.h"
+#include "test_extras.h"
+
+
+#define PRIME_NAME               "p610"
+
+#define fprandom_test            fprandom610_test
+#define fp2random_test           fp2random610_test
+#define fpadd                    fpadd610
+#define fpsub                    fpsub610
+#define fpneg                    fpneg610
+#define fpdiv2                   fpdiv2_610
+#define fpcorrection             fpcorrection610
+#define fpmul_mont               fpmul610_mont
+#define fpsqr_mont               fpsqr610_mont
+#define fpinv_chain_mont         fpinv610_chain_mont
+#define fpinv_mont_safegcd       fpinv610_mont_safegcd
+#define fp2add                   fp2add610
+#define fp2sub                   fp2sub610
+#define fp2mul_mont              fp2mul610_mont
+#define fp2sqr_mont              fp2sqr610_mont
+#define fp2inv_mont              fp2inv610_mont
+
+#include "arith_bench.c"
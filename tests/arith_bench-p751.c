@@ -0,0 +1,32 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: benchmarking code for field arithmetic, elliptic curve and isogeny functions over GF(p751^2)
+*********************************************************************************************/
+
+#include "../src/config.h"
+#include "../src/P751/P751_internal.h"
+#include "../src/internal.h"
+#include "test_extras.h"
+
+
+#define PRIME_NAME               "p751"
+
+#define fprandom_test            fprandom751_test
+#define fp2random_test           fp2random751_test
+#define fpadd                    fpadd751
+#define fpsub                    fpsub751
+#define fpneg                    fpneg751
+#define fpdiv2                   fpdiv2_751
+#define fpcorrection             fpcorrection751
+#define fpmul_mont               fpmul751_mont
+#define fpsqr_mont               fpsqr751_mont
+#define fpinv_chain_mont         fpinv751_chain_mont
+#define fpinv_mont_safegcd       fpinv751_mont_safegcd
+#define fp2add                   fp2add751
+#define fp2sub                   fp2sub751
+#define fp2mul_mont              fp2mul751_mont
+#define fp2sqr_mont              fp2sqr751_mont
+#define fp2inv_mont              fp2inv751_mont
+
+#include "arith_bench.c"
@@ -0,0 +1,259 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: benchmarking harness for the field arithmetic, elliptic curve and isogeny functions
+*
+* Every function is timed over a number of samples after a warm-up phase. A sample measures a batch of
+* consecutive calls and is normalized per call. The report gives the minimum, median and 99th percentile
+* of the samples, and the mean of the samples that remain after rejecting outliers above Q3 + 3*IQR.
+* Results are printed as a table and can additionally be written in CSV and JSON formats.
+*
+* Usage: arith_bench-pXXX [--samples N] [--csv FILE] [--json FILE]
+*********************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define BENCH_SAMPLES     1000      // Default number of samples per function
+#define BENCH_WARMUP        10      // Percentage of additional samples run and discarded before measuring
+#define BENCH_MAX_ENTRIES   64      // Maximum number of benchmarked functions
+
+#if defined(FP2_ASM_IMPLEMENTATION)
+    #define IMPLEMENTATION_NAME    "FAST (fused GF(p^2) squaring asm)"
+#elif defined(FAST_IMPLEMENTATION)
+    #define IMPLEMENTATION_NAME    "FAST"
+#elif defined(CXX_BACKEND_IMPLEMENTATION)
+    #define IMPLEMENTATION_NAME    "GENERIC (C++ backend)"
+#elif defined(REDUCED_RADIX_IMPLEMENTATION)
+    #define IMPLEMENTATION_NAME    "GENERIC (reduced radix)"
+#else
+    #define IMPLEMENTATION_NAME    "GENERIC"
+#endif
+
+#if (TARGET == TARGET_ARM || TARGET == TARGET_ARM64)
+    #define UNIT_NAME    "nsec"
+#else
+    #define UNIT_NAME    "cycles"
+#endif
+
+
+typedef struct {
+    const char* function;
+    const char* group;
+    unsigned int batch;
+    unsigned int samples;
+    double min;
+    double median;
+    double p99;
+    double mean;
+    unsigned int outliers;
+} bench_result_t;
+
+static bench_result_t results[BENCH_MAX_ENTRIES];
+static unsigned int nresults = 0;
+static double* samples;
+static unsigned int nsamples = BENCH_SAMPLES;
+
+
+static int compare_doubles(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+
+static void bench_record(const char* function, const char* group, unsigned int batch)
+{ // Computes the statistics of the current samples and stores them
+    bench_result_t* r = &results[nresults++];
+    double q1, q3, fence, sum = 0;
+    unsigned int i, kept = 0;
+
+    qsort(samples, nsamples, sizeof(double), compare_doubles);
+    q1 = samples[nsamples/4];
+    q3 = samples[(3*nsamples)/4];
+    fence = q3 + 3*(q3 - q1);
+    for (i = 0; i < nsamples; i++) {
+        if (samples[i] <= fence) {
+            sum += samples[i];
+            kept++;
+        }
+    }
+
+    r->function = function;
+    r->group = group;
+    r->batch = batch;
+    r->samples = nsamples;
+    r->min = samples[0];
+    r->median = (nsamples % 2 == 1) ? samples[nsamples/2] : (samples[nsamples/2-1] + samples[nsamples/2])/2;
+    r->p99 = samples[(99*nsamples + 99)/100 - 1];
+    r->mean = sum/kept;
+    r->outliers = nsamples - kept;
+
+    printf("  %-18s %-14s %12.1f %12.1f %12.1f %12.1f %9u\n", r->function, r->group, r->median, r->min, r->p99, r->mean, r->outliers);
+}
+
+
+// Runs "statement" batch times per sample, for nsamples samples after the warm-up, and records the result
+#define BENCH(function, group, batch, statement)                                      \
+    {                                                                                 \
+        unsigned int s_, k_, warmup_ = (nsamples*BENCH_WARMUP + 99)/100;              \
+        int64_t start_;                                                               \
+        for (s_ = 0; s_ < warmup_*(batch); s_++) {                                    \
+            statement;                                                                \
+        }                                                                             \
+        for (s_ = 0; s_ < nsamples; s_++) {                                           \
+            start_ = cpucycles();                                                     \
+            for (k_ = 0; k_ < (batch); k_++) {                                        \
+                statement;                                                            \
+            }                                                                         \
+            samples[s_] = (double)(cpucycles() - start_)/(batch);                     \
+        }                                                                             \
+        bench_record(function, group, batch);                                         \
+    }
+
+
+static void run_benchmarks(void)
+{
+    felm_t a, b;
+    dfelm_t aa;
+    f2elm_t a2, b2, vec[8], inv[8], scratch[8], coeff[3], A24, C24, jinv;
+    point_proj_t P, Q, R;
+    unsigned int i;
+
+    fprandom_test(a); fprandom_test(b);
+    fp2random_test((digit_t*)a2); fp2random_test((digit_t*)b2);
+    fp2random_test((digit_t*)A24); fp2random_test((digit_t*)C24);
+    fp2random_test((digit_t*)P->X); fp2random_test((digit_t*)P->Z);
+    fp2random_test((digit_t*)Q->X); fp2random_test((digit_t*)Q->Z);
+    fp2random_test((digit_t*)R->X); fp2random_test((digit_t*)R->Z);
+    for (i = 0; i < 3; i++) {
+        fp2random_test((digit_t*)coeff[i]);
+    }
+    for (i = 0; i < 8; i++) {
+        fp2random_test((digit_t*)vec[i]);
+    }
+    mp_mul(a, b, aa, NWORDS_FIELD);
+
+    // GF(p) arithmetic
+    BENCH("fpadd",              "GF(p)",   100, fpadd(a, b, a));
+    BENCH("fpsub",              "GF(p)",   100, fpsub(a, b, a));
+    BENCH("fpneg",              "GF(p)",   100, fpneg(a));
+    BENCH("fpdiv2",             "GF(p)",   100, fpdiv2(a, a));
+    BENCH("fpcorrection",       "GF(p)",   100, fpcorrection(a));
+    BENCH("mp_mul",             "GF(p)",   100, mp_mul(a, b, aa, NWORDS_FIELD));
+#if defined(MP_SQR_IMPLEMENTATION)
+    BENCH("mp_sqr",             "GF(p)",   100, mp_sqr(a, aa, NWORDS_FIELD));
+#endif
+    BENCH("rdc_mont",           "GF(p)",   100, rdc_mont(aa, a));
+    BENCH("fpmul_mont",         "GF(p)",   100, fpmul_mont(a, b, a));
+    BENCH("fpsqr_mont",         "GF(p)",   100, fpsqr_mont(a, a));
+    BENCH("fpinv_chain_mont",   "GF(p)",     1, fpinv_chain_mont(a));
+    BENCH("fpinv_mont_safegcd", "GF(p)",     1, fpinv_mont_safegcd(a));
+
+    // GF(p^2) arithmetic
+    BENCH("fp2add",             "GF(p^2)", 100, fp2add(a2, b2, a2));
+    BENCH("fp2sub",             "GF(p^2)", 100, fp2sub(a2, b2, a2));
+    BENCH("fp2mul_mont",        "GF(p^2)", 100, fp2mul_mont(a2, b2, a2));
+    BENCH("fp2sqr_mont",        "GF(p^2)", 100, fp2sqr_mont(a2, a2));
+    BENCH("fp2inv_mont",        "GF(p^2)",   1, fp2inv_mont(a2));
+    BENCH("fp2_batch_inv(8)",   "GF(p^2)",   1, fp2_batch_inv(vec, 8, inv, scratch));
+
+    // Elliptic curve and isogeny functions
+    BENCH("xDBL",               "curve",    10, xDBL(P, P, A24, C24));
+    BENCH("xDBLADD",            "curve",    10, xDBLADD(P, Q, R->X, R->Z, A24));
+    BENCH("xTPL",               "curve",    10, xTPL(P, P, A24, C24));
+    BENCH("xDBLe(2)",           "curve",    10, xDBLe(P, P, A24, C24, 2));
+    BENCH("xTPLe(1)",           "curve",    10, xTPLe(P, P, A24, C24, 1));
+    BENCH("get_4_isog",         "isogeny",  10, get_4_isog(P, A24, C24, coeff));
+    BENCH("eval_4_isog",        "isogeny",  10, eval_4_isog(Q, coeff));
+    BENCH("get_3_isog",         "isogeny",  10, get_3_isog(P, A24, C24, coeff));
+    BENCH("eval_3_isog",        "isogeny",  10, eval_3_isog(Q, coeff));
+    BENCH("j_inv",              "isogeny",   1, j_inv(A24, C24, jinv));
+}
+
+
+static int write_csv(const char* path)
+{
+    FILE* f = fopen(path, "w");
+    unsigned int i;
+
+    if (f == NULL) {
+        return 1;
+    }
+    fprintf(f, "prime,implementation,unit,function,group,batch,samples,min,median,p99,mean,outliers\n");
+    for (i = 0; i < nresults; i++) {
+        fprintf(f, "%s,%s,%s,%s,%s,%u,%u,%.1f,%.1f,%.1f,%.1f,%u\n", PRIME_NAME, IMPLEMENTATION_NAME, UNIT_NAME, results[i].function, results[i].group,
+                results[i].batch, results[i].samples, results[i].min, results[i].median, results[i].p99, results[i].mean, results[i].outliers);
+    }
+    fclose(f);
+    return 0;
+}
+
+
+static int write_json(const char* path)
+{
+    FILE* f = fopen(path, "w");
+    unsigned int i;
+
+    if (f == NULL) {
+        return 1;
+    }
+    fprintf(f, "{\n  \"prime\": \"%s\",\n  \"implementation\": \"%s\",\n  \"unit\": \"%s\",\n  \"results\": [\n", PRIME_NAME, IMPLEMENTATION_NAME, UNIT_NAME);
+    for (i = 0; i < nresults; i++) {
+        fprintf(f, "    {\"function\": \"%s\", \"group\": \"%s\", \"batch\": %u, \"samples\": %u, \"min\": %.1f, \"median\": %.1f, \"p99\": %.1f, \"mean\": %.1f, \"outliers\": %u}%s\n",
+                results[i].function, results[i].group, results[i].batch, results[i].samples, results[i].min, results[i].median, results[i].p99, results[i].mean,
+                results[i].outliers, (i+1 < nresults) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+    const char *csv = NULL, *json = NULL;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--samples") == 0 && i+1 < argc) {
+            nsamples = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--csv") == 0 && i+1 < argc) {
+            csv = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i+1 < argc) {
+            json = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--samples N] [--csv FILE] [--json FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (nsamples < 4) {
+        nsamples = 4;
+    }
+    samples = (double*)malloc(nsamples*sizeof(double));
+    if (samples == NULL) {
+        return 1;
+    }
+
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Benchmarking arithmetic, curve and isogeny functions over GF(%s^2), %s implementation: \n\n", PRIME_NAME, IMPLEMENTATION_NAME);
+    printf("  %u samples per function after %u%% warm-up, in %s per call\n\n", nsamples, BENCH_WARMUP, UNIT_NAME);
+    printf("  %-18s %-14s %12s %12s %12s %12s %9s\n", "function", "group", "median", "min", "p99", "mean", "outliers");
+
+    run_benchmarks();
+    free(samples);
+
+    if (csv != NULL && write_csv(csv) != 0) {
+        fprintf(stderr, "Cannot write %s\n", csv);
+        return 1;
+    }
+    if (json != NULL && write_json(json) != 0) {
+        fprintf(stderr, "Cannot write %s\n", json);
+        return 1;
+    }
+
+    return 0;
+}
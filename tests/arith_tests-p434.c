@@ -9,6 +9,13 @@
 #include "../src/internal.h"
 #include "test_extras.h"
 #include <stdio.h>
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+    #include "../src/cpu_features.h"
+
+// Variants of the squaring kernel, of which the library binds one at load time
+void sqr434_asm_adx(const digit_t* a, digit_t* c);
+void sqr434_asm_mulx(const digit_t* a, digit_t* c);
+#endif
 
 
 // Benchmark and test parameters  
@@ -22,12 +29,23 @@
     #define TEST_LOOPS            100   
 #endif
 
+// Public generators and precomputed tables of the fixed-base key generation
+extern const uint64_t A_gen[6*NWORDS64_FIELD];
+extern const uint64_t B_gen[6*NWORDS64_FIELD];
+extern const uint64_t A_fixed_base[OALICE_BITS*2*NWORDS64_FIELD];
+extern const uint64_t B_fixed_base[(OBOB_BITS-1)*NWORDS64_FIELD];
+
 
 bool fp_test()
 { // Tests for the field arithmetic
     bool OK = true;
     int n, passed;
+    unsigned int i;
     felm_t a, b, c, d, e, f, ma, mb, mc, md, me, mf;
+    dfelm_t tt1, tt2;
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+    const unsigned int features = cpu_features();
+#endif
 
     printf("\n--------------------------------------------------------------------------------------------------------\n\n"); 
     printf("Testing field arithmetic over GF(p434): \n\n"); 
@@ -159,10 +177,35 @@ bool fp_test()
         fpmul434_mont(ma, ma, mc);                             // c = a*a 
         if (compare_words(mb, mc, NWORDS_FIELD)!=0) { passed=0; break; }
 
+#if defined(MP_SQR_IMPLEMENTATION)
+        fprandom434_test(b);
+        mp_add(a, b, c, NWORDS_FIELD);                          // c in [0, 2*p434-2], the input range of fpsqr434_mont
+        mp_sqr(c, tt1, NWORDS_FIELD);                           // tt1 = c^2
+        mp_mul(c, c, tt2, NWORDS_FIELD);                        // tt2 = c*c
+        if (compare_words(tt1, tt2, 2*NWORDS_FIELD)!=0) { passed=0; break; }
+#if (OS_TARGET == OS_NIX) && defined(_CPU_DISPATCH_)
+        if ((features & CPU_FEATURE_MULX) && (features & CPU_FEATURE_ADX)) {
+            sqr434_asm_adx(c, tt1);
+            if (compare_words(tt1, tt2, 2*NWORDS_FIELD)!=0) { passed=0; break; }
+        }
+        if (features & CPU_FEATURE_MULX) {
+            sqr434_asm_mulx(c, tt1);
+            if (compare_words(tt1, tt2, 2*NWORDS_FIELD)!=0) { passed=0; break; }
+        }
+#endif
+#endif
+
         fpzero434(a); to_mont(a, ma);
         fpsqr434_mont(ma, md);                                 // d = 0^2 
         if (compare_words(ma, md, NWORDS_FIELD)!=0) { passed=0; break; }
     }
+#if defined(MP_SQR_IMPLEMENTATION)
+    for (i = 0; i < NWORDS_FIELD; i++) a[i] = (digit_t)-1;
+    a[NWORDS_FIELD-1] >>= (MAXBITS_FIELD-NBITS_FIELD);
+    mp_sqr(a, tt1, NWORDS_FIELD);                               // tt1 = a^2, where a = 2^NBITS_FIELD-1
+    mp_mul(a, a, tt2, NWORDS_FIELD);                            // tt2 = a*a
+    if (compare_words(tt1, tt2, 2*NWORDS_FIELD)!=0) passed=0;
+#endif
     if (passed==1) printf("  GF(p) squaring tests............................................. PASSED");
     else { printf("  GF(p) squaring tests... FAILED"); printf("\n"); return false; }
     printf("\n");
@@ -182,6 +225,25 @@ bool fp_test()
     if (passed==1) printf("  GF(p) inversion tests............................................ PASSED");
     else { printf("  GF(p) inversion tests... FAILED"); printf("\n"); return false; }
     printf("\n");
+
+    // Constant-time field inversion over the prime p434
+    passed = 1;
+    for (n=0; n<TEST_LOOPS; n++)
+    {
+        fprandom434_test(a); 
+        to_mont(a, ma);
+        fpcopy434(ma, mb);                            
+        fpinv434_mont(ma);                                     // a^-1 via exponentiation
+        fpinv434_mont_safegcd(mb);                             // a^-1 via safegcd
+        fpcorrection434(ma);
+        if (compare_words(ma, mb, NWORDS_FIELD)!=0) { passed=0; break; }
+    }
+    fpzero434(ma); fpzero434(md);
+    fpinv434_mont_safegcd(ma);                                 // 0^-1 = 0
+    if (compare_words(ma, md, NWORDS_FIELD)!=0) passed=0;
+    if (passed==1) printf("  GF(p) inversion tests (safegcd).................................. PASSED");
+    else { printf("  GF(p) inversion tests (safegcd)... FAILED"); printf("\n"); return false; }
+    printf("\n");
     
     return OK;
 }
@@ -191,7 +253,8 @@ bool fp2_test()
 { // Tests for the quadratic extension field arithmetic
     bool OK = true;
     int n, passed;
-    f2elm_t a, b, c, d, e, f, ma, mb, mc, md, me, mf;
+    f2elm_t a, b, c, d, e, f, ma, mb, mc, md, me, mf, vec[8], inv[8], scratch[8];
+    unsigned int i;
 
     printf("\n--------------------------------------------------------------------------------------------------------\n\n"); 
     printf("Testing quadratic extension arithmetic over GF(p434^2): \n\n"); 
@@ -339,11 +402,105 @@ bool fp2_test()
     if (passed==1) printf("  GF(p^2) inversion tests.......................................... PASSED");
     else { printf("  GF(p^2) inversion tests... FAILED"); printf("\n"); return false; }
     printf("\n");
+
+    // Simultaneous inversion over GF(p434^2)
+    passed = 1;
+    for (n=0; n<TEST_LOOPS; n++)
+    {
+        for (i = 0; i < 8; i++) {
+            fp2random434_test((digit_t*)a);
+            to_fp2mont(a, vec[i]);
+            fp2copy434(vec[i], inv[i]);
+        }
+        fp2_batch_inv(vec, 8, vec, scratch);                    // In-place inversion
+        for (i = 0; i < 8; i++) {
+            fp2inv434_mont(inv[i]);
+            fp2correction434(inv[i]); fp2correction434(vec[i]);
+            if (compare_words((digit_t*)inv[i], (digit_t*)vec[i], 2*NWORDS_FIELD)!=0) { passed=0; break; }
+        }
+        if (passed==0) break;
+    }
+    if (passed==1) printf("  GF(p^2) simultaneous inversion tests............................. PASSED");
+    else { printf("  GF(p^2) simultaneous inversion tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Simultaneous inversion of independent elements over GF(p434^2), where one of the elements is zero
+    passed = 1;
+    for (n=0; n<TEST_LOOPS; n++)
+    {
+        for (i = 0; i < 8; i++) {
+            fp2random434_test((digit_t*)a);
+            to_fp2mont(a, vec[i]);
+        }
+        fp2zero434(vec[n % 8]);
+        fp2_batch_inv_masked(vec, 8, inv, scratch);
+        for (i = 0; i < 8; i++) {
+            fp2inv434_mont(vec[i]);                             // The inverse of zero is zero
+            fp2correction434(inv[i]); fp2correction434(vec[i]);
+            if (compare_words((digit_t*)inv[i], (digit_t*)vec[i], 2*NWORDS_FIELD)!=0) { passed=0; break; }
+        }
+        if (passed==0) break;
+    }
+    if (passed==1) printf("  GF(p^2) masked simultaneous inversion tests...................... PASSED");
+    else { printf("  GF(p^2) masked simultaneous inversion tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
     
     return OK;
 }
 
 
+static bool fixed_base_check(const digit_t* gen, const digit_t* table, const unsigned int n, const unsigned int in_fp)
+{ // Recomputes x([2^i]Q), i = 0,...,n-1, by repeated doubling from the generator x(Q) in gen, on the starting curve E0: y^2 = x^3 + 6x^2 + x,
+  // and compares the affine x-coordinates with table, whose entries are in GF(p) if in_fp = 1 and in GF(p^2) otherwise
+    felm_t a = {0};
+    f2elm_t A24plus = {0}, C24 = {0}, x, t;
+    point_proj_t Q = {0};
+    unsigned int i;
+
+    a[0] = 8; to_mont(a, A24plus[0]);                           // A24plus = A+2C = 8, where A=6, C=1
+    a[0] = 4; to_mont(a, C24[0]);                               // C24 = 4C = 4
+    a[0] = 1; to_mont(a, Q->Z[0]);
+    fpcopy434(gen + 2*NWORDS_FIELD, Q->X[0]);
+    fpcopy434(gen + 3*NWORDS_FIELD, Q->X[1]);
+
+    for (i = 0; i < n; i++) {
+        fp2copy434(Q->Z, t);
+        fp2inv434_mont(t);
+        fp2mul434_mont(Q->X, t, x);                                // x = x([2^i]Q)
+        fp2correction434(x);
+        if (in_fp == 1) {
+            fpcopy434(table + i*NWORDS_FIELD, t[0]);
+            fpzero434(t[1]);
+        } else {
+            fpcopy434(table + 2*i*NWORDS_FIELD, t[0]);
+            fpcopy434(table + (2*i+1)*NWORDS_FIELD, t[1]);
+        }
+        fp2correction434(t);
+        if (compare_words((digit_t*)x, (digit_t*)t, 2*NWORDS_FIELD)!=0) return false;
+        xDBL(Q, Q, A24plus, C24);
+    }
+    return true;
+}
+
+
+bool fixed_base_test()
+{ // Tests for the precomputed tables of the fixed-base key generation
+    bool OK = true;
+    int passed = 1;
+
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n"); 
+    printf("Testing precomputed tables of the fixed-base key generation over GF(p434^2): \n\n"); 
+
+    if (!fixed_base_check((digit_t*)&A_gen, (digit_t*)&A_fixed_base, OALICE_BITS, 0)) passed=0;      // x([2^i]QA), i = 0,...,eA-1
+    if (!fixed_base_check((digit_t*)&B_gen, (digit_t*)&B_fixed_base, OBOB_BITS-1, 1)) passed=0;      // x([2^i]QB), i = 0,...,OBOB_BITS-2
+    if (passed==1) printf("  Fixed-base table tests .......................................... PASSED");
+    else { printf("  Fixed-base table tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    return OK;
+}
+
+
 bool fp_run()
 {
     bool OK = true;
@@ -393,6 +550,18 @@ bool fp_run()
     printf("  GF(p) multiplication runs in .................................... %7lld ", cycles/BENCH_LOOPS); print_unit;
     printf("\n");
 
+    // GF(p) squaring using p434
+    cycles = 0;
+    for (n=0; n<BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles(); 
+        fpsqr434_mont(a, c);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  GF(p) squaring runs in .......................................... %7lld ", cycles/BENCH_LOOPS); print_unit;
+    printf("\n");
+
     // GF(p) reduction using p434
     cycles = 0;
     for (n=0; n<BENCH_LOOPS; n++)
@@ -418,6 +587,18 @@ bool fp_run()
     }
     printf("  GF(p) inversion (exponentiation) runs in ........................ %7lld ", cycles/SMALL_BENCH_LOOPS); print_unit;
     printf("\n"); 
+
+    // GF(p) inversion using safegcd
+    cycles = 0;
+    for (n=0; n<SMALL_BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles(); 
+        fpinv434_mont_safegcd(a);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  GF(p) inversion (safegcd) runs in ............................... %7lld ", cycles/SMALL_BENCH_LOOPS); print_unit;
+    printf("\n"); 
     
     return OK;
 }
@@ -492,7 +673,7 @@ bool fp2_run()
         cycles2 = cpucycles();
         cycles = cycles+(cycles2-cycles1);
     }
-    printf("  GF(p^2) inversion (exponentiation) runs in ...................... %7lld ", cycles/SMALL_BENCH_LOOPS); print_unit;
+    printf("  GF(p^2) inversion (safegcd) runs in ............................. %7lld ", cycles/SMALL_BENCH_LOOPS); print_unit;
     printf("\n");
     
     return OK;
@@ -605,6 +786,8 @@ int main()
 
     OK = OK && fp2_test();         // Test arithmetic functions over GF(p434^2)
     OK = OK && fp2_run();          // Benchmark arithmetic functions over GF(p434^2)
+
+    OK = OK && fixed_base_test();  // Test the precomputed tables of the fixed-base key generation
     
     OK = OK && ecisog_run();       // Benchmark elliptic curve and isogeny functions
 
@@ -0,0 +1,17 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: generation of optimal isogeny tree traversal strategies for SIDHp434
+*********************************************************************************************/
+
+#include "../src/config.h"
+#include "../src/P434/P434_internal.h"
+#include "../src/internal.h"
+#include "test_extras.h"
+
+
+#define PRIME_NAME        "p434"
+
+#define fp2random_test    fp2random434_test
+
+#include "strategy_gen.c"
@@ -0,0 +1,210 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny cryptography library
+*
+* Abstract: generation of optimal strategies for the isogeny tree traversal from measured costs
+*
+* The costs of one step of point multiplication (xDBLe with e = 2 for Alice, xTPL for Bob) and of one isogeny
+* evaluation (eval_4_isog, eval_3_isog) are measured on the target machine. Optimal strategies for these costs
+* are computed with the usual dynamic program, S(n) = [b] | S(n-b) | S(b) minimizing C(b) + C(n-b) + b*p + (n-b)*q,
+* which gives the splits in the order consumed by the traversal loops in sidh.c. The result is written as a header
+* containing the strategies and the maximum number of intermediate points, which is used by the uncompressed variants
+* when the library is built with USE_TUNED_STRATEGIES=TRUE (the compressed encodings depend on the traversal).
+*
+* Usage: strategy_gen-pXXX [header file]
+*********************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define STRATEGY_SAMPLES    1001      // Number of samples per measurement (the median is used)
+#define STRATEGY_BATCH        10      // Number of calls per sample
+
+#if defined(FP2_ASM_IMPLEMENTATION)
+    #define IMPLEMENTATION_NAME    "FAST (fused GF(p^2) squaring asm)"
+#elif defined(FAST_IMPLEMENTATION)
+    #define IMPLEMENTATION_NAME    "FAST"
+#elif defined(CXX_BACKEND_IMPLEMENTATION)
+    #define IMPLEMENTATION_NAME    "GENERIC (C++ backend)"
+#elif defined(REDUCED_RADIX_IMPLEMENTATION)
+    #define IMPLEMENTATION_NAME    "GENERIC (reduced radix)"
+#else
+    #define IMPLEMENTATION_NAME    "GENERIC"
+#endif
+
+#define MAX_LEAVES    ((MAX_Alice > MAX_Bob) ? MAX_Alice : MAX_Bob)
+
+extern const unsigned int strat_Alice[MAX_Alice-1];
+extern const unsigned int strat_Bob[MAX_Bob-1];
+
+static double samples[STRATEGY_SAMPLES];
+
+
+static int compare_doubles(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+
+// Returns the median cost per call of "statement"
+#define MEASURE(result, statement)                                                    \
+    {                                                                                 \
+        unsigned int s_, k_;                                                          \
+        int64_t start_;                                                               \
+        for (s_ = 0; s_ < STRATEGY_SAMPLES/10*STRATEGY_BATCH; s_++) {                 \
+            statement;                                                                \
+        }                                                                             \
+        for (s_ = 0; s_ < STRATEGY_SAMPLES; s_++) {                                   \
+            start_ = cpucycles();                                                     \
+            for (k_ = 0; k_ < STRATEGY_BATCH; k_++) {                                 \
+                statement;                                                            \
+            }                                                                         \
+            samples[s_] = (double)(cpucycles() - start_)/STRATEGY_BATCH;              \
+        }                                                                             \
+        qsort(samples, STRATEGY_SAMPLES, sizeof(double), compare_doubles);            \
+        result = samples[STRATEGY_SAMPLES/2];                                         \
+    }
+
+
+static void optimal_strategy(const unsigned int n, const double p, const double q, unsigned int* strat)
+{ // Computes an optimal strategy for a tree with n leaves, where p is the cost of one multiplication step and q the cost of one isogeny evaluation.
+  // Output: the n-1 splits in the order in which they are consumed by the tree traversal.
+    static double C[MAX_LEAVES+1];
+    static unsigned int S[MAX_LEAVES+1][MAX_LEAVES];
+    unsigned int i, b, best;
+    double cost;
+
+    C[1] = 0;
+    for (i = 2; i <= n; i++) {
+        best = 1;
+        C[i] = C[i-1] + C[1] + p + (i-1)*q;
+        for (b = 2; b < i; b++) {
+            cost = C[i-b] + C[b] + b*p + (i-b)*q;
+            if (cost < C[i]) {
+                C[i] = cost;
+                best = b;
+            }
+        }
+        S[i][0] = best;
+        memcpy(&S[i][1], S[i-best], (i-best-1)*sizeof(unsigned int));
+        memcpy(&S[i][i-best], S[best], (best-1)*sizeof(unsigned int));
+    }
+    memcpy(strat, S[n], (n-1)*sizeof(unsigned int));
+}
+
+
+static int traverse(const unsigned int n, const unsigned int* strat, unsigned int* muls, unsigned int* evals, unsigned int* max_pts)
+{ // Replays the tree traversal of sidh.c for a strategy, counting multiplication steps, isogeny evaluations of intermediate points
+  // and the maximum number of intermediate points. Returns 0 if the strategy is not valid.
+    unsigned int row, m, index = 0, npts = 0, ii = 0, pts_index[MAX_LEAVES];
+
+    *muls = *evals = *max_pts = 0;
+    for (row = 1; row < n; row++) {
+        while (index < n-row) {
+            if (ii == n-1) {
+                return 0;
+            }
+            pts_index[npts++] = index;
+            m = strat[ii++];
+            if (m == 0) {
+                return 0;
+            }
+            *muls += m;
+            index += m;
+        }
+        if (npts == 0) {
+            return 0;
+        }
+        if (npts > *max_pts) {
+            *max_pts = npts;
+        }
+        *evals += npts;
+        index = pts_index[npts-1];
+        npts -= 1;
+    }
+    return (ii == n-1);
+}
+
+
+static void print_strategy(FILE* f, const char* name, const unsigned int n, const unsigned int* strat)
+{
+    unsigned int i;
+
+    fprintf(f, "#define %s    { \\\n", name);
+    for (i = 0; i < n-1; i++) {
+        fprintf(f, "%u%s", strat[i], (i+1 < n-1) ? ", " : " }\n");
+        if ((i+1) % 46 == 0 && i+1 < n-1) {
+            fprintf(f, "\\\n");
+        }
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    f2elm_t A24plus, C24, coeff[3];
+    point_proj_t P, Q;
+    unsigned int strat_A[MAX_Alice-1], strat_B[MAX_Bob-1], muls, evals, pts_A, pts_B, pts_A0, pts_B0;
+    double pA, qA, pB, qB, cost_A, cost_B, cost_A0, cost_B0;
+    FILE* f;
+    int i;
+
+    fp2random_test((digit_t*)A24plus); fp2random_test((digit_t*)C24);
+    fp2random_test((digit_t*)P->X); fp2random_test((digit_t*)P->Z);
+    fp2random_test((digit_t*)Q->X); fp2random_test((digit_t*)Q->Z);
+    for (i = 0; i < 3; i++) {
+        fp2random_test((digit_t*)coeff[i]);
+    }
+
+    MEASURE(pA, xDBLe(P, P, A24plus, C24, 2));
+    MEASURE(qA, eval_4_isog(Q, coeff));
+    MEASURE(pB, xTPL(P, P, A24plus, C24));
+    MEASURE(qB, eval_3_isog(Q, coeff));
+
+    optimal_strategy(MAX_Alice, pA, qA, strat_A);
+    optimal_strategy(MAX_Bob, pB, qB, strat_B);
+    if (!traverse(MAX_Alice, strat_A, &muls, &evals, &pts_A)) {
+        printf("Invalid strategy for Alice\n");
+        return 1;
+    }
+    cost_A = muls*pA + evals*qA;
+    if (!traverse(MAX_Bob, strat_B, &muls, &evals, &pts_B)) {
+        printf("Invalid strategy for Bob\n");
+        return 1;
+    }
+    cost_B = muls*pB + evals*qB;
+    traverse(MAX_Alice, strat_Alice, &muls, &evals, &pts_A0);
+    cost_A0 = muls*pA + evals*qA;
+    traverse(MAX_Bob, strat_Bob, &muls, &evals, &pts_B0);
+    cost_B0 = muls*pB + evals*qB;
+
+    printf("\nStrategies for SIDH%s, %s implementation: \n\n", PRIME_NAME, IMPLEMENTATION_NAME);
+    printf("  Alice: xDBLe(2) = %.0f, eval_4_isog = %.0f cycles, traversal cost %.0f with %u intermediate points (current strategy %.0f with %u)\n", pA, qA, cost_A, pts_A, cost_A0, pts_A0);
+    printf("  Bob:   xTPL = %.0f, eval_3_isog = %.0f cycles, traversal cost %.0f with %u intermediate points (current strategy %.0f with %u)\n", pB, qB, cost_B, pts_B, cost_B0, pts_B0);
+
+    if (argc < 2) {
+        return 0;
+    }
+    f = fopen(argv[1], "w");
+    if (f == NULL) {
+        printf("Cannot write %s\n", argv[1]);
+        return 1;
+    }
+    fprintf(f, "/********************************************************************************************\n");
+    fprintf(f, "* SIDH: an efficient supersingular isogeny cryptography library\n*\n");
+    fprintf(f, "* Abstract: isogeny tree traversal strategies for SIDH%s tuned on the target machine\n", PRIME_NAME);
+    fprintf(f, "*\n* Generated by strategy_gen-%s (make strategies) for the %s implementation, with costs in cycles\n", PRIME_NAME, IMPLEMENTATION_NAME);
+    fprintf(f, "* xDBLe(2) = %.0f, eval_4_isog = %.0f, xTPL = %.0f, eval_3_isog = %.0f\n", pA, qA, pB, qB);
+    fprintf(f, "*********************************************************************************************/\n\n");
+    fprintf(f, "#define MAX_INT_POINTS_ALICE    %u\n", pts_A);
+    fprintf(f, "#define MAX_INT_POINTS_BOB      %u\n\n", pts_B);
+    print_strategy(f, "STRAT_ALICE_TUNED", MAX_Alice, strat_A);
+    fprintf(f, "\n");
+    print_strategy(f, "STRAT_BOB_TUNED", MAX_Bob, strat_B);
+    fclose(f);
+
+    return 0;
+}
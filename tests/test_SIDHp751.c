@@ -18,5 +18,12 @@
 #define EphemeralKeyGeneration_B      EphemeralKeyGeneration_B_SIDHp751
 #define EphemeralSecretAgreement_A    EphemeralSecretAgreement_A_SIDHp751
 #define EphemeralSecretAgreement_B    EphemeralSecretAgreement_B_SIDHp751
+#define EphemeralKeyGeneration_A_x4   EphemeralKeyGeneration_A_x4_SIDHp751
+#define EphemeralSecretAgreement_B_x4 EphemeralSecretAgreement_B_x4_SIDHp751
+#define EphemeralKeyPoolStart_A       EphemeralKeyPoolStart_A_SIDHp751
+#define EphemeralKeyPoolStart_B       EphemeralKeyPoolStart_B_SIDHp751
+#define EphemeralKeyPoolStop          EphemeralKeyPoolStop_SIDHp751
+#define EphemeralKeyPair_A            EphemeralKeyPair_A_SIDHp751
+#define EphemeralKeyPair_B            EphemeralKeyPair_B_SIDHp751
 
 #include "test_sidh.c"
\ No newline at end of file
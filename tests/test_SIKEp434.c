@@ -15,5 +15,11 @@
 #define crypto_kem_keypair            crypto_kem_keypair_SIKEp434
 #define crypto_kem_enc                crypto_kem_enc_SIKEp434
 #define crypto_kem_dec                crypto_kem_dec_SIKEp434
+#define crypto_kem_dec_x4             crypto_kem_dec_x4_SIKEp434
+#define crypto_kem_pk_expand          crypto_kem_pk_expand_SIKEp434
+#define crypto_kem_enc_ctx            crypto_kem_enc_ctx_SIKEp434
+#define sike_pk_ctx                   sike_pk_ctx_SIKEp434
+#define crypto_kem_enc_batch          crypto_kem_enc_batch_SIKEp434
+#define crypto_kem_dec_batch          crypto_kem_dec_batch_SIKEp434
 
 #include "test_sike.c"
\ No newline at end of file
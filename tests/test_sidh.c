@@ -14,6 +14,10 @@
     #define TEST_LOOPS        10      
 #endif
 
+#if defined(PARALLEL_TRAVERSAL)
+    #include "../src/threads/thread_pool.h"
+#endif
+
 
 int cryptotest_kex()
 { // Testing key exchange
@@ -50,6 +54,101 @@ int cryptotest_kex()
 }
 
 
+#if defined(EphemeralKeyPair_A)
+
+int cryptotest_kex_pool()
+{ // Testing key exchange with key pairs from the key pools, or generated by the caller if the build does not support the pools
+    unsigned int i;
+    unsigned char PrivateKeyA[SIDH_SECRETKEYBYTES_A], PrivateKeyB[SIDH_SECRETKEYBYTES_B];
+    unsigned char PublicKeyA[SIDH_PUBLICKEYBYTES], PublicKeyB[SIDH_PUBLICKEYBYTES], PublicKey[SIDH_PUBLICKEYBYTES];
+    unsigned char PreviousKeyA[SIDH_PUBLICKEYBYTES] = {0};
+    unsigned char SharedSecretA[SIDH_BYTES], SharedSecretB[SIDH_BYTES];
+    bool passed = true;
+
+    if (EphemeralKeyPoolStart_A(4, 1) == 0 && EphemeralKeyPoolStart_A(4, 1) == 0) {
+        passed = false;                                                               // A running pool must not be started again
+    }
+    EphemeralKeyPoolStart_B(4, 1);
+
+    for (i = 0; i < TEST_LOOPS + 1 && passed; i++) 
+    {
+        if (i == TEST_LOOPS) {
+            EphemeralKeyPoolStop();                                                   // The last key pairs are generated by the caller
+        }
+        EphemeralKeyPair_A(PrivateKeyA, PublicKeyA);
+        EphemeralKeyPair_B(PrivateKeyB, PublicKeyB);
+        EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA);
+        EphemeralSecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB);
+        if (memcmp(SharedSecretA, SharedSecretB, SIDH_BYTES) != 0 || memcmp(PublicKeyA, PreviousKeyA, SIDH_PUBLICKEYBYTES) == 0) {
+            passed = false;
+        }
+        memcpy(PreviousKeyA, PublicKeyA, SIDH_PUBLICKEYBYTES);
+
+        EphemeralKeyGeneration_A(PrivateKeyA, PublicKey);                             // The public keys must match the private keys
+        if (memcmp(PublicKey, PublicKeyA, SIDH_PUBLICKEYBYTES) != 0) {
+            passed = false;
+        }
+        EphemeralKeyGeneration_B(PrivateKeyB, PublicKey);
+        if (memcmp(PublicKey, PublicKeyB, SIDH_PUBLICKEYBYTES) != 0) {
+            passed = false;
+        }
+    }
+
+    if (passed == true) printf("  Key exchange tests with pooled key pairs ..................... PASSED");
+    else { printf("  Key exchange tests with pooled key pairs ... FAILED"); printf("\n"); return FAILED; }
+    printf("\n"); 
+
+    return PASSED;
+}
+
+#endif
+
+
+#if defined(AVX2_X4_IMPLEMENTATION) && defined(EphemeralKeyGeneration_A_x4)
+
+int cryptotest_kex_x4()
+{ // Testing the 4-way key exchange functions against the single-lane ones
+    unsigned int i, j;
+    unsigned char PrivateKeyA[4][SIDH_SECRETKEYBYTES_A], PrivateKeyB[4][SIDH_SECRETKEYBYTES_B];
+    unsigned char PublicKeyA[4][SIDH_PUBLICKEYBYTES], PublicKeyB[4][SIDH_PUBLICKEYBYTES], PublicKeyA_x4[4][SIDH_PUBLICKEYBYTES];
+    unsigned char SharedSecretA[4][SIDH_BYTES], SharedSecretB_x4[4][SIDH_BYTES];
+    const unsigned char* skA[4] = {PrivateKeyA[0], PrivateKeyA[1], PrivateKeyA[2], PrivateKeyA[3]};
+    const unsigned char* skB[4] = {PrivateKeyB[0], PrivateKeyB[1], PrivateKeyB[2], PrivateKeyB[3]};
+    const unsigned char* pkA[4] = {PublicKeyA[0], PublicKeyA[1], PublicKeyA[2], PublicKeyA[3]};
+    unsigned char* pkA_x4[4] = {PublicKeyA_x4[0], PublicKeyA_x4[1], PublicKeyA_x4[2], PublicKeyA_x4[3]};
+    unsigned char* ssB_x4[4] = {SharedSecretB_x4[0], SharedSecretB_x4[1], SharedSecretB_x4[2], SharedSecretB_x4[3]};
+    bool passed = true;
+
+    for (i = 0; i < TEST_LOOPS && passed; i++) 
+    {
+        for (j = 0; j < 4; j++) {
+            random_mod_order_A(PrivateKeyA[j]);
+            random_mod_order_B(PrivateKeyB[j]);
+            EphemeralKeyGeneration_A(PrivateKeyA[j], PublicKeyA[j]);
+            EphemeralKeyGeneration_B(PrivateKeyB[j], PublicKeyB[j]);
+            EphemeralSecretAgreement_A(PrivateKeyA[j], PublicKeyB[j], SharedSecretA[j]);
+        }
+        EphemeralKeyGeneration_A_x4(skA, pkA_x4);                                     // Alice's public keys computed 4 at a time
+        EphemeralSecretAgreement_B_x4(skB, pkA, ssB_x4);                              // Bob's shared secrets computed 4 at a time
+
+        for (j = 0; j < 4; j++) {
+            if (memcmp(PublicKeyA[j], PublicKeyA_x4[j], SIDH_PUBLICKEYBYTES) != 0 || memcmp(SharedSecretA[j], SharedSecretB_x4[j], SIDH_BYTES) != 0) {
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    if (passed == true) printf("  4-way key exchange tests ..................................... PASSED");
+    else { printf("  4-way key exchange tests ... FAILED"); printf("\n"); return FAILED; }
+    printf("\n"); 
+
+    return PASSED;
+}
+
+#endif
+
+
 int cryptorun_kex()
 { // Benchmarking key exchange
     unsigned int n;
@@ -100,10 +199,119 @@ int cryptorun_kex()
     printf("  Bob's shared key computation runs in ......................... %10lld ", cycles_shared_B/BENCH_LOOPS); print_unit;
     printf("\n");
 
+#if defined(AVX2_X4_IMPLEMENTATION) && defined(EphemeralKeyGeneration_A_x4)
+    unsigned char PrivateKeyA_x4[4][SIDH_SECRETKEYBYTES_A], PrivateKeyB_x4[4][SIDH_SECRETKEYBYTES_B];
+    unsigned char PublicKeyA_x4[4][SIDH_PUBLICKEYBYTES], SharedSecretB_x4[4][SIDH_BYTES];
+    const unsigned char* skA[4] = {PrivateKeyA_x4[0], PrivateKeyA_x4[1], PrivateKeyA_x4[2], PrivateKeyA_x4[3]};
+    const unsigned char* skB[4] = {PrivateKeyB_x4[0], PrivateKeyB_x4[1], PrivateKeyB_x4[2], PrivateKeyB_x4[3]};
+    const unsigned char* pkA[4] = {PublicKeyA_x4[0], PublicKeyA_x4[1], PublicKeyA_x4[2], PublicKeyA_x4[3]};
+    unsigned char* pkA_x4[4] = {PublicKeyA_x4[0], PublicKeyA_x4[1], PublicKeyA_x4[2], PublicKeyA_x4[3]};
+    unsigned char* ssB_x4[4] = {SharedSecretB_x4[0], SharedSecretB_x4[1], SharedSecretB_x4[2], SharedSecretB_x4[3]};
+    unsigned long long cycles_keygen_A_x4 = 0, cycles_shared_B_x4 = 0;
+
+    for (n = 0; n < 4; n++) {
+        random_mod_order_A(PrivateKeyA_x4[n]);
+        random_mod_order_B(PrivateKeyB_x4[n]);
+    }
+
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        // Benchmarking 4 of Alice's key generations at once
+        cycles1 = cpucycles();
+        EphemeralKeyGeneration_A_x4(skA, pkA_x4);
+        cycles2 = cpucycles();
+        cycles_keygen_A_x4 = cycles_keygen_A_x4+(cycles2-cycles1);
+
+        // Benchmarking 4 of Bob's shared key computations at once
+        cycles1 = cpucycles();
+        EphemeralSecretAgreement_B_x4(skB, pkA, ssB_x4);
+        cycles2 = cpucycles();
+        cycles_shared_B_x4 = cycles_shared_B_x4+(cycles2-cycles1);
+    }
+
+    printf("  4-way Alice's key generation runs in ......................... %10lld ", cycles_keygen_A_x4/BENCH_LOOPS); print_unit;
+    printf("\n");
+    printf("  4-way Bob's shared key computation runs in ................... %10lld ", cycles_shared_B_x4/BENCH_LOOPS); print_unit;
+    printf("\n");
+#endif
+
     return PASSED;
 }
 
 
+#if defined(PARALLEL_TRAVERSAL)
+
+static void kex_latency(unsigned long long cycles[4])
+{ // Average latency of Alice's and Bob's key generation and shared key computation
+    unsigned int n, i;
+    unsigned char PrivateKeyA[SIDH_SECRETKEYBYTES_A], PrivateKeyB[SIDH_SECRETKEYBYTES_B];
+    unsigned char PublicKeyA[SIDH_PUBLICKEYBYTES], PublicKeyB[SIDH_PUBLICKEYBYTES];
+    unsigned char SharedSecretA[SIDH_BYTES], SharedSecretB[SIDH_BYTES];
+    unsigned long long cycles1, cycles2;
+
+    random_mod_order_A(PrivateKeyA);
+    random_mod_order_B(PrivateKeyB);
+    for (i = 0; i < 4; i++) cycles[i] = 0;
+
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA);
+        cycles2 = cpucycles();
+        cycles[0] += cycles2-cycles1;
+
+        cycles1 = cpucycles();
+        EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB);
+        cycles2 = cpucycles();
+        cycles[1] += cycles2-cycles1;
+
+        cycles1 = cpucycles();
+        EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA); 
+        cycles2 = cpucycles();
+        cycles[2] += cycles2-cycles1;
+
+        cycles1 = cpucycles();
+        EphemeralSecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB);
+        cycles2 = cpucycles();
+        cycles[3] += cycles2-cycles1;
+    }
+    for (i = 0; i < 4; i++) cycles[i] /= BENCH_LOOPS;
+}
+
+
+int cryptorun_kex_parallel()
+{ // Benchmarking the latency of key exchange with and without the worker pool of the parallel traversal.
+  // While this thread holds the pool, the traversal runs serially.
+    unsigned long long serial[4], parallel[4];
+    int nworkers = thread_pool_acquire();
+
+    printf("\n\nBENCHMARKING THE PARALLEL ISOGENY TREE TRAVERSAL %s\n", SCHEME_NAME);
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    if (nworkers == 0) {
+        printf("  No worker threads (single available CPU or SIDH_THREAD_POOL_WORKERS=0), skipped\n");
+        return PASSED;
+    }
+    kex_latency(serial);
+    thread_pool_release();
+    kex_latency(parallel);
+
+    printf("  Worker threads, in addition to the calling thread ............ %10d\n", nworkers);
+    printf("  Alice's key generation runs in (serial / parallel) ........... %10lld / %10lld ", serial[0], parallel[0]); print_unit;
+    printf("\n");
+    printf("  Bob's key generation runs in (serial / parallel) ............. %10lld / %10lld ", serial[1], parallel[1]); print_unit;
+    printf("\n");
+    printf("  Alice's shared key computation runs in (serial / parallel) ... %10lld / %10lld ", serial[2], parallel[2]); print_unit;
+    printf("\n");
+    printf("  Bob's shared key computation runs in (serial / parallel) ..... %10lld / %10lld ", serial[3], parallel[3]); print_unit;
+    printf("\n");
+
+    return PASSED;
+}
+
+#endif
+
+
 int main()
 {
     int Status = PASSED;
@@ -114,11 +322,31 @@ int main()
         return FAILED;
     }
 
+#if defined(EphemeralKeyPair_A)
+    Status = cryptotest_kex_pool();        // Test key exchange with pooled key pairs
+    if (Status != PASSED) {
+        printf("\n\n   Error detected: KEX_ERROR_SHARED_KEY \n\n");
+        return FAILED;
+    }
+#endif
+
+#if defined(AVX2_X4_IMPLEMENTATION) && defined(EphemeralKeyGeneration_A_x4)
+    Status = cryptotest_kex_x4();          // Test 4-way key exchange
+    if (Status != PASSED) {
+        printf("\n\n   Error detected: KEX_ERROR_SHARED_KEY \n\n");
+        return FAILED;
+    }
+#endif
+
     Status = cryptorun_kex();              // Benchmark key exchange
     if (Status != PASSED) {
         printf("\n\n   Error detected: KEX_ERROR_SHARED_KEY \n\n");
         return FAILED;
     }
+
+#if defined(PARALLEL_TRAVERSAL)
+    Status = cryptorun_kex_parallel();     // Benchmark the latency of key exchange with and without the worker pool
+#endif
     
     return Status;
 }
\ No newline at end of file
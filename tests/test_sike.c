@@ -5,6 +5,10 @@
 *********************************************************************************************/ 
 
 #include "../src/random/random.h"
+#include "../src/sha3/fips202.h"
+#ifdef AVX2_X4_IMPLEMENTATION
+#include "../src/sha3/fips202x4.h"
+#endif
 
 #ifdef DO_VALGRIND_CHECK
 #include <valgrind/memcheck.h>
@@ -26,6 +30,83 @@
     #define BENCH_LOOPS      100    
 #endif
 
+#define TEST_BATCH             9      // Number of operations per batch in the batch tests (more than one group of the batched SIDH functions)
+#define BENCH_BATCH           10      // Number of operations per batch in the batch benchmarks
+#define SHAKE_TEST_BYTES      (3*SHAKE256_RATE + 8)    // Maximum input and output lengths in the SHAKE256 tests (more than three blocks)
+
+
+int cryptotest_shake256_inc()
+{ // Testing the incremental SHAKE256 against SHAKE256, with all input lengths up to SHAKE_TEST_BYTES. The input is absorbed and the
+  // output is squeezed in segments of random lengths from 0 to 255 bytes, which are not aligned to the blocks.
+    unsigned int inlen, pos, len;
+    unsigned char in[SHAKE_TEST_BYTES], out[SHAKE_TEST_BYTES], out1[SHAKE_TEST_BYTES], r;
+    uint64_t s[SHAKE_INC_STATE_WORDS];
+    bool passed = true;
+
+    randombytes(in, sizeof(in));
+    for (inlen = 0; inlen <= SHAKE_TEST_BYTES && passed; inlen++) {
+        shake256_inc_init(s);
+        for (pos = 0; pos < inlen; pos += len) {
+            randombytes(&r, 1);
+            len = (r < inlen - pos) ? r : inlen - pos;
+            shake256_inc_absorb(s, in + pos, len);
+        }
+        shake256_inc_finalize(s);
+        for (pos = 0; pos < SHAKE_TEST_BYTES; pos += len) {
+            randombytes(&r, 1);
+            len = (r < SHAKE_TEST_BYTES - pos) ? r : SHAKE_TEST_BYTES - pos;
+            shake256_inc_squeeze(out + pos, len, s);
+        }
+
+        shake256(out1, SHAKE_TEST_BYTES, in, inlen);
+        if (memcmp(out, out1, SHAKE_TEST_BYTES) != 0) {
+            passed = false;
+        }
+    }
+
+    if (passed == true) printf("  Incremental SHAKE256 tests ................................... PASSED");
+    else { printf("  Incremental SHAKE256 tests ... FAILED"); printf("\n"); return FAILED; }
+    printf("\n"); 
+
+    return PASSED;
+}
+
+
+#if defined(AVX2_X4_IMPLEMENTATION) && defined(crypto_kem_dec_x4)
+
+static const unsigned int shake_outlen[] = { 1, 16, SHAKE256_RATE - 1, SHAKE256_RATE, SHAKE256_RATE + 1, 2*SHAKE256_RATE, 2*SHAKE256_RATE + 1, SHAKE_TEST_BYTES };
+
+
+int cryptotest_shake256x4()
+{ // Testing the 4-way SHAKE256 used by the batch and 4-way KEM against SHAKE256, with all input lengths up to SHAKE_TEST_BYTES
+  // and outputs of one to several blocks
+    unsigned int i, j, inlen;
+    unsigned char in[4][SHAKE_TEST_BYTES], out[4][SHAKE_TEST_BYTES], out1[SHAKE_TEST_BYTES];
+    bool passed = true;
+
+    randombytes(in[0], sizeof(in));
+    for (inlen = 0; inlen <= SHAKE_TEST_BYTES && passed; inlen++) {
+        for (i = 0; i < sizeof(shake_outlen)/sizeof(shake_outlen[0]) && passed; i++) {
+            shake256x4(out[0], out[1], out[2], out[3], shake_outlen[i], in[0], in[1], in[2], in[3], inlen);
+            for (j = 0; j < 4; j++) {
+                shake256(out1, shake_outlen[i], in[j], inlen);
+                if (memcmp(out[j], out1, shake_outlen[i]) != 0) {
+                    passed = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (passed == true) printf("  4-way SHAKE256 tests ......................................... PASSED");
+    else { printf("  4-way SHAKE256 tests ... FAILED"); printf("\n"); return FAILED; }
+    printf("\n"); 
+
+    return PASSED;
+}
+
+#endif
+
 
 int cryptotest_kem()
 { // Testing KEM
@@ -89,6 +170,187 @@ int cryptotest_kem()
 }
 
 
+int cryptotest_kem_det()
+{ // Testing that the deterministic generator reproduces key pairs and encapsulations
+    unsigned int i;
+    unsigned char sk[2][CRYPTO_SECRETKEYBYTES] = {0};
+    unsigned char pk[3][CRYPTO_PUBLICKEYBYTES] = {0};
+    unsigned char ct[2][CRYPTO_CIPHERTEXTBYTES] = {0};
+    unsigned char ss[2][CRYPTO_BYTES] = {0};
+    unsigned char ss_[CRYPTO_BYTES] = {0};
+    unsigned char seed[32];
+    randombytes_det_t rng;
+    bool passed = true;
+
+    for (i = 0; i < sizeof(seed); i++) {
+        seed[i] = (unsigned char)i;
+    }
+    for (i = 0; i < 2; i++) 
+    {
+        randombytes_det_init(&rng, seed, sizeof(seed));
+        randombytes_set_callback(randombytes_det, &rng);
+        crypto_kem_keypair(pk[i], sk[i]);
+        crypto_kem_enc(ct[i], ss[i], pk[i]);
+        randombytes_set_callback(NULL, NULL);
+    }
+    crypto_kem_keypair(pk[2], sk[1]);                                             // The default generator is restored
+    crypto_kem_dec(ss_, ct[0], sk[0]);
+
+    if (memcmp(pk[0], pk[1], CRYPTO_PUBLICKEYBYTES) != 0 || memcmp(ct[0], ct[1], CRYPTO_CIPHERTEXTBYTES) != 0 || 
+        memcmp(ss[0], ss[1], CRYPTO_BYTES) != 0 || memcmp(ss[0], ss_, CRYPTO_BYTES) != 0 || memcmp(pk[0], pk[2], CRYPTO_PUBLICKEYBYTES) == 0) {
+        passed = false;
+    }
+
+    if (passed == true) printf("  KEM tests with the deterministic generator ................... PASSED");
+    else { printf("  KEM tests with the deterministic generator ... FAILED"); printf("\n"); return FAILED; }
+    printf("\n"); 
+
+    return PASSED;
+}
+
+
+#if defined(crypto_kem_enc_ctx)
+
+int cryptotest_kem_ctx()
+{ // Testing encapsulation with an expanded public key
+    unsigned int i, j;
+    unsigned char sk[CRYPTO_SECRETKEYBYTES] = {0};
+    unsigned char pk[CRYPTO_PUBLICKEYBYTES] = {0};
+    unsigned char ct[CRYPTO_CIPHERTEXTBYTES] = {0};
+    unsigned char ss[CRYPTO_BYTES] = {0};
+    unsigned char ss_[CRYPTO_BYTES] = {0};
+    static sike_pk_ctx ctx;
+    bool passed = true;
+
+    for (i = 0; i < TEST_LOOPS && passed; i++) 
+    {
+        crypto_kem_keypair(pk, sk);
+        crypto_kem_pk_expand(&ctx, pk);
+
+        for (j = 0; j < 4; j++) {
+            crypto_kem_enc_ctx(ct, ss, &ctx);
+            crypto_kem_dec(ss_, ct, sk);
+            if (memcmp(ss, ss_, CRYPTO_BYTES) != 0) {
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    if (passed == true) printf("  KEM tests with expanded public keys .......................... PASSED");
+    else { printf("  KEM tests with expanded public keys ... FAILED"); printf("\n"); return FAILED; }
+    printf("\n"); 
+
+    return PASSED;
+}
+
+#endif
+
+
+#if defined(crypto_kem_enc_batch)
+
+int cryptotest_kem_batch()
+{ // Testing batch encapsulation and decapsulation against the single KEM, with two key pairs used alternately
+    unsigned int i, j;
+    unsigned char sk[2][CRYPTO_SECRETKEYBYTES] = {{0}};
+    unsigned char pk[2][CRYPTO_PUBLICKEYBYTES] = {{0}};
+    unsigned char ct[TEST_BATCH][CRYPTO_CIPHERTEXTBYTES] = {{0}};
+    unsigned char ss[TEST_BATCH][CRYPTO_BYTES] = {{0}};
+    unsigned char ss_[TEST_BATCH][CRYPTO_BYTES] = {{0}};
+    unsigned char ss1[CRYPTO_BYTES] = {0};
+    const unsigned char *skp[TEST_BATCH], *pkp[TEST_BATCH], *ctp[TEST_BATCH];
+    unsigned char *ctp_[TEST_BATCH], *ssp[TEST_BATCH], *ssp_[TEST_BATCH];
+    unsigned char bytes[4];
+    uint32_t* pos = (uint32_t*)bytes;
+    bool passed = true;
+
+    for (j = 0; j < TEST_BATCH; j++) {
+        skp[j] = sk[j % 2];
+        pkp[j] = pk[j % 2];
+        ctp[j] = ctp_[j] = ct[j];
+        ssp[j] = ss[j];
+        ssp_[j] = ss_[j];
+    }
+
+    for (i = 0; i < TEST_LOOPS && passed; i++) 
+    {
+        crypto_kem_keypair(pk[0], sk[0]);
+        crypto_kem_keypair(pk[1], sk[1]);
+        crypto_kem_enc_batch(ctp_, ssp, pkp, TEST_BATCH);
+
+        // Testing decapsulation after changing one bit of one of the ciphertexts
+        randombytes(bytes, 4);
+        *pos %= CRYPTO_CIPHERTEXTBYTES;
+        ct[i % TEST_BATCH][*pos] ^= 1;
+        crypto_kem_dec_batch(ssp_, ctp, skp, TEST_BATCH);
+
+        for (j = 0; j < TEST_BATCH; j++) {
+            crypto_kem_dec(ss1, ct[j], sk[j % 2]);
+            if ((memcmp(ss[j], ss_[j], CRYPTO_BYTES) == 0) != (j != i % TEST_BATCH) || memcmp(ss1, ss_[j], CRYPTO_BYTES) != 0) {
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    if (passed == true) printf("  Batch KEM tests .............................................. PASSED");
+    else { printf("  Batch KEM tests ... FAILED"); printf("\n"); return FAILED; }
+    printf("\n"); 
+
+    return PASSED;
+}
+
+#endif
+
+
+#if defined(AVX2_X4_IMPLEMENTATION) && defined(crypto_kem_dec_x4)
+
+int cryptotest_kem_x4()
+{ // Testing 4-way decapsulation against the single-lane KEM
+    unsigned int i, j;
+    unsigned char sk[4][CRYPTO_SECRETKEYBYTES] = {{0}};
+    unsigned char pk[4][CRYPTO_PUBLICKEYBYTES] = {{0}};
+    unsigned char ct[4][CRYPTO_CIPHERTEXTBYTES] = {{0}};
+    unsigned char ss[4][CRYPTO_BYTES] = {{0}};
+    unsigned char ss_[4][CRYPTO_BYTES] = {{0}};
+    const unsigned char* skp[4] = {sk[0], sk[1], sk[2], sk[3]};
+    const unsigned char* ctp[4] = {ct[0], ct[1], ct[2], ct[3]};
+    unsigned char* ssp_[4] = {ss_[0], ss_[1], ss_[2], ss_[3]};
+    unsigned char bytes[4];
+    uint32_t* pos = (uint32_t*)bytes;
+    bool passed = true;
+
+    for (i = 0; i < TEST_LOOPS && passed; i++) 
+    {
+        for (j = 0; j < 4; j++) {
+            crypto_kem_keypair(pk[j], sk[j]);
+            crypto_kem_enc(ct[j], ss[j], pk[j]);
+        }
+
+        // Testing decapsulation after changing one bit of the ciphertext in one of the lanes
+        randombytes(bytes, 4);
+        *pos %= CRYPTO_CIPHERTEXTBYTES;
+        ct[i % 4][*pos] ^= 1;
+        crypto_kem_dec_x4(ssp_, ctp, skp);
+
+        for (j = 0; j < 4; j++) {
+            if ((memcmp(ss[j], ss_[j], CRYPTO_BYTES) == 0) != (j != i % 4)) {
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    if (passed == true) printf("  4-way KEM decapsulation tests ................................ PASSED");
+    else { printf("  4-way KEM decapsulation tests ... FAILED"); printf("\n"); return FAILED; }
+    printf("\n"); 
+
+    return PASSED;
+}
+
+#endif
+
+
 int cryptorun_kem()
 { // Benchmarking key exchange
     unsigned int n;
@@ -98,10 +360,16 @@ int cryptorun_kem()
     unsigned char ss[CRYPTO_BYTES] = {0};
     unsigned char ss_[CRYPTO_BYTES] = {0};
     unsigned long long cycles_keygen = 0, cycles_encaps = 0, cycles_decaps = 0, cycles1, cycles2;
+    static const unsigned char seed[32] = {0};
+    randombytes_det_t rng;
 
     printf("\n\nBENCHMARKING ISOGENY-BASED KEY ENCAPSULATION MECHANISM %s\n", SCHEME_NAME);
     printf("--------------------------------------------------------------------------------------------------------\n\n");
 
+    // The deterministic generator keeps system calls out of the measurements and makes them repeatable
+    randombytes_det_init(&rng, seed, sizeof(seed));
+    randombytes_set_callback(randombytes_det, &rng);
+
     for (n = 0; n < BENCH_LOOPS; n++)
     {
         // Benchmarking key generation
@@ -130,6 +398,87 @@ int cryptorun_kem()
     printf("  Decapsulation runs in ........................................ %10lld ", cycles_decaps/BENCH_LOOPS); print_unit;
     printf("\n");
 
+#if defined(crypto_kem_enc_ctx)
+    static sike_pk_ctx ctx;
+    unsigned long long cycles_expand = 0, cycles_encaps_ctx = 0;
+
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        // Benchmarking public key expansion
+        cycles1 = cpucycles();
+        crypto_kem_pk_expand(&ctx, pk);
+        cycles2 = cpucycles();
+        cycles_expand = cycles_expand+(cycles2-cycles1);
+
+        // Benchmarking encapsulation with an expanded public key
+        cycles1 = cpucycles();
+        crypto_kem_enc_ctx(ct, ss, &ctx);
+        cycles2 = cpucycles();
+        cycles_encaps_ctx = cycles_encaps_ctx+(cycles2-cycles1);
+    }
+
+    printf("  Public key expansion runs in ................................. %10lld ", cycles_expand/BENCH_LOOPS); print_unit;
+    printf("\n");
+    printf("  Encapsulation with an expanded public key runs in ............ %10lld ", cycles_encaps_ctx/BENCH_LOOPS); print_unit;
+    printf("\n");
+#endif
+
+#if defined(crypto_kem_enc_batch)
+    const unsigned char *skp_batch[BENCH_BATCH], *pkp_batch[BENCH_BATCH], *ctp_batch[BENCH_BATCH];
+    unsigned char ct_batch[BENCH_BATCH][CRYPTO_CIPHERTEXTBYTES], ss_batch[BENCH_BATCH][CRYPTO_BYTES];
+    unsigned char *ctp_batch_[BENCH_BATCH], *ssp_batch[BENCH_BATCH];
+    unsigned long long cycles_encaps_batch = 0, cycles_decaps_batch = 0;
+
+    for (n = 0; n < BENCH_BATCH; n++) {
+        skp_batch[n] = sk;
+        pkp_batch[n] = pk;
+        ctp_batch[n] = ctp_batch_[n] = ct_batch[n];
+        ssp_batch[n] = ss_batch[n];
+    }
+
+    for (n = 0; n < BENCH_LOOPS; n += BENCH_BATCH)
+    {
+        // Benchmarking batch encapsulation
+        cycles1 = cpucycles();
+        crypto_kem_enc_batch(ctp_batch_, ssp_batch, pkp_batch, BENCH_BATCH);
+        cycles2 = cpucycles();
+        cycles_encaps_batch = cycles_encaps_batch+(cycles2-cycles1);
+
+        // Benchmarking batch decapsulation
+        cycles1 = cpucycles();
+        crypto_kem_dec_batch(ssp_batch, ctp_batch, skp_batch, BENCH_BATCH);
+        cycles2 = cpucycles();
+        cycles_decaps_batch = cycles_decaps_batch+(cycles2-cycles1);
+    }
+    n = (BENCH_LOOPS + BENCH_BATCH - 1)/BENCH_BATCH*BENCH_BATCH;    // Number of operations benchmarked
+
+    printf("  Batch encapsulation runs in (per operation) .................. %10lld ", cycles_encaps_batch/n); print_unit;
+    printf("\n");
+    printf("  Batch decapsulation runs in (per operation) .................. %10lld ", cycles_decaps_batch/n); print_unit;
+    printf("\n");
+#endif
+
+#if defined(AVX2_X4_IMPLEMENTATION) && defined(crypto_kem_dec_x4)
+    const unsigned char* skp[4] = {sk, sk, sk, sk};
+    const unsigned char* ctp[4] = {ct, ct, ct, ct};
+    unsigned char ss_x4[4][CRYPTO_BYTES];
+    unsigned char* ssp_x4[4] = {ss_x4[0], ss_x4[1], ss_x4[2], ss_x4[3]};
+    unsigned long long cycles_decaps_x4 = 0;
+
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        // Benchmarking 4 decapsulations at once
+        cycles1 = cpucycles();
+        crypto_kem_dec_x4(ssp_x4, ctp, skp);
+        cycles2 = cpucycles();
+        cycles_decaps_x4 = cycles_decaps_x4+(cycles2-cycles1);
+    }
+
+    printf("  4-way decapsulation runs in .................................. %10lld ", cycles_decaps_x4/BENCH_LOOPS); print_unit;
+    printf("\n");
+#endif
+
+    randombytes_set_callback(NULL, NULL);
     return PASSED;
 }
 
@@ -143,6 +492,50 @@ int main(int argc, char **argv)
         printf("\n\n   Error detected: KEM_ERROR_SHARED_KEY \n\n");
         return FAILED;
     }
+
+    Status = cryptotest_shake256_inc();  // Test incremental SHAKE256
+    if (Status != PASSED) {
+        printf("\n\n   Error detected: SHAKE256 \n\n");
+        return FAILED;
+    }
+
+#if defined(AVX2_X4_IMPLEMENTATION) && defined(crypto_kem_dec_x4)
+    Status = cryptotest_shake256x4();  // Test 4-way SHAKE256
+    if (Status != PASSED) {
+        printf("\n\n   Error detected: SHAKE256 \n\n");
+        return FAILED;
+    }
+#endif
+
+    Status = cryptotest_kem_det(); // Test reproducibility with the deterministic generator
+    if (Status != PASSED) {
+        printf("\n\n   Error detected: KEM_ERROR_SHARED_KEY \n\n");
+        return FAILED;
+    }
+
+#if defined(crypto_kem_enc_ctx)
+    Status = cryptotest_kem_ctx(); // Test encapsulation with expanded public keys
+    if (Status != PASSED) {
+        printf("\n\n   Error detected: KEM_ERROR_SHARED_KEY \n\n");
+        return FAILED;
+    }
+#endif
+
+#if defined(crypto_kem_enc_batch)
+    Status = cryptotest_kem_batch(); // Test batch encapsulation and decapsulation
+    if (Status != PASSED) {
+        printf("\n\n   Error detected: KEM_ERROR_SHARED_KEY \n\n");
+        return FAILED;
+    }
+#endif
+
+#if defined(AVX2_X4_IMPLEMENTATION) && defined(crypto_kem_dec_x4)
+    Status = cryptotest_kem_x4();  // Test 4-way decapsulation
+    if (Status != PASSED) {
+        printf("\n\n   Error detected: KEM_ERROR_SHARED_KEY \n\n");
+        return FAILED;
+    }
+#endif
     
     if ((argc > 1) && (strcmp("nobench", argv[1]) == 0)) {}
     else {